@@ -32,7 +32,7 @@ const std::string& Option::Help() const
 }
 
 template <>
-bool SimpleOption<std::string>::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool SimpleOption<std::string>::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	if ( argsBegin != argsEnd )
 	{
@@ -49,19 +49,19 @@ bool SimpleOption<std::string>::Parse( std::vector< std::string >::const_iterato
 }
 
 template <>
-bool SimpleOption<bool>::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool SimpleOption<bool>::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	// TODO: use in_avail
 	if ( argsBegin != argsEnd )
 	{
-		const std::string& arg = (*argsBegin);
+		const char* arg = (*argsBegin);
 		++argsBegin;
 
-		if ( CaseInsensitiveCompareString( arg.c_str(), "false" ) == 0 || CaseInsensitiveCompareString( arg.c_str(), "0" ) == 0 )
+		if ( CaseInsensitiveCompareString( arg, "false" ) == 0 || CaseInsensitiveCompareString( arg, "0" ) == 0 )
 		{
 			*m_Data = false;
 		}
-		else if ( CaseInsensitiveCompareString( arg.c_str(), "true" ) == 0 || CaseInsensitiveCompareString( arg.c_str(), "1" ) == 0 )
+		else if ( CaseInsensitiveCompareString( arg, "true" ) == 0 || CaseInsensitiveCompareString( arg, "1" ) == 0 )
 		{
 			*m_Data = true;
 		}
@@ -74,7 +74,7 @@ bool SimpleOption<bool>::Parse( std::vector< std::string >::const_iterator& args
 }
 
 template <>
-bool SimpleOption< std::vector< std::string > >::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool SimpleOption< std::vector< std::string > >::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	// tokenize and push_back via m_Data
 	bool result = false;
@@ -82,24 +82,21 @@ bool SimpleOption< std::vector< std::string > >::Parse( std::vector< std::string
 	while ( argsBegin != argsEnd )
 	{
 		// stop looking once we get to the optional params
-		const std::string& arg = (*argsBegin);
+		const char* arg = (*argsBegin);
 
-		if ( arg.length() >= 1 )
+		if ( arg[ 0 ] == '-' )
 		{
-			if ( arg[ 0 ] == '-' )
-			{
-				break;
-			}
-			else
-			{
-				++argsBegin;
+			break;
+		}
 
-				(*m_Data).push_back( arg );
+		++argsBegin;
 
-				result = true;
-			}
-		}
+		if ( arg[ 0 ] != '\0' )
+		{
+			(*m_Data).push_back( arg );
 
+			result = true;
+		}
 	}
 
 	if ( !result || (*m_Data).empty() )
@@ -118,7 +115,7 @@ FlagOption::FlagOption( bool* data, const char* token, const char* help )
 	*m_Data = false;
 }
 
-bool FlagOption::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool FlagOption::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	*m_Data = true;
 	return true;
@@ -190,17 +187,17 @@ bool OptionsMap::AddOption( const OptionPtr& option, std::string& error )
 	return true;
 }
 
-bool OptionsMap::ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool OptionsMap::ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	bool result = true;
 
 	while ( result && ( argsBegin != argsEnd ) )
 	{
-		const std::string& arg = (*argsBegin);
+		const char* arg = (*argsBegin);
 
-		if ( arg.length() >= 1 && arg[ 0 ] == '-' )
+		if ( arg[ 0 ] == '-' )
 		{
-			M_StringToOptionPtr::const_iterator optionsItr = m_OptionsMap.find( arg.substr( 1 ) );
+			M_StringToOptionPtr::const_iterator optionsItr = m_OptionsMap.find( arg + 1 );
 			if ( optionsItr != m_OptionsMap.end() )
 			{
 				argsBegin++;
@@ -268,7 +265,7 @@ bool Command::AddOption( const OptionPtr& option, std::string& error )
 	return m_OptionsMap.AddOption( option, error );
 }
 
-bool Command::ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool Command::ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	return m_OptionsMap.ParseOptions( argsBegin, argsEnd, error );
 }
@@ -279,7 +276,7 @@ HelpCommand::HelpCommand( Processor* owner )
 {
 }
 
-bool HelpCommand::Process( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool HelpCommand::Process( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	HELIUM_ASSERT( m_Owner );
 
@@ -381,7 +378,7 @@ bool Processor::AddOption( const OptionPtr& option, std::string& error )
 	return m_OptionsMap.AddOption( option, error );
 }
 
-bool Processor::ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool Processor::ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	return m_OptionsMap.ParseOptions( argsBegin, argsEnd, error );
 }
@@ -410,7 +407,7 @@ Command* Processor::GetCommand( const std::string& token )
 	return command;
 }
 
-bool Processor::Process( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool Processor::Process( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	if ( !ParseOptions( argsBegin, argsEnd, error ) )
 	{
@@ -421,10 +418,10 @@ bool Processor::Process( std::vector< std::string >::const_iterator& argsBegin,
 
 	while ( result && ( argsBegin != argsEnd ) )
 	{
-		const std::string& arg = (*argsBegin);
+		const char* arg = (*argsBegin);
 		++argsBegin;
 
-		if ( arg.length() < 1 )
+		if ( arg[ 0 ] == '\0' )
 			continue;
 
 		if ( arg[ 0 ] == '-' )
@@ -449,3 +446,25 @@ bool Processor::Process( std::vector< std::string >::const_iterator& argsBegin,
 
 	return result;
 }
+
+bool Processor::Process( int argc, ArgIterator argv, std::string& error )
+{
+	ArgIterator argsBegin = argc > 1 ? argv + 1 : argv;
+	ArgIterator argsEnd = argc > 1 ? argv + argc : argv;
+	return Process( argsBegin, argsEnd, error );
+}
+
+bool Processor::Process( const std::vector< std::string >& args, std::string& error )
+{
+	// only the pointers are copied
+	std::vector< const char* > argv;
+	argv.reserve( args.size() );
+	for ( std::vector< std::string >::const_iterator itr = args.begin(), end = args.end(); itr != end; ++itr )
+	{
+		argv.push_back( itr->c_str() );
+	}
+
+	ArgIterator argsBegin = argv.empty() ? NULL : &argv.front();
+	ArgIterator argsEnd = argsBegin + argv.size();
+	return Process( argsBegin, argsEnd, error );
+}
@@ -14,6 +14,9 @@ namespace Helium
 {
 	namespace CommandLine
 	{
+		// options and commands parse the arguments in place, through a view of argv (or any other array of strings)
+		typedef const char* const* ArgIterator;
+
 		class HELIUM_APPLICATION_API Option : public Helium::RefCountBase< Option >
 		{
 		protected:
@@ -28,7 +31,7 @@ namespace Helium
 			virtual const std::string& Usage() const;
 			virtual const std::string& Help() const;
 	
-			virtual bool Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error ) = 0;
+			virtual bool Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error ) = 0;
 		};
 		typedef Helium::SmartPtr< Option > OptionPtr;
 		typedef std::vector< OptionPtr > V_OptionPtr;
@@ -43,17 +46,17 @@ namespace Helium
 		public:
 			SimpleOption( T* data, const char* token, const char* usage = "<ARG>", const char* help = "" );
 
-			virtual bool Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error ) override;
+			virtual bool Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error ) override;
 		};
 
 		template <>
-		HELIUM_APPLICATION_API bool SimpleOption<std::string>::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+		HELIUM_APPLICATION_API bool SimpleOption<std::string>::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 
 		template <>
-		HELIUM_APPLICATION_API bool SimpleOption<bool>::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+		HELIUM_APPLICATION_API bool SimpleOption<bool>::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 
 		template <>
-		HELIUM_APPLICATION_API bool SimpleOption< std::vector< std::string > >::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+		HELIUM_APPLICATION_API bool SimpleOption< std::vector< std::string > >::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 
 		class HELIUM_APPLICATION_API FlagOption : public SimpleOption<bool>
 		{
@@ -63,7 +66,7 @@ namespace Helium
 		public:
 			FlagOption( bool* data, const char* token, const char* help = "" );
 
-			virtual bool Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error ) override;
+			virtual bool Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error ) override;
 		};
 
 		class HELIUM_APPLICATION_API OptionsMap
@@ -82,7 +85,7 @@ namespace Helium
 			const std::string& Help() const;
 
 			bool AddOption( const OptionPtr& option, std::string& error );
-			bool ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+			bool ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 		};
 
 		class HELIUM_APPLICATION_API Command
@@ -106,9 +109,9 @@ namespace Helium
 			virtual const std::string& Help() const;
 
 			bool AddOption( const OptionPtr& option, std::string& error );
-			bool ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+			bool ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 
-			virtual bool Process( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error ) = 0;
+			virtual bool Process( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error ) = 0;
 		};
 
 		typedef std::map< std::string, Command* > M_StringToCommandDumbPtr;
@@ -126,7 +129,7 @@ namespace Helium
 
 			inline void SetOwner( Processor* owner );
 
-			virtual bool Process( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error ) override;
+			virtual bool Process( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error ) override;
 		};
 		
 		class HELIUM_APPLICATION_API Processor
@@ -152,12 +155,16 @@ namespace Helium
 			virtual const std::string& Help() const;
 
 			bool AddOption( const OptionPtr& option, std::string& error );
-			bool ParseOptions( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+			bool ParseOptions( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
 
 			bool RegisterCommand( Command* command, std::string& error );
 			Command* GetCommand( const std::string& token );
 
-			virtual bool Process( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error );
+			virtual bool Process( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error );
+
+			// process the arguments after the program name, takes main's char** argv as it is
+			bool Process( int argc, ArgIterator argv, std::string& error );
+			bool Process( const std::vector< std::string >& args, std::string& error );
 		};
 	}
 }
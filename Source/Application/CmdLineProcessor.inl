@@ -6,17 +6,23 @@ Helium::CommandLine::SimpleOption<T>::SimpleOption( T* data, const char* token,
 }
 
 template <class T>
-bool Helium::CommandLine::SimpleOption<T>::Parse( std::vector< std::string >::const_iterator& argsBegin, const std::vector< std::string >::const_iterator& argsEnd, std::string& error )
+bool Helium::CommandLine::SimpleOption<T>::Parse( ArgIterator& argsBegin, const ArgIterator& argsEnd, std::string& error )
 {
 	if ( argsBegin != argsEnd )
 	{
-		const std::string& arg = (*argsBegin);
+		const char* arg = (*argsBegin);
 		++argsBegin;
 
 		std::stringstream str ( arg );
 		str >> *m_Data;
 
-		return str.fail();
+		if ( str.fail() )
+		{
+			error = std::string( "Invalid parameter for option: " ) + m_Token;
+			return false;
+		}
+
+		return true;
 	}
 				
 	error = std::string( "Missing parameter for option: " ) + m_Token;
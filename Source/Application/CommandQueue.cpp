@@ -1,61 +1,166 @@
 #include "Precompile.h"
 #include "CommandQueue.h"
 
+#include "Platform/Timer.h"
+
 using namespace Helium;
 
 CommandQueue::CommandQueue()
+    : m_Posted( NULL )
 {
-
+    for ( uint32_t i = 0; i < CommandPriorities::Count; ++i )
+    {
+        m_Lanes[ i ].m_Head = m_Lanes[ i ].m_Tail = NULL;
+    }
 }
 
 CommandQueue::~CommandQueue()
 {
+    TakePosted();
+
+    for ( uint32_t i = 0; i < CommandPriorities::Count; ++i )
+    {
+        while ( Command* command = m_Lanes[ i ].m_Head )
+        {
+            m_Lanes[ i ].m_Head = command->m_Next;
+            delete command;
+        }
+    }
+}
+
+void CommandQueue::Post( VoidSignature::Delegate delegate, CommandPriority priority, uint64_t key )
+{
+    HELIUM_ASSERT( priority < CommandPriorities::Count );
+
+    Command* command = new Command( delegate, priority, key );
+
+    // delegate reference counts are not atomic, drop our reference before the command is
+    //  visible to the flushing thread (a delegate posted from another thread must not be kept around by the caller)
+    delegate.Clear();
 
+    // push onto the posted stack, the flushing thread takes the whole stack at once so a
+    //  compare and swap on the top is all the synchronization producers need
+    Command* top;
+    do
+    {
+        top = m_Posted;
+        command->m_Next = top;
+    }
+    while ( AtomicCompareExchangeRelease( m_Posted, command, top ) != top );
+
+    // the flush flag groups commands into a batch
+    //  - the first push on an empty stack schedules a flush via message
+    //  - subsequent pushes do not dispatch another message
+    //  - the flush swaps out the whole stack, so all the commands posted during a message pump will be flushed together
+    //  - after the stack is taken the next push will schedule the next message
+    if ( !top )
+    {
+        EnqueueFlush();
+    }
 }
 
-void CommandQueue::Post( VoidSignature::Delegate delegate )
+void CommandQueue::Flush( float64_t budgetMilliseconds )
 {
-    bool flush;
+    TakePosted();
 
+    const uint64_t start = Timer::GetTickCount();
+    bool expired = false;
+
+    for ( uint32_t i = 0; i < CommandPriorities::Count && !expired; ++i )
     {
-        Helium::MutexScopeLock taken( m_Mutex );
+        Lane& lane = m_Lanes[ i ];
+        while ( Command* command = lane.m_Head )
+        {
+            // unlink before invoking, the command may post or even flush again
+            lane.m_Head = command->m_Next;
+            if ( !lane.m_Head )
+            {
+                lane.m_Tail = NULL;
+            }
+
+            if ( command->m_Key )
+            {
+                m_Keys.Remove( command->m_Key );
+            }
 
-        // the flash flag groups commands into a batch
-        //  - the first push on an empty queue schedules a flush via message
-        //  - subsequent pushes do not dispatch another message
-        //  - ownership of the messages is taken in a lock, so the all the messages queued during a message pump will be flushed together
-        //  - after the queue is emptied the next push will schedule the next message
-        flush = m_Commands.empty();
+            // perform the work
+            command->m_Delegate.Invoke( Helium::Void () );
+            delete command;
 
-        m_Commands.push_back( delegate );
+            // at least one command runs per flush, so a tiny budget still makes progress
+            if ( budgetMilliseconds > 0.0 && Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) >= budgetMilliseconds )
+            {
+                expired = true;
+                break;
+            }
+        }
     }
 
-    if ( flush )
+    if ( expired && !IsEmpty() )
     {
         EnqueueFlush();
     }
 }
 
-void CommandQueue::Flush()
+bool CommandQueue::IsEmpty() const
+{
+    if ( m_Posted )
+    {
+        return false;
+    }
+
+    for ( uint32_t i = 0; i < CommandPriorities::Count; ++i )
+    {
+        if ( m_Lanes[ i ].m_Head )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CommandQueue::TakePosted()
 {
-    std::vector< VoidSignature::Delegate > commands;
+    Command* posted = AtomicExchangeAcquire( m_Posted, static_cast< Command* >( NULL ) );
 
+    // the stack is newest first, reverse it so each lane runs in posting order
+    Command* ordered = NULL;
+    while ( posted )
     {
-        Helium::MutexScopeLock taken ( m_Mutex);
-        commands = m_Commands;
-        m_Commands.clear();
+        Command* next = posted->m_Next;
+        posted->m_Next = ordered;
+        ordered = posted;
+        posted = next;
     }
 
-    std::vector< VoidSignature::Delegate >::const_iterator itr = commands.begin();
-    std::vector< VoidSignature::Delegate >::const_iterator end = commands.end();
-    for ( ; itr != end; ++itr )
+    while ( ordered )
     {
-        // perform the work
-        (*itr).Invoke( Helium::Void () );
+        Command* command = ordered;
+        ordered = command->m_Next;
+        command->m_Next = NULL;
+
+        if ( command->m_Key && !m_Keys.Insert( command->m_Key ).Second() )
+        {
+            // an identical command is already waiting to run
+            delete command;
+            continue;
+        }
+
+        Lane& lane = m_Lanes[ command->m_Priority ];
+        if ( lane.m_Tail )
+        {
+            lane.m_Tail->m_Next = command;
+        }
+        else
+        {
+            lane.m_Head = command;
+        }
+        lane.m_Tail = command;
     }
 }
 
 void CommandQueue::EnqueueFlush()
 {
     // override this to manually defer the Flush() call (instead of calling it explicitly in an update loop or timer)
-}
\ No newline at end of file
+}
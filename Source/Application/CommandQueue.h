@@ -1,17 +1,33 @@
 #pragma once
 
-#include "Platform/Locks.h"
+#include "Platform/Atomic.h"
 
 #include "Application/API.h"
 #include "Foundation/Event.h"
+#include "Foundation/HashSet.h"
 
 namespace Helium
 {
+    namespace CommandPriorities
+    {
+        enum CommandPriority
+        {
+            High,
+            Normal,
+            Low,
+            Count,
+        };
+    }
+    typedef CommandPriorities::CommandPriority CommandPriority;
+
     //
     // Designed to be aggregated into an editor, this class
     //  allows deferred command execution to allow performing
     //  commands to coexist easier with issuing commands in callbacks
     //
+    // Any thread may post without blocking; Flush must only be called
+    //  from one thread at a time (usually the main thread)
+    //
 
     class HELIUM_APPLICATION_API CommandQueue
     {
@@ -20,13 +36,46 @@ namespace Helium
         virtual ~CommandQueue();
 
     public:
-        void Post( VoidSignature::Delegate delegate );
-        void Flush();
+        // a non-zero key coalesces the command with any command of the same key that
+        //  has been posted but not yet run, the first one posted keeps its place
+        void Post( VoidSignature::Delegate delegate, CommandPriority priority = CommandPriorities::Normal, uint64_t key = 0 );
+
+        // runs higher priority commands first and posting order within a priority,
+        //  with a budget the commands left over are deferred to the next flush
+        void Flush( float64_t budgetMilliseconds = 0.0 );
+
+        // commands posted or deferred that have not run yet (consumer side only)
+        bool IsEmpty() const;
 
     protected:
         virtual void EnqueueFlush();
 
-        std::vector< VoidSignature::Delegate >  m_Commands; // the commands to redo when flushing
-        Helium::Mutex                           m_Mutex;    // to protect the command container
+        struct Command
+        {
+            Command( const VoidSignature::Delegate& delegate, CommandPriority priority, uint64_t key )
+                : m_Delegate( delegate )
+                , m_Priority( priority )
+                , m_Key( key )
+                , m_Next( NULL )
+            {
+            }
+
+            VoidSignature::Delegate m_Delegate;
+            CommandPriority         m_Priority;
+            uint64_t                m_Key;
+            Command*                m_Next;
+        };
+
+        struct Lane
+        {
+            Command* m_Head;
+            Command* m_Tail;
+        };
+
+        void TakePosted();
+
+        Command* volatile   m_Posted;                               // commands posted since the last flush, newest first
+        Lane                m_Lanes[ CommandPriorities::Count ];    // commands waiting to run, owned by the flushing thread
+        HashSet< uint64_t > m_Keys;                                 // coalescing keys of the commands in m_Lanes
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,27 @@
+#include "Precompile.h"
+#include "Application/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::ApplicationTests;
+
+// prints the time for several producers to post, and this thread to flush, 100k commands each, CommandQueueProducers checks they all run
+TEST(Application, CommandQueueProducersBenchmark)
+{
+	const uint32_t commandCount = 100000;
+
+	TestQueue queue;
+	StressCounter counters[ StressProducerCount ];
+
+	uint64_t start = Timer::GetTickCount();
+	PostAndFlush( queue, counters, commandCount );
+	float64_t milliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "CommandQueue: %u producers posted and flushed %u commands in %.2fms\n",
+		StressProducerCount, StressProducerCount * commandCount, milliseconds );
+
+	EXPECT_TRUE( queue.IsEmpty() );
+}
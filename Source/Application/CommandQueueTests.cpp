@@ -0,0 +1,140 @@
+#include "Precompile.h"
+#include "Application/CommandQueue.h"
+#include "Application/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::ApplicationTests;
+
+namespace
+{
+	struct Recorder
+	{
+		std::vector< int > m_Order;
+		uint32_t           m_SpinMilliseconds;
+
+		Recorder()
+			: m_SpinMilliseconds( 0 )
+		{
+		}
+
+		void Record( int value )
+		{
+			if ( m_SpinMilliseconds )
+			{
+				uint64_t start = Timer::GetTickCount();
+				while ( Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) < m_SpinMilliseconds );
+			}
+
+			m_Order.push_back( value );
+		}
+
+		void A( Helium::Void ) { Record( 0 ); }
+		void B( Helium::Void ) { Record( 1 ); }
+		void C( Helium::Void ) { Record( 2 ); }
+		void D( Helium::Void ) { Record( 3 ); }
+	};
+}
+
+TEST(Application, CommandQueuePriority)
+{
+	TestQueue queue;
+	Recorder recorder;
+
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Low );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::B ) );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::C ), CommandPriorities::High );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::D ) );
+	EXPECT_EQ( 1, queue.m_FlushRequests );
+	EXPECT_FALSE( queue.IsEmpty() );
+
+	queue.Flush();
+	EXPECT_TRUE( queue.IsEmpty() );
+
+	ASSERT_EQ( 4u, recorder.m_Order.size() );
+	EXPECT_EQ( 2, recorder.m_Order[ 0 ] );
+	EXPECT_EQ( 1, recorder.m_Order[ 1 ] );
+	EXPECT_EQ( 3, recorder.m_Order[ 2 ] );
+	EXPECT_EQ( 0, recorder.m_Order[ 3 ] );
+
+	// the next post after a flush asks for another flush
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ) );
+	EXPECT_EQ( 2, queue.m_FlushRequests );
+	queue.Flush();
+	EXPECT_EQ( 5u, recorder.m_Order.size() );
+}
+
+TEST(Application, CommandQueueCoalesce)
+{
+	TestQueue queue;
+	Recorder recorder;
+
+	const uint64_t refreshKey = 1;
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Normal, refreshKey );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::B ) );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Normal, refreshKey );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::B ) );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Normal, refreshKey );
+	queue.Flush();
+
+	ASSERT_EQ( 3u, recorder.m_Order.size() );
+	EXPECT_EQ( 0, recorder.m_Order[ 0 ] );
+	EXPECT_EQ( 1, recorder.m_Order[ 1 ] );
+	EXPECT_EQ( 1, recorder.m_Order[ 2 ] );
+
+	// once run the key is free again
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Normal, refreshKey );
+	queue.Flush();
+	EXPECT_EQ( 4u, recorder.m_Order.size() );
+}
+
+TEST(Application, CommandQueueBudget)
+{
+	TestQueue queue;
+	Recorder recorder;
+	recorder.m_SpinMilliseconds = 2;
+
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::A ), CommandPriorities::Normal, 7 );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::B ) );
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::C ) );
+	EXPECT_EQ( 1, queue.m_FlushRequests );
+
+	// each command outlasts the budget, so one runs per flush and the rest are deferred
+	queue.Flush( 1.0 );
+	EXPECT_EQ( 1u, recorder.m_Order.size() );
+	EXPECT_EQ( 2, queue.m_FlushRequests );
+	EXPECT_FALSE( queue.IsEmpty() );
+
+	// a deferred command keeps its place ahead of commands posted later
+	queue.Post( VoidSignature::Delegate( &recorder, &Recorder::D ) );
+	queue.Flush( 1.0 );
+	queue.Flush( 1.0 );
+	queue.Flush( 1.0 );
+	EXPECT_TRUE( queue.IsEmpty() );
+
+	ASSERT_EQ( 4u, recorder.m_Order.size() );
+	EXPECT_EQ( 0, recorder.m_Order[ 0 ] );
+	EXPECT_EQ( 1, recorder.m_Order[ 1 ] );
+	EXPECT_EQ( 2, recorder.m_Order[ 2 ] );
+	EXPECT_EQ( 3, recorder.m_Order[ 3 ] );
+}
+
+TEST(Application, CommandQueueProducers)
+{
+	const uint32_t commandCount = 10000;
+
+	TestQueue queue;
+	StressCounter counters[ StressProducerCount ];
+	PostAndFlush( queue, counters, commandCount );
+
+	EXPECT_TRUE( queue.IsEmpty() );
+	for ( uint32_t i = 0; i < StressProducerCount; ++i )
+	{
+		EXPECT_EQ( commandCount, counters[ i ].m_Count );
+	}
+}
@@ -2,6 +2,8 @@
 #include "DocumentManager.h"
 
 #include "Platform/Assert.h"
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
 #include "Foundation/Flags.h"
 #include "Foundation/Log.h"
 #include "Application/RCS.h"
@@ -12,6 +14,55 @@
 
 using namespace Helium;
 
+// worker threads used to write documents for SaveModes::Parallel
+static const uint32_t SaveThreadCount = 8;
+
+// the index key for a path, matching FilePath::operator== (case sensitive only on linux)
+static String IndexKey( const Helium::FilePath& path )
+{
+#if HELIUM_OS_LINUX
+	return String( path.Get().c_str() );
+#else
+	return String( path.Normalized().Get().c_str() );
+#endif
+}
+
+namespace
+{
+	struct SaveJob
+	{
+		Document*   m_Document;
+		bool        m_Started;  // BeginSave() was called
+		bool        m_Write;    // and the save wasn't vetoed
+		bool        m_Result;
+		std::string m_Error;
+	};
+
+	struct SaveWorker
+	{
+		std::vector< SaveJob >* m_Jobs;
+		volatile int32_t*       m_Next;
+
+		void Run()
+		{
+			for ( ;; )
+			{
+				int32_t index = AtomicIncrement( *m_Next ) - 1;
+				if ( index >= static_cast< int32_t >( m_Jobs->size() ) )
+				{
+					break;
+				}
+
+				SaveJob& job = ( *m_Jobs )[ index ];
+				if ( job.m_Write )
+				{
+					job.m_Result = job.m_Document->WriteSave( job.m_Error );
+				}
+			}
+		}
+	};
+}
+
 Document::Document( const std::string& path )
 	: m_Path( path )
 	, m_DocumentStatus( DocumentStatus::Default )
@@ -28,31 +79,59 @@ Document::~Document()
 ///////////////////////////////////////////////////////////////////////////////
 bool Document::Save( std::string& error )
 {
-	SetFlag<uint32_t>( m_DocumentStatus, DocumentStatus::Saving, true );
-
 	bool result = false;
 
+	if ( BeginSave() )
+	{
+		result = WriteSave( error );
+	}
+
+	EndSave( result );
+
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// First phase of Save(), raises e_Saving and returns false if it was vetoed.
+// EndSave() must be called whatever this returns.
+// 
+bool Document::BeginSave()
+{
+	SetFlag<uint32_t>( m_DocumentStatus, DocumentStatus::Saving, true );
+
 	DocumentEventArgs savingArgs( this );
 	e_Saving.Raise( savingArgs );
-	if ( !savingArgs.m_Veto )
-	{
-		DocumentEventArgs saveArgs( this, &error );
-		d_Save.Invoke( saveArgs );
-		if ( saveArgs.m_Result )
-		{
-			SetFlag<uint32_t>( m_DocumentStatus, DocumentStatus::Saving, false );
+	return !savingArgs.m_Veto;
+}
 
-			e_Saved.Raise( DocumentEventArgs( this ) );
+///////////////////////////////////////////////////////////////////////////////
+// Second phase of Save(), writes the document through d_Save.  This raises no
+// events, so the DocumentManager may run it on a worker thread when d_Save is
+// safe to call concurrently for different documents.
+// 
+bool Document::WriteSave( std::string& error )
+{
+	DocumentEventArgs saveArgs( this, &error );
+	d_Save.Invoke( saveArgs );
+	return saveArgs.m_Result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Last phase of Save(), raises e_Saved and clears the changed flag if the
+// document was written.
+// 
+void Document::EndSave( bool saved )
+{
+	if ( saved )
+	{
+		SetFlag<uint32_t>( m_DocumentStatus, DocumentStatus::Saving, false );
 
-			HasChanged( false );
+		e_Saved.Raise( DocumentEventArgs( this ) );
 
-			result = true;
-		}
+		HasChanged( false );
 	}
 
 	SetFlag<uint32_t>( m_DocumentStatus, DocumentStatus::Saving, false );
-
-	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -128,7 +207,7 @@ bool Document::IsCheckedOut() const
 
 		try
 		{
-			rcsFile.GetInfo();
+			RCS::GetStatusCache().GetInfo( rcsFile );
 		}
 		catch ( Helium::Exception& ex )
 		{
@@ -159,7 +238,7 @@ bool Document::IsUpToDate() const
 
 			try
 			{
-				rcsFile.GetInfo();
+				RCS::GetStatusCache().GetInfo( rcsFile );
 			}
 			catch ( Helium::Exception& ex )
 			{
@@ -209,7 +288,7 @@ void Document::UpdateRCSFileInfo()
 
 			try
 			{
-				rcsFile.GetInfo();
+				RCS::GetStatusCache().GetInfo( rcsFile );
 			}
 			catch ( Helium::Exception& ex )
 			{
@@ -229,22 +308,23 @@ DocumentManager::DocumentManager( MessageSignature::Delegate message, FileDialog
 {
 }
 
+DocumentManager::~DocumentManager()
+{
+	// out of line, so the index is freed by the module heap that allocated it
+}
+
 ///////////////////////////////////////////////////////////////////////////////
-// Returns the first document found with the specified path.
+// Returns the document open with the specified path.
 // 
 Document* DocumentManager::FindDocument( const Helium::FilePath& path ) const
 {
-	OS_DocumentSmartPtr::Iterator docItr = m_Documents.Begin();
-	OS_DocumentSmartPtr::Iterator docEnd = m_Documents.End();
-	for ( ; docItr != docEnd; ++docItr )
+	if ( path.Empty() )
 	{
-		Document* document = *docItr;
-		if ( document->GetPath() == path )
-		{
-			return document;
-		}
+		return NULL;
 	}
-	return NULL;
+
+	HashMap< String, Document* >::ConstIterator found = m_Index.Find( IndexKey( path ) );
+	return found != m_Index.End() ? found->Second() : NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -280,6 +360,8 @@ bool DocumentManager::AddDocument( const DocumentPtr& document )
 	if ( m_Documents.Append( document ) )
 	{
 		document->e_Closed.AddMethod( this, &DocumentManager::OnDocumentClosed );
+		document->e_PathChanged.AddMethod( this, &DocumentManager::OnDocumentPathChanged );
+		IndexDocument( document );
 
 		e_DocumentOpened.Raise( DocumentEventArgs( document ) );
 
@@ -290,9 +372,12 @@ bool DocumentManager::AddDocument( const DocumentPtr& document )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// Iterates over all the documents, calling save on each one.
+// Iterates over all the changed documents, calling save on each one.  In
+// parallel mode the documents to save in each pass are written concurrently,
+// and e_Saving and e_Saved are raised on the calling thread in document order,
+// but each pass raises every e_Saving before any e_Saved: see SaveDocuments().
 // 
-bool DocumentManager::SaveAll( std::string& error )
+bool DocumentManager::SaveAll( std::string& error, SaveMode mode )
 {
 	bool savedAll = true;
 	bool prompt = true;
@@ -303,6 +388,8 @@ bool DocumentManager::SaveAll( std::string& error )
 	while ( dirtyDocuments && savedAll )
 	{
 		dirtyDocuments = false;
+		std::vector< DocumentPtr > pending;
+
 		OS_DocumentSmartPtr::Iterator docItr = m_Documents.Begin();
 		OS_DocumentSmartPtr::Iterator docEnd = m_Documents.End();
 		for ( ; docItr != docEnd; ++docItr )
@@ -310,7 +397,7 @@ bool DocumentManager::SaveAll( std::string& error )
 			Document* document = *docItr;
 
 			bool abort = false;
-			bool save = true;
+			bool save = document->HasChanged();
 			if ( prompt )
 			{
 				switch ( QuerySave( document ) )
@@ -348,6 +435,12 @@ bool DocumentManager::SaveAll( std::string& error )
 			{
 				dirtyDocuments = true;
 
+				if ( mode == SaveModes::Parallel )
+				{
+					pending.push_back( document );
+					continue;
+				}
+
 				std::string msg;
 				if ( !SaveDocument( document, msg ) )
 				{
@@ -360,6 +453,11 @@ bool DocumentManager::SaveAll( std::string& error )
 				}
 			}
 		}
+
+		if ( !pending.empty() && !SaveDocuments( pending, error ) )
+		{
+			savedAll = false;
+		}
 	}
 
 	return savedAll;
@@ -375,7 +473,30 @@ bool DocumentManager::SaveAll( std::string& error )
 //
 bool DocumentManager::SaveDocument( DocumentPtr document, std::string& error )
 {
-	// Check for "save as"
+	if ( !QuerySavePath( document, error ) )
+	{
+		return false;
+	}
+
+	if ( document->Save( error ) )
+	{
+		return true;
+	}
+
+	if ( error.empty() )
+	{
+		error = "Failed to save " + document->GetPath().Filename().Get();
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Prompts for a path if the document doesn't have a usable one yet ("save as"),
+// returns false if the user cancelled.
+// 
+bool DocumentManager::QuerySavePath( Document* document, std::string& error )
+{
 	if ( document->GetPath().Empty() || !document->GetPath().IsAbsolute() )
 	{
 		std::string filters = document->GetPath().Extension() + "|*." + document->GetPath().Extension() + "|All Files|*";
@@ -392,17 +513,88 @@ bool DocumentManager::SaveDocument( DocumentPtr document, std::string& error )
 		}
 	}
 
-	if ( document->Save( error ) )
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Saves several documents, writing them on worker threads.  Prompts and events
+// happen on the calling thread in the order the documents are given: first
+// every e_Saving, then the writes, then every e_Saved.  Errors are appended in
+// document order.
+// 
+bool DocumentManager::SaveDocuments( const std::vector< DocumentPtr >& documents, std::string& error )
+{
+	std::vector< SaveJob > jobs ( documents.size() );
+	for ( size_t i = 0; i < documents.size(); ++i )
 	{
-		return true;
+		SaveJob& job = jobs[ i ];
+		job.m_Document = documents[ i ];
+		job.m_Started = false;
+		job.m_Write = false;
+		job.m_Result = false;
+		if ( QuerySavePath( job.m_Document, job.m_Error ) )
+		{
+			// a vetoed save is ended (as failed) along with the others, below
+			job.m_Started = true;
+			job.m_Write = job.m_Document->BeginSave();
+		}
 	}
 
-	if ( error.empty() )
+	volatile int32_t next = 0;
+	uint32_t workerCount = std::min< uint32_t >( SaveThreadCount, static_cast< uint32_t >( jobs.size() ) );
+
+	SaveWorker workers[ SaveThreadCount ];
+	CallbackThread threads[ SaveThreadCount ];
+	bool running[ SaveThreadCount ];
+
+	// the calling thread works too, it only needs helpers for the rest
+	for ( uint32_t i = 1; i < workerCount; ++i )
 	{
-		error = "Failed to save " + document->GetPath().Filename().Get();
+		workers[ i ].m_Jobs = &jobs;
+		workers[ i ].m_Next = &next;
+
+		CallbackThread::Entry entry = &CallbackThread::EntryHelper< SaveWorker, &SaveWorker::Run >;
+		running[ i ] = threads[ i ].Create( entry, &workers[ i ], "Document Save" );
 	}
 
-	return false;
+	workers[ 0 ].m_Jobs = &jobs;
+	workers[ 0 ].m_Next = &next;
+	workers[ 0 ].Run();
+
+	for ( uint32_t i = 1; i < workerCount; ++i )
+	{
+		if ( running[ i ] )
+		{
+			threads[ i ].Join();
+		}
+	}
+
+	bool savedAll = true;
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		SaveJob& job = jobs[ i ];
+		if ( job.m_Started )
+		{
+			job.m_Document->EndSave( job.m_Result );
+		}
+
+		if ( !job.m_Result )
+		{
+			savedAll = false;
+			if ( job.m_Error.empty() )
+			{
+				job.m_Error = "Failed to save " + job.m_Document->GetPath().Filename().Get();
+			}
+
+			if ( !error.empty() )
+			{
+				error += "\n";
+			}
+			error += job.m_Error;
+		}
+	}
+
+	return savedAll;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -574,9 +766,12 @@ bool DocumentManager::CloseDocument( DocumentPtr document, bool prompt )
 bool DocumentManager::RemoveDocument( const DocumentPtr& document )
 {
 	document->e_Closed.RemoveMethod( this, &DocumentManager::OnDocumentClosed );
+	document->e_PathChanged.RemoveMethod( this, &DocumentManager::OnDocumentPathChanged );
 
 	if ( m_Documents.Remove( document ) )
 	{
+		UnindexDocument( document, document->GetPath() );
+
 		e_DocumenClosed.Raise( DocumentEventArgs( document ) );
 		return true;
 	}
@@ -593,6 +788,45 @@ void DocumentManager::OnDocumentClosed( const DocumentEventArgs& args )
 	RemoveDocument( args.m_Document );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Callback for when a document is renamed (or saved as), moves it in the index.
+// 
+void DocumentManager::OnDocumentPathChanged( const DocumentPathChangedArgs& args )
+{
+	Document* document = const_cast< Document* >( args.m_Document );
+	UnindexDocument( document, args.m_OldPath );
+	IndexDocument( document );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Adds the document to the path index.  Untitled documents aren't indexed, and
+// if another document is already open at the path, that one is kept.
+// 
+void DocumentManager::IndexDocument( Document* document )
+{
+	if ( !document->GetPath().Empty() )
+	{
+		m_Index.Insert( HashMap< String, Document* >::ValueType( IndexKey( document->GetPath() ), document ) );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Removes the document from the path index, if it is the one indexed at path.
+// 
+void DocumentManager::UnindexDocument( Document* document, const Helium::FilePath& path )
+{
+	if ( path.Empty() )
+	{
+		return;
+	}
+
+	HashMap< String, Document* >::Iterator found = m_Index.Find( IndexKey( path ) );
+	if ( found != m_Index.End() && found->Second() == document )
+	{
+		m_Index.Remove( found );
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Call this function if the user fails to checkout a file, or attempts to edit
 // a file without checking it out.  The user is prompted as to whether they want
@@ -3,7 +3,9 @@
 #include "Foundation/TUID.h"
 #include "Foundation/Event.h"
 #include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
 #include "Foundation/SmartPtr.h"
+#include "Foundation/String.h"
 #include "Application/OrderedSet.h"
 
 #include "Application/API.h"
@@ -96,6 +98,11 @@ namespace Helium
         bool Save( std::string& error );
         void Close();
 
+        // the phases of Save(), so several documents can be written at once
+        bool BeginSave();
+        bool WriteSave( std::string& error );
+        void EndSave( bool saved );
+
         void Checkout() const;
 
         bool HasChanged() const;
@@ -177,6 +184,18 @@ namespace Helium
     }
     typedef SaveActions::SaveAction SaveAction;
 
+    // How SaveAll writes documents
+    namespace SaveModes
+    {
+        enum SaveMode
+        {
+            Serial,   // Save each document in turn on the calling thread, each e_Saving is followed by that document's e_Saved
+            Parallel  // Write the documents on worker threads (d_Save must be thread safe), events are raised in document order on the
+                      //  calling thread but batched: e_Saving for every document in a pass, then the writes, then every e_Saved
+        };
+    }
+    typedef SaveModes::SaveMode SaveMode;
+
     typedef Helium::OrderedSet< DocumentPtr > OS_DocumentSmartPtr;
 
     /////////////////////////////////////////////////////////////////////////////
@@ -187,6 +206,7 @@ namespace Helium
     {
     public:
         DocumentManager( MessageSignature::Delegate displayMessage, FileDialogSignature::Delegate fileDialog );
+        ~DocumentManager();
 
         const OS_DocumentSmartPtr& GetDocuments()
         {
@@ -196,7 +216,7 @@ namespace Helium
         bool                OpenDocument( const DocumentPtr& document, std::string& error );
         Document*           FindDocument( const Helium::FilePath& path ) const;
 
-        bool                SaveAll( std::string& error );
+        bool                SaveAll( std::string& error, SaveMode mode = SaveModes::Serial );
         bool                SaveDocument( DocumentPtr document, std::string& error );
 
         bool                CloseAll();
@@ -224,8 +244,16 @@ namespace Helium
         bool AddDocument( const DocumentPtr& document );
         bool RemoveDocument( const DocumentPtr& document );
         void OnDocumentClosed( const DocumentEventArgs& args );
+        void OnDocumentPathChanged( const DocumentPathChangedArgs& args );
+
+        bool QuerySavePath( Document* document, std::string& error );
+        bool SaveDocuments( const std::vector< DocumentPtr >& documents, std::string& error );
+
+        void IndexDocument( Document* document );
+        void UnindexDocument( Document* document, const Helium::FilePath& path );
 
         OS_DocumentSmartPtr m_Documents;
+        HashMap< String, Document* > m_Index;   // open documents by path, see IndexKey()
         MessageSignature::Delegate m_Message;
         FileDialogSignature::Delegate m_FileDialog;
     };
@@ -0,0 +1,55 @@
+#include "Precompile.h"
+#include "Application/DocumentManager.h"
+#include "Application/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::ApplicationTests;
+
+// prints the time to open 5000 documents into the path index, DocumentManagerIndex checks the lookups
+TEST(Application, DocumentManagerIndexBenchmark)
+{
+	MessageSignature::Delegate message;
+	FileDialogSignature::Delegate fileDialog;
+	DocumentManager manager ( message, fileDialog );
+	Saver saver;
+	std::vector< DocumentPtr > documents;
+
+	const uint32_t documentCount = 5000;
+	uint64_t start = Timer::GetTickCount();
+	OpenDocuments( manager, saver, documentCount, documents );
+	float64_t openMilliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "DocumentManager opened %u documents in %.2fms\n", documentCount, openMilliseconds );
+}
+
+// prints the time to save 64 documents that take 2ms each serially and in parallel, DocumentManagerParallelSave checks the results
+TEST(Application, DocumentManagerParallelSaveBenchmark)
+{
+	const uint32_t documentCount = 64;
+	float64_t milliseconds[ 2 ];
+
+	for ( uint32_t mode = SaveModes::Serial; mode <= SaveModes::Parallel; ++mode )
+	{
+		MessageSignature::Delegate message;
+		FileDialogSignature::Delegate fileDialog;
+		DocumentManager manager ( message, fileDialog );
+		Saver saver;
+		saver.m_WriteMilliseconds = 2;
+
+		std::vector< DocumentPtr > documents;
+		OpenDocuments( manager, saver, documentCount, documents );
+
+		std::string error;
+		uint64_t start = Timer::GetTickCount();
+		EXPECT_TRUE( manager.SaveAll( error, static_cast< SaveMode >( mode ) ) );
+		milliseconds[ mode ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+	}
+
+	printf( "DocumentManager saved %u documents: serial %.2fms, parallel %.2fms\n", documentCount, milliseconds[ 0 ], milliseconds[ 1 ] );
+}
@@ -0,0 +1,110 @@
+#include "Precompile.h"
+#include "Application/DocumentManager.h"
+#include "Application/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::ApplicationTests;
+
+TEST(Application, DocumentManagerIndex)
+{
+	MessageSignature::Delegate message;
+	FileDialogSignature::Delegate fileDialog;
+	DocumentManager manager ( message, fileDialog );
+	Saver saver;
+	std::vector< DocumentPtr > documents;
+
+	const uint32_t documentCount = 1000;
+	OpenDocuments( manager, saver, documentCount, documents );
+
+	for ( uint32_t i = 0; i < documentCount; ++i )
+	{
+		EXPECT_EQ( documents[ i ].Ptr(), manager.FindDocument( FilePath( DocumentPath( i ) ) ) );
+	}
+	EXPECT_TRUE( NULL == manager.FindDocument( FilePath( DocumentPath( documentCount ) ) ) );
+
+	// the same path can't be opened twice
+	std::string error;
+	DocumentPtr duplicate = new Document( DocumentPath( 7 ) );
+	EXPECT_FALSE( manager.OpenDocument( duplicate, error ) );
+
+	// renames move the document in the index
+	documents[ 7 ]->SetPath( FilePath( "/helium/documents/renamed.txt" ) );
+	EXPECT_TRUE( NULL == manager.FindDocument( FilePath( DocumentPath( 7 ) ) ) );
+	EXPECT_EQ( documents[ 7 ].Ptr(), manager.FindDocument( FilePath( "/helium/documents/renamed.txt" ) ) );
+	EXPECT_TRUE( manager.OpenDocument( duplicate, error ) );
+	EXPECT_EQ( duplicate.Ptr(), manager.FindDocument( FilePath( DocumentPath( 7 ) ) ) );
+
+	// closing removes it
+	EXPECT_TRUE( manager.CloseDocument( documents[ 9 ], false ) );
+	EXPECT_TRUE( NULL == manager.FindDocument( FilePath( DocumentPath( 9 ) ) ) );
+	EXPECT_EQ( documents[ 10 ].Ptr(), manager.FindDocument( FilePath( DocumentPath( 10 ) ) ) );
+}
+
+TEST(Application, DocumentManagerParallelSave)
+{
+	const uint32_t documentCount = 64;
+
+	for ( uint32_t mode = SaveModes::Serial; mode <= SaveModes::Parallel; ++mode )
+	{
+		MessageSignature::Delegate message;
+		FileDialogSignature::Delegate fileDialog;
+		DocumentManager manager ( message, fileDialog );
+		Saver saver;
+		saver.m_WriteMilliseconds = 2;
+
+		std::vector< DocumentPtr > documents;
+		OpenDocuments( manager, saver, documentCount, documents );
+		documents[ 5 ]->HasChanged( false );
+		saver.m_Fail = documents[ 20 ];
+
+		std::string error;
+		EXPECT_FALSE( manager.SaveAll( error, static_cast< SaveMode >( mode ) ) );
+		EXPECT_EQ( "Disk full", error );
+
+		// the failed document is left changed and stops further passes
+		EXPECT_EQ( static_cast< int32_t >( documentCount - 1 ), saver.m_Writes );
+		for ( uint32_t i = 0; i < documentCount; ++i )
+		{
+			EXPECT_EQ( i == 20, documents[ i ]->HasChanged() ) << "document " << i;
+		}
+
+		// events are in document order, serial saves interleave them and parallel saves raise every e_Saving first
+		std::vector< const Document* > expectedEvents;
+		std::vector< bool > expectedSaved;
+		for ( uint32_t pass = 0; pass < 2; ++pass )
+		{
+			for ( uint32_t i = 0; i < documentCount; ++i )
+			{
+				if ( i == 5 )
+				{
+					continue;
+				}
+
+				bool saving = mode == SaveModes::Serial || pass == 0;
+				bool saved = ( mode == SaveModes::Serial || pass == 1 ) && i != 20;
+				if ( saving )
+				{
+					expectedEvents.push_back( documents[ i ] );
+					expectedSaved.push_back( false );
+				}
+				if ( saved )
+				{
+					expectedEvents.push_back( documents[ i ] );
+					expectedSaved.push_back( true );
+				}
+			}
+
+			if ( mode == SaveModes::Serial )
+			{
+				break;
+			}
+		}
+
+		EXPECT_TRUE( expectedEvents == saver.m_Events );
+		EXPECT_TRUE( expectedSaved == saver.m_Saved );
+	}
+}
@@ -1,6 +1,9 @@
 #include "Precompile.h"
 #include "InitializerStack.h"
 
+#include "Platform/Timer.h"
+#include "Foundation/Log.h"
+
 using namespace Helium;
 
 InitializerStack::InitializerStack( bool autoCleanup )
@@ -18,7 +21,7 @@ InitializerStack::~InitializerStack()
     }
 }
 
-void InitializerStack::Push( InitializeFunc initFunction, CleanupFunc cleanupFunction )
+void InitializerStack::Push( InitializeFunc initFunction, CleanupFunc cleanupFunction, const char* name )
 {
     if ( cleanupFunction )
     {
@@ -28,7 +31,13 @@ void InitializerStack::Push( InitializeFunc initFunction, CleanupFunc cleanupFun
     // we allow NULL initializers to just toss something on the uninit stack for cleanup purposes
     if ( initFunction != NULL )
     {
+        uint64_t start = Timer::GetTickCount();
         (*initFunction)();
+
+        InitializerStage stage;
+        stage.m_Name = name;
+        stage.m_Ticks = Timer::GetTickCount() - start;
+        m_Stages.push_back( stage );
     }
 }
 
@@ -46,3 +55,31 @@ void InitializerStack::Cleanup()
         Pop();
     }
 }
+
+uint64_t InitializerStack::GetTotalTicks() const
+{
+    uint64_t ticks = 0;
+    for ( V_InitializerStage::const_iterator itr = m_Stages.begin(), end = m_Stages.end(); itr != end; ++itr )
+    {
+        ticks += itr->m_Ticks;
+    }
+
+    return ticks;
+}
+
+void InitializerStack::ReportStages() const
+{
+    Log::Profile( "Initialization took %.3fms:\n", Timer::TicksToMilliseconds( GetTotalTicks() ) );
+
+    for ( V_InitializerStage::const_iterator itr = m_Stages.begin(), end = m_Stages.end(); itr != end; ++itr )
+    {
+        if ( itr->m_Name )
+        {
+            Log::Profile( "  %-32s %.3fms\n", itr->m_Name, Timer::TicksToMilliseconds( itr->m_Ticks ) );
+        }
+        else
+        {
+            Log::Profile( "  stage %-26u %.3fms\n", static_cast< uint32_t >( itr - m_Stages.begin() ), Timer::TicksToMilliseconds( itr->m_Ticks ) );
+        }
+    }
+}
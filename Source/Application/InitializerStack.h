@@ -1,8 +1,10 @@
 #pragma once
 
 #include <stack>
+#include <vector>
 
 #include "Application/API.h"
+#include "Platform/Types.h"
 
 namespace Helium
 {
@@ -15,14 +17,23 @@ namespace Helium
     //  Push() adds an init function (and makes the call)
     //  Pop() calls a cleanup function, and pops it from the stack
     //  Clean() pops and calls each cleanup function registered on the stack
+    //  GetStages() is how long each init function took, to see where startup time goes
     //
 
     typedef std::stack< CleanupFunc > InitCleanupStack;
 
+    struct InitializerStage
+    {
+        const char* m_Name;     // may be NULL
+        uint64_t    m_Ticks;    // Timer ticks spent in the init function
+    };
+    typedef std::vector< InitializerStage > V_InitializerStage;
+
     class HELIUM_APPLICATION_API InitializerStack
     {
     private:
         InitCleanupStack    m_InitCleanupStack;
+        V_InitializerStage  m_Stages;
         bool                m_AutoCleanup;
         int                 m_Count;
 
@@ -45,8 +56,8 @@ namespace Helium
             return m_Count;
         }
 
-        // push and call init, call cleanup later
-        void Push( InitializeFunc init, CleanupFunc cleanup );
+        // push and call init (timed as a stage called name), call cleanup later
+        void Push( InitializeFunc init, CleanupFunc cleanup, const char* name = NULL );
 
         // just call cleanup later
         void Push( CleanupFunc cleanup )
@@ -59,5 +70,17 @@ namespace Helium
 
         // pop all cleanup functions off the stack (called automatically in the destructor)
         void Cleanup();
+
+        // the init functions called so far, in the order they were pushed
+        const V_InitializerStage& GetStages() const
+        {
+            return m_Stages;
+        }
+
+        // the time spent in all the init functions
+        uint64_t GetTotalTicks() const;
+
+        // print the time spent in each init function to the profile channel
+        void ReportStages() const;
     };
 }
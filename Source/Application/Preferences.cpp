@@ -1,8 +1,15 @@
 #include "Precompile.h"
 #include "Preferences.h"
 
+#include "Platform/Atomic.h"
 #include "Platform/Process.h"
 
+#include <sstream>
+#include <string.h>
+#include <vector>
+
+using namespace Helium;
+
 bool Helium::GetPreferencesDirectory( Helium::FilePath& preferencesDirectory )
 {
 	std::string prefDirectory = Helium::GetHomeDirectory();
@@ -13,4 +20,235 @@ bool Helium::GetPreferencesDirectory( Helium::FilePath& preferencesDirectory )
 	}
 
 	return false;
-}
\ No newline at end of file
+}
+
+const uint32_t PreferencesSnapshot::Signature = 'H' | ( 'P' << 8 ) | ( 'S' << 16 ) | ( 'N' << 24 );
+const uint32_t PreferencesSnapshot::Version = 1;
+
+PreferencesSnapshot::PreferencesSnapshot()
+{
+}
+
+PreferencesSnapshot::~PreferencesSnapshot()
+{
+}
+
+bool PreferencesSnapshot::Write( const char* path, const M_Preferences& preferences, const char* source )
+{
+	Header header;
+	header.m_Signature = Signature;
+	header.m_Version = Version;
+	header.m_Count = static_cast< uint32_t >( preferences.size() );
+	header.m_Reserved = 0;
+	header.m_SourceSize = 0;
+	header.m_SourceModifiedTime = 0;
+
+	if ( source )
+	{
+		Status status;
+		if ( !status.Read( source ) )
+		{
+			return false;
+		}
+
+		header.m_SourceSize = status.m_Size;
+		header.m_SourceModifiedTime = status.m_ModifiedTime;
+	}
+
+	// the map is already in the order Find searches in
+	std::vector< Entry > entries;
+	entries.reserve( preferences.size() );
+	std::string strings;
+	uint32_t stringsOffset = static_cast< uint32_t >( sizeof( Header ) + preferences.size() * sizeof( Entry ) );
+	for ( M_Preferences::const_iterator itr = preferences.begin(), end = preferences.end(); itr != end; ++itr )
+	{
+		// names are compared as C strings
+		if ( itr->first.find( '\0' ) != std::string::npos )
+		{
+			return false;
+		}
+
+		Entry entry;
+		entry.m_NameOffset = stringsOffset + static_cast< uint32_t >( strings.size() );
+		entry.m_NameLength = static_cast< uint32_t >( itr->first.size() );
+		strings.append( itr->first.c_str(), itr->first.size() + 1 );
+
+		entry.m_ValueOffset = stringsOffset + static_cast< uint32_t >( strings.size() );
+		entry.m_ValueLength = static_cast< uint32_t >( itr->second.size() );
+		strings.append( itr->second.c_str(), itr->second.size() + 1 );
+
+		entries.push_back( entry );
+	}
+
+	// written aside and moved into place, so a reader never maps half a snapshot; the name is unique to this
+	//  process and call so tools writing the same snapshot at once don't write into each other's temporary file
+	static volatile int32_t s_TemporaryCount = 0;
+	std::stringstream temporaryName;
+	temporaryName << path << "." << GetProcessId() << "." << AtomicIncrement( s_TemporaryCount ) << ".tmp";
+	std::string temporaryPath = temporaryName.str();
+	{
+		File file;
+		if ( !file.Open( temporaryPath.c_str(), FileModes::Write ) )
+		{
+			return false;
+		}
+
+		bool written = file.Write( &header, sizeof( header ) )
+			&& ( entries.empty() || file.Write( &entries.front(), entries.size() * sizeof( Entry ) ) )
+			&& ( strings.empty() || file.Write( strings.data(), strings.size() ) );
+
+		if ( !file.Close() || !written )
+		{
+			DeleteFile( temporaryPath.c_str() );
+			return false;
+		}
+	}
+
+	if ( !MoveFile( temporaryPath.c_str(), path ) )
+	{
+		// some platforms won't move over an existing file
+		if ( !DeleteFile( path ) || !MoveFile( temporaryPath.c_str(), path ) )
+		{
+			DeleteFile( temporaryPath.c_str() );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool PreferencesSnapshot::Open( const char* path, const char* source )
+{
+	if ( !m_File.Open( path ) )
+	{
+		return false;
+	}
+
+	if ( !Validate( source ) )
+	{
+		m_File.Close();
+		return false;
+	}
+
+	return true;
+}
+
+void PreferencesSnapshot::Close()
+{
+	m_File.Close();
+}
+
+bool PreferencesSnapshot::IsOpen() const
+{
+	return m_File.IsOpen();
+}
+
+uint32_t PreferencesSnapshot::GetCount() const
+{
+	return IsOpen() ? GetHeader()->m_Count : 0;
+}
+
+const char* PreferencesSnapshot::Find( const char* name, uint32_t* length ) const
+{
+	const Entry* entries = IsOpen() ? GetEntries() : NULL;
+	uint32_t first = 0;
+	uint32_t last = GetCount();
+	while ( first < last )
+	{
+		uint32_t middle = first + ( last - first ) / 2;
+		int compare = strcmp( GetString( entries[ middle ].m_NameOffset ), name );
+		if ( compare < 0 )
+		{
+			first = middle + 1;
+		}
+		else if ( compare > 0 )
+		{
+			last = middle;
+		}
+		else
+		{
+			if ( length )
+			{
+				*length = entries[ middle ].m_ValueLength;
+			}
+
+			return GetString( entries[ middle ].m_ValueOffset );
+		}
+	}
+
+	return NULL;
+}
+
+void PreferencesSnapshot::GetAll( M_Preferences& preferences ) const
+{
+	const Entry* entries = IsOpen() ? GetEntries() : NULL;
+	for ( uint32_t i = 0, count = GetCount(); i < count; ++i )
+	{
+		const Entry& entry = entries[ i ];
+		preferences[ std::string( GetString( entry.m_NameOffset ), entry.m_NameLength ) ].assign( GetString( entry.m_ValueOffset ), entry.m_ValueLength );
+	}
+}
+
+bool PreferencesSnapshot::Validate( const char* source ) const
+{
+	size_t size = m_File.GetSize();
+	if ( size < sizeof( Header ) )
+	{
+		return false;
+	}
+
+	const Header* header = GetHeader();
+	if ( header->m_Signature != Signature || header->m_Version != Version )
+	{
+		return false;
+	}
+
+	if ( source )
+	{
+		Status status;
+		if ( !status.Read( source ) || status.m_Size != header->m_SourceSize || status.m_ModifiedTime != header->m_SourceModifiedTime )
+		{
+			return false;
+		}
+	}
+
+	if ( header->m_Count > ( size - sizeof( Header ) ) / sizeof( Entry ) )
+	{
+		return false;
+	}
+
+	// every string has to be terminated inside the file, and the names in order, before Find can trust them
+	const char* data = static_cast< const char* >( m_File.GetData() );
+	const Entry* entries = GetEntries();
+	for ( uint32_t i = 0; i < header->m_Count; ++i )
+	{
+		const Entry& entry = entries[ i ];
+		if ( entry.m_NameOffset >= size || entry.m_NameLength >= size - entry.m_NameOffset || data[ entry.m_NameOffset + entry.m_NameLength ] != '\0'
+			|| entry.m_ValueOffset >= size || entry.m_ValueLength >= size - entry.m_ValueOffset || data[ entry.m_ValueOffset + entry.m_ValueLength ] != '\0' )
+		{
+			return false;
+		}
+
+		if ( i > 0 && strcmp( GetString( entries[ i - 1 ].m_NameOffset ), GetString( entry.m_NameOffset ) ) >= 0 )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const PreferencesSnapshot::Header* PreferencesSnapshot::GetHeader() const
+{
+	return static_cast< const Header* >( m_File.GetData() );
+}
+
+const PreferencesSnapshot::Entry* PreferencesSnapshot::GetEntries() const
+{
+	return reinterpret_cast< const Entry* >( GetHeader() + 1 );
+}
+
+const char* PreferencesSnapshot::GetString( uint32_t offset ) const
+{
+	return static_cast< const char* >( m_File.GetData() ) + offset;
+}
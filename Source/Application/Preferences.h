@@ -2,8 +2,75 @@
 
 #include "Application/API.h"
 #include "Foundation/FilePath.h"
+#include "Platform/File.h"
+
+#include <map>
+#include <string>
 
 namespace Helium
 {
     HELIUM_APPLICATION_API bool GetPreferencesDirectory( Helium::FilePath& preferencesDirectory );
-}
\ No newline at end of file
+
+    //
+    // PreferencesSnapshot is a flat binary copy of a set of preferences (name/value strings) that is
+    //  memory mapped and searched in place, so a tool that starts many times doesn't need to load its
+    //  preferences archive every time.  The snapshot remembers the size and modification time of the
+    //  archive it was made from, so a stale snapshot fails to open and can be rewritten.  It is in
+    //  native byte order, it's a cache and not an interchange format.
+    //
+
+    class HELIUM_APPLICATION_API PreferencesSnapshot : NonCopyable
+    {
+    public:
+        typedef std::map< std::string, std::string > M_Preferences;
+
+        PreferencesSnapshot();
+        ~PreferencesSnapshot();
+
+        // write a snapshot of preferences that were loaded from source (if any)
+        static bool Write( const char* path, const M_Preferences& preferences, const char* source = NULL );
+
+        // map a snapshot, fails if it is damaged or out of date with source (if any)
+        bool Open( const char* path, const char* source = NULL );
+        void Close();
+        bool IsOpen() const;
+
+        uint32_t GetCount() const;
+
+        // find a preference, the value points into the snapshot and is valid until it is closed
+        const char* Find( const char* name, uint32_t* length = NULL ) const;
+
+        // copy every preference out
+        void GetAll( M_Preferences& preferences ) const;
+
+    private:
+        struct Header
+        {
+            uint32_t m_Signature;
+            uint32_t m_Version;
+            uint32_t m_Count;
+            uint32_t m_Reserved;
+            uint64_t m_SourceSize;
+            uint64_t m_SourceModifiedTime;
+        };
+
+        // sorted by name, offsets are from the start of the file, strings are null terminated
+        struct Entry
+        {
+            uint32_t m_NameOffset;
+            uint32_t m_NameLength;
+            uint32_t m_ValueOffset;
+            uint32_t m_ValueLength;
+        };
+
+        static const uint32_t Signature;
+        static const uint32_t Version;
+
+        bool Validate( const char* source ) const;
+        const Header* GetHeader() const;
+        const Entry* GetEntries() const;
+        const char* GetString( uint32_t offset ) const;
+
+        MappedFile m_File;
+    };
+}
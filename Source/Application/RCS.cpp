@@ -23,6 +23,7 @@ static Changeset                  g_DefaultChangeset;
 static std::vector< std::string > g_ManagedPaths;
 static std::vector< std::string > g_IgnoredPaths;
 static uint64_t                   g_SyncTimestamp = 0;
+static StatusCache                g_StatusCache;
 
 ///////////////////////////////////////////////////////////////////
 // Utility methods
@@ -61,6 +62,10 @@ void RCS::SetProvider(Provider* provider)
 		throw RCS::Exception( "Attempt to re-set provider.  Current provider is: %s\n", g_Provider->GetName());
 	}
 
+	// the cache belongs to the old provider, let any refresh using it finish first
+	g_StatusCache.WaitForRefresh();
+	g_StatusCache.Invalidate();
+
 	g_Provider = provider;
 }
 
@@ -69,6 +74,11 @@ Provider* RCS::GetProvider()
 	return g_Provider;
 }
 
+StatusCache& RCS::GetStatusCache()
+{
+	return g_StatusCache;
+}
+
 ///////////////////////////////////////////////////////////////////
 // Implementation
 
@@ -165,13 +175,25 @@ bool RCS::IsValidChangeset(const RCS::Changeset& changeset)
 	return false;
 }
 
+void RCS::Sync(V_File& files, const uint64_t timestamp)
+{
+	uint64_t syncTime = timestamp ? timestamp : GetSyncTimestamp();
+
+	g_Provider->Sync(files, syncTime);
+
+	for ( V_File::const_iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+	{
+		g_StatusCache.Invalidate( ( *itr ).m_LocalPath );
+	}
+}
+
 void RCS::GetInfo(V_File& files, GetInfoFlag flags)
 {
-	for ( V_File::iterator itr = files.begin(), end = files.end();
-		itr != end;
-		++itr )
+	g_Provider->GetInfo(files, flags);
+
+	if ( flags == GetInfoFlags::Default )
 	{
-		( *itr ).GetInfo(flags);
+		g_StatusCache.Store(files);
 	}
 }
 
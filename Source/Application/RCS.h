@@ -10,6 +10,7 @@
 #include "Application/RCSTypes.h"
 #include "Application/RCSExceptions.h"
 #include "Application/RCSProvider.h"
+#include "Application/RCSStatusCache.h"
 
 namespace Helium
 {
@@ -26,6 +27,9 @@ namespace Helium
         HELIUM_APPLICATION_API void SetProvider( Provider* provider );
         HELIUM_APPLICATION_API Provider* GetProvider();
 
+        // cached file status, shared by everything that just needs to check on a file
+        HELIUM_APPLICATION_API StatusCache& GetStatusCache();
+
         // Note: if you are passing in a directory, make sure it ends in a slash.
         HELIUM_APPLICATION_API void SetManagedPaths( const std::vector< std::string >& paths );
         HELIUM_APPLICATION_API void SetIgnoredPaths( const std::vector< std::string >& paths );
@@ -39,6 +43,8 @@ namespace Helium
         HELIUM_APPLICATION_API void GetChangesets( RCS::V_Changeset& changesets );
         HELIUM_APPLICATION_API bool IsValidChangeset( const RCS::Changeset& changeset );
 
+        // these make one provider request for all the files
+        HELIUM_APPLICATION_API void Sync( V_File& files, const uint64_t timestamp = 0 );
         HELIUM_APPLICATION_API void GetInfo( V_File& files, const GetInfoFlag flags = GetInfoFlags::Default );
         HELIUM_APPLICATION_API void GetInfo( const std::string& folder, V_File& files, bool recursive = false, uint32_t fileData = FileData::All, uint32_t actionData = ActionData::All );
     }
@@ -62,11 +62,13 @@ void Changeset::Commit()
   }
 
   GetProvider()->Commit( *this );
+  GetStatusCache().Invalidate();
 }
 
 void Changeset::Revert( const OpenFlag flags )
 {
   GetProvider()->Revert( *this, ( ( flags & OpenFlags::UnchangedOnly ) == OpenFlags::UnchangedOnly ) );
+  GetStatusCache().Invalidate();
   m_Id = DefaultChangesetId;
 }
 
@@ -82,4 +84,5 @@ void Changeset::Reopen( File& file, const OpenFlag flags ) const
   file.m_ChangesetId = m_Id;
 
   GetProvider()->Reopen( file );
+  GetStatusCache().Invalidate( file.m_LocalPath );
 }
\ No newline at end of file
@@ -12,6 +12,11 @@ using namespace Helium::RCS;
 void RCS::File::GetInfo( const GetInfoFlag flags )
 {
 	GetProvider()->GetInfo( *this, flags );
+
+	if ( flags == GetInfoFlags::Default )
+	{
+		GetStatusCache().Store( *this );
+	}
 }
 
 void RCS::File::Sync( const uint64_t timestamp )
@@ -19,6 +24,7 @@ void RCS::File::Sync( const uint64_t timestamp )
 	uint64_t syncTime = timestamp ? timestamp : GetSyncTimestamp();
 
 	GetProvider()->Sync( *this, syncTime );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 void RCS::File::Add( const OpenFlag flags, const uint64_t changesetId )
@@ -40,6 +46,7 @@ void RCS::File::Add( const OpenFlag flags, const uint64_t changesetId )
 	m_ChangesetId = changesetId;
 
 	GetProvider()->Add( *this );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 void RCS::File::Edit( const OpenFlag flags, const uint64_t changesetId )
@@ -74,6 +81,7 @@ void RCS::File::Edit( const OpenFlag flags, const uint64_t changesetId )
 	m_ChangesetId = changesetId;
 
 	GetProvider()->Edit( *this );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 void RCS::File::Delete( const OpenFlag flags, const uint64_t changesetId )
@@ -100,6 +108,7 @@ void RCS::File::Delete( const OpenFlag flags, const uint64_t changesetId )
 	m_ChangesetId = changesetId;
 
 	GetProvider()->Delete( *this );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 void RCS::File::Reopen( const Changeset& changeset, const OpenFlag flags )
@@ -114,6 +123,7 @@ void RCS::File::Reopen( const Changeset& changeset, const OpenFlag flags )
 	m_ChangesetId = changeset.m_Id;
 
 	GetProvider()->Reopen( *this );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 void RCS::File::Copy( File& target, const OpenFlag flags, const uint64_t changesetId )
@@ -137,6 +147,7 @@ void RCS::File::Copy( File& target, const OpenFlag flags, const uint64_t changes
 	target.m_ChangesetId = changesetId;
 
 	GetProvider()->Integrate( *this, target );
+	GetStatusCache().Invalidate( target.m_LocalPath );
 }
 
 void RCS::File::Rename( File& target, const OpenFlag flags, const uint64_t changesetId )
@@ -186,6 +197,8 @@ void RCS::File::Rename( File& target, const OpenFlag flags, const uint64_t chang
 	target.m_ChangesetId = changesetId;
 
 	GetProvider()->Rename( *this, target );
+	GetStatusCache().Invalidate( m_LocalPath );
+	GetStatusCache().Invalidate( target.m_LocalPath );
 }
 
 void RCS::File::Revert( const OpenFlag flags )
@@ -200,6 +213,7 @@ void RCS::File::Revert( const OpenFlag flags )
 	bool revertUnchangedOnly = ( flags & OpenFlags::UnchangedOnly ) == OpenFlags::UnchangedOnly;
 
 	GetProvider()->Revert( *this, revertUnchangedOnly );
+	GetStatusCache().Invalidate( m_LocalPath );
 }
 
 //
@@ -10,3 +10,51 @@ Provider::Provider()
 Provider::~Provider()
 {
 }
+
+void Provider::Sync( V_File& files, const uint64_t timestamp )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        Sync( *itr, timestamp );
+    }
+}
+
+void Provider::GetInfo( V_File& files, const GetInfoFlag flags )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        GetInfo( *itr, flags );
+    }
+}
+
+void Provider::Add( V_File& files )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        Add( *itr );
+    }
+}
+
+void Provider::Edit( V_File& files )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        Edit( *itr );
+    }
+}
+
+void Provider::Delete( V_File& files )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        Delete( *itr );
+    }
+}
+
+void Provider::Revert( V_File& files, bool revertUnchangedOnly )
+{
+    for ( V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        Revert( *itr, revertUnchangedOnly );
+    }
+}
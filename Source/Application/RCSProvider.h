@@ -47,6 +47,18 @@ namespace Helium
             virtual void CreateChangeset( RCS::Changeset& changeset ) = 0;
             virtual void GetChangesets( RCS::V_Changeset& changesets ) = 0;
 
+            //
+            // Batched operations, a provider that can handle many files in one request (one process spawn
+            //  or server round trip) should override these, the defaults make one call per file
+            //
+
+            virtual void Sync( RCS::V_File& files, const uint64_t timestamp = 0 );
+            virtual void GetInfo( RCS::V_File& files, const GetInfoFlag flags = GetInfoFlags::Default );
+            virtual void Add( RCS::V_File& files );
+            virtual void Edit( RCS::V_File& files );
+            virtual void Delete( RCS::V_File& files );
+            virtual void Revert( RCS::V_File& files, bool revertUnchangedOnly = false );
+
             /*
             virtual void GetChangeset( RCS::Changeset& changeset ) = 0;
             virtual void DeleteChangeset( RCS::Changeset& changeset ) = 0;
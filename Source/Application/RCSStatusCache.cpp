@@ -0,0 +1,333 @@
+#include "Precompile.h"
+#include "RCSStatusCache.h"
+
+#include "Platform/File.h"
+#include "Platform/Timer.h"
+#include "Foundation/FilePath.h"
+
+#include "Application/RCS.h"
+
+using namespace Helium;
+using namespace Helium::RCS;
+
+StatusCache::StatusCache()
+    : m_MaxAge( 5000 )
+    , m_Wakeup( false, false )
+    , m_Idle( false, false )
+    , m_Refreshing( false )
+    , m_Running( false )
+{
+}
+
+StatusCache::~StatusCache()
+{
+    if ( m_Thread.IsValid() )
+    {
+        {
+            MutexScopeLock lock( m_Mutex );
+            m_Running = false;
+        }
+
+        m_Wakeup.Signal();
+        m_Thread.Join();
+    }
+
+    // anything the thread didn't get to is dropped, callbacks included
+    for ( std::deque< Refresh* >::iterator itr = m_Refreshes.begin(), end = m_Refreshes.end(); itr != end; ++itr )
+    {
+        delete *itr;
+    }
+}
+
+void StatusCache::SetMaxAge( uint32_t milliseconds )
+{
+    MutexScopeLock lock( m_Mutex );
+    m_MaxAge = milliseconds;
+
+    if ( !m_MaxAge )
+    {
+        m_Entries.clear();
+    }
+}
+
+void StatusCache::GetInfo( File& file, const GetInfoFlag flags )
+{
+    // the file isn't touched by the query, so one stat serves the lookup and the store
+    LocalStatus status;
+    if ( flags == GetInfoFlags::Default )
+    {
+        ReadStatus( file.m_LocalPath, status );
+
+        MutexScopeLock lock( m_Mutex );
+        if ( Lookup( file, status, Timer::GetTickCount() ) )
+        {
+            return;
+        }
+    }
+
+    GetProvider()->GetInfo( file, flags );
+
+    MutexScopeLock lock( m_Mutex );
+    ++m_Statistics.m_Queries;
+    if ( flags == GetInfoFlags::Default )
+    {
+        StoreLocked( file, status, Timer::GetTickCount() );
+    }
+}
+
+void StatusCache::GetInfo( V_File& files, const GetInfoFlag flags )
+{
+    if ( flags != GetInfoFlags::Default )
+    {
+        GetProvider()->GetInfo( files, flags );
+
+        MutexScopeLock lock( m_Mutex );
+        ++m_Statistics.m_Queries;
+        return;
+    }
+
+    // stat before taking the lock, a slow file system shouldn't hold up the other threads' lookups
+    std::vector< LocalStatus > statuses;
+    ReadStatuses( files, statuses );
+
+    // gather the misses so they cost a single provider request
+    std::vector< size_t > misses;
+    V_File query;
+    {
+        MutexScopeLock lock( m_Mutex );
+        uint64_t now = Timer::GetTickCount();
+        for ( size_t i = 0; i < files.size(); ++i )
+        {
+            if ( !Lookup( files[ i ], statuses[ i ], now ) )
+            {
+                misses.push_back( i );
+                query.push_back( files[ i ] );
+            }
+        }
+    }
+
+    if ( query.empty() )
+    {
+        return;
+    }
+
+    // the lock isn't held across the query, two threads missing on the same file both ask for it
+    GetProvider()->GetInfo( query, flags );
+
+    MutexScopeLock lock( m_Mutex );
+    ++m_Statistics.m_Queries;
+    uint64_t now = Timer::GetTickCount();
+    for ( size_t i = 0; i < misses.size(); ++i )
+    {
+        files[ misses[ i ] ] = query[ i ];
+        StoreLocked( query[ i ], statuses[ misses[ i ] ], now );
+    }
+}
+
+void StatusCache::Store( const File& file )
+{
+    LocalStatus status;
+    ReadStatus( file.m_LocalPath, status );
+
+    MutexScopeLock lock( m_Mutex );
+    StoreLocked( file, status, Timer::GetTickCount() );
+}
+
+void StatusCache::Store( const V_File& files )
+{
+    std::vector< LocalStatus > statuses;
+    ReadStatuses( files, statuses );
+
+    MutexScopeLock lock( m_Mutex );
+    uint64_t now = Timer::GetTickCount();
+    for ( size_t i = 0; i < files.size(); ++i )
+    {
+        StoreLocked( files[ i ], statuses[ i ], now );
+    }
+}
+
+void StatusCache::Invalidate( const std::string& path )
+{
+    std::string key = Key( path );
+
+    MutexScopeLock lock( m_Mutex );
+    m_Entries.erase( key );
+}
+
+void StatusCache::Invalidate()
+{
+    MutexScopeLock lock( m_Mutex );
+    m_Entries.clear();
+}
+
+void StatusCache::RefreshAsync( const V_File& files, StatusRefreshSignature::Delegate callback )
+{
+    Refresh* refresh = new Refresh;
+    refresh->m_Files = files;
+    refresh->m_Callback = callback;
+
+    // delegate reference counts are not atomic, the refresh thread must hold the only reference
+    callback.Clear();
+
+    {
+        MutexScopeLock lock( m_Mutex );
+        m_Refreshes.push_back( refresh );
+
+        if ( !m_Running )
+        {
+            m_Running = true;
+            Helium::CallbackThread::Entry entry = Helium::CallbackThread::EntryHelper< StatusCache, &StatusCache::ThreadEntryPoint >;
+            m_Thread.Create( entry, this, "RCS Status Refresh" );
+        }
+    }
+
+    m_Wakeup.Signal();
+}
+
+void StatusCache::WaitForRefresh()
+{
+    m_Mutex.Lock();
+
+    while ( !m_Refreshes.empty() || m_Refreshing )
+    {
+        m_Mutex.Unlock();
+        m_Idle.Wait( 1 );
+        m_Mutex.Lock();
+    }
+
+    m_Mutex.Unlock();
+}
+
+StatusCacheStatistics StatusCache::GetStatistics()
+{
+    MutexScopeLock lock( m_Mutex );
+    return m_Statistics;
+}
+
+std::string StatusCache::Key( const std::string& path )
+{
+    FilePath key( path );
+    FilePath::Normalize( key );
+    return key.Get();
+}
+
+void StatusCache::ReadStatus( const std::string& path, LocalStatus& status )
+{
+    Helium::Status fileStatus;
+    status.m_Exists = fileStatus.Read( path.c_str() );
+    status.m_ModifiedTime = fileStatus.m_ModifiedTime;
+    status.m_Size = fileStatus.m_Size;
+}
+
+void StatusCache::ReadStatuses( const V_File& files, std::vector< LocalStatus >& statuses )
+{
+    statuses.resize( files.size() );
+    for ( size_t i = 0; i < files.size(); ++i )
+    {
+        ReadStatus( files[ i ].m_LocalPath, statuses[ i ] );
+    }
+}
+
+bool StatusCache::Lookup( File& file, const LocalStatus& status, uint64_t now )
+{
+    M_Entry::iterator found = m_Entries.find( Key( file.m_LocalPath ) );
+    if ( found == m_Entries.end() )
+    {
+        ++m_Statistics.m_Misses;
+        return false;
+    }
+
+    Entry& entry = found->second;
+    if ( Timer::TicksToMilliseconds( now - entry.m_Ticks ) >= static_cast< float64_t >( m_MaxAge ) )
+    {
+        m_Entries.erase( found );
+        ++m_Statistics.m_Misses;
+        return false;
+    }
+
+    // a stat is far cheaper than a provider request, and catches files synced or edited behind our back
+    if ( status.m_Exists != entry.m_Status.m_Exists || ( status.m_Exists && ( status.m_ModifiedTime != entry.m_Status.m_ModifiedTime || status.m_Size != entry.m_Status.m_Size ) ) )
+    {
+        m_Entries.erase( found );
+        ++m_Statistics.m_Misses;
+        return false;
+    }
+
+    file = entry.m_File;
+    ++m_Statistics.m_Hits;
+    return true;
+}
+
+void StatusCache::StoreLocked( const File& file, const LocalStatus& status, uint64_t now )
+{
+    if ( !m_MaxAge || file.m_LocalPath.empty() )
+    {
+        return;
+    }
+
+    Entry& entry = m_Entries[ Key( file.m_LocalPath ) ];
+    entry.m_File = file;
+    entry.m_Ticks = now;
+
+    // history is never cached, and its reference counted records must not be shared across threads
+    entry.m_File.m_Actions.clear();
+    entry.m_File.m_Revisions.clear();
+    entry.m_Status = status;
+}
+
+void StatusCache::ThreadEntryPoint()
+{
+    m_Mutex.Lock();
+
+    while ( m_Running )
+    {
+        if ( m_Refreshes.empty() )
+        {
+            m_Mutex.Unlock();
+            m_Wakeup.Wait();
+            m_Mutex.Lock();
+            continue;
+        }
+
+        Refresh* refresh = m_Refreshes.front();
+        m_Refreshes.pop_front();
+        m_Refreshing = true;
+        m_Mutex.Unlock();
+
+        std::string error;
+        std::vector< LocalStatus > statuses;
+        try
+        {
+            GetProvider()->GetInfo( refresh->m_Files );
+            ReadStatuses( refresh->m_Files, statuses );
+        }
+        catch ( Helium::Exception& ex )
+        {
+            error = ex.What();
+        }
+
+        m_Mutex.Lock();
+        ++m_Statistics.m_Queries;
+        if ( error.empty() )
+        {
+            uint64_t now = Timer::GetTickCount();
+            for ( size_t i = 0; i < refresh->m_Files.size(); ++i )
+            {
+                StoreLocked( refresh->m_Files[ i ], statuses[ i ], now );
+            }
+        }
+        m_Mutex.Unlock();
+
+        refresh->m_Callback.Invoke( StatusRefreshArgs( refresh->m_Files, error ) );
+        delete refresh;
+
+        m_Mutex.Lock();
+        m_Refreshing = false;
+        if ( m_Refreshes.empty() )
+        {
+            m_Idle.Signal();
+        }
+    }
+
+    m_Mutex.Unlock();
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Platform/Types.h"
+#include "Platform/Condition.h"
+#include "Platform/Locks.h"
+#include "Platform/Thread.h"
+#include "Foundation/Event.h"
+
+#include "Application/API.h"
+#include "Application/RCSFile.h"
+
+namespace Helium
+{
+    namespace RCS
+    {
+        struct HELIUM_APPLICATION_API StatusRefreshArgs
+        {
+            const V_File&       m_Files;
+            const std::string&  m_Error;    // empty if the provider query succeeded
+
+            StatusRefreshArgs( const V_File& files, const std::string& error )
+                : m_Files( files )
+                , m_Error( error )
+            {
+            }
+        };
+        typedef Helium::Signature< const StatusRefreshArgs& > StatusRefreshSignature;
+
+        struct HELIUM_APPLICATION_API StatusCacheStatistics
+        {
+            uint64_t m_Hits;
+            uint64_t m_Misses;
+            uint64_t m_Queries;     // batched provider requests made for the misses
+
+            StatusCacheStatistics()
+                : m_Hits( 0 )
+                , m_Misses( 0 )
+                , m_Queries( 0 )
+            {
+            }
+        };
+
+        //
+        // Caches file status from the provider for a limited time so repeated checks (is it checked
+        //  out, is it up to date) don't each cost a provider round trip.  Entries are dropped when they
+        //  get older than the max age, when the local file's size or modification time changes, or when
+        //  they are invalidated explicitly (every File operation that changes state does this).  Only
+        //  default info is cached, history queries always go to the provider.
+        //
+
+        class HELIUM_APPLICATION_API StatusCache
+        {
+        public:
+            StatusCache();
+            ~StatusCache();
+
+            uint32_t GetMaxAge() const
+            {
+                return m_MaxAge;
+            }
+
+            // milliseconds an entry stays valid, zero disables caching
+            void SetMaxAge( uint32_t milliseconds );
+
+            // fill in the files from the cache, everything missing or stale is queried from the provider in one batch
+            void GetInfo( File& file, const GetInfoFlag flags = GetInfoFlags::Default );
+            void GetInfo( V_File& files, const GetInfoFlag flags = GetInfoFlags::Default );
+
+            // record info that was just queried from the provider
+            void Store( const File& file );
+            void Store( const V_File& files );
+
+            void Invalidate( const std::string& path );
+            void Invalidate();
+
+            // query the files on the refresh thread and store the results, the callback is made on the
+            //  refresh thread once they are in the cache (post it to a CommandQueue to handle it on the UI thread)
+            void RefreshAsync( const V_File& files, StatusRefreshSignature::Delegate callback = StatusRefreshSignature::Delegate() );
+
+            // block until every pending refresh is done
+            void WaitForRefresh();
+
+            StatusCacheStatistics GetStatistics();
+
+        private:
+            // local file status, read without the lock held
+            struct LocalStatus
+            {
+                uint64_t m_ModifiedTime;
+                uint64_t m_Size;
+                bool     m_Exists;
+            };
+
+            struct Entry
+            {
+                File        m_File;
+                uint64_t    m_Ticks;        // when the info was queried
+                LocalStatus m_Status;       // local file status at that time
+            };
+            typedef std::map< std::string, Entry > M_Entry;
+
+            struct Refresh
+            {
+                V_File                              m_Files;
+                StatusRefreshSignature::Delegate    m_Callback;
+            };
+
+            static std::string Key( const std::string& path );
+            static void ReadStatus( const std::string& path, LocalStatus& status );
+            static void ReadStatuses( const V_File& files, std::vector< LocalStatus >& statuses );
+            bool Lookup( File& file, const LocalStatus& status, uint64_t now );
+            void StoreLocked( const File& file, const LocalStatus& status, uint64_t now );
+            void ThreadEntryPoint();
+
+            Mutex                   m_Mutex;
+            uint32_t                m_MaxAge;
+            M_Entry                 m_Entries;
+            StatusCacheStatistics   m_Statistics;
+
+            CallbackThread          m_Thread;           // refresh thread, started by the first RefreshAsync()
+            Condition               m_Wakeup;           // signaled when refreshes are queued or the cache is shutting down
+            Condition               m_Idle;             // signaled when the refresh queue drains
+            std::deque< Refresh* >  m_Refreshes;
+            bool                    m_Refreshing;       // the refresh thread is working on a request
+            bool                    m_Running;
+        };
+    }
+}
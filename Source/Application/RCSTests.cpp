@@ -0,0 +1,303 @@
+#include "Precompile.h"
+#include "Application/RCS.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Condition.h"
+#include "Platform/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <sstream>
+
+using namespace Helium;
+
+namespace
+{
+	// answers from a table and counts the requests, the way a real provider costs a process spawn per request
+	class FakeProvider : public RCS::Provider
+	{
+	public:
+		volatile int32_t m_Requests;
+		volatile int32_t m_Files;
+		uint32_t         m_LatencyMilliseconds;
+		Condition*       m_Gate;        // if set, requests wait for it to be signaled
+		bool             m_Batched;
+		int32_t          m_Revision;
+
+		FakeProvider()
+			: m_Requests( 0 )
+			, m_Files( 0 )
+			, m_LatencyMilliseconds( 0 )
+			, m_Gate( NULL )
+			, m_Batched( true )
+			, m_Revision( 3 )
+		{
+		}
+
+		virtual bool IsEnabled() { return true; }
+		virtual void SetEnabled( bool enabled ) {}
+		virtual const char* GetName() { return "Fake"; }
+
+		virtual void Sync( RCS::File& file, const uint64_t timestamp ) { Request(); }
+
+		virtual void GetInfo( RCS::File& file, const RCS::GetInfoFlag flags )
+		{
+			Request();
+			Fill( file );
+		}
+
+		virtual void GetInfo( const std::string& folder, RCS::V_File& files, bool recursive, uint32_t fileData, uint32_t actionData ) { Request(); }
+
+		virtual void GetInfo( RCS::V_File& files, const RCS::GetInfoFlag flags )
+		{
+			if ( !m_Batched )
+			{
+				Provider::GetInfo( files, flags );
+				return;
+			}
+
+			Request();
+			for ( RCS::V_File::iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+			{
+				Fill( *itr );
+			}
+		}
+
+		virtual void Add( RCS::File& file ) { Request(); }
+		virtual void Edit( RCS::File& file ) { Request(); }
+		virtual void Delete( RCS::File& file ) { Request(); }
+		virtual void GetOpenedFiles( RCS::V_File& files ) { Request(); }
+		virtual void Reopen( RCS::File& file ) { Request(); }
+		virtual void Rename( RCS::File& source, RCS::File& dest ) { Request(); }
+		virtual void Integrate( RCS::File& source, RCS::File& dest ) { Request(); }
+		virtual void Revert( RCS::Changeset& changeset, bool revertUnchangedOnly ) { Request(); }
+		virtual void Revert( RCS::File& file, bool revertUnchangedOnly ) { Request(); }
+		virtual void Commit( RCS::Changeset& changeset ) { Request(); }
+		virtual void CreateChangeset( RCS::Changeset& changeset ) { Request(); }
+		virtual void GetChangesets( RCS::V_Changeset& changesets ) { Request(); }
+
+	private:
+		void Request()
+		{
+			if ( m_Gate )
+			{
+				m_Gate->Wait( 5000 );
+			}
+
+			if ( m_LatencyMilliseconds )
+			{
+				Thread::Sleep( m_LatencyMilliseconds );
+			}
+
+			AtomicIncrement( m_Requests );
+		}
+
+		void Fill( RCS::File& file )
+		{
+			AtomicIncrement( m_Files );
+			file.m_State = RCS::FileStates::ExistsInDepot | RCS::FileStates::CheckedOut | RCS::FileStates::CheckedOutByMe;
+			file.m_LocalRevision = m_Revision;
+			file.m_HeadRevision = m_Revision;
+		}
+	};
+
+	struct ScopedProvider
+	{
+		ScopedProvider( RCS::Provider* provider )
+		{
+			RCS::SetProvider( provider );
+		}
+
+		~ScopedProvider()
+		{
+			RCS::SetProvider( NULL );
+		}
+	};
+
+	std::string TestPath( uint32_t index )
+	{
+		std::stringstream str;
+		str << "/tmp/helium_rcs_test_" << index << ".txt";
+		return str.str();
+	}
+
+	void WriteFile( const std::string& path, const char* contents )
+	{
+		FILE* file = fopen( path.c_str(), "w" );
+		ASSERT_TRUE( file != NULL );
+		fputs( contents, file );
+		fclose( file );
+	}
+
+	struct RefreshListener
+	{
+		Condition   m_Done;
+		size_t      m_Files;
+		std::string m_Error;
+
+		RefreshListener()
+			: m_Done( true, false )
+			, m_Files( 0 )
+		{
+		}
+
+		void Refreshed( const RCS::StatusRefreshArgs& args )
+		{
+			m_Files = args.m_Files.size();
+			m_Error = args.m_Error;
+			m_Done.Signal();
+		}
+	};
+}
+
+TEST(Application, RCSBatchedGetInfo)
+{
+	FakeProvider provider;
+	ScopedProvider scope ( &provider );
+
+	const uint32_t fileCount = 100;
+	RCS::V_File files;
+	for ( uint32_t i = 0; i < fileCount; ++i )
+	{
+		files.push_back( RCS::File( TestPath( i ) ) );
+	}
+
+	// a provider without a batched query still works, one request per file
+	provider.m_Batched = false;
+	RCS::GetInfo( files );
+	EXPECT_EQ( static_cast< int32_t >( fileCount ), provider.m_Requests );
+
+	provider.m_Batched = true;
+	provider.m_Requests = 0;
+	RCS::GetInfo( files );
+	EXPECT_EQ( 1, provider.m_Requests );
+	for ( uint32_t i = 0; i < fileCount; ++i )
+	{
+		EXPECT_TRUE( files[ i ].IsCheckedOutByMe() );
+		EXPECT_EQ( 3, files[ i ].m_LocalRevision );
+	}
+
+	// that query filled the cache
+	provider.m_Requests = 0;
+	RCS::File file ( TestPath( 42 ) );
+	RCS::GetStatusCache().GetInfo( file );
+	EXPECT_EQ( 0, provider.m_Requests );
+	EXPECT_EQ( 3, file.m_LocalRevision );
+}
+
+TEST(Application, RCSStatusCache)
+{
+	FakeProvider provider;
+	ScopedProvider scope ( &provider );
+
+	RCS::StatusCache cache;
+	std::string path = TestPath( 1000 );
+	WriteFile( path, "one" );
+
+	RCS::File file ( path );
+	cache.GetInfo( file );
+	EXPECT_EQ( 1, provider.m_Requests );
+	EXPECT_EQ( 3, file.m_LocalRevision );
+
+	// repeated checks are free
+	provider.m_Revision = 4;
+	for ( uint32_t i = 0; i < 100; ++i )
+	{
+		RCS::File check ( path );
+		cache.GetInfo( check );
+		EXPECT_EQ( 3, check.m_LocalRevision );
+	}
+	EXPECT_EQ( 1, provider.m_Requests );
+
+	// a local change (a sync or an edit outside the editor) drops the entry
+	WriteFile( path, "one two" );
+	cache.GetInfo( file );
+	EXPECT_EQ( 2, provider.m_Requests );
+	EXPECT_EQ( 4, file.m_LocalRevision );
+
+	cache.Invalidate( path );
+	cache.GetInfo( file );
+	EXPECT_EQ( 3, provider.m_Requests );
+
+	// mixed hits and misses cost one request for all the misses
+	RCS::V_File files;
+	for ( uint32_t i = 999; i < 1010; ++i )
+	{
+		files.push_back( RCS::File( TestPath( i ) ) );
+	}
+	cache.GetInfo( files );
+	EXPECT_EQ( 4, provider.m_Requests );
+	EXPECT_EQ( 3 + 10, provider.m_Files );
+
+	// history is never cached
+	cache.GetInfo( file, RCS::GetInfoFlags::GetHistory );
+	EXPECT_EQ( 5, provider.m_Requests );
+
+	// entries expire
+	cache.SetMaxAge( 20 );
+	cache.GetInfo( file );
+	EXPECT_EQ( 5, provider.m_Requests );
+	Thread::Sleep( 40 );
+	cache.GetInfo( file );
+	EXPECT_EQ( 6, provider.m_Requests );
+
+	RCS::StatusCacheStatistics statistics = cache.GetStatistics();
+	EXPECT_EQ( 102u, statistics.m_Hits );
+	EXPECT_EQ( 6u, statistics.m_Queries );
+
+	remove( path.c_str() );
+}
+
+TEST(Application, RCSStatusCacheInvalidatedByOperations)
+{
+	FakeProvider provider;
+	ScopedProvider scope ( &provider );
+
+	RCS::File file ( TestPath( 2000 ) );
+	file.GetInfo();
+	provider.m_Requests = 0;
+
+	RCS::File check ( TestPath( 2000 ) );
+	RCS::GetStatusCache().GetInfo( check );
+	EXPECT_EQ( 0, provider.m_Requests );
+
+	// reverting changes the state, the next check asks the provider
+	file.Revert();
+	provider.m_Requests = 0;
+	RCS::GetStatusCache().GetInfo( check );
+	EXPECT_EQ( 1, provider.m_Requests );
+}
+
+TEST(Application, RCSStatusCacheRefreshAsync)
+{
+	FakeProvider provider;
+	ScopedProvider scope ( &provider );
+	Condition gate ( true, false );
+	provider.m_Gate = &gate;
+
+	RCS::StatusCache cache;
+	RCS::V_File files;
+	for ( uint32_t i = 3000; i < 3050; ++i )
+	{
+		files.push_back( RCS::File( TestPath( i ) ) );
+	}
+
+	// the caller (the UI thread) doesn't wait on the provider, which can't answer until the gate opens
+	RefreshListener listener;
+	cache.RefreshAsync( files, RCS::StatusRefreshSignature::Delegate( &listener, &RefreshListener::Refreshed ) );
+	EXPECT_FALSE( listener.m_Done.Wait( 0 ) );
+	EXPECT_EQ( 0, provider.m_Requests );
+
+	gate.Signal();
+	EXPECT_TRUE( listener.m_Done.Wait( 5000 ) );
+	EXPECT_EQ( files.size(), listener.m_Files );
+	EXPECT_TRUE( listener.m_Error.empty() );
+	cache.WaitForRefresh();
+	EXPECT_EQ( 1, provider.m_Requests );
+
+	// everything is cached now
+	cache.GetInfo( files );
+	EXPECT_EQ( 1, provider.m_Requests );
+	EXPECT_EQ( 3, files[ 7 ].m_LocalRevision );
+}
@@ -0,0 +1,89 @@
+#include "Precompile.h"
+#include "Application/CmdLineProcessor.h"
+#include "Application/Preferences.h"
+#include "Application/TestUtilities.h"
+
+#include "Platform/File.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::CommandLine;
+using namespace Helium::ApplicationTests;
+
+// prints the time for a tool to parse its arguments and load its preferences the old way and through the fast path,
+//  CmdLineProcessorArgs and PreferencesSnapshot check the results
+TEST(Application, StartupFastPathBenchmark)
+{
+	const char* sourcePath = "StartupBenchmark.prefs";
+	const char* snapshotPath = "StartupBenchmark.prefs.snapshot";
+	const uint32_t runs = 200;
+	const uint32_t lookups = 50;
+
+	PreferencesSnapshot::M_Preferences preferences = MakePreferences( 1000 );
+	WriteSource( sourcePath, preferences );
+	ASSERT_TRUE( PreferencesSnapshot::Write( snapshotPath, preferences, sourcePath ) );
+
+	const char* argv[] = { "tool", "-define", "A", "B", "C", "D", "-v", "-jobs", "8", "-platform", "linux", "build", "-clean", "core", "tools", "editor", "runtime" };
+	int argc = sizeof( argv ) / sizeof( argv[ 0 ] );
+
+	// what a tool does before its real work: parse its arguments, then load its preferences
+	float64_t milliseconds[ 2 ];
+	for ( uint32_t fast = 0; fast < 2; ++fast )
+	{
+		uint64_t start = Timer::GetTickCount();
+		for ( uint32_t run = 0; run < runs; ++run )
+		{
+			Processor processor ( "tool" );
+			ToolOptions options;
+			options.Register( processor );
+			BuildCommand build;
+			std::string error;
+			processor.RegisterCommand( &build, error );
+
+			uint32_t found = 0;
+			if ( fast )
+			{
+				ASSERT_TRUE( processor.Process( argc, argv, error ) );
+
+				PreferencesSnapshot snapshot;
+				ASSERT_TRUE( snapshot.Open( snapshotPath, sourcePath ) );
+				for ( uint32_t i = 0; i < lookups; ++i )
+				{
+					std::stringstream name;
+					name << "Editor.Panel" << i * 20 << ".Setting";
+					found += snapshot.Find( name.str().c_str() ) ? 1 : 0;
+				}
+			}
+			else
+			{
+				std::vector< std::string > args ( argv + 1, argv + argc );
+				ASSERT_TRUE( processor.Process( args, error ) );
+
+				PreferencesSnapshot::M_Preferences loaded;
+				ReadSource( sourcePath, loaded );
+				for ( uint32_t i = 0; i < lookups; ++i )
+				{
+					std::stringstream name;
+					name << "Editor.Panel" << i * 20 << ".Setting";
+					found += loaded.find( name.str() ) != loaded.end() ? 1 : 0;
+				}
+			}
+
+			EXPECT_EQ( lookups, found );
+			EXPECT_EQ( 4u, build.m_Targets.size() );
+		}
+		milliseconds[ fast ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) / runs;
+	}
+
+	printf( "Tool init (%d arguments, %u of %u preferences): copied arguments and a parsed archive %.3fms, argument view and a mapped snapshot %.3fms\n",
+		argc - 1, lookups, static_cast< uint32_t >( preferences.size() ), milliseconds[ 0 ], milliseconds[ 1 ] );
+
+	EXPECT_TRUE( DeleteFile( snapshotPath ) );
+	EXPECT_TRUE( DeleteFile( sourcePath ) );
+}
@@ -0,0 +1,167 @@
+#include "Precompile.h"
+#include "Application/CmdLineProcessor.h"
+#include "Application/InitializerStack.h"
+#include "Application/Preferences.h"
+#include "Application/TestUtilities.h"
+
+#include "Platform/File.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::CommandLine;
+using namespace Helium::ApplicationTests;
+
+namespace
+{
+	std::vector< int > g_Calls;
+
+	void InitializeFirst()
+	{
+		g_Calls.push_back( 1 );
+	}
+
+	void CleanupFirst()
+	{
+		g_Calls.push_back( -1 );
+	}
+
+	void InitializeSlow()
+	{
+		Thread::Sleep( 5 );
+		g_Calls.push_back( 2 );
+	}
+
+	void CleanupSlow()
+	{
+		g_Calls.push_back( -2 );
+	}
+}
+
+TEST(Application, InitializerStackStages)
+{
+	g_Calls.clear();
+
+	{
+		InitializerStack stack ( true );
+		stack.Push( &InitializeFirst, &CleanupFirst, "First" );
+		stack.Push( &InitializeSlow, &CleanupSlow );
+		stack.Push( &CleanupFirst );
+
+		// cleanup only pushes aren't stages
+		const V_InitializerStage& stages = stack.GetStages();
+		ASSERT_EQ( 2u, stages.size() );
+		EXPECT_STREQ( "First", stages[ 0 ].m_Name );
+		EXPECT_TRUE( stages[ 1 ].m_Name == NULL );
+		EXPECT_GE( Timer::TicksToMilliseconds( stages[ 1 ].m_Ticks ), 4.0 );
+		EXPECT_GT( stages[ 1 ].m_Ticks, stages[ 0 ].m_Ticks );
+		EXPECT_EQ( stages[ 0 ].m_Ticks + stages[ 1 ].m_Ticks, stack.GetTotalTicks() );
+
+		stack.ReportStages();
+	}
+
+	int expected[] = { 1, 2, -1, -2, -1 };
+	ASSERT_EQ( 5u, g_Calls.size() );
+	EXPECT_EQ( 0, memcmp( expected, &g_Calls.front(), sizeof( expected ) ) );
+}
+
+TEST(Application, CmdLineProcessorArgs)
+{
+	Processor processor ( "tool" );
+	ToolOptions options;
+	options.Register( processor );
+
+	BuildCommand build;
+	std::string error;
+	ASSERT_TRUE( processor.RegisterCommand( &build, error ) );
+
+	const char* argv[] = { "tool", "-define", "A", "B", "-v", "-jobs", "8", "-platform", "linux", "-cache", "true", "build", "-clean", "core", "tools" };
+	ASSERT_TRUE( processor.Process( sizeof( argv ) / sizeof( argv[ 0 ] ), argv, error ) ) << error;
+	EXPECT_TRUE( options.m_Verbose );
+	EXPECT_EQ( 8u, options.m_Jobs );
+	EXPECT_EQ( "linux", options.m_Platform );
+	EXPECT_TRUE( options.m_Cache );
+	ASSERT_EQ( 2u, options.m_Defines.size() );
+	EXPECT_EQ( "B", options.m_Defines[ 1 ] );
+	EXPECT_TRUE( build.m_Clean );
+	ASSERT_EQ( 2u, build.m_Targets.size() );
+	EXPECT_EQ( "tools", build.m_Targets[ 1 ] );
+
+	// the same arguments held as strings
+	std::vector< std::string > args;
+	args.push_back( "-jobs" );
+	args.push_back( "3" );
+	ASSERT_TRUE( processor.Process( args, error ) ) << error;
+	EXPECT_EQ( 3u, options.m_Jobs );
+
+	args[ 1 ] = "three";
+	EXPECT_FALSE( processor.Process( args, error ) );
+	EXPECT_EQ( "Invalid parameter for option: jobs", error );
+
+	args[ 0 ] = "-unknown";
+	EXPECT_FALSE( processor.Process( args, error ) );
+	EXPECT_EQ( "Unknown option: -unknown", error );
+}
+
+TEST(Application, PreferencesSnapshot)
+{
+	const char* sourcePath = "StartupTests.prefs";
+	const char* snapshotPath = "StartupTests.prefs.snapshot";
+
+	PreferencesSnapshot::M_Preferences preferences = MakePreferences( 100 );
+	preferences[ "Empty" ] = "";
+	WriteSource( sourcePath, preferences );
+	ASSERT_TRUE( PreferencesSnapshot::Write( snapshotPath, preferences, sourcePath ) );
+
+	{
+		PreferencesSnapshot snapshot;
+		ASSERT_TRUE( snapshot.Open( snapshotPath, sourcePath ) );
+		EXPECT_EQ( 101u, snapshot.GetCount() );
+
+		uint32_t length = 0;
+		EXPECT_STREQ( "value of setting 350", snapshot.Find( "Editor.Panel50.Setting", &length ) );
+		EXPECT_EQ( 20u, length );
+		EXPECT_STREQ( "", snapshot.Find( "Empty" ) );
+		EXPECT_TRUE( snapshot.Find( "Editor.Panel" ) == NULL );
+		EXPECT_TRUE( snapshot.Find( "Missing" ) == NULL );
+
+		PreferencesSnapshot::M_Preferences loaded;
+		snapshot.GetAll( loaded );
+		EXPECT_TRUE( loaded == preferences );
+	}
+
+	// a snapshot of an archive that has since changed is out of date
+	preferences[ "Added" ] = "later";
+	WriteSource( sourcePath, preferences );
+	{
+		PreferencesSnapshot snapshot;
+		EXPECT_FALSE( snapshot.Open( snapshotPath, sourcePath ) );
+		EXPECT_EQ( 0u, snapshot.GetCount() );
+		EXPECT_TRUE( snapshot.Find( "Added" ) == NULL );
+
+		// rewriting it replaces the old one
+		ASSERT_TRUE( PreferencesSnapshot::Write( snapshotPath, preferences, sourcePath ) );
+		ASSERT_TRUE( snapshot.Open( snapshotPath, sourcePath ) );
+		EXPECT_STREQ( "later", snapshot.Find( "Added" ) );
+	}
+
+	// a damaged snapshot doesn't open
+	{
+		File file;
+		ASSERT_TRUE( file.Open( snapshotPath, FileModes::Write ) );
+		const char truncated[ 40 ] = { 'H', 'P', 'S', 'N', 1, 0, 0, 0, 100 };
+		ASSERT_TRUE( file.Write( truncated, sizeof( truncated ) ) );
+		file.Close();
+
+		PreferencesSnapshot snapshot;
+		EXPECT_FALSE( snapshot.Open( snapshotPath ) );
+	}
+
+	EXPECT_TRUE( DeleteFile( snapshotPath ) );
+	EXPECT_TRUE( DeleteFile( sourcePath ) );
+}
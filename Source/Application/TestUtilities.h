@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Application/CmdLineProcessor.h"
+#include "Application/CommandQueue.h"
+#include "Application/DocumentManager.h"
+#include "Application/Preferences.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// Helpers shared by the Application tests and benchmarks, not part of the library
+//
+
+namespace Helium
+{
+    namespace ApplicationTests
+    {
+        // counts the flushes it asks for instead of scheduling them, tests call Flush themselves
+        class TestQueue : public CommandQueue
+        {
+        public:
+            TestQueue()
+                : m_FlushRequests( 0 )
+            {
+            }
+
+            volatile int32_t m_FlushRequests;
+
+        protected:
+            virtual void EnqueueFlush()
+            {
+                AtomicIncrement( m_FlushRequests );
+            }
+        };
+
+        const uint32_t StressProducerCount = 4;
+
+        struct StressCounter
+        {
+            uint32_t m_Count;
+
+            void Count( Helium::Void )
+            {
+                ++m_Count;
+            }
+        };
+
+        struct StressProducer
+        {
+            TestQueue*     m_Queue;
+            StressCounter* m_Counter;
+            uint32_t       m_CommandCount;
+
+            void Run()
+            {
+                for ( uint32_t i = 0; i < m_CommandCount; ++i )
+                {
+                    m_Queue->Post( VoidSignature::Delegate( m_Counter, &StressCounter::Count ) );
+                }
+            }
+        };
+
+        // posts commandCount commands from each of StressProducerCount threads while flushing on this one,
+        //  each producer's commands bump its own counter
+        inline void PostAndFlush( TestQueue& queue, StressCounter ( &counters )[ StressProducerCount ], uint32_t commandCount )
+        {
+            StressProducer producers[ StressProducerCount ];
+            CallbackThread threads[ StressProducerCount ];
+
+            for ( uint32_t i = 0; i < StressProducerCount; ++i )
+            {
+                counters[ i ].m_Count = 0;
+                producers[ i ].m_Queue = &queue;
+                producers[ i ].m_Counter = &counters[ i ];
+                producers[ i ].m_CommandCount = commandCount;
+
+                CallbackThread::Entry entry = &CallbackThread::EntryHelper< StressProducer, &StressProducer::Run >;
+                ASSERT_TRUE( threads[ i ].Create( entry, &producers[ i ], "Command Queue Producer" ) );
+            }
+
+            // flush concurrently with the producers
+            bool running = true;
+            while ( running )
+            {
+                queue.Flush();
+
+                running = false;
+                for ( uint32_t i = 0; i < StressProducerCount; ++i )
+                {
+                    running |= threads[ i ].IsValid() && !threads[ i ].TryJoin();
+                }
+            }
+
+            queue.Flush();
+        }
+
+        inline std::string DocumentPath( uint32_t index )
+        {
+            std::stringstream str;
+            str << "/helium/documents/asset" << index << ".txt";
+            return str.str();
+        }
+
+        // stands in for the disk, records the save events in the order they are raised
+        struct Saver
+        {
+            volatile int32_t          m_Writes;
+            uint32_t                  m_WriteMilliseconds;
+            const Document*           m_Fail;
+            std::vector< const Document* > m_Events;
+            std::vector< bool >       m_Saved;         // false for e_Saving, true for e_Saved
+
+            Saver()
+                : m_Writes( 0 )
+                , m_WriteMilliseconds( 0 )
+                , m_Fail( NULL )
+            {
+            }
+
+            void Save( const DocumentEventArgs& args )
+            {
+                if ( m_WriteMilliseconds )
+                {
+                    Thread::Sleep( m_WriteMilliseconds );
+                }
+
+                AtomicIncrement( m_Writes );
+                if ( args.m_Document == m_Fail )
+                {
+                    *args.m_Error = "Disk full";
+                    args.m_Result = false;
+                }
+            }
+
+            void Saving( const DocumentEventArgs& args )
+            {
+                m_Events.push_back( args.m_Document );
+                m_Saved.push_back( false );
+            }
+
+            void SavedDocument( const DocumentEventArgs& args )
+            {
+                m_Events.push_back( args.m_Document );
+                m_Saved.push_back( true );
+            }
+        };
+
+        inline void OpenDocuments( DocumentManager& manager, Saver& saver, uint32_t count, std::vector< DocumentPtr >& documents )
+        {
+            for ( uint32_t i = 0; i < count; ++i )
+            {
+                DocumentPtr document = new Document( DocumentPath( i ) );
+                document->d_Save = DocumentEventSignature::Delegate( &saver, &Saver::Save );
+                document->e_Saving.AddMethod( &saver, &Saver::Saving );
+                document->e_Saved.AddMethod( &saver, &Saver::SavedDocument );
+                document->HasChanged( true );
+
+                std::string error;
+                EXPECT_TRUE( manager.OpenDocument( document, error ) );
+                documents.push_back( document );
+            }
+        }
+
+        // a command with a flag and free arguments, like most tool subcommands
+        class BuildCommand : public CommandLine::Command
+        {
+        public:
+            bool                       m_Clean;
+            std::vector< std::string > m_Targets;
+
+            BuildCommand()
+                : Command( "build", "[OPTIONS] <TARGETS>", "Builds the targets" )
+            {
+                std::string error;
+                AddOption( new CommandLine::FlagOption( &m_Clean, "clean", "rebuild from scratch" ), error );
+            }
+
+            virtual bool Process( CommandLine::ArgIterator& argsBegin, const CommandLine::ArgIterator& argsEnd, std::string& error ) override
+            {
+                if ( !ParseOptions( argsBegin, argsEnd, error ) )
+                {
+                    return false;
+                }
+
+                for ( ; argsBegin != argsEnd; ++argsBegin )
+                {
+                    m_Targets.push_back( *argsBegin );
+                }
+
+                return true;
+            }
+        };
+
+        // the options a typical tool takes, attached to a processor
+        struct ToolOptions
+        {
+            bool                       m_Verbose;
+            uint32_t                   m_Jobs;
+            std::string                m_Platform;
+            bool                       m_Cache;
+            std::vector< std::string > m_Defines;
+
+            void Register( CommandLine::Processor& processor )
+            {
+                std::string error;
+                m_Cache = false;
+                processor.AddOption( new CommandLine::FlagOption( &m_Verbose, "verbose|v", "print more" ), error );
+                processor.AddOption( new CommandLine::SimpleOption< uint32_t >( &m_Jobs, "jobs", "<N>", "parallel jobs" ), error );
+                processor.AddOption( new CommandLine::SimpleOption< std::string >( &m_Platform, "platform", "<NAME>", "target platform" ), error );
+                processor.AddOption( new CommandLine::SimpleOption< bool >( &m_Cache, "cache", "<BOOL>", "use the cache" ), error );
+                processor.AddOption( new CommandLine::SimpleOption< std::vector< std::string > >( &m_Defines, "define", "<DEFINES>", "preprocessor defines" ), error );
+            }
+        };
+
+        inline void WriteSource( const char* path, const PreferencesSnapshot::M_Preferences& preferences )
+        {
+            std::ofstream file ( path );
+            for ( PreferencesSnapshot::M_Preferences::const_iterator itr = preferences.begin(), end = preferences.end(); itr != end; ++itr )
+            {
+                file << itr->first << "=" << itr->second << "\n";
+            }
+        }
+
+        // stands in for the archive a snapshot saves us from reading
+        inline void ReadSource( const char* path, PreferencesSnapshot::M_Preferences& preferences )
+        {
+            std::ifstream file ( path );
+            std::string line;
+            while ( std::getline( file, line ) )
+            {
+                std::string::size_type equals = line.find( '=' );
+                if ( equals != std::string::npos )
+                {
+                    preferences[ line.substr( 0, equals ) ] = line.substr( equals + 1 );
+                }
+            }
+        }
+
+        inline PreferencesSnapshot::M_Preferences MakePreferences( uint32_t count )
+        {
+            PreferencesSnapshot::M_Preferences preferences;
+            for ( uint32_t i = 0; i < count; ++i )
+            {
+                std::stringstream name, value;
+                name << "Editor.Panel" << i << ".Setting";
+                value << "value of setting " << i * 7;
+                preferences[ name.str() ] = value.str();
+            }
+
+            return preferences;
+        }
+    }
+}
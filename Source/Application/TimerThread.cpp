@@ -3,39 +3,33 @@
 
 using namespace Helium;
 
-TimerThread::~TimerThread()
+TimerThread::TimerThread( const std::string& timerName, int32_t intervalInMilliseconds, bool singleShot, TimerWheel* wheel )
+    : m_Name( timerName )
+    , m_Interval( intervalInMilliseconds )
+    , m_SingleShot( singleShot )
+    , m_Alive( false )
+    , m_Wheel( wheel ? wheel : &TimerWheel::GetShared() )
 {
-    // m_TimerThreadArgs are cleaned up when the thread stops
-
-    if ( m_Alive )
-    {
-        Stop();
-    }
+    m_Entry.m_Callback = TimerWheelSignature::Delegate( this, &TimerThread::Fire );
 }
 
-void TimerThread::ThreadEntryPoint( TimerThreadArgs& args )
+TimerThread::~TimerThread()
 {
-    HELIUM_ASSERT( args.m_TimerInstance != NULL );
-    HELIUM_ASSERT( args.m_Interval != -1 );
-
-    while( args.m_TimerInstance->IsAlive() )
-    {
-        Thread::Sleep( args.m_Interval );
-        args.m_TimerInstance->Fire();
-    }
+    // a single shot timer may have just fired, always cancel so its callback is finished before we go away
+    m_Alive = false;
+    m_Wheel->Cancel( m_Entry );
 }
 
 void TimerThread::Start()
 {
-    HELIUM_ASSERT( !m_Thread.IsValid() );
+    HELIUM_ASSERT( !m_Alive );
+    HELIUM_ASSERT( m_Interval >= 0 );
 
-    // create thread
     m_Alive = true;
-
-    TimerThreadArgs* args = new TimerThreadArgs( this, m_Interval );
-    Helium::CallbackThread::Entry entry = Helium::CallbackThread::EntryHelperWithArgs< TimerThread, TimerThreadArgs, &TimerThread::ThreadEntryPoint >;
-    m_Thread.CreateWithArgs( entry, this, args, m_Name.c_str() );
     m_Timer.Reset();
+
+    uint32_t interval = static_cast< uint32_t >( m_Interval );
+    m_Wheel->Schedule( m_Entry, interval, m_SingleShot ? 0 : interval );
 }
 
 void TimerThread::Stop()
@@ -44,13 +38,13 @@ void TimerThread::Stop()
 
     m_Alive = false;
 
-    // destroy thread
-    m_Thread.Join();
+    // waits for a tick in progress on another thread
+    m_Wheel->Cancel( m_Entry );
 }
 
-void TimerThread::Fire()
+void TimerThread::Fire( const TimerWheelArgs& wheelArgs )
 {
-    TimerTickArgs args( static_cast< float32_t >( m_Timer.Elapsed() ) );
+    TimerTickArgs args( static_cast< float32_t >( m_Timer.Elapsed() ), static_cast< float32_t >( wheelArgs.m_Lateness ), static_cast< uint32_t >( wheelArgs.m_Skipped ) );
     m_Timer.Reset();
 
     m_TimerTickEvent.Raise( args );
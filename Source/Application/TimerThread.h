@@ -3,34 +3,38 @@
 #include "API.h"
 #include "Platform/Types.h"
 #include "Platform/Assert.h"
-#include "Platform/Thread.h"
 #include "Platform/Timer.h"
 #include "Foundation/Event.h"
+#include "Application/TimerWheel.h"
 
 namespace Helium
 {
 
     struct HELIUM_APPLICATION_API TimerTickArgs
     {
-        float32_t m_Elapsed;
+        float32_t m_Elapsed;    // milliseconds since Start() or the previous tick
+        float32_t m_Lateness;   // milliseconds past the tick's deadline
+        uint32_t  m_Skipped;    // periods dropped since the previous tick
 
-        TimerTickArgs( float32_t elapsed )
+        TimerTickArgs( float32_t elapsed, float32_t lateness = 0.0f, uint32_t skipped = 0 )
             : m_Elapsed( elapsed )
+            , m_Lateness( lateness )
+            , m_Skipped( skipped )
         {
         }
     };
     typedef Helium::Signature< const TimerTickArgs& > TimerTickSignature;
 
+    //
+    // Timers share the thread of a TimerWheel (TimerWheel::GetShared() by default), ticks
+    //  are raised on that thread.  Repeating timers tick at fixed multiples of the
+    //  interval from Start(), the time spent in listeners doesn't push later ticks back.
+    //
+
     class HELIUM_APPLICATION_API TimerThread
     {
     public:
-        TimerThread( const std::string& timerName, int32_t intervalInMilliseconds, bool singleShot = false )
-            : m_Name( timerName )
-            , m_Interval( intervalInMilliseconds )
-            , m_SingleShot( singleShot )
-            , m_Alive( false )
-        {
-        }
+        TimerThread( const std::string& timerName, int32_t intervalInMilliseconds, bool singleShot = false, TimerWheel* wheel = NULL );
         virtual ~TimerThread();
 
         void SetInterval( int32_t interval )
@@ -60,21 +64,14 @@ namespace Helium
             return m_Alive;
         }
 
-    private:
-        struct TimerThreadArgs
+        // how late this timer's ticks have been against their schedule
+        TimerStatistics GetStatistics()
         {
-            TimerThread* m_TimerInstance;
-            int32_t m_Interval;
-            
-            TimerThreadArgs( TimerThread* instance = NULL, int32_t interval = -1 )
-                : m_TimerInstance( instance )
-                , m_Interval( interval )
-            {
-            }
-        };
-
-        void ThreadEntryPoint( TimerThreadArgs& args );
-        void Fire();
+            return m_Wheel->GetStatistics( m_Entry );
+        }
+
+    private:
+        void Fire( const TimerWheelArgs& args );
 
     private:
         std::string m_Name;
@@ -83,8 +80,9 @@ namespace Helium
 
         TimerTickSignature::Event m_TimerTickEvent;
 
-        bool            m_Alive;
-        CallbackThread  m_Thread;
-        SimpleTimer     m_Timer;
+        volatile bool       m_Alive;
+        TimerWheel*         m_Wheel;
+        TimerWheel::Entry   m_Entry;
+        SimpleTimer         m_Timer;
     };
 }
\ No newline at end of file
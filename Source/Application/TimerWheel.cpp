@@ -0,0 +1,371 @@
+#include "Precompile.h"
+#include "TimerWheel.h"
+
+#include "Platform/Timer.h"
+
+using namespace Helium;
+
+static const uint64_t NoEvent = ~static_cast< uint64_t >( 0 );
+
+void TimerStatistics::Accumulate( float64_t lateness, uint64_t skipped )
+{
+    ++m_Fired;
+    m_Skipped += skipped;
+    m_TotalLateness += lateness;
+    if ( lateness > m_MaxLateness )
+    {
+        m_MaxLateness = lateness;
+    }
+}
+
+TimerWheel::TimerWheel()
+    : m_Wakeup( false, false )
+    , m_Fired( false, false )
+    , m_ThreadId( InvalidThreadId )
+    , m_Running( true )
+    , m_StartTicks( Timer::GetTickCount() )
+    , m_Current( 0 )
+    , m_Wake( NoEvent )
+    , m_Firing( NULL )
+    , m_Expired( NULL )
+{
+    for ( uint32_t level = 0; level < LevelCount; ++level )
+    {
+        m_Count[ level ] = 0;
+        for ( uint32_t slot = 0; slot < SlotCount; ++slot )
+        {
+            m_Slots[ level ][ slot ] = NULL;
+        }
+    }
+
+    Helium::CallbackThread::Entry entry = Helium::CallbackThread::EntryHelper< TimerWheel, &TimerWheel::ThreadEntryPoint >;
+    m_Thread.Create( entry, this, "Timer Wheel" );
+}
+
+TimerWheel::~TimerWheel()
+{
+    {
+        MutexScopeLock lock( m_Mutex );
+        m_Running = false;
+    }
+
+    m_Wakeup.Signal();
+    m_Thread.Join();
+}
+
+TimerWheel& TimerWheel::GetShared()
+{
+    static TimerWheel wheel;
+    return wheel;
+}
+
+void TimerWheel::Schedule( Entry& entry, uint32_t delayMilliseconds, uint32_t periodMilliseconds )
+{
+    MutexScopeLock lock( m_Mutex );
+
+    if ( entry.m_Scheduled )
+    {
+        Remove( &entry );
+    }
+
+    entry.m_Deadline = Now() + delayMilliseconds;
+    entry.m_Period = periodMilliseconds;
+    Insert( &entry );
+
+    // only wake the thread if it would otherwise sleep past this deadline
+    if ( entry.m_Deadline < m_Wake )
+    {
+        m_Wake = entry.m_Deadline;
+        m_Wakeup.Signal();
+    }
+}
+
+void TimerWheel::Cancel( Entry& entry )
+{
+    m_Mutex.Lock();
+
+    if ( entry.m_Scheduled )
+    {
+        Remove( &entry );
+    }
+
+    // wait out a callback in flight, unless it is the one cancelling itself
+    while ( m_Firing == &entry && Thread::GetCurrentId() != m_ThreadId )
+    {
+        m_Mutex.Unlock();
+        m_Fired.Wait( 1 );
+        m_Mutex.Lock();
+    }
+
+    m_Mutex.Unlock();
+}
+
+bool TimerWheel::IsScheduled( const Entry& entry )
+{
+    MutexScopeLock lock( m_Mutex );
+    return entry.m_Scheduled;
+}
+
+TimerStatistics TimerWheel::GetStatistics()
+{
+    MutexScopeLock lock( m_Mutex );
+    return m_Statistics;
+}
+
+TimerStatistics TimerWheel::GetStatistics( const Entry& entry )
+{
+    MutexScopeLock lock( m_Mutex );
+    return entry.m_Statistics;
+}
+
+void TimerWheel::ThreadEntryPoint()
+{
+    m_Mutex.Lock();
+    m_ThreadId = Thread::GetCurrentId();
+
+    while ( m_Running )
+    {
+        Advance( Now() );
+
+        while ( Entry* entry = m_Expired )
+        {
+            Fire( entry );
+        }
+
+        uint64_t next = NextEvent();
+        m_Wake = next;
+        m_Mutex.Unlock();
+
+        // sleep until the next deadline, Schedule() signals us if an earlier one shows up
+        uint64_t now = Now();
+        if ( next == NoEvent )
+        {
+            m_Wakeup.Wait();
+        }
+        else if ( next > now )
+        {
+            m_Wakeup.Wait( static_cast< uint32_t >( next - now ) );
+        }
+
+        m_Mutex.Lock();
+    }
+
+    m_Mutex.Unlock();
+}
+
+uint64_t TimerWheel::Now() const
+{
+    // whole milliseconds since the wheel started, a deadline at D is due once this reaches D
+    return static_cast< uint64_t >( Timer::TicksToMilliseconds( Timer::GetTickCount() - m_StartTicks ) );
+}
+
+void TimerWheel::Insert( Entry* entry )
+{
+    uint64_t expires = entry->m_Deadline > m_Current ? entry->m_Deadline : m_Current;
+    uint64_t delta = expires - m_Current;
+
+    // pick the finest level whose span covers the delta, anything past the last level waits
+    //  in its farthest slot and is placed again (with its real deadline) when that slot cascades
+    uint32_t level = 0;
+    while ( level < LevelCount - 1 && ( delta >> ( SlotBits * ( level + 1 ) ) ) )
+    {
+        ++level;
+    }
+
+    if ( delta >> ( SlotBits * LevelCount ) )
+    {
+        expires = m_Current + ( static_cast< uint64_t >( 1 ) << ( SlotBits * LevelCount ) ) - 1;
+    }
+
+    uint32_t slot = static_cast< uint32_t >( expires >> ( SlotBits * level ) ) & ( SlotCount - 1 );
+
+    entry->m_Level = level;
+    entry->m_Slot = slot;
+    entry->m_Previous = NULL;
+    entry->m_Next = m_Slots[ level ][ slot ];
+    if ( entry->m_Next )
+    {
+        entry->m_Next->m_Previous = entry;
+    }
+    m_Slots[ level ][ slot ] = entry;
+    ++m_Count[ level ];
+    entry->m_Scheduled = true;
+}
+
+void TimerWheel::Remove( Entry* entry )
+{
+    HELIUM_ASSERT( entry->m_Scheduled );
+
+    Entry*& head = entry->m_Level < LevelCount ? m_Slots[ entry->m_Level ][ entry->m_Slot ] : m_Expired;
+    if ( entry->m_Previous )
+    {
+        entry->m_Previous->m_Next = entry->m_Next;
+    }
+    else
+    {
+        head = entry->m_Next;
+    }
+
+    if ( entry->m_Next )
+    {
+        entry->m_Next->m_Previous = entry->m_Previous;
+    }
+
+    if ( entry->m_Level < LevelCount )
+    {
+        --m_Count[ entry->m_Level ];
+    }
+
+    entry->m_Previous = entry->m_Next = NULL;
+    entry->m_Scheduled = false;
+}
+
+void TimerWheel::Advance( uint64_t now )
+{
+    while ( m_Current <= now )
+    {
+        // skip ahead to the next boundary of the lowest occupied level, nothing can become due before it
+        uint32_t empty = 0;
+        while ( empty < LevelCount && !m_Count[ empty ] )
+        {
+            ++empty;
+        }
+
+        if ( empty == LevelCount )
+        {
+            m_Current = now + 1;
+            break;
+        }
+
+        if ( empty )
+        {
+            uint64_t mask = ( static_cast< uint64_t >( 1 ) << ( SlotBits * empty ) ) - 1;
+            if ( m_Current & mask )
+            {
+                uint64_t next = ( m_Current | mask ) + 1;
+                if ( next > now )
+                {
+                    m_Current = now + 1;
+                    break;
+                }
+
+                m_Current = next;
+            }
+        }
+
+        // each time a level wraps, redistribute the next slot of the level above
+        for ( uint32_t level = 1; level < LevelCount; ++level )
+        {
+            uint32_t shift = SlotBits * level;
+            if ( m_Current & ( ( static_cast< uint64_t >( 1 ) << shift ) - 1 ) )
+            {
+                break;
+            }
+
+            uint32_t slot = static_cast< uint32_t >( m_Current >> shift ) & ( SlotCount - 1 );
+            Entry* entry = m_Slots[ level ][ slot ];
+            m_Slots[ level ][ slot ] = NULL;
+            while ( entry )
+            {
+                Entry* next = entry->m_Next;
+                --m_Count[ level ];
+                Insert( entry );
+                entry = next;
+            }
+        }
+
+        // everything in the current slot is due
+        uint32_t slot = static_cast< uint32_t >( m_Current ) & ( SlotCount - 1 );
+        while ( Entry* entry = m_Slots[ 0 ][ slot ] )
+        {
+            Remove( entry );
+
+            entry->m_Level = LevelCount;
+            entry->m_Next = m_Expired;
+            if ( m_Expired )
+            {
+                m_Expired->m_Previous = entry;
+            }
+            m_Expired = entry;
+            entry->m_Scheduled = true;
+        }
+
+        ++m_Current;
+    }
+}
+
+void TimerWheel::Fire( Entry* entry )
+{
+    Remove( entry );
+
+    float64_t now = Timer::TicksToMilliseconds( Timer::GetTickCount() - m_StartTicks );
+    float64_t lateness = now - static_cast< float64_t >( entry->m_Deadline );
+    if ( lateness < 0.0 )
+    {
+        lateness = 0.0;
+    }
+
+    // periodic entries are due a whole number of periods after the last deadline, regardless of how
+    //  late this call is, any periods that have already gone by are dropped instead of fired back to back
+    uint64_t skipped = 0;
+    if ( entry->m_Period )
+    {
+        uint64_t current = static_cast< uint64_t >( now );
+        if ( current >= entry->m_Deadline + entry->m_Period )
+        {
+            skipped = ( current - entry->m_Deadline ) / entry->m_Period;
+        }
+
+        entry->m_Deadline += ( skipped + 1 ) * entry->m_Period;
+        Insert( entry );
+    }
+
+    entry->m_Statistics.Accumulate( lateness, skipped );
+    m_Statistics.Accumulate( lateness, skipped );
+
+    // the callback may schedule or cancel this or any other entry
+    m_Firing = entry;
+    m_Mutex.Unlock();
+
+    entry->m_Callback.Invoke( TimerWheelArgs( lateness, skipped ) );
+
+    m_Mutex.Lock();
+    m_Firing = NULL;
+    m_Fired.Signal();
+}
+
+uint64_t TimerWheel::NextEvent() const
+{
+    if ( m_Expired )
+    {
+        return m_Current;
+    }
+
+    uint64_t result = NoEvent;
+
+    // the first occupied slot of each level, in the order the wheel will reach them
+    for ( uint32_t level = 0; level < LevelCount; ++level )
+    {
+        if ( !m_Count[ level ] )
+        {
+            continue;
+        }
+
+        uint32_t shift = SlotBits * level;
+        uint64_t step = static_cast< uint64_t >( 1 ) << shift;
+        uint64_t time = ( m_Current + step - 1 ) & ~( step - 1 );
+        for ( uint32_t i = 0; i < SlotCount; ++i, time += step )
+        {
+            if ( m_Slots[ level ][ static_cast< uint32_t >( time >> shift ) & ( SlotCount - 1 ) ] )
+            {
+                if ( time < result )
+                {
+                    result = time;
+                }
+                break;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "API.h"
+#include "Platform/Types.h"
+#include "Platform/Condition.h"
+#include "Platform/Locks.h"
+#include "Platform/Thread.h"
+#include "Foundation/Event.h"
+
+namespace Helium
+{
+    // lateness is measured from the scheduled deadline to the moment the callback starts
+    struct HELIUM_APPLICATION_API TimerStatistics
+    {
+        uint64_t  m_Fired;
+        uint64_t  m_Skipped;        // periods dropped because the previous callback (or the whole process) ran over
+        float64_t m_TotalLateness;  // milliseconds
+        float64_t m_MaxLateness;    // milliseconds
+
+        TimerStatistics()
+            : m_Fired( 0 )
+            , m_Skipped( 0 )
+            , m_TotalLateness( 0.0 )
+            , m_MaxLateness( 0.0 )
+        {
+        }
+
+        float64_t GetAverageLateness() const
+        {
+            return m_Fired ? m_TotalLateness / static_cast< float64_t >( m_Fired ) : 0.0;
+        }
+
+        void Accumulate( float64_t lateness, uint64_t skipped );
+    };
+
+    struct HELIUM_APPLICATION_API TimerWheelArgs
+    {
+        float64_t m_Lateness;   // milliseconds past the deadline
+        uint64_t  m_Skipped;    // periods dropped since the last callback
+
+        TimerWheelArgs( float64_t lateness, uint64_t skipped )
+            : m_Lateness( lateness )
+            , m_Skipped( skipped )
+        {
+        }
+    };
+    typedef Helium::Signature< const TimerWheelArgs& > TimerWheelSignature;
+
+    //
+    // Hierarchical timer wheel (four levels of 64 one millisecond slots) serviced by a single thread
+    //  that sleeps until the next deadline.  Periodic timers are rescheduled from their previous
+    //  deadline rather than from when the callback finished, so they don't drift.  Callbacks are
+    //  made on the wheel thread and must not block for long, they delay every other timer.
+    //
+
+    class HELIUM_APPLICATION_API TimerWheel
+    {
+    public:
+        static const uint32_t SlotBits = 6;
+        static const uint32_t SlotCount = 1 << SlotBits;
+        static const uint32_t LevelCount = 4;
+
+        class HELIUM_APPLICATION_API Entry
+        {
+        public:
+            Entry()
+                : m_Deadline( 0 )
+                , m_Period( 0 )
+                , m_Previous( NULL )
+                , m_Next( NULL )
+                , m_Level( 0 )
+                , m_Slot( 0 )
+                , m_Scheduled( false )
+            {
+            }
+
+            TimerWheelSignature::Delegate m_Callback;
+
+            // statistics are written on the wheel thread, use TimerWheel::GetStatistics() for a consistent copy
+            TimerStatistics m_Statistics;
+
+        private:
+            uint64_t m_Deadline;    // wheel milliseconds
+            uint64_t m_Period;      // milliseconds, zero for a single shot
+            Entry*   m_Previous;
+            Entry*   m_Next;
+            uint32_t m_Level;       // LevelCount while waiting in the expired list
+            uint32_t m_Slot;
+            bool     m_Scheduled;
+
+            friend class TimerWheel;
+        };
+
+        TimerWheel();
+        ~TimerWheel();
+
+        // the wheel shared by every TimerThread
+        static TimerWheel& GetShared();
+
+        // fires the entry delayMilliseconds from now and then every periodMilliseconds (if non-zero),
+        //  an entry that is already scheduled is rescheduled
+        void Schedule( Entry& entry, uint32_t delayMilliseconds, uint32_t periodMilliseconds );
+
+        // once this returns the entry's callback is not running and will not be called again,
+        //  unless this is called from the callback itself
+        void Cancel( Entry& entry );
+
+        bool IsScheduled( const Entry& entry );
+
+        TimerStatistics GetStatistics();
+        TimerStatistics GetStatistics( const Entry& entry );
+
+    private:
+        void ThreadEntryPoint();
+
+        uint64_t Now() const;
+        void Insert( Entry* entry );
+        void Remove( Entry* entry );
+        void Advance( uint64_t now );
+        void Fire( Entry* entry );
+        uint64_t NextEvent() const;
+
+        Mutex           m_Mutex;
+        Condition       m_Wakeup;               // signaled when the wheel has an earlier deadline or is shutting down
+        Condition       m_Fired;                // signaled after each callback, for cancels waiting on it
+        CallbackThread  m_Thread;
+        ThreadId        m_ThreadId;
+        bool            m_Running;
+
+        uint64_t        m_StartTicks;
+        uint64_t        m_Current;              // next wheel millisecond to process
+        uint64_t        m_Wake;                 // wheel millisecond the thread is sleeping until
+        Entry*          m_Firing;               // entry whose callback is running
+        uint32_t        m_Count[ LevelCount ];  // scheduled entries per level
+        Entry*          m_Slots[ LevelCount ][ SlotCount ];
+        Entry*          m_Expired;              // entries due this pass that have not fired yet
+
+        TimerStatistics m_Statistics;
+    };
+}
@@ -0,0 +1,83 @@
+#include "Precompile.h"
+#include "Application/TimerThread.h"
+#include "Application/TimerWheel.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+
+namespace
+{
+	struct TickCounter
+	{
+		volatile int32_t m_Count;
+
+		TickCounter()
+			: m_Count( 0 )
+		{
+		}
+
+		void Tick( const TimerTickArgs& )
+		{
+			AtomicIncrement( m_Count );
+		}
+
+		void WheelTick( const TimerWheelArgs& )
+		{
+			AtomicIncrement( m_Count );
+		}
+	};
+
+	void WaitForCount( volatile int32_t& count, int32_t expected )
+	{
+		while ( count < expected )
+		{
+			Thread::Sleep( 1 );
+		}
+	}
+}
+
+// prints how late a periodic timer's ticks land, TimerWheelNoDrift checks they stay on schedule
+TEST(Application, TimerWheelPeriodicBenchmark)
+{
+	TimerWheel wheel;
+	TickCounter counter;
+
+	const uint32_t interval = 10;
+	TimerThread timer( "Periodic", interval, false, &wheel );
+	timer.AddTickListener( TimerTickSignature::Delegate( &counter, &TickCounter::Tick ) );
+	timer.Start();
+	WaitForCount( counter.m_Count, 100 );
+	timer.Stop();
+
+	TimerStatistics statistics = timer.GetStatistics();
+	printf( "TimerWheel periodic %ums: %u ticks, lateness avg %.3fms max %.3fms, %u skipped\n",
+		interval, static_cast< uint32_t >( statistics.m_Fired ), statistics.GetAverageLateness(), statistics.m_MaxLateness, static_cast< uint32_t >( statistics.m_Skipped ) );
+}
+
+// prints how late single shots spread over the first two levels of the wheel fire, TimerWheelManyTimers checks they all do
+TEST(Application, TimerWheelManyTimersBenchmark)
+{
+	TimerWheel wheel;
+
+	const uint32_t timerCount = 256;
+	TickCounter counter;
+	std::vector< TimerWheel::Entry > entries( timerCount );
+	for ( uint32_t i = 0; i < timerCount; ++i )
+	{
+		entries[ i ].m_Callback = TimerWheelSignature::Delegate( &counter, &TickCounter::WheelTick );
+		wheel.Schedule( entries[ i ], 1 + ( i * 7 ) % 250, 0 );
+	}
+
+	WaitForCount( counter.m_Count, timerCount );
+
+	TimerStatistics statistics = wheel.GetStatistics();
+	printf( "TimerWheel %u single shots on one thread: lateness avg %.3fms max %.3fms\n",
+		timerCount, statistics.GetAverageLateness(), statistics.m_MaxLateness );
+}
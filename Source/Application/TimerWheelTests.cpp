@@ -0,0 +1,199 @@
+#include "Precompile.h"
+#include "Application/TimerThread.h"
+#include "Application/TimerWheel.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+
+namespace
+{
+	// how late a tick may be before a test fails, generous so a loaded machine doesn't fail it
+	const float64_t LatenessBound = 500.0;
+
+	// how long to wait for ticks that are due well before it
+	const uint32_t WaitTimeout = 5000;
+
+	struct TickRecorder
+	{
+		uint64_t                m_Start;
+		uint32_t                m_SpinMilliseconds;
+		volatile int32_t        m_Count;
+		volatile int32_t*       m_Total;
+		uint64_t                m_Skipped;
+		std::vector< float64_t > m_Times;
+
+		TickRecorder()
+			: m_Start( Timer::GetTickCount() )
+			, m_SpinMilliseconds( 0 )
+			, m_Count( 0 )
+			, m_Total( NULL )
+			, m_Skipped( 0 )
+		{
+			m_Times.reserve( 1024 );
+		}
+
+		void Tick( const TimerTickArgs& args )
+		{
+			m_Times.push_back( Timer::TicksToMilliseconds( Timer::GetTickCount() - m_Start ) );
+			m_Skipped += args.m_Skipped;
+
+			if ( m_SpinMilliseconds )
+			{
+				uint64_t start = Timer::GetTickCount();
+				while ( Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) < m_SpinMilliseconds );
+			}
+
+			AtomicIncrement( m_Count );
+		}
+
+		void WheelTick( const TimerWheelArgs& )
+		{
+			AtomicIncrement( m_Count );
+
+			if ( m_Total )
+			{
+				AtomicIncrement( *m_Total );
+			}
+		}
+	};
+
+	// polls rather than sleeping a fixed time and counting, a slow machine only makes it take longer
+	bool WaitForCount( volatile int32_t& count, int32_t expected )
+	{
+		uint64_t start = Timer::GetTickCount();
+		while ( count < expected )
+		{
+			if ( Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) > WaitTimeout )
+			{
+				return false;
+			}
+
+			Thread::Sleep( 1 );
+		}
+
+		return true;
+	}
+
+	bool WaitForStop( TimerThread& timer )
+	{
+		uint64_t start = Timer::GetTickCount();
+		while ( timer.IsAlive() )
+		{
+			if ( Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) > WaitTimeout )
+			{
+				return false;
+			}
+
+			Thread::Sleep( 1 );
+		}
+
+		return true;
+	}
+}
+
+TEST(Application, TimerWheelSingleShot)
+{
+	TimerWheel wheel;
+	TickRecorder recorder;
+
+	TimerThread timer( "Single Shot", 20, true, &wheel );
+	timer.AddTickListener( TimerTickSignature::Delegate( &recorder, &TickRecorder::Tick ) );
+	recorder.m_Start = Timer::GetTickCount();
+	timer.Start();
+	EXPECT_TRUE( timer.IsAlive() );
+
+	ASSERT_TRUE( WaitForCount( recorder.m_Count, 1 ) );
+	EXPECT_TRUE( WaitForStop( timer ) );
+	ASSERT_EQ( 1u, recorder.m_Times.size() );
+	EXPECT_GE( recorder.m_Times[ 0 ], 19.0 );
+	EXPECT_LT( recorder.m_Times[ 0 ], 20.0 + LatenessBound );
+
+	// a single shot never fires again on its own
+	Thread::Sleep( 50 );
+	EXPECT_EQ( 1, recorder.m_Count );
+
+	// restart after the shot
+	timer.Start();
+	EXPECT_TRUE( WaitForCount( recorder.m_Count, 2 ) );
+	EXPECT_TRUE( WaitForStop( timer ) );
+	EXPECT_EQ( 2, recorder.m_Count );
+}
+
+TEST(Application, TimerWheelNoDrift)
+{
+	TimerWheel wheel;
+	TickRecorder recorder;
+
+	// the listener takes a good part of the interval, a sleep-then-fire loop would drift by it every tick
+	recorder.m_SpinMilliseconds = 4;
+
+	const uint32_t interval = 10;
+	TimerThread timer( "Periodic", interval, false, &wheel );
+	timer.AddTickListener( TimerTickSignature::Delegate( &recorder, &TickRecorder::Tick ) );
+	recorder.m_Start = Timer::GetTickCount();
+	timer.Start();
+
+	EXPECT_TRUE( WaitForCount( recorder.m_Count, 40 ) );
+	timer.Stop();
+
+	// Stop() waits for a tick in progress, nothing fires after it
+	int32_t count = recorder.m_Count;
+	Thread::Sleep( 50 );
+	EXPECT_EQ( count, recorder.m_Count );
+
+	// every tick lands near its own multiple of the interval, skipped periods only shift later ticks by whole periods
+	TimerStatistics statistics = timer.GetStatistics();
+	EXPECT_EQ( static_cast< uint64_t >( count ), statistics.m_Fired );
+	EXPECT_EQ( statistics.m_Skipped, recorder.m_Skipped );
+
+	float64_t last = recorder.m_Times.back();
+	float64_t scheduled = static_cast< float64_t >( ( count + statistics.m_Skipped ) * interval );
+	EXPECT_GE( last, scheduled - 1.0 );
+	EXPECT_LT( last, scheduled + interval );
+}
+
+TEST(Application, TimerWheelManyTimers)
+{
+	TimerWheel wheel;
+
+	// deadlines across the first two levels of the wheel, so entries cascade
+	const uint32_t timerCount = 256;
+	std::vector< TickRecorder > recorders( timerCount );
+	std::vector< TimerWheel::Entry > entries( timerCount );
+	volatile int32_t total = 0;
+	for ( uint32_t i = 0; i < timerCount; ++i )
+	{
+		recorders[ i ].m_Total = &total;
+		entries[ i ].m_Callback = TimerWheelSignature::Delegate( &recorders[ i ], &TickRecorder::WheelTick );
+		wheel.Schedule( entries[ i ], 1 + ( i * 7 ) % 250, 0 );
+	}
+
+	// cancel a few before they fire and reschedule one later
+	wheel.Cancel( entries[ 100 ] );
+	wheel.Cancel( entries[ 107 ] );
+	wheel.Schedule( entries[ 120 ], 300, 0 );
+	EXPECT_FALSE( wheel.IsScheduled( entries[ 100 ] ) );
+	EXPECT_TRUE( wheel.IsScheduled( entries[ 120 ] ) );
+
+	EXPECT_TRUE( WaitForCount( total, timerCount - 2 ) );
+
+	// none of them fire twice, and the cancelled ones not at all
+	Thread::Sleep( 50 );
+	EXPECT_EQ( static_cast< int32_t >( timerCount - 2 ), total );
+	for ( uint32_t i = 0; i < timerCount; ++i )
+	{
+		EXPECT_EQ( ( i == 100 || i == 107 ) ? 0 : 1, recorders[ i ].m_Count ) << "timer " << i;
+		EXPECT_FALSE( wheel.IsScheduled( entries[ i ] ) );
+	}
+
+	TimerStatistics statistics = wheel.GetStatistics();
+	EXPECT_EQ( timerCount - 2u, statistics.m_Fired );
+	EXPECT_LT( statistics.m_MaxLateness, LatenessBound );
+}
@@ -2,6 +2,7 @@
 #include "UndoQueue.h"
 
 #include "Platform/Assert.h"
+#include "Platform/Timer.h"
 #include "Foundation/Log.h"
 #include "Foundation/Exception.h"
 
@@ -88,8 +89,24 @@ bool BatchUndoCommand::IsEmpty() const
     return m_Commands.empty();
 }
 
+size_t BatchUndoCommand::GetMemoryFootprint() const
+{
+    size_t footprint = sizeof( *this ) + m_Commands.capacity() * sizeof( UndoCommandPtr );
+
+    std::vector<UndoCommandPtr>::const_iterator itr = m_Commands.begin();
+    std::vector<UndoCommandPtr>::const_iterator end = m_Commands.end();
+    for ( ; itr != end; ++itr )
+    {
+        footprint += (*itr)->GetMemoryFootprint();
+    }
+
+    return footprint;
+}
+
 UndoQueue::UndoQueue()
 : m_MaxLength (0)
+, m_MaxMemory (0)
+, m_MergeMilliseconds (500)
 {
     Reset();
 }
@@ -103,6 +120,9 @@ void UndoQueue::Reset()
 {
     m_Undo.clear();
     m_Redo.clear();
+    m_Memory = 0;
+    m_LastPushTicks = 0;
+    m_Mergeable = false;
     m_Active = false;
     m_BatchState = 0;
     m_Reset.Raise( UndoQueueChangeArgs( this, NULL ) );
@@ -110,7 +130,7 @@ void UndoQueue::Reset()
 
 void UndoQueue::Print() const
 {
-    Log::Print( "Max: %d\tUndo Length:\t%d\tRedo Length:\t%d\n", GetMaxLength(), m_Undo.size(), m_Redo.size() );
+    Log::Print( "Max: %d\tUndo Length:\t%d\tRedo Length:\t%d\tMemory:\t%u\n", GetMaxLength(), m_Undo.size(), m_Redo.size(), static_cast< uint32_t >( m_Memory ) );
 }
 
 bool UndoQueue::IsActive() const
@@ -131,6 +151,33 @@ int UndoQueue::GetMaxLength() const
 void UndoQueue::SetMaxLength( int value )
 {
     m_MaxLength = value;
+    Trim();
+}
+
+size_t UndoQueue::GetMemoryFootprint() const
+{
+    return m_Memory;
+}
+
+size_t UndoQueue::GetMaxMemory() const
+{
+    return m_MaxMemory;
+}
+
+void UndoQueue::SetMaxMemory( size_t value )
+{
+    m_MaxMemory = value;
+    Trim();
+}
+
+uint32_t UndoQueue::GetMergeMilliseconds() const
+{
+    return m_MergeMilliseconds;
+}
+
+void UndoQueue::SetMergeMilliseconds( uint32_t value )
+{
+    m_MergeMilliseconds = value;
 }
 
 bool UndoQueue::IsBatching() const
@@ -173,16 +220,39 @@ void UndoQueue::Push( const UndoCommandPtr& c )
     HELIUM_ASSERT( c.ReferencesObject() );
 
     // we have a new command, so delete all subsequent commands from our current position
+    std::vector<UndoCommandPtr>::const_iterator itr = m_Redo.begin();
+    std::vector<UndoCommandPtr>::const_iterator end = m_Redo.end();
+    for ( ; itr != end; ++itr )
+    {
+        m_Memory -= (*itr)->GetMemoryFootprint();
+    }
     m_Redo.clear();
 
-    // if we have a finite length and we are full, remove the oldest command
-    while ( m_MaxLength > 0 && GetLength() >= m_MaxLength )
+    // fold repeated changes (dragging a slider, etc...) into the last command if it was pushed just before this one
+    uint64_t ticks = Timer::GetTickCount();
+    if ( m_Mergeable && m_MergeMilliseconds > 0 && !m_Undo.empty() &&
+        Timer::TicksToMilliseconds( ticks - m_LastPushTicks ) <= m_MergeMilliseconds )
     {
-        m_Undo.erase( m_Undo.begin() );
+        UndoCommand* last = m_Undo.back();
+        size_t footprint = last->GetMemoryFootprint();
+        if ( last->Merge( c ) )
+        {
+            m_Memory = m_Memory - footprint + last->GetMemoryFootprint();
+            m_LastPushTicks = ticks;
+
+            m_UndoCommandPushed.Raise( UndoQueueChangeArgs( this, last ) );
+            return;
+        }
     }
 
     // append our command to the queue
     m_Undo.push_back( c );
+    m_Memory += c->GetMemoryFootprint();
+    m_LastPushTicks = ticks;
+    m_Mergeable = true;
+
+    // if we have a finite length or memory budget and we are over, remove the oldest commands
+    Trim();
 
     // fire an event to interested listeners
     m_UndoCommandPushed.Raise( UndoQueueChangeArgs( this, c ) );
@@ -205,6 +275,7 @@ bool UndoQueue::CanRedo() const
 void UndoQueue::Undo()
 {
     m_Active = true;
+    m_Mergeable = false;
 
     // if the undo stack is not empty
     if ( m_Undo.size() > 0 )
@@ -216,6 +287,7 @@ void UndoQueue::Undo()
             // get the command at the current position
             UndoCommandPtr c = m_Undo.back();
             m_Undo.pop_back();
+            m_Memory -= c->GetMemoryFootprint();
 
             try
             {
@@ -226,6 +298,7 @@ void UndoQueue::Undo()
                 // not make it into the redo queue and the smart pointer will cause it to be
                 // deleted.
                 m_Redo.push_back( c );
+                m_Memory += c->GetMemoryFootprint();
 
                 m_Undone.Raise( UndoQueueChangeArgs( this, c.Ptr() ) );
             }
@@ -247,6 +320,7 @@ void UndoQueue::Undo()
 void UndoQueue::Redo()
 {
     m_Active = true;
+    m_Mergeable = false;
 
     // if the redo staick is not empty
     if ( m_Redo.size() > 0 )
@@ -258,6 +332,7 @@ void UndoQueue::Redo()
             // get the command at the next position
             UndoCommandPtr c = m_Redo.back();
             m_Redo.pop_back();
+            m_Memory -= c->GetMemoryFootprint();
 
             try
             {
@@ -268,6 +343,7 @@ void UndoQueue::Redo()
                 // not make it into the redo queue and the smart pointer will cause it to be
                 // deleted.
                 m_Undo.push_back( c );
+                m_Memory += c->GetMemoryFootprint();
 
                 m_Redone.Raise( UndoQueueChangeArgs( this, c.Ptr() ) );
             }
@@ -285,3 +361,14 @@ void UndoQueue::Redo()
     Print();
 #endif
 }
+
+void UndoQueue::Trim()
+{
+    // the newest command is always kept, even if it is over budget on its own
+    while ( m_Undo.size() > 1 &&
+        ( ( m_MaxLength > 0 && GetLength() > m_MaxLength ) || ( m_MaxMemory > 0 && m_Memory > m_MaxMemory ) ) )
+    {
+        m_Memory -= m_Undo.front()->GetMemoryFootprint();
+        m_Undo.pop_front();
+    }
+}
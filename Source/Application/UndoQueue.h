@@ -1,14 +1,46 @@
 #pragma once
 
 #include "Application/API.h"
+#include "Foundation/DynamicArray.h"
 #include "Foundation/Event.h"
 #include "Foundation/Property.h"
 #include "Foundation/SmartPtr.h"
 
+#include <deque>
+#include <string>
 #include <vector>
 
 namespace Helium
 {
+    //
+    // Heap memory owned by a value stored in an undo command (beyond sizeof the value itself),
+    //  overload this for types that own large buffers so the undo queue can budget for them
+    //
+
+    template< class V >
+    inline size_t GetHeapFootprint( const V& )
+    {
+        return 0;
+    }
+
+    template< class T, class A >
+    inline size_t GetHeapFootprint( const std::vector< T, A >& value )
+    {
+        return value.capacity() * sizeof( T );
+    }
+
+    template< class C, class T, class A >
+    inline size_t GetHeapFootprint( const std::basic_string< C, T, A >& value )
+    {
+        return ( value.capacity() + 1 ) * sizeof( C );
+    }
+
+    template< class T, class A >
+    inline size_t GetHeapFootprint( const DynamicArray< T, A >& value )
+    {
+        return value.GetCapacity() * sizeof( T );
+    }
+
     //
     // This is a basic undoable command object, interface for the queue
     //
@@ -33,6 +65,34 @@ namespace Helium
         {
             return true;
         }
+
+        //
+        // Bytes of memory retained by this command, used to keep the undo queue within its memory
+        //  budget.  Commands that hold large data (copies of meshes, arrays, etc...) should override
+        //  this and include their heap allocations.
+        //
+
+        virtual size_t GetMemoryFootprint() const
+        {
+            return sizeof( UndoCommand );
+        }
+
+        //
+        // Fold a command pushed right after this one into this one, so both are undone as one step.
+        //  Both commands have already been done, so this should keep its own undo state and only
+        //  take whatever it needs to redo the later command.  Return false to leave them separate.
+        //
+
+        virtual bool Merge( const UndoCommand* command )
+        {
+            return false;
+        }
+
+        // identifies the concrete command class without RTTI (for Merge), NULL if it never merges
+        virtual const void* GetTypeTag() const
+        {
+            return NULL;
+        }
     };
 
     typedef Helium::SmartPtr<UndoCommand> UndoCommandPtr;
@@ -59,6 +119,8 @@ namespace Helium
 
         virtual bool IsSignificant() const override;
         virtual bool IsEmpty() const;
+
+        virtual size_t GetMemoryFootprint() const override;
     };
 
     typedef Helium::SmartPtr<BatchUndoCommand> BatchUndoCommandPtr;
@@ -71,6 +133,8 @@ namespace Helium
     class PropertyUndoCommand : public UndoCommand
     {
     private:
+        static const char s_TypeTag;
+
         // the property object we will get/set through
         Helium::SmartPtr< Helium::Property<V> > m_Property;
 
@@ -115,6 +179,35 @@ namespace Helium
             Swap();
         }
 
+        virtual size_t GetMemoryFootprint() const override
+        {
+            return sizeof( *this ) + GetHeapFootprint( m_Value );
+        }
+
+        // consecutive sets of the same property (a slider drag, etc...) undo back to the value before the first
+        virtual bool Merge( const UndoCommand* command ) override
+        {
+            if ( command->GetTypeTag() != GetTypeTag() )
+            {
+                return false;
+            }
+
+            const PropertyUndoCommand* next = static_cast< const PropertyUndoCommand* >( command );
+            if ( !m_Property->Equals( next->m_Property.Ptr() ) )
+            {
+                return false;
+            }
+
+            // our latent value is still the one from before the first set, and redo will read the latest value back
+            m_Significant |= next->m_Significant;
+            return true;
+        }
+
+        virtual const void* GetTypeTag() const override
+        {
+            return &s_TypeTag;
+        }
+
         void Swap()
         {
             // read the existing value
@@ -128,6 +221,9 @@ namespace Helium
         }
     };
 
+    template <class V>
+    const char PropertyUndoCommand< V >::s_TypeTag = 0;
+
     //
     // ExistenceUndoCommand helps store some state for add/remove with undo/redo support using delegates
     //
@@ -191,6 +287,11 @@ namespace Helium
                 break;
             }
         }
+
+        size_t GetMemoryFootprint() const override
+        {
+            return sizeof( *this ) + GetHeapFootprint( m_Value );
+        }
     };
 
     class UndoQueue;
@@ -231,7 +332,7 @@ namespace Helium
 
     private:
         // The undo and redo stacks
-        std::vector<UndoCommandPtr> m_Undo;
+        std::deque<UndoCommandPtr> m_Undo;
         std::vector<UndoCommandPtr> m_Redo;
 
         // is the queue active, we don't want to modify the queue while we are commiting a change
@@ -240,6 +341,15 @@ namespace Helium
         // max allowed length of the queue
         int m_MaxLength;
 
+        // max allowed memory of the queue, and the memory retained by both stacks
+        size_t m_MaxMemory;
+        size_t m_Memory;
+
+        // pushes within this many milliseconds of the last push may be merged into it
+        uint32_t m_MergeMilliseconds;
+        uint64_t m_LastPushTicks;
+        bool m_Mergeable;
+
         // the batch state
         int m_BatchState;
 
@@ -272,6 +382,18 @@ namespace Helium
 
         void SetMaxLength(int value);
 
+        size_t GetMemoryFootprint() const;
+
+        size_t GetMaxMemory() const;
+
+        // zero for no budget, otherwise the oldest commands are discarded to stay within it
+        void SetMaxMemory(size_t value);
+
+        uint32_t GetMergeMilliseconds() const;
+
+        // zero to never merge commands
+        void SetMergeMilliseconds(uint32_t value);
+
 
         //
         // Auto-Batching
@@ -301,13 +423,17 @@ namespace Helium
 
         void Redo();
 
+    private:
+        // discard the oldest commands until we are within our length and memory limits
+        void Trim();
+
 
         // 
         // Events
         //
 
     private:
-        UndoQueueChangeSignature::Event m_UndoCommandPushed;
+        UndoQueueChangeSignature::ConcurrentEvent m_UndoCommandPushed;
     public:
         void AddUndoCommandPushedListener( const UndoQueueChangeSignature::Delegate& listener )
         {
@@ -319,7 +445,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangeSignature::Event m_Reset;
+        UndoQueueChangeSignature::ConcurrentEvent m_Reset;
     public:
         void AddResetListener( const UndoQueueChangeSignature::Delegate& listener )
         {
@@ -331,7 +457,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangeSignature::Event m_Destroyed;
+        UndoQueueChangeSignature::ConcurrentEvent m_Destroyed;
     public:
         void AddDestroyListener( const UndoQueueChangeSignature::Delegate& listener )
         {
@@ -343,7 +469,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangingSignature::Event m_Undoing;
+        UndoQueueChangingSignature::ConcurrentEvent m_Undoing;
     public:
         void AddUndoingListener( const UndoQueueChangingSignature::Delegate& listener )
         {
@@ -355,7 +481,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangingSignature::Event m_Redoing;
+        UndoQueueChangingSignature::ConcurrentEvent m_Redoing;
     public:
         void AddRedoingListener( const UndoQueueChangingSignature::Delegate& listener )
         {
@@ -367,7 +493,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangeSignature::Event m_Undone;
+        UndoQueueChangeSignature::ConcurrentEvent m_Undone;
     public:
         void AddUndoneListener( const UndoQueueChangeSignature::Delegate& listener )
         {
@@ -379,7 +505,7 @@ namespace Helium
         }
 
     private:
-        UndoQueueChangeSignature::Event m_Redone;
+        UndoQueueChangeSignature::ConcurrentEvent m_Redone;
     public:
         void AddRedoneListener( const UndoQueueChangeSignature::Delegate& listener )
         {
@@ -0,0 +1,137 @@
+#include "Precompile.h"
+#include "Application/UndoQueue.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+
+namespace
+{
+	struct Document
+	{
+		int32_t                 m_Position;
+		int32_t                 m_Scale;
+		std::vector< float32_t > m_Vertices;
+
+		Document()
+			: m_Position( 0 )
+			, m_Scale( 1 )
+		{
+		}
+
+		int32_t GetPosition() const { return m_Position; }
+		void SetPosition( int32_t value ) { m_Position = value; }
+
+		int32_t GetScale() const { return m_Scale; }
+		void SetScale( int32_t value ) { m_Scale = value; }
+
+		const std::vector< float32_t >& GetVertices() const { return m_Vertices; }
+		void SetVertices( const std::vector< float32_t >& value ) { m_Vertices = value; }
+
+		void Set( UndoQueue& queue, int32_t (Document::*getter)() const, void (Document::*setter)( int32_t ), int32_t value )
+		{
+			SmartPtr< Property< int32_t > > property = new MemberProperty< Document, int32_t >( this, getter, setter );
+			queue.Push( new PropertyUndoCommand< int32_t >( property, value ) );
+		}
+
+		void SetVertices( UndoQueue& queue, size_t count )
+		{
+			SmartPtr< Property< std::vector< float32_t > > > property =
+				new MemberProperty< Document, std::vector< float32_t > >( this, &Document::GetVertices, &Document::SetVertices );
+			queue.Push( new PropertyUndoCommand< std::vector< float32_t > >( property, std::vector< float32_t >( count, static_cast< float32_t >( count ) ) ) );
+		}
+	};
+}
+
+TEST(Application, UndoQueueMerge)
+{
+	UndoQueue queue;
+	Document document;
+
+	// a drag sets the same property over and over, with a different property in the middle
+	for ( int32_t i = 1; i <= 100; ++i )
+	{
+		document.Set( queue, &Document::GetPosition, &Document::SetPosition, i );
+	}
+	EXPECT_EQ( 1, queue.GetLength() );
+	EXPECT_EQ( 100, document.m_Position );
+
+	document.Set( queue, &Document::GetScale, &Document::SetScale, 2 );
+	document.Set( queue, &Document::GetPosition, &Document::SetPosition, 200 );
+	EXPECT_EQ( 3, queue.GetLength() );
+
+	queue.Undo();
+	EXPECT_EQ( 100, document.m_Position );
+	queue.Undo();
+	EXPECT_EQ( 1, document.m_Scale );
+	queue.Undo();
+	EXPECT_EQ( 0, document.m_Position );
+
+	queue.Redo();
+	EXPECT_EQ( 100, document.m_Position );
+
+	// a set after undo/redo starts a new step
+	document.Set( queue, &Document::GetPosition, &Document::SetPosition, 101 );
+	EXPECT_EQ( 2, queue.GetLength() );
+	queue.Undo();
+	EXPECT_EQ( 100, document.m_Position );
+
+	// with merging off every set is its own step
+	queue.Reset();
+	queue.SetMergeMilliseconds( 0 );
+	for ( int32_t i = 1; i <= 10; ++i )
+	{
+		document.Set( queue, &Document::GetPosition, &Document::SetPosition, i );
+	}
+	EXPECT_EQ( 10, queue.GetLength() );
+}
+
+TEST(Application, UndoQueueMemoryBudget)
+{
+	UndoQueue queue;
+	Document document;
+	queue.SetMergeMilliseconds( 0 );
+
+	const size_t vertexCount = 1 << 16;
+	const size_t commandBytes = vertexCount * sizeof( float32_t );
+	queue.SetMaxMemory( 8 * commandBytes );
+
+	for ( size_t i = 1; i <= 32; ++i )
+	{
+		document.SetVertices( queue, vertexCount + i );
+		EXPECT_LE( queue.GetMemoryFootprint(), queue.GetMaxMemory() );
+	}
+
+	// only the newest commands are kept
+	int32_t length = queue.GetLength();
+	EXPECT_GE( length, 6 );
+	EXPECT_LT( length, 8 );
+	EXPECT_GT( queue.GetMemoryFootprint(), static_cast< size_t >( length ) * commandBytes );
+
+	// footprints follow the commands between the stacks, values swap sizes as they are undone
+	for ( int32_t i = 0; i < length; ++i )
+	{
+		queue.Undo();
+		EXPECT_LE( queue.GetMemoryFootprint(), queue.GetMaxMemory() + commandBytes );
+	}
+	EXPECT_FALSE( queue.CanUndo() );
+	EXPECT_EQ( vertexCount + 32 - length, document.m_Vertices.size() );
+
+	queue.Redo();
+	EXPECT_EQ( vertexCount + 33 - length, document.m_Vertices.size() );
+
+	// a new push drops the redo stack and its memory
+	size_t before = queue.GetMemoryFootprint();
+	document.SetVertices( queue, 16 );
+	EXPECT_LT( queue.GetMemoryFootprint(), before );
+	EXPECT_EQ( 2, queue.GetLength() );
+
+	// shrinking the budget trims right away, but keeps the newest command
+	queue.SetMaxMemory( 1 );
+	EXPECT_EQ( 1, queue.GetLength() );
+
+	queue.Reset();
+	EXPECT_EQ( 0u, queue.GetMemoryFootprint() );
+}
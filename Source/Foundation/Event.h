@@ -2,8 +2,11 @@
 
 #include "Platform/Types.h"
 #include "Platform/Assert.h"
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
 #include "Foundation/SmartPtr.h"
 
+#include <string.h>
 #include <vector>
 
 namespace Helium
@@ -23,6 +26,15 @@ namespace Helium
 	//
 	//  Event is a set of delegates that are invoked together.
 	//
+	//  InlineDelegate is a Delegate held by value (a thunk, an instance, and
+	//   the function or method pointer) with no heap allocation or reference
+	//   counting.
+	//
+	//  ConcurrentEvent is an Event for hot, shared events.  Its delegates are
+	//   kept inline in one contiguous array that is replaced (copy-on-write)
+	//   by Add and Remove, so Raise walks a published array without locking
+	//   and Add and Remove are safe from any thread.
+	//
 	// Comments:
 	//
 	//  The reliance on internally allocated worker (Impl) classes is there to
@@ -278,6 +290,144 @@ namespace Helium
 		Helium::SmartPtr< EventImpl > m_Impl;
 	};
 
+	//
+	// InlineDelegate is a Delegate for a function or method that is stored by value
+	//
+
+	template< typename ArgsType, template< typename T > class RefCountBaseType >
+	class ConcurrentEvent;
+
+	template< typename ArgsType >
+	class InlineDelegate
+	{
+	public:
+		typedef void (*FunctionType)(ArgsType);
+
+		InlineDelegate();
+		InlineDelegate( FunctionType function );
+
+		template < class ClassType, typename MethodType >
+		InlineDelegate( ClassType* instance, MethodType method );
+
+		bool Valid() const;
+		bool Equals( const InlineDelegate& rhs ) const;
+
+		void Invoke( ArgsType parameter ) const;
+
+	private:
+		template< typename A, template< typename T > class R >
+		friend class ConcurrentEvent;
+
+		typedef void (*ThunkType)( const InlineDelegate& delegate, ArgsType parameter );
+
+		// sized for the largest member function pointer (a class the compiler knows nothing about)
+		class UnknownClass;
+		typedef void (UnknownClass::*UnknownMethodType)(ArgsType);
+
+		static void FunctionThunk( const InlineDelegate& delegate, ArgsType parameter );
+		template< class ClassType, typename MethodType >
+		static void MethodThunk( const InlineDelegate& delegate, ArgsType parameter );
+
+		ThunkType m_Thunk;
+		void*     m_Instance;
+		union
+		{
+			FunctionType      m_Function;
+			UnknownMethodType m_Method;
+			unsigned char     m_Storage[ sizeof( UnknownMethodType ) ];
+		};
+	};
+
+	//
+	// ConcurrentEvent is an Event whose delegates live in an immutable, contiguous array.  Add and Remove
+	//  publish a new array (under a lock), Raise reads the published one without locking.  Arrays that
+	//  were replaced are freed once no Raise is in progress.  Functions and methods are stored inline,
+	//  Delegate objects are accepted for compatibility with Event (at the cost of one heap copy each),
+	//  a delegate has to be removed the same way (inline or as a Delegate) it was added.
+	//
+
+	template< typename ArgsType, template< typename T > class RefCountBaseType = RefCountBase >
+	class ConcurrentEvent : NonCopyable
+	{
+	public:
+		typedef Helium::Delegate< ArgsType, RefCountBaseType > Delegate;
+		typedef Helium::InlineDelegate< ArgsType >             InlineDelegate;
+
+		ConcurrentEvent();
+		~ConcurrentEvent();
+
+		uint32_t Count() const;
+		bool Valid() const;
+
+		void Add( const Delegate& delegate );
+		void Add( const InlineDelegate& delegate );
+		template < typename FunctionType >
+		void AddFunction( FunctionType function );
+		template < class ClassType, typename MethodType >
+		void AddMethod( ClassType* instance, MethodType method );
+
+		void Remove( const Delegate& delegate );
+		void Remove( const InlineDelegate& delegate );
+		template < typename FunctionType >
+		void RemoveFunction( FunctionType function );
+		template < class ClassType, typename MethodType >
+		void RemoveMethod( const ClassType* instance, MethodType method );
+
+		void Raise( ArgsType parameter );
+		void RaiseWithEmitter( ArgsType parameter, const Delegate& emitter );
+		void RaiseWithEmitter( ArgsType parameter, const InlineDelegate& emitter );
+
+	private:
+		struct Entry
+		{
+			InlineDelegate  m_Delegate;
+			Delegate*       m_Copy;     // the Delegate this entry calls (owned by the event), or NULL
+			int32_t         m_Removed;  // set if removed while a Raise may still be walking this entry
+		};
+
+		// the delegates as of one Add or Remove, never changed once published (except for m_Removed)
+		struct Snapshot
+		{
+			uint32_t  m_Count;
+			Snapshot* m_NextRetired;
+
+			inline Entry* GetEntries();
+		};
+
+		// heap allocated so a Raise can finish even if a delegate destroys the event (and its owner)
+		struct State
+		{
+			Snapshot* volatile       m_Snapshot;
+			int32_t volatile         m_Count;    // m_Snapshot's count, so Count doesn't touch a snapshot Reclaim may free
+			Snapshot*                m_Retired;
+			std::vector< Delegate* > m_RetiredCopies;
+			int32_t volatile         m_Raising;
+			int32_t volatile         m_Orphaned;
+			SpinLock                 m_Lock;
+
+			State();
+			~State();
+
+			// replaces the published snapshot, the old one is retired
+			void Publish( Snapshot* snapshot );
+
+			// frees what was retired, if no Raise is walking it
+			void Reclaim();
+		};
+
+		static Snapshot* AllocateSnapshot( uint32_t count );
+		static void FreeSnapshot( Snapshot* snapshot );
+
+		void Insert( const Entry& entry );
+		void Erase( const InlineDelegate* inlineDelegate, const Delegate* delegate );
+		template< class EmitterType >
+		void Raise( ArgsType parameter, const EmitterType* emitter );
+		static bool IsEmitter( const Entry& entry, const InlineDelegate* emitter );
+		static bool IsEmitter( const Entry& entry, const Delegate* emitter );
+
+		State* volatile m_State;
+	};
+
 	//
 	// Signature intantiates all the template classes necessary for working with a particular signature
 	//
@@ -286,8 +436,10 @@ namespace Helium
 	class Signature
 	{
 	public:
-		typedef Helium::Delegate< ArgsType, RefCountBaseType >  Delegate;
-		typedef Helium::Event< ArgsType, RefCountBaseType >     Event;
+		typedef Helium::Delegate< ArgsType, RefCountBaseType >        Delegate;
+		typedef Helium::Event< ArgsType, RefCountBaseType >           Event;
+		typedef Helium::InlineDelegate< ArgsType >                    InlineDelegate;
+		typedef Helium::ConcurrentEvent< ArgsType, RefCountBaseType > ConcurrentEvent;
 	};
 
 	typedef Helium::Signature<Helium::Void> VoidSignature;
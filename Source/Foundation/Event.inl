@@ -551,3 +551,444 @@ void Helium::Event< ArgsType, RefCountBaseType >::EventImpl::Raise( ArgsType par
 		Compact();
 	}
 }
+
+template< typename ArgsType >
+Helium::InlineDelegate< ArgsType >::InlineDelegate()
+	: m_Thunk( NULL )
+	, m_Instance( NULL )
+{
+	memset( m_Storage, 0, sizeof( m_Storage ) );
+}
+
+template< typename ArgsType >
+Helium::InlineDelegate< ArgsType >::InlineDelegate( FunctionType function )
+	: m_Thunk( &FunctionThunk )
+	, m_Instance( NULL )
+{
+	memset( m_Storage, 0, sizeof( m_Storage ) );
+	m_Function = function;
+}
+
+template< typename ArgsType >
+template < class ClassType, typename MethodType >
+Helium::InlineDelegate< ArgsType >::InlineDelegate( ClassType* instance, MethodType method )
+	: m_Thunk( &MethodThunk< ClassType, MethodType > )
+	, m_Instance( const_cast< void* >( static_cast< const void* >( instance ) ) )
+{
+	HELIUM_COMPILE_ASSERT( sizeof( MethodType ) <= sizeof( m_Storage ) );
+	memset( m_Storage, 0, sizeof( m_Storage ) );
+	memcpy( m_Storage, &method, sizeof( method ) );
+}
+
+template< typename ArgsType >
+bool Helium::InlineDelegate< ArgsType >::Valid() const
+{
+	return m_Thunk != NULL;
+}
+
+template< typename ArgsType >
+bool Helium::InlineDelegate< ArgsType >::Equals( const InlineDelegate& rhs ) const
+{
+	return m_Thunk == rhs.m_Thunk && m_Instance == rhs.m_Instance && memcmp( m_Storage, rhs.m_Storage, sizeof( m_Storage ) ) == 0;
+}
+
+template< typename ArgsType >
+void Helium::InlineDelegate< ArgsType >::Invoke( ArgsType parameter ) const
+{
+	if ( m_Thunk )
+	{
+		m_Thunk( *this, parameter );
+	}
+}
+
+template< typename ArgsType >
+void Helium::InlineDelegate< ArgsType >::FunctionThunk( const InlineDelegate& delegate, ArgsType parameter )
+{
+	delegate.m_Function( parameter );
+}
+
+template< typename ArgsType >
+template< class ClassType, typename MethodType >
+void Helium::InlineDelegate< ArgsType >::MethodThunk( const InlineDelegate& delegate, ArgsType parameter )
+{
+	MethodType method;
+	memcpy( &method, delegate.m_Storage, sizeof( method ) );
+	(static_cast< ClassType* >( delegate.m_Instance )->*method)( parameter );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+typename Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Entry* Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Snapshot::GetEntries()
+{
+	return reinterpret_cast< Entry* >( this + 1 );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::State::State()
+	: m_Snapshot( NULL )
+	, m_Count( 0 )
+	, m_Retired( NULL )
+	, m_Raising( 0 )
+	, m_Orphaned( 0 )
+{
+
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::State::~State()
+{
+	HELIUM_ASSERT( m_Raising == 0 );
+
+	Publish( NULL );
+	Reclaim();
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::State::Publish( Snapshot* snapshot )
+{
+	Snapshot* previous = static_cast< Snapshot* >( AtomicExchangePointer( reinterpret_cast< void* volatile & >( m_Snapshot ), snapshot ) );
+	AtomicExchange( m_Count, snapshot ? static_cast< int32_t >( snapshot->m_Count ) : 0 );
+	if ( previous )
+	{
+		previous->m_NextRetired = m_Retired;
+		m_Retired = previous;
+	}
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::State::Reclaim()
+{
+	// a Raise announces itself before it reads m_Snapshot, so once the count is zero (after the
+	//  exchange in Publish) nothing can be walking a retired snapshot or calling a retired copy
+	if ( AtomicCompareExchange( m_Raising, 0, 0 ) != 0 )
+	{
+		return;
+	}
+
+	while ( m_Retired )
+	{
+		Snapshot* retired = m_Retired;
+		m_Retired = retired->m_NextRetired;
+		FreeSnapshot( retired );
+	}
+
+	for ( typename std::vector< Delegate* >::const_iterator itr = m_RetiredCopies.begin(), end = m_RetiredCopies.end(); itr != end; ++itr )
+	{
+		delete *itr;
+	}
+	m_RetiredCopies.clear();
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::ConcurrentEvent()
+	: m_State( NULL )
+{
+
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::~ConcurrentEvent()
+{
+	State* state = m_State;
+	if ( state )
+	{
+		// the delegates are going away with us, everything but the snapshot a Raise is still walking
+		state->m_Lock.Lock();
+		Snapshot* snapshot = state->m_Snapshot;
+		if ( snapshot )
+		{
+			Entry* entries = snapshot->GetEntries();
+			for ( uint32_t i = 0; i < snapshot->m_Count; ++i )
+			{
+				if ( entries[ i ].m_Copy )
+				{
+					state->m_RetiredCopies.push_back( entries[ i ].m_Copy );
+				}
+			}
+		}
+
+		state->m_Lock.Unlock();
+
+		// counted as a Raise while orphaning, so exactly one of us (or a Raise in progress) sees the count reach zero
+		AtomicIncrement( state->m_Raising );
+		AtomicExchange( state->m_Orphaned, 1 );
+		if ( AtomicDecrement( state->m_Raising ) == 0 )
+		{
+			delete state;
+		}
+	}
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+uint32_t Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Count() const
+{
+	State* state = m_State;
+	return state ? static_cast< uint32_t >( state->m_Count ) : 0;
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+bool Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Valid() const
+{
+	return Count() > 0;
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Add( const Delegate& delegate )
+{
+	// the copy is only made if the delegate isn't already there
+	Entry entry;
+	entry.m_Copy = const_cast< Delegate* >( &delegate );
+	entry.m_Removed = 0;
+	Insert( entry );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Add( const InlineDelegate& delegate )
+{
+	Entry entry;
+	entry.m_Delegate = delegate;
+	entry.m_Copy = NULL;
+	entry.m_Removed = 0;
+	Insert( entry );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+template < typename FunctionType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::AddFunction( FunctionType function )
+{
+	Add( InlineDelegate( function ) );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+template < class ClassType, typename MethodType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::AddMethod( ClassType* instance, MethodType method )
+{
+	Add( InlineDelegate( instance, method ) );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Remove( const Delegate& delegate )
+{
+	Erase( NULL, &delegate );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Remove( const InlineDelegate& delegate )
+{
+	Erase( &delegate, NULL );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+template < typename FunctionType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::RemoveFunction( FunctionType function )
+{
+	Remove( InlineDelegate( function ) );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+template < class ClassType, typename MethodType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::RemoveMethod( const ClassType* instance, MethodType method )
+{
+	Remove( InlineDelegate( const_cast< ClassType* >( instance ), method ) );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Raise( ArgsType parameter )
+{
+	Raise< InlineDelegate >( parameter, NULL );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::RaiseWithEmitter( ArgsType parameter, const Delegate& emitter )
+{
+	Raise< Delegate >( parameter, emitter.Valid() ? &emitter : NULL );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::RaiseWithEmitter( ArgsType parameter, const InlineDelegate& emitter )
+{
+	Raise< InlineDelegate >( parameter, emitter.Valid() ? &emitter : NULL );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+typename Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Snapshot* Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::AllocateSnapshot( uint32_t count )
+{
+	Snapshot* snapshot = reinterpret_cast< Snapshot* >( new char[ sizeof( Snapshot ) + count * sizeof( Entry ) ] );
+	snapshot->m_Count = count;
+	snapshot->m_NextRetired = NULL;
+	return snapshot;
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::FreeSnapshot( Snapshot* snapshot )
+{
+	delete[] reinterpret_cast< char* >( snapshot );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Insert( const Entry& entry )
+{
+	State* state = m_State;
+	if ( !state )
+	{
+		State* created = new State ();
+		state = static_cast< State* >( AtomicCompareExchangePointer( reinterpret_cast< void* volatile & >( m_State ), created, NULL ) );
+		if ( state )
+		{
+			delete created;
+		}
+		else
+		{
+			state = created;
+		}
+	}
+
+	ScopeSpinLock lock ( state->m_Lock );
+
+	Snapshot* current = state->m_Snapshot;
+	uint32_t count = current ? current->m_Count : 0;
+	for ( uint32_t i = 0; i < count; ++i )
+	{
+		const Entry& existing = current->GetEntries()[ i ];
+		if ( entry.m_Copy ? existing.m_Copy && existing.m_Copy->Equals( *entry.m_Copy ) : !existing.m_Copy && existing.m_Delegate.Equals( entry.m_Delegate ) )
+		{
+			return;
+		}
+	}
+
+	Snapshot* snapshot = AllocateSnapshot( count + 1 );
+	Entry* entries = snapshot->GetEntries();
+	for ( uint32_t i = 0; i < count; ++i )
+	{
+		entries[ i ] = current->GetEntries()[ i ];
+	}
+
+	entries[ count ] = entry;
+	if ( entry.m_Copy )
+	{
+		entries[ count ].m_Copy = new Delegate ( *entry.m_Copy );
+	}
+
+	state->Publish( snapshot );
+	state->Reclaim();
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Erase( const InlineDelegate* inlineDelegate, const Delegate* delegate )
+{
+	State* state = m_State;
+	if ( !state )
+	{
+		return;
+	}
+
+	ScopeSpinLock lock ( state->m_Lock );
+
+	Snapshot* current = state->m_Snapshot;
+	uint32_t count = current ? current->m_Count : 0;
+	uint32_t found = count;
+	for ( uint32_t i = 0; i < count && found == count; ++i )
+	{
+		const Entry& existing = current->GetEntries()[ i ];
+		if ( delegate ? existing.m_Copy && existing.m_Copy->Equals( *delegate ) : !existing.m_Copy && existing.m_Delegate.Equals( *inlineDelegate ) )
+		{
+			found = i;
+		}
+	}
+
+	if ( found == count )
+	{
+		return;
+	}
+
+	// a Raise walking this (or an older) snapshot must not call the delegate once it is removed
+	Entry& removed = current->GetEntries()[ found ];
+	for ( Snapshot* snapshot = current; snapshot; snapshot = ( snapshot == current ? state->m_Retired : snapshot->m_NextRetired ) )
+	{
+		Entry* entries = snapshot->GetEntries();
+		for ( uint32_t i = 0; i < snapshot->m_Count; ++i )
+		{
+			if ( entries[ i ].m_Copy == removed.m_Copy && entries[ i ].m_Delegate.Equals( removed.m_Delegate ) )
+			{
+				AtomicExchange( entries[ i ].m_Removed, 1 );
+			}
+		}
+	}
+
+	if ( removed.m_Copy )
+	{
+		state->m_RetiredCopies.push_back( removed.m_Copy );
+	}
+
+	Snapshot* snapshot = NULL;
+	if ( count > 1 )
+	{
+		snapshot = AllocateSnapshot( count - 1 );
+		Entry* entries = snapshot->GetEntries();
+		for ( uint32_t i = 0, j = 0; i < count; ++i )
+		{
+			if ( i != found )
+			{
+				entries[ j ] = current->GetEntries()[ i ];
+				entries[ j++ ].m_Removed = 0;
+			}
+		}
+	}
+
+	state->Publish( snapshot );
+	state->Reclaim();
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+template< class EmitterType >
+void Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::Raise( ArgsType parameter, const EmitterType* emitter )
+{
+	State* state = m_State;
+	if ( !state )
+	{
+		return;
+	}
+
+	// announce the Raise before reading the snapshot, see State::Reclaim
+	AtomicIncrement( state->m_Raising );
+
+	Snapshot* snapshot = state->m_Snapshot;
+	if ( snapshot )
+	{
+		Entry* entries = snapshot->GetEntries();
+		for ( uint32_t i = 0, count = snapshot->m_Count; i < count; ++i )
+		{
+			const Entry& entry = entries[ i ];
+			if ( entry.m_Removed || ( emitter && IsEmitter( entry, emitter ) ) )
+			{
+				continue;
+			}
+
+			if ( entry.m_Copy )
+			{
+				entry.m_Copy->Invoke( parameter );
+			}
+			else
+			{
+				entry.m_Delegate.m_Thunk( entry.m_Delegate, parameter );
+			}
+		}
+	}
+
+	if ( AtomicDecrement( state->m_Raising ) == 0 && state->m_Orphaned )
+	{
+		// the event was destroyed by one of its delegates
+		delete state;
+	}
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+bool Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::IsEmitter( const Entry& entry, const InlineDelegate* emitter )
+{
+	return !entry.m_Copy && entry.m_Delegate.Equals( *emitter );
+}
+
+template< typename ArgsType, template< typename T > class RefCountBaseType >
+bool Helium::ConcurrentEvent< ArgsType, RefCountBaseType >::IsEmitter( const Entry& entry, const Delegate* emitter )
+{
+	return entry.m_Copy && entry.m_Copy->Equals( *emitter );
+}
@@ -0,0 +1,51 @@
+#include "Precompile.h"
+#include "Foundation/Event.h"
+#include "Foundation/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::FoundationTests;
+
+// prints the time to raise an Event and a ConcurrentEvent to the same listeners, the Event tests check delivery
+TEST(Foundation, ConcurrentEventBenchmark)
+{
+	const uint32_t listenerCount = 8;
+	const uint32_t raiseCount = 1000000;
+
+	EventCounter counters[ listenerCount ];
+	EventTestSignature::Event event;
+	EventTestSignature::ConcurrentEvent concurrentEvent;
+	for ( uint32_t i = 0; i < listenerCount; ++i )
+	{
+		event.AddMethod( &counters[ i ], &EventCounter::Tally );
+		concurrentEvent.AddMethod( &counters[ i ], &EventCounter::Tally );
+	}
+
+	EventTestArgs args ( 1 );
+	uint64_t start = Timer::GetTickCount();
+	for ( uint32_t i = 0; i < raiseCount; ++i )
+	{
+		event.Raise( args );
+	}
+	float64_t eventMilliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	start = Timer::GetTickCount();
+	for ( uint32_t i = 0; i < raiseCount; ++i )
+	{
+		concurrentEvent.Raise( args );
+	}
+	float64_t concurrentMilliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	for ( uint32_t i = 0; i < listenerCount; ++i )
+	{
+		EXPECT_EQ( raiseCount * 2, counters[ i ].m_Sum );
+		event.RemoveMethod( &counters[ i ], &EventCounter::Tally );
+		concurrentEvent.RemoveMethod( &counters[ i ], &EventCounter::Tally );
+	}
+
+	printf( "%u raises to %u listeners: Event %.2fms, ConcurrentEvent %.2fms\n",
+		raiseCount, listenerCount, eventMilliseconds, concurrentMilliseconds );
+}
@@ -0,0 +1,273 @@
+#include "Precompile.h"
+#include "Foundation/Event.h"
+#include "Foundation/TestUtilities.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::FoundationTests;
+
+namespace
+{
+	uint32_t g_FunctionCalls = 0;
+
+	void CountFunction( const EventTestArgs& args )
+	{
+		++g_FunctionCalls;
+	}
+
+	// changes the event it listens to while it is being raised
+	struct EventMutator
+	{
+		EventTestSignature::ConcurrentEvent* m_Event;
+		EventCounter*                        m_Removes;
+		EventCounter*                        m_Adds;
+		uint32_t                             m_Calls;
+
+		EventMutator()
+			: m_Event( NULL )
+			, m_Removes( NULL )
+			, m_Adds( NULL )
+			, m_Calls( 0 )
+		{
+		}
+
+		void Mutate( const EventTestArgs& args )
+		{
+			++m_Calls;
+			if ( m_Removes )
+			{
+				m_Event->RemoveMethod( m_Removes, &EventCounter::Count );
+			}
+			if ( m_Adds )
+			{
+				m_Event->AddMethod( m_Adds, &EventCounter::Count );
+			}
+		}
+
+		void Destroy( const EventTestArgs& args )
+		{
+			++m_Calls;
+			delete m_Event;
+			m_Event = NULL;
+		}
+	};
+
+	// adds and removes its own listener while other threads raise
+	struct EventChurn
+	{
+		EventTestSignature::ConcurrentEvent* m_Event;
+		EventCounter                         m_Counters[ 4 ];
+		uint32_t                             m_Iterations;
+		bool                                 m_Raise;
+		uint32_t                             m_Raised;
+
+		void Run()
+		{
+			for ( uint32_t i = 0; i < m_Iterations; ++i )
+			{
+				if ( m_Raise )
+				{
+					m_Event->Raise( EventTestArgs( 1 ) );
+					++m_Raised;
+					continue;
+				}
+
+				EventCounter* counter = &m_Counters[ i % 4 ];
+				if ( i % 3 == 0 )
+				{
+					m_Event->Add( EventTestSignature::Delegate( counter, &EventCounter::Count ) );
+					m_Event->Remove( EventTestSignature::Delegate( counter, &EventCounter::Count ) );
+				}
+				else
+				{
+					m_Event->AddMethod( counter, &EventCounter::Count );
+					m_Event->RemoveMethod( counter, &EventCounter::Count );
+				}
+			}
+		}
+	};
+
+	// asks the event about its listeners while other threads change them
+	struct EventQuery
+	{
+		EventTestSignature::ConcurrentEvent* m_Event;
+		int32_t volatile                     m_Stop;
+		uint32_t                             m_Queries;
+		uint32_t                             m_Invalid;
+		uint32_t                             m_MaxCount;
+
+		void Run()
+		{
+			while ( !m_Stop )
+			{
+				if ( !m_Event->Valid() )
+				{
+					++m_Invalid;
+				}
+
+				m_MaxCount = std::max( m_MaxCount, m_Event->Count() );
+				++m_Queries;
+			}
+		}
+	};
+}
+
+TEST(Foundation, ConcurrentEventAddRemove)
+{
+	EventTestSignature::ConcurrentEvent event;
+	EXPECT_FALSE( event.Valid() );
+	event.Raise( EventTestArgs( 1 ) );
+
+	EventCounter inlined, delegated, emitter;
+	g_FunctionCalls = 0;
+
+	// duplicates are ignored, the same way Event ignores them
+	event.AddMethod( &inlined, &EventCounter::Count );
+	event.AddMethod( &inlined, &EventCounter::Count );
+	event.AddFunction( &CountFunction );
+	event.Add( EventTestSignature::Delegate( &delegated, &EventCounter::Count ) );
+	event.Add( EventTestSignature::Delegate( &delegated, &EventCounter::Count ) );
+	event.AddMethod( &emitter, &EventCounter::Count );
+	EXPECT_EQ( 4u, event.Count() );
+
+	event.Raise( EventTestArgs( 3 ) );
+	EXPECT_EQ( 1, inlined.m_Calls );
+	EXPECT_EQ( 3u, inlined.m_Sum );
+	EXPECT_EQ( 1, delegated.m_Calls );
+	EXPECT_EQ( 1u, g_FunctionCalls );
+
+	// the emitter doesn't hear about its own change
+	event.RaiseWithEmitter( EventTestArgs( 1 ), EventTestSignature::InlineDelegate( &emitter, &EventCounter::Count ) );
+	EXPECT_EQ( 2, inlined.m_Calls );
+	EXPECT_EQ( 1, emitter.m_Calls );
+
+	event.RemoveMethod( &inlined, &EventCounter::Count );
+	event.RemoveFunction( &CountFunction );
+	event.Remove( EventTestSignature::Delegate( &delegated, &EventCounter::Count ) );
+	EXPECT_EQ( 1u, event.Count() );
+
+	event.Raise( EventTestArgs( 1 ) );
+	EXPECT_EQ( 2, inlined.m_Calls );
+	EXPECT_EQ( 2, delegated.m_Calls );
+	EXPECT_EQ( 2u, g_FunctionCalls );
+	EXPECT_EQ( 2, emitter.m_Calls );
+}
+
+TEST(Foundation, ConcurrentEventChangedDuringRaise)
+{
+	EventTestSignature::ConcurrentEvent event;
+	EventCounter removed, added;
+	EventMutator mutator;
+	mutator.m_Event = &event;
+	mutator.m_Removes = &removed;
+	mutator.m_Adds = &added;
+
+	// a delegate removed while raising is not called, one added while raising waits for the next Raise
+	event.AddMethod( &mutator, &EventMutator::Mutate );
+	event.AddMethod( &removed, &EventCounter::Count );
+	event.Raise( EventTestArgs( 1 ) );
+	EXPECT_EQ( 1u, mutator.m_Calls );
+	EXPECT_EQ( 0, removed.m_Calls );
+	EXPECT_EQ( 0, added.m_Calls );
+
+	event.Raise( EventTestArgs( 1 ) );
+	EXPECT_EQ( 1, added.m_Calls );
+	EXPECT_EQ( 2u, event.Count() );
+
+	// the event (usually along with its owner) can be destroyed by one of its delegates
+	EventMutator destroyer;
+	destroyer.m_Event = new EventTestSignature::ConcurrentEvent ();
+	destroyer.m_Event->AddMethod( &destroyer, &EventMutator::Destroy );
+	destroyer.m_Event->Add( EventTestSignature::Delegate( &removed, &EventCounter::Count ) );
+	destroyer.m_Event->Raise( EventTestArgs( 1 ) );
+	EXPECT_EQ( 1u, destroyer.m_Calls );
+	EXPECT_TRUE( destroyer.m_Event == NULL );
+}
+
+TEST(Foundation, ConcurrentEventThreads)
+{
+	const uint32_t threadCount = 4;
+	const uint32_t iterations = 20000;
+
+	EventTestSignature::ConcurrentEvent event;
+	EventCounter always;
+	event.AddMethod( &always, &EventCounter::Count );
+
+	EventChurn churns[ threadCount ];
+	CallbackThread threads[ threadCount ];
+	for ( uint32_t i = 0; i < threadCount; ++i )
+	{
+		churns[ i ].m_Event = &event;
+		churns[ i ].m_Iterations = iterations;
+		churns[ i ].m_Raise = i % 2 == 0;
+		churns[ i ].m_Raised = 0;
+
+		CallbackThread::Entry entry = &CallbackThread::EntryHelper< EventChurn, &EventChurn::Run >;
+		ASSERT_TRUE( threads[ i ].Create( entry, &churns[ i ], "Event Churn" ) );
+	}
+
+	uint32_t raised = 0;
+	for ( uint32_t i = 0; i < threadCount; ++i )
+	{
+		threads[ i ].Join();
+		raised += churns[ i ].m_Raised;
+	}
+
+	// every Raise reached the listener that was there the whole time, the churned ones all went away
+	EXPECT_EQ( static_cast< int32_t >( raised ), always.m_Calls );
+	EXPECT_EQ( 1u, event.Count() );
+}
+
+TEST(Foundation, ConcurrentEventQueryThreads)
+{
+	const uint32_t churnCount = 3;
+	const uint32_t iterations = 20000;
+
+	EventTestSignature::ConcurrentEvent event;
+	EventCounter always;
+	event.AddMethod( &always, &EventCounter::Count );
+
+	EventQuery query;
+	query.m_Event = &event;
+	query.m_Stop = 0;
+	query.m_Queries = 0;
+	query.m_Invalid = 0;
+	query.m_MaxCount = 0;
+
+	CallbackThread queryThread;
+	ASSERT_TRUE( queryThread.Create( &CallbackThread::EntryHelper< EventQuery, &EventQuery::Run >, &query, "Event Query" ) );
+
+	// the snapshots replaced by these are freed under the query's feet (unless Count reads them)
+	EventChurn churns[ churnCount ];
+	CallbackThread threads[ churnCount ];
+	for ( uint32_t i = 0; i < churnCount; ++i )
+	{
+		churns[ i ].m_Event = &event;
+		churns[ i ].m_Iterations = iterations;
+		churns[ i ].m_Raise = false;
+		churns[ i ].m_Raised = 0;
+
+		CallbackThread::Entry entry = &CallbackThread::EntryHelper< EventChurn, &EventChurn::Run >;
+		ASSERT_TRUE( threads[ i ].Create( entry, &churns[ i ], "Event Churn" ) );
+	}
+
+	for ( uint32_t i = 0; i < churnCount; ++i )
+	{
+		threads[ i ].Join();
+	}
+
+	AtomicExchange( query.m_Stop, 1 );
+	queryThread.Join();
+
+	// the listener that was there the whole time kept it valid, and each churn adds one listener at a time
+	EXPECT_LT( 0u, query.m_Queries );
+	EXPECT_EQ( 0u, query.m_Invalid );
+	EXPECT_GE( churnCount + 1, query.m_MaxCount );
+	EXPECT_EQ( 1u, event.Count() );
+}
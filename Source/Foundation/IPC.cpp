@@ -2,44 +2,184 @@
 #include "IPC.h"
 
 #include "Platform/Assert.h"
+#include "Platform/Atomic.h"
 #include "Platform/Console.h"
 
 #include "Foundation/String.h"
 
+#include <new>
 #include <string.h>
 
 using namespace Helium;
 using namespace Helium::IPC;
 
+namespace
+{
+	// blocks are pooled in power of two size classes from 64 bytes to 64k, larger blocks go straight to the heap
+	const uint32_t PoolMinShift = 6;
+	const uint32_t PoolClassCount = 11;
+	const uint32_t PoolMaxFree = 256;      // max idle blocks kept per size class
+	const size_t   PoolHeaderSize = 16;    // keeps the returned memory 16 byte aligned
+
+	struct PoolHeader
+	{
+		PoolHeader* m_Next;  // free list link while the block is idle
+		uint32_t    m_Class; // size class, PoolClassCount for blocks that bypass the pool
+	};
+	HELIUM_COMPILE_ASSERT( sizeof( PoolHeader ) <= PoolHeaderSize );
+
+	class BlockPool
+	{
+	public:
+		BlockPool()
+		{
+			MemoryZero( m_Free, sizeof( m_Free ) );
+			MemoryZero( m_FreeCount, sizeof( m_FreeCount ) );
+		}
+
+		~BlockPool()
+		{
+			for ( uint32_t i=0; i<PoolClassCount; i++ )
+			{
+				ScopeSpinLock lock ( m_Locks[i] );
+				while ( m_Free[i] )
+				{
+					PoolHeader* next = m_Free[i]->m_Next;
+					DefaultAllocator().Free( m_Free[i] );
+					m_Free[i] = next;
+				}
+				m_FreeCount[i] = 0;
+			}
+		}
+
+		void* Allocate( size_t size )
+		{
+			uint32_t sizeClass = 0;
+			while ( sizeClass < PoolClassCount && ( static_cast< size_t >( 1 ) << ( sizeClass + PoolMinShift ) ) < size )
+			{
+				sizeClass++;
+			}
+
+			PoolHeader* header = NULL;
+			if ( sizeClass < PoolClassCount )
+			{
+				{
+					ScopeSpinLock lock ( m_Locks[ sizeClass ] );
+					header = m_Free[ sizeClass ];
+					if ( header )
+					{
+						m_Free[ sizeClass ] = header->m_Next;
+						m_FreeCount[ sizeClass ]--;
+					}
+				}
+
+				if ( !header )
+				{
+					header = static_cast< PoolHeader* >( DefaultAllocator().Allocate( PoolHeaderSize + ( static_cast< size_t >( 1 ) << ( sizeClass + PoolMinShift ) ) ) );
+				}
+			}
+			else
+			{
+				header = static_cast< PoolHeader* >( DefaultAllocator().Allocate( PoolHeaderSize + size ) );
+			}
+
+			if ( !header )
+			{
+				return NULL;
+			}
+
+			header->m_Next = NULL;
+			header->m_Class = sizeClass;
+			return reinterpret_cast< uint8_t* >( header ) + PoolHeaderSize;
+		}
+
+		void Free( void* memory )
+		{
+			if ( !memory )
+			{
+				return;
+			}
+
+			PoolHeader* header = reinterpret_cast< PoolHeader* >( static_cast< uint8_t* >( memory ) - PoolHeaderSize );
+			uint32_t sizeClass = header->m_Class;
+			if ( sizeClass < PoolClassCount )
+			{
+				ScopeSpinLock lock ( m_Locks[ sizeClass ] );
+				if ( m_FreeCount[ sizeClass ] < PoolMaxFree )
+				{
+					header->m_Next = m_Free[ sizeClass ];
+					m_Free[ sizeClass ] = header;
+					m_FreeCount[ sizeClass ]++;
+					return;
+				}
+			}
+
+			DefaultAllocator().Free( header );
+		}
+
+	private:
+		SpinLock    m_Locks[ PoolClassCount ];
+		PoolHeader* m_Free[ PoolClassCount ];
+		uint32_t    m_FreeCount[ PoolClassCount ];
+	};
+
+	BlockPool g_MessagePool;
+}
+
 Message::Message(uint32_t id, int32_t trn, uint32_t size, MessageType type)
 	: MessageHeader( id, trn, size, type )
 	, m_Next (NULL)
 	, m_Number (0)
 {
-	if (size)
-	{
-		m_Data = new uint8_t[size];
-	}
-	else
-	{
-		m_Data = 0;
-	}
+	m_Data = AllocateData( size );
 }
 
 Message::~Message()
 {
-	delete[] m_Data;
+	FreeData( m_Data );
 	m_Data = 0;
 }
 
-MessageQueue::MessageQueue()
-	: m_Head (0)
+void* Message::operator new(size_t size)
+{
+	// the pool only comes up empty when the heap behind it does
+	void* memory = g_MessagePool.Allocate( size );
+	if ( !memory )
+	{
+		throw std::bad_alloc ();
+	}
+
+	return memory;
+}
+
+void Message::operator delete(void* ptr)
+{
+	g_MessagePool.Free( ptr );
+}
+
+uint8_t* Message::AllocateData(uint32_t size)
+{
+	return size ? static_cast< uint8_t* >( g_MessagePool.Allocate( size ) ) : NULL;
+}
+
+void Message::FreeData(uint8_t* data)
+{
+	g_MessagePool.Free( data );
+}
+
+MessageQueue::MessageQueue( MessageQueueMode mode )
+	: m_Mode (MessageQueueModes::Locked)
+	, m_Head (0)
 	, m_Tail (0)
 	, m_Count (0)
 	, m_Total (0)
 	, m_MaxLength (0)
+	, m_Stub (0, 0, 0)
+	, m_PushHead (0)
+	, m_Waiting (0)
+	, m_Interrupts (0)
 {
-
+	SetMode( mode );
 }
 
 MessageQueue::~MessageQueue()
@@ -47,9 +187,56 @@ MessageQueue::~MessageQueue()
 	Clear();
 }
 
+void MessageQueue::SetMode(MessageQueueMode mode)
+{
+	HELIUM_ASSERT( m_Count == 0 );
+
+	m_Mode = mode;
+
+	if (m_Mode == MessageQueueModes::LockFree)
+	{
+		// both ends start on the stub
+		m_Stub.m_Next = 0;
+		m_Head = &m_Stub;
+		m_Tail = 0;
+		m_PushHead = &m_Stub;
+	}
+	else
+	{
+		m_Head = 0;
+		m_Tail = 0;
+		m_PushHead = 0;
+	}
+}
+
 void MessageQueue::Add(Message* msg)
 {
 	HELIUM_IPC_SCOPE_TIMER("");
+
+	if (m_Mode == MessageQueueModes::LockFree)
+	{
+		if ( msg )
+		{
+			msg->SetNumber( AtomicIncrement( m_Total ) );
+			PushLockFree( msg );
+
+			// the count must be published after the link, the consumer trusts it to mean a message is reachable
+			AtomicIncrement( m_Count );
+		}
+		else
+		{
+			AtomicIncrement( m_Interrupts );
+		}
+
+		// only pay for the semaphore when the consumer is (or is about to be) asleep
+		if ( !msg || AtomicExchange( m_Waiting, 0 ) )
+		{
+			m_Append.Increment();
+		}
+
+		return;
+	}
+
 	bool shouldIncrement = true;
 
 	if ( msg )
@@ -91,7 +278,7 @@ void MessageQueue::Add(Message* msg)
 		msg->SetNumber( m_Total );
 
 		// if we're over our limit now, then remove the oldest message.
-		if (m_MaxLength > 0 && m_Count > m_MaxLength)
+		if (m_MaxLength > 0 && m_Count > static_cast< int32_t >( m_MaxLength ))
 		{
 			m_Count--;
 			shouldIncrement = false;
@@ -116,6 +303,85 @@ Message* MessageQueue::Remove()
 {
 	HELIUM_IPC_SCOPE_TIMER("");
 
+	if (m_Mode == MessageQueueModes::Locked)
+	{
+		return RemoveLocked();
+	}
+
+	Message* result = 0;
+	RemoveBatch( &result, 1 );
+	return result;
+}
+
+uint32_t MessageQueue::RemoveBatch(Message** messages, uint32_t maxCount)
+{
+	HELIUM_IPC_SCOPE_TIMER("");
+	HELIUM_ASSERT( messages && maxCount );
+
+	if (m_Mode == MessageQueueModes::Locked)
+	{
+		// each message holds a semaphore count, so we can't take more than one per wakeup
+		messages[0] = RemoveLocked();
+		return messages[0] ? 1 : 0;
+	}
+
+	while (1)
+	{
+		uint32_t count = 0;
+
+		{
+			Helium::MutexScopeLock mutex (m_Mutex);
+
+			// the max length is enforced at the consumer end since producers can't pop, the count is
+			//  compared signed because it dips below zero while a producer is between its link and its increment
+			while (m_MaxLength > 0 && m_Count > static_cast< int32_t >( m_MaxLength ))
+			{
+				Message* trash = PopLockFree();
+				if (!trash)
+				{
+					break;
+				}
+
+				AtomicDecrement( m_Count );
+				delete trash;
+			}
+
+			while (count < maxCount)
+			{
+				Message* msg = PopLockFree();
+				if (!msg)
+				{
+					break;
+				}
+
+				messages[count++] = msg;
+			}
+		}
+
+		if (count)
+		{
+			AtomicSubtract( m_Count, static_cast< int32_t >( count ) );
+			return count;
+		}
+
+		if (TakeInterrupt())
+		{
+			return 0;
+		}
+
+		if (m_Count > 0)
+		{
+			// a producer is between linking its message and the one we saw counted, let it finish
+			Thread::Yield();
+			continue;
+		}
+
+		Sleep();
+	}
+}
+
+Message* MessageQueue::RemoveLocked()
+{
 	m_Append.Decrement();
 
 	Helium::MutexScopeLock mutex (m_Mutex);
@@ -141,24 +407,121 @@ Message* MessageQueue::Remove()
 	return result;
 }
 
+void MessageQueue::PushLockFree(Message* msg)
+{
+	msg->m_Next = 0;
+
+	// swing the producer end to us, then link the previous message to us; until the link is
+	//  written the consumer will see the list end at the previous message and wait for us
+	Message* prev = AtomicExchange( m_PushHead, msg );
+	AtomicExchangeRelease( prev->m_Next, msg );
+}
+
+Message* MessageQueue::PopLockFree()
+{
+	Message* head = m_Head;
+	Message* next = head->m_Next;
+
+	if (head == &m_Stub)
+	{
+		if (next == 0)
+		{
+			return 0;
+		}
+
+		// step over the stub
+		m_Head = next;
+		head = next;
+		next = next->m_Next;
+	}
+
+	if (next)
+	{
+		m_Head = next;
+		return head;
+	}
+
+	if (head != m_PushHead)
+	{
+		// a producer has swung m_PushHead but not linked yet
+		return 0;
+	}
+
+	// head is the last message, put the stub behind it so we can take it
+	PushLockFree( &m_Stub );
+
+	next = head->m_Next;
+	if (next)
+	{
+		m_Head = next;
+		return head;
+	}
+
+	return 0;
+}
+
+bool MessageQueue::TakeInterrupt()
+{
+	int32_t interrupts = m_Interrupts;
+	while (interrupts > 0)
+	{
+		int32_t previous = AtomicCompareExchange( m_Interrupts, interrupts - 1, interrupts );
+		if (previous == interrupts)
+		{
+			return true;
+		}
+
+		interrupts = previous;
+	}
+
+	return false;
+}
+
+void MessageQueue::Sleep()
+{
+	// announce we are about to sleep, then check again so a producer racing with us can't be missed
+	AtomicExchange( m_Waiting, 1 );
+
+	if (m_Count > 0 || m_Interrupts > 0)
+	{
+		return;
+	}
+
+	m_Append.Decrement();
+}
+
 void MessageQueue::Clear()
 {
 	HELIUM_IPC_SCOPE_TIMER("");
 
 	Helium::MutexScopeLock mutex (m_Mutex);
 
-	Message* msg = m_Head;
-	while (msg)
+	if (m_Mode == MessageQueueModes::LockFree)
 	{
-		Message* next = msg->m_Next;
-		delete msg;
-		msg = next;
+		while (Message* msg = PopLockFree())
+		{
+			AtomicDecrement( m_Count );
+			delete msg;
+		}
+
+		AtomicExchange( m_Total, 0 );
+		AtomicExchange( m_Interrupts, 0 );
 	}
+	else
+	{
+		Message* msg = m_Head;
+		while (msg)
+		{
+			Message* next = msg->m_Next;
+			delete msg;
+			msg = next;
+		}
 
-	m_Head = 0;
-	m_Tail = 0;
-	m_Count = 0;
-	m_Total = 0;
+		m_Head = 0;
+		m_Tail = 0;
+		m_Count = 0;
+		m_Total = 0;
+	}
 
 	m_Append.Increment();
 	m_Append.Reset();
@@ -166,16 +529,28 @@ void MessageQueue::Clear()
 
 uint32_t MessageQueue::Count()
 {
-	return m_Count;
+	int32_t count = m_Count;
+	return count > 0 ? static_cast< uint32_t >( count ) : 0;
 }
 
 uint32_t MessageQueue::Total()
 {
-	return m_Total;
+	return static_cast< uint32_t >( m_Total );
 }
 
 void MessageQueue::Wait()
 {
+	if (m_Mode == MessageQueueModes::LockFree)
+	{
+		// the semaphore only carries wakeups, so just sleep until there is something to see
+		while (m_Count == 0 && m_Interrupts == 0)
+		{
+			Sleep();
+		}
+
+		return;
+	}
+
 	// this will send the calling thread to sleep, and when it returns the semaphore value will be decremented for *this* thread
 	m_Append.Decrement();
 
@@ -215,6 +590,7 @@ Connection::Connection()
 	, m_ConnectCount (0)
 	, m_RemoteType ( Helium::Platform::GetType() )
 	, m_RemoteEndianness ( Helium::Platform::GetEndianness() )
+	, m_RemoteVersion (PROTOCOL_VERSION)
 	, m_NextTransaction (0)
 {
 	SetState(ConnectionStates::Closed);
@@ -300,10 +676,10 @@ void Connection::SetState(ConnectionState state)
 
 Message* Connection::CreateMessage(uint32_t id, uint32_t size, int32_t trans, MessageType type)
 {
-	HELIUM_ASSERT(m_NextTransaction != 0);
-
 	if (trans == 0)
 	{
+		HELIUM_ASSERT(m_NextTransaction != 0);
+
 		if (m_Server)
 		{
 			trans = m_NextTransaction--;
@@ -377,6 +753,19 @@ void Connection::CleanupThread()
 	// nothing to do by default
 }
 
+bool Connection::WriteMessages(Message** msgs, uint32_t count)
+{
+	for ( uint32_t i=0; i<count; i++ )
+	{
+		if (!WriteMessage(msgs[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool Connection::ReadPump()
 {
 	Message* msg = NULL;
@@ -414,18 +803,22 @@ bool Connection::WritePump()
 {
 	bool result = false;
 
-	Message* msg = m_WriteQueue.Remove();
-	if (msg)
+	Message* batch[ IPC_WRITE_BATCH_SIZE ];
+	uint32_t count = m_WriteQueue.RemoveBatch( batch, IPC_WRITE_BATCH_SIZE );
+	if (count)
 	{
 		// the result will be true unless there was heinous breakage
-		result = WriteMessage(msg);
+		result = WriteMessages(batch, count);
 
+		for ( uint32_t i=0; i<count; i++ )
+		{
 #ifdef IPC_CONNECTION_DEBUG
-		Helium::Print("%s: %s putting message %d, id '%d', transaction '%d', size '%d'\n", result ? "Success" : "Failure", m_Name, msg->GetNumber(), msg->GetID(), msg->GetTransaction(), msg->GetSize());
+			Helium::Print("%s: %s putting message %d, id '%d', transaction '%d', size '%d'\n", result ? "Success" : "Failure", m_Name, batch[i]->GetNumber(), batch[i]->GetID(), batch[i]->GetTransaction(), batch[i]->GetSize());
 #endif
 
-		// free the memory
-		delete msg;
+			// free the memory
+			delete batch[i];
+		}
 	}
 	else
 	{
@@ -586,6 +979,9 @@ void Connection::SendProtocolMessage( uint32_t message )
 	}
 }
 
+// the peer info is a single byte
+HELIUM_COMPILE_ASSERT( Helium::Platform::Types::Count <= 16 && Helium::Platform::Endiannesses::Count <= 2 && PROTOCOL_VERSION < 8 );
+
 bool Connection::ReadPeerInfo()
 {
 	uint8_t byte = 0;
@@ -595,8 +991,10 @@ bool Connection::ReadPeerInfo()
 		return false;
 	}
 
+	// the type is in the low four bits, then the byte order, and the protocol version in the top three
 	m_RemoteType = static_cast<Helium::Platform::Type>( byte & 0xf );
-	m_RemoteEndianness = static_cast<Helium::Platform::Endianness>( byte >> 4 );
+	m_RemoteEndianness = static_cast<Helium::Platform::Endianness>( ( byte >> 4 ) & 0x1 );
+	m_RemoteVersion = byte >> 5;
 	return true;
 }
 
@@ -605,6 +1003,7 @@ bool Connection::WritePeerInfo()
 	uint8_t byte = 0;
 	byte = static_cast<uint8_t>( Helium::Platform::GetType() );
 	byte |= static_cast<uint8_t>( Helium::Platform::GetEndianness() << 4 );
+	byte |= static_cast<uint8_t>( PROTOCOL_VERSION << 5 );
 
 	if (!Write(&byte, sizeof(byte)))
 	{
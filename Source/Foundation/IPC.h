@@ -20,6 +20,9 @@ namespace Helium
 {
 	namespace IPC
 	{
+		// exchanged in the handshake (with the platform type and byte order), peers from before versioning send zero
+		const uint32_t PROTOCOL_VERSION = 1;
+
 		namespace MessageTypes
 		{
 			enum MessageType
@@ -61,7 +64,7 @@ namespace Helium
 			friend class MessageQueue;
 
 		private:
-			Message*	m_Next;
+			Message* volatile m_Next;
 			uint32_t	m_Number;
 			uint8_t*	m_Data;
 
@@ -71,6 +74,13 @@ namespace Helium
 		public:
 			~Message();
 
+			// messages and their payloads are recycled through size-classed pools, so data
+			//  detached with TakeData() must be released with FreeData() rather than delete[]
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr);
+			static uint8_t* AllocateData(uint32_t size);
+			static void FreeData(uint8_t* data);
+
 			uint32_t GetNumber() const
 			{
 				return m_Number;
@@ -114,22 +124,50 @@ namespace Helium
 			}
 		};
 
+		namespace MessageQueueModes
+		{
+			enum MessageQueueMode
+			{
+				Locked,    // linked list guarded by a mutex, the semaphore is signaled for every message
+				LockFree,  // intrusive MPSC list, producers never block and the consumer is only signaled when asleep
+			};
+		}
+		typedef MessageQueueModes::MessageQueueMode MessageQueueMode;
+
+		// max number of messages the write pump drains from the write queue per wakeup
+		const static uint32_t IPC_WRITE_BATCH_SIZE = 64;
+
 		class HELIUM_FOUNDATION_API MessageQueue
 		{
 		private:
+			MessageQueueMode m_Mode;    // how producers and consumers synchronize
 			Message* m_Head;            // pointer to head message 
 			Message* m_Tail;            // pointer to tail message 
-			uint32_t m_Count;           // number of messages in queue
-			uint32_t m_Total;           // number of messages that have passed through the queue since clear
+			volatile int32_t m_Count;   // number of messages in queue
+			volatile int32_t m_Total;   // number of messages that have passed through the queue since clear
 			uint32_t m_MaxLength;       // max allowable number of messages in queue.  A value of zero means unlimited
 
-			Helium::Mutex m_Mutex;      // mutex to control access to the queue
-			Helium::Semaphore m_Append; // semaphore that increments on add, decrements on remove
+			Helium::Mutex m_Mutex;      // mutex to control access to the queue (consumers only when lock free)
+			Helium::Semaphore m_Append; // semaphore that increments on add, decrements on remove (wakeup only when lock free)
+
+			// lock free state, m_Head is the consumer end and m_PushHead is the producer end
+			Message m_Stub;                  // sentinel that keeps the list non-empty
+			Message* volatile m_PushHead;    // most recently pushed message
+			volatile int32_t m_Waiting;      // set by the consumer before it sleeps on m_Append
+			volatile int32_t m_Interrupts;   // pending wakeups requested via Add(NULL)
 
 		public:
-			MessageQueue();
+			MessageQueue( MessageQueueMode mode = MessageQueueModes::Locked );
 			~MessageQueue();
 
+			// the mode may only be changed while the queue is empty and unused by other threads
+			void SetMode(MessageQueueMode mode);
+
+			MessageQueueMode GetMode() const
+			{
+				return m_Mode;
+			}
+
 			void SetMaxLength(uint32_t q)
 			{
 				m_MaxLength = q;
@@ -142,10 +180,22 @@ namespace Helium
 
 			void Add(Message*);
 			Message* Remove();
+
+			// blocks like Remove(), then takes up to maxCount messages without blocking again,
+			//  returns zero if woken without a message (Add(NULL) or Clear())
+			uint32_t RemoveBatch(Message** messages, uint32_t maxCount);
+
 			void Clear();
 			uint32_t Count();
 			uint32_t Total();
 			void Wait();
+
+		private:
+			Message* RemoveLocked();
+			void PushLockFree(Message* msg);
+			Message* PopLockFree();
+			bool TakeInterrupt();
+			void Sleep();
 		};
 		
 		namespace ConnectionStates
@@ -172,6 +222,7 @@ namespace Helium
 			uint32_t                     m_ConnectCount;     // track the number of connection that have occured
 			Helium::Platform::Type       m_RemoteType;       // the platform of the end point on the other side
 			Helium::Platform::Endianness m_RemoteEndianness; // the platform of the end point on the other side
+			uint32_t                     m_RemoteVersion;    // the PROTOCOL_VERSION of the end point on the other side
 			int32_t                      m_NextTransaction;  // next transaction id for this connection endpoint
 
 			Helium::Mutex                m_Mutex;            // mutex to protect access to this class
@@ -199,6 +250,17 @@ namespace Helium
 				m_WriteQueue.SetMaxLength(q);
 			}
 
+			// queue modes must be set before Initialize()
+			void SetReadQueueMode(MessageQueueMode mode)
+			{
+				m_ReadQueue.SetMode(mode);
+			}
+
+			void SetWriteQueueMode(MessageQueueMode mode)
+			{
+				m_WriteQueue.SetMode(mode);
+			}
+
 
 		protected:
 			bool Initialize(bool server, const char* name);
@@ -237,6 +299,11 @@ namespace Helium
 				return m_RemoteEndianness;
 			}
 
+			uint32_t GetRemoteVersion()
+			{
+				return m_RemoteVersion;
+			}
+
 			uint32_t GetConnectCount()
 			{
 				return m_ConnectCount;
@@ -295,6 +362,9 @@ namespace Helium
 			virtual bool ReadMessage(Message** msg) = 0;
 			virtual bool WriteMessage(Message* msg) = 0;
 
+			// Synchronously write a batch of messages, transports that can coalesce writes should override this
+			virtual bool WriteMessages(Message** msgs, uint32_t count);
+
 			// These synchronously read or write data through the connection
 			virtual bool Read(void* buffer, uint32_t bytes) = 0;
 			virtual bool Write(void* buffer, uint32_t bytes) = 0;
@@ -0,0 +1,49 @@
+#include "Precompile.h"
+#include "Foundation/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::IPC;
+using namespace Helium::FoundationTests;
+
+namespace
+{
+	const uint32_t LoopbackMessageCount = 20000;
+
+	void PrintLoopback( const char* label, LoopbackResult& result )
+	{
+		if ( result.m_Latencies.empty() )
+		{
+			return;
+		}
+
+		std::sort( result.m_Latencies.begin(), result.m_Latencies.end() );
+		uint64_t p99 = result.m_Latencies[ result.m_Latencies.size() * 99 / 100 ];
+
+		printf( "IPC loopback (%s): %.0f messages/s, p99 latency %.1f us\n",
+			label,
+			result.m_Latencies.size() / ( result.m_ElapsedMs / 1000.0 ),
+			Timer::TicksToMilliseconds( p99 ) * 1000.0 );
+	}
+}
+
+// prints throughput and p99 latency of each transport, the IPCLoopback tests check delivery and ordering
+TEST(Foundation, IPCLoopbackBenchmark)
+{
+	LoopbackResult result;
+	RunTCPLoopback( MessageQueueModes::Locked, LoopbackPort(), LoopbackMessageCount, result );
+	PrintLoopback( "tcp, locked queues", result );
+
+	RunTCPLoopback( MessageQueueModes::LockFree, LoopbackPort() + 2, LoopbackMessageCount, result );
+	PrintLoopback( "tcp, lock free queues", result );
+
+#if HELIUM_OS_LINUX
+	RunSharedMemoryLoopback( LoopbackMessageCount, result );
+	PrintLoopback( "shared memory, lock free queues", result );
+#endif
+}
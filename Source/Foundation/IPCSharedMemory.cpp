@@ -0,0 +1,641 @@
+#include "Precompile.h"
+#include "IPCSharedMemory.h"
+
+#if HELIUM_OS_LINUX
+
+#include "Platform/Assert.h"
+#include "Platform/Atomic.h"
+#include "Platform/Console.h"
+#include "Platform/Process.h"
+
+#include "Foundation/String.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+using namespace Helium;
+using namespace Helium::IPC;
+
+namespace
+{
+	const uint32_t SharedMemoryMagic = 0x484d5348; // 'HSMH'
+	const uint32_t SharedMemoryVersion = 1;
+	const uint32_t SharedMemorySpinCount = 4000;   // polls of the peer before we go to sleep
+	const uint32_t SharedMemoryWaitMs = 100;       // sleep timeout, bounds how long we take to notice termination
+
+	int FutexWait( volatile int32_t* address, int32_t value, uint32_t timeoutMs )
+	{
+		struct timespec timeout = { static_cast< time_t >( timeoutMs / 1000 ), static_cast< long >( timeoutMs % 1000 ) * 1000000 };
+		return static_cast< int >( syscall( SYS_futex, address, FUTEX_WAIT, value, &timeout, NULL, 0 ) );
+	}
+
+	void FutexWake( volatile int32_t* address )
+	{
+		syscall( SYS_futex, address, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0 );
+	}
+
+	bool IsProcessAlive( int32_t pid )
+	{
+		return pid != 0 && ( kill( pid, 0 ) == 0 || errno == EPERM );
+	}
+}
+
+namespace Helium
+{
+	namespace IPC
+	{
+		// one direction of the connection, producer and consumer fields live on their own cache lines
+		struct SharedMemoryRing
+		{
+			volatile int32_t m_Head;          // total bytes written, only the producer stores this
+			volatile int32_t m_DataSequence;  // bumped after each write, consumers sleep on it
+			volatile int32_t m_DataWaiters;   // consumers asleep on m_DataSequence
+			uint8_t          m_ProducerPad[ 52 ];
+
+			volatile int32_t m_Tail;          // total bytes read, only the consumer stores this
+			volatile int32_t m_SpaceSequence; // bumped after each read, producers sleep on it
+			volatile int32_t m_SpaceWaiters;  // producers asleep on m_SpaceSequence
+			uint8_t          m_ConsumerPad[ 52 ];
+		};
+
+		struct SharedMemoryHeader
+		{
+			uint32_t         m_Magic;
+			uint32_t         m_Version;
+			uint32_t         m_RingSize;
+			volatile int32_t m_ServerProcess;   // pid of the server
+			volatile int32_t m_ClientProcess;   // pid of the attached client, zero when free
+			volatile int32_t m_ServerReady;     // set once the server has reset the session for a new client
+			volatile int32_t m_Closed;          // set by either side to end the session
+			volatile int32_t m_AttachSequence;  // bumped on attach/detach, the server sleeps on it
+			uint8_t          m_Pad[ 32 ];
+
+			SharedMemoryRing m_Rings[ 2 ];      // [0] client to server, [1] server to client
+		};
+	}
+}
+
+HELIUM_COMPILE_ASSERT( sizeof( SharedMemoryRing ) == 128 );
+HELIUM_COMPILE_ASSERT( sizeof( SharedMemoryHeader ) % 64 == 0 );
+
+SharedMemoryConnection::SharedMemoryConnection()
+	: m_RingSize (IPC_SHM_DEFAULT_RING_SIZE)
+	, m_Header (NULL)
+	, m_MappedSize (0)
+	, m_ReadRing (NULL)
+	, m_ReadData (NULL)
+	, m_WriteRing (NULL)
+	, m_WriteData (NULL)
+{
+	m_Segment[0] = '\0';
+}
+
+SharedMemoryConnection::~SharedMemoryConnection()
+{
+	// other threads still need our object's virtual functions, so call this in the derived destructor
+	Cleanup();
+}
+
+bool SharedMemoryConnection::Initialize(bool server, const char* name, const char* segment, uint32_t ringSize)
+{
+	HELIUM_ASSERT( ringSize && ( ringSize & ( ringSize - 1 ) ) == 0 );
+
+	if (!Connection::Initialize( server, name ))
+	{
+		return false;
+	}
+
+	// segment names are a single path component with a leading slash
+	StringPrint( m_Segment, "/%s", segment );
+	m_RingSize = ringSize;
+
+	SetState(ConnectionStates::Waiting);
+
+	Helium::CallbackThread::Entry serverEntry = Helium::CallbackThread::EntryHelper<SharedMemoryConnection, &SharedMemoryConnection::ServerThread>;
+	Helium::CallbackThread::Entry clientEntry = Helium::CallbackThread::EntryHelper<SharedMemoryConnection, &SharedMemoryConnection::ClientThread>;
+	if (!m_ConnectThread.Create(server ? serverEntry : clientEntry, this, "IPC Connection Thread"))
+	{
+		Helium::Print( "%s: Failed to create connect thread\n", m_Name);
+		SetState(ConnectionStates::Failed);
+		return false;
+	}
+
+	return true;
+}
+
+void SharedMemoryConnection::Close()
+{
+	Helium::MutexScopeLock mutex (m_SegmentMutex);
+
+	if (m_Header)
+	{
+		EndSession();
+	}
+}
+
+void SharedMemoryConnection::ServerThread()
+{
+	Helium::Print( "%s: Starting shared memory server (%s)\n", m_Name, m_Segment);
+
+	if (!CreateSegment())
+	{
+		SetState(ConnectionStates::Failed);
+		return;
+	}
+
+	// while the server is still running, cycle through connections
+	while (!m_Terminating)
+	{
+		ResetSession();
+
+		Helium::Print( "%s: Ready for client\n", m_Name);
+
+		// wait for a client to claim the segment
+		while (!m_Terminating)
+		{
+			int32_t sequence = m_Header->m_AttachSequence;
+			if (m_Header->m_ClientProcess)
+			{
+				break;
+			}
+
+			FutexWait( &m_Header->m_AttachSequence, sequence, SharedMemoryWaitMs );
+		}
+
+		if (!m_Terminating)
+		{
+			Helium::Print( "%s: Accepted connection from process %d (%dk/%dk)\n", m_Name, m_Header->m_ClientProcess, m_RingSize >> 10, m_RingSize >> 10);
+
+			// do connection
+			ConnectThread();
+		}
+
+		// make sure the client sees the session end, then wait for it to detach (or die)
+		{
+			Helium::MutexScopeLock mutex (m_SegmentMutex);
+			EndSession();
+		}
+
+		while (!m_Terminating)
+		{
+			int32_t sequence = m_Header->m_AttachSequence;
+			int32_t client = m_Header->m_ClientProcess;
+			if (!client || !IsProcessAlive( client ))
+			{
+				break;
+			}
+
+			FutexWait( &m_Header->m_AttachSequence, sequence, SharedMemoryWaitMs );
+		}
+
+		AtomicExchange( m_Header->m_ClientProcess, 0 );
+
+		if (!m_Terminating)
+		{
+			// reset back to waiting for connections
+			SetState(ConnectionStates::Waiting);
+		}
+	}
+
+	UnmapSegment( true );
+
+	Helium::Print( "%s: Stopping shared memory server (%s)\n", m_Name, m_Segment);
+
+	CleanupThread();
+}
+
+void SharedMemoryConnection::ClientThread()
+{
+	Helium::Print( "%s: Starting shared memory client (%s)\n", m_Name, m_Segment);
+
+	int32_t process = GetProcessId();
+
+	while (!m_Terminating)
+	{
+		Helium::Print( "%s: Ready for server\n", m_Name);
+
+		bool attached = false;
+
+		while (!m_Terminating)
+		{
+			if (OpenSegment())
+			{
+				// claim the segment once the server has prepared a fresh session, checking again after the
+				//  claim in case the server ended the session we saw as ready before it could reset
+				if (m_Header->m_ServerReady && AtomicCompareExchange( m_Header->m_ClientProcess, process, 0 ) == 0)
+				{
+					if (m_Header->m_ServerReady)
+					{
+						AtomicIncrement( m_Header->m_AttachSequence );
+						FutexWake( &m_Header->m_AttachSequence );
+						attached = true;
+						break;
+					}
+
+					AtomicCompareExchange( m_Header->m_ClientProcess, 0, process );
+				}
+
+				UnmapSegment( false );
+			}
+
+			Thread::Sleep( 100 );
+		}
+
+		if (attached)
+		{
+			Helium::Print( "%s: Connection established (%dk/%dk)\n", m_Name, m_RingSize >> 10, m_RingSize >> 10);
+
+			// do connection
+			ConnectThread();
+
+			// end the session for the server, then let it know we are gone
+			{
+				Helium::MutexScopeLock mutex (m_SegmentMutex);
+				EndSession();
+			}
+
+			AtomicCompareExchange( m_Header->m_ClientProcess, 0, process );
+			AtomicIncrement( m_Header->m_AttachSequence );
+			FutexWake( &m_Header->m_AttachSequence );
+
+			UnmapSegment( false );
+		}
+
+		if (!m_Terminating)
+		{
+			// reset back to waiting for connections
+			SetState(ConnectionStates::Waiting);
+		}
+	}
+
+	Helium::Print( "%s: Stopping shared memory client (%s)\n", m_Name, m_Segment);
+
+	CleanupThread();
+}
+
+bool SharedMemoryConnection::CreateSegment()
+{
+	// a previous server may have died without cleaning up
+	shm_unlink( m_Segment );
+
+	int fd = shm_open( m_Segment, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR );
+	if (fd < 0)
+	{
+		Helium::Print( "%s: Failed to create shared memory segment '%s' (%d)\n", m_Name, m_Segment, errno);
+		return false;
+	}
+
+	size_t size = sizeof( SharedMemoryHeader ) + 2 * static_cast< size_t >( m_RingSize );
+	if (ftruncate( fd, size ) != 0)
+	{
+		Helium::Print( "%s: Failed to size shared memory segment '%s' (%d)\n", m_Name, m_Segment, errno);
+		close( fd );
+		shm_unlink( m_Segment );
+		return false;
+	}
+
+	void* memory = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+
+	if (memory == MAP_FAILED)
+	{
+		Helium::Print( "%s: Failed to map shared memory segment '%s' (%d)\n", m_Name, m_Segment, errno);
+		shm_unlink( m_Segment );
+		return false;
+	}
+
+	// new segments are zero filled
+	SharedMemoryHeader* header = static_cast< SharedMemoryHeader* >( memory );
+	header->m_Version = SharedMemoryVersion;
+	header->m_RingSize = m_RingSize;
+	header->m_ServerProcess = GetProcessId();
+
+	// clients check the magic last
+	AtomicExchangeRelease( reinterpret_cast< volatile int32_t& >( header->m_Magic ), static_cast< int32_t >( SharedMemoryMagic ) );
+
+	Helium::MutexScopeLock mutex (m_SegmentMutex);
+	m_Header = header;
+	m_MappedSize = size;
+	m_ReadRing = &header->m_Rings[ 0 ];
+	m_WriteRing = &header->m_Rings[ 1 ];
+	m_ReadData = reinterpret_cast< uint8_t* >( header + 1 );
+	m_WriteData = m_ReadData + m_RingSize;
+
+	return true;
+}
+
+bool SharedMemoryConnection::OpenSegment()
+{
+	int fd = shm_open( m_Segment, O_RDWR, 0 );
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat( fd, &info ) != 0 || static_cast< size_t >( info.st_size ) < sizeof( SharedMemoryHeader ))
+	{
+		close( fd );
+		return false;
+	}
+
+	size_t size = static_cast< size_t >( info.st_size );
+	void* memory = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+
+	if (memory == MAP_FAILED)
+	{
+		return false;
+	}
+
+	SharedMemoryHeader* header = static_cast< SharedMemoryHeader* >( memory );
+	if (header->m_Magic != SharedMemoryMagic || header->m_Version != SharedMemoryVersion || size < sizeof( SharedMemoryHeader ) + 2 * static_cast< size_t >( header->m_RingSize ))
+	{
+		munmap( memory, size );
+		return false;
+	}
+
+	Helium::MutexScopeLock mutex (m_SegmentMutex);
+	m_Header = header;
+	m_MappedSize = size;
+	m_RingSize = header->m_RingSize;
+	m_ReadRing = &header->m_Rings[ 1 ];
+	m_WriteRing = &header->m_Rings[ 0 ];
+	m_WriteData = reinterpret_cast< uint8_t* >( header + 1 );
+	m_ReadData = m_WriteData + m_RingSize;
+
+	return true;
+}
+
+void SharedMemoryConnection::UnmapSegment(bool unlink)
+{
+	Helium::MutexScopeLock mutex (m_SegmentMutex);
+
+	if (m_Header)
+	{
+		munmap( m_Header, m_MappedSize );
+		m_Header = NULL;
+		m_MappedSize = 0;
+		m_ReadRing = m_WriteRing = NULL;
+		m_ReadData = m_WriteData = NULL;
+	}
+
+	if (unlink)
+	{
+		shm_unlink( m_Segment );
+	}
+}
+
+void SharedMemoryConnection::ResetSession()
+{
+	// only the server does this, and only while no client is attached
+	for ( uint32_t i=0; i<2; i++ )
+	{
+		SharedMemoryRing& ring = m_Header->m_Rings[i];
+		ring.m_Head = 0;
+		ring.m_Tail = 0;
+		ring.m_DataWaiters = 0;
+		ring.m_SpaceWaiters = 0;
+	}
+
+	AtomicExchange( m_Header->m_Closed, 0 );
+	AtomicExchange( m_Header->m_ServerReady, 1 );
+}
+
+void SharedMemoryConnection::EndSession()
+{
+	AtomicExchange( m_Header->m_ServerReady, 0 );
+	AtomicExchange( m_Header->m_Closed, 1 );
+
+	// wake anyone asleep in either direction so they notice
+	for ( uint32_t i=0; i<2; i++ )
+	{
+		SharedMemoryRing& ring = m_Header->m_Rings[i];
+		AtomicIncrement( ring.m_DataSequence );
+		AtomicIncrement( ring.m_SpaceSequence );
+		FutexWake( &ring.m_DataSequence );
+		FutexWake( &ring.m_SpaceSequence );
+	}
+
+	AtomicIncrement( m_Header->m_AttachSequence );
+	FutexWake( &m_Header->m_AttachSequence );
+}
+
+bool SharedMemoryConnection::IsSessionOpen()
+{
+	return !m_Terminating && !m_Header->m_Closed;
+}
+
+bool SharedMemoryConnection::WaitForPeer(volatile int32_t& sequence, volatile int32_t& waiters, int32_t observed)
+{
+	if (!IsSessionOpen())
+	{
+		return false;
+	}
+
+	// the peer is usually running on another core and about to make progress
+	for ( uint32_t i=0; i<SharedMemorySpinCount; i++ )
+	{
+		if (sequence != observed)
+		{
+			return true;
+		}
+	}
+
+	AtomicIncrement( waiters );
+
+	if (FutexWait( &sequence, observed, SharedMemoryWaitMs ) != 0 && errno == ETIMEDOUT)
+	{
+		// nothing for a while, make sure the other side is still there
+		int32_t peer = m_Server ? m_Header->m_ClientProcess : m_Header->m_ServerProcess;
+		if (!IsProcessAlive( peer ))
+		{
+			AtomicExchange( m_Header->m_Closed, 1 );
+		}
+	}
+
+	AtomicDecrement( waiters );
+
+	return IsSessionOpen();
+}
+
+bool SharedMemoryConnection::ReadMessage(Message** msg)
+{
+	HELIUM_IPC_SCOPE_TIMER("");
+
+	if (!Read(&m_ReadHeader, sizeof(m_ReadHeader)))
+	{
+#ifdef IPC_SHM_DEBUG
+		Helium::Print("%s: Failed to read message header\n", m_Name);
+#endif
+		return false;
+	}
+
+	// both ends are on this machine, so there is nothing to swizzle
+
+	IPC::Message* message = CreateMessage(m_ReadHeader.m_ID, m_ReadHeader.m_Size, m_ReadHeader.m_TRN, m_ReadHeader.m_Type);
+
+	// out of memory condition
+	if ( message == NULL )
+	{
+		Helium::Print( "%s: Failed to allocate memory for message\n", m_Name);
+		return false;
+	}
+
+	uint8_t* data = message->GetData();
+
+	// out of memory condition #2
+	if ( m_ReadHeader.m_Size > 0 && data == NULL )
+	{
+		Helium::Print( "%s: Failed to allocate memory for message data\n", m_Name);
+		delete message;
+		return false;
+	}
+
+	if (!Read(data, m_ReadHeader.m_Size))
+	{
+#ifdef IPC_SHM_DEBUG
+		Helium::Print("%s: Failed to read message data\n", m_Name);
+#endif
+		delete message;
+		return false;
+	}
+
+	*msg = message;
+
+	return true;
+}
+
+bool SharedMemoryConnection::WriteMessage(Message* msg)
+{
+	HELIUM_IPC_SCOPE_TIMER("");
+
+	m_WriteHeader.m_ID = msg->GetID();
+	m_WriteHeader.m_TRN = msg->GetTransaction();
+	m_WriteHeader.m_Size = msg->GetSize();
+	m_WriteHeader.m_Type = msg->GetType();
+
+	if (!Write( &m_WriteHeader, sizeof( m_WriteHeader ) ))
+	{
+#ifdef IPC_SHM_DEBUG
+		Helium::Print("%s: Failed to write message header\n", m_Name);
+#endif
+		return false;
+	}
+
+	if (!Write( msg->GetData(), msg->GetSize() ))
+	{
+#ifdef IPC_SHM_DEBUG
+		Helium::Print("%s: Failed to write message data\n", m_Name);
+#endif
+		return false;
+	}
+
+	return true;
+}
+
+bool SharedMemoryConnection::Read(void* buffer, uint32_t bytes)
+{
+	SharedMemoryRing& ring = *m_ReadRing;
+	uint32_t mask = m_RingSize - 1;
+
+	while (bytes > 0)
+	{
+		// observe the sequence before the head so a write that lands in between can't be slept through
+		int32_t sequence = ring.m_DataSequence;
+		uint32_t tail = static_cast< uint32_t >( ring.m_Tail );
+		// acquire pairs with the producer's release of m_Head, so the bytes it wrote are visible before we copy them
+		uint32_t head = static_cast< uint32_t >( AtomicCompareExchangeAcquire( ring.m_Head, 0, 0 ) );
+		uint32_t available = head - tail;
+
+		if (available == 0)
+		{
+			if (!WaitForPeer( ring.m_DataSequence, ring.m_DataWaiters, sequence ))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		uint32_t count = std::min<uint32_t>( bytes, available );
+		uint32_t offset = tail & mask;
+		uint32_t first = std::min<uint32_t>( count, m_RingSize - offset );
+		memcpy( buffer, m_ReadData + offset, first );
+		memcpy( static_cast< uint8_t* >( buffer ) + first, m_ReadData, count - first );
+
+		// hand the space back to the producer
+		AtomicExchangeRelease( ring.m_Tail, static_cast< int32_t >( tail + count ) );
+		AtomicIncrement( ring.m_SpaceSequence );
+		if (ring.m_SpaceWaiters)
+		{
+			FutexWake( &ring.m_SpaceSequence );
+		}
+
+		bytes -= count;
+		buffer = static_cast< uint8_t* >( buffer ) + count;
+	}
+
+	return true;
+}
+
+bool SharedMemoryConnection::Write(void* buffer, uint32_t bytes)
+{
+	SharedMemoryRing& ring = *m_WriteRing;
+	uint32_t mask = m_RingSize - 1;
+
+	while (bytes > 0)
+	{
+		if (!IsSessionOpen())
+		{
+			return false;
+		}
+
+		// observe the sequence before the tail so a read that lands in between can't be slept through
+		int32_t sequence = ring.m_SpaceSequence;
+		uint32_t head = static_cast< uint32_t >( ring.m_Head );
+		// acquire pairs with the consumer's release of m_Tail, so it is done copying out before we overwrite
+		uint32_t tail = static_cast< uint32_t >( AtomicCompareExchangeAcquire( ring.m_Tail, 0, 0 ) );
+		uint32_t space = m_RingSize - ( head - tail );
+
+		if (space == 0)
+		{
+			if (!WaitForPeer( ring.m_SpaceSequence, ring.m_SpaceWaiters, sequence ))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		uint32_t count = std::min<uint32_t>( bytes, space );
+		uint32_t offset = head & mask;
+		uint32_t first = std::min<uint32_t>( count, m_RingSize - offset );
+		memcpy( m_WriteData + offset, buffer, first );
+		memcpy( m_WriteData, static_cast< const uint8_t* >( buffer ) + first, count - first );
+
+		// publish the data to the consumer
+		AtomicExchangeRelease( ring.m_Head, static_cast< int32_t >( head + count ) );
+		AtomicIncrement( ring.m_DataSequence );
+		if (ring.m_DataWaiters)
+		{
+			FutexWake( &ring.m_DataSequence );
+		}
+
+		bytes -= count;
+		buffer = static_cast< uint8_t* >( buffer ) + count;
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Platform/System.h"
+
+#include "Foundation/IPC.h"
+
+// Debug printing
+//#define IPC_SHM_DEBUG
+
+#if HELIUM_OS_LINUX
+
+namespace Helium
+{
+	namespace IPC
+	{
+		// size of each direction's ring, must be a power of two
+		const static uint32_t IPC_SHM_DEFAULT_RING_SIZE = 4 << 20;
+
+		struct SharedMemoryHeader;
+		struct SharedMemoryRing;
+
+		//
+		// Same-host transport, each direction is a single producer single consumer byte ring in a POSIX shared
+		//  memory segment created by the server.  Blocked readers and writers sleep on futexes in the segment, so
+		//  a message costs two memcpys and (only when the other side is asleep) a wake syscall.
+		//
+		class HELIUM_FOUNDATION_API SharedMemoryConnection : public Connection
+		{
+		private:
+			char                m_Segment[256];  // name of the shared memory segment
+			uint32_t            m_RingSize;      // bytes in each ring, power of two
+
+			Helium::Mutex       m_SegmentMutex;  // guards mapping and unmapping against Close()
+			SharedMemoryHeader* m_Header;        // mapped segment
+			size_t              m_MappedSize;    // bytes mapped
+			SharedMemoryRing*   m_ReadRing;      // ring we consume
+			uint8_t*            m_ReadData;      // ring we consume's storage
+			SharedMemoryRing*   m_WriteRing;     // ring we produce
+			uint8_t*            m_WriteData;     // ring we produce's storage
+
+		public:
+			SharedMemoryConnection();
+			virtual ~SharedMemoryConnection();
+
+		public:
+			bool Initialize(bool server, const char* name, const char* segment, uint32_t ringSize = IPC_SHM_DEFAULT_RING_SIZE);
+			void Close();
+
+		protected:
+			void ServerThread();
+			void ClientThread();
+
+			bool CreateSegment();
+			bool OpenSegment();
+			void UnmapSegment(bool unlink);
+			void ResetSession();
+			void EndSession();
+			bool IsSessionOpen();
+			bool WaitForPeer(volatile int32_t& sequence, volatile int32_t& waiters, int32_t observed);
+
+			virtual bool ReadMessage(Message** msg);
+			virtual bool WriteMessage(Message* msg);
+			virtual bool Read(void* buffer, uint32_t bytes);
+			virtual bool Write(void* buffer, uint32_t bytes);
+		};
+	}
+}
+
+#endif
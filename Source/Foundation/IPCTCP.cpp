@@ -26,6 +26,8 @@ struct timeval g_TimeoutWaiting = {0, 17000};
 TCPConnection::TCPConnection()
 	: m_ReadPort (0)
 	, m_WritePort (0)
+	, m_ReadBufferStart (0)
+	, m_ReadBufferEnd (0)
 {
 	m_IP[0] = '\0';
 }
@@ -178,6 +180,9 @@ void TCPConnection::ServerThread()
 			HELIUM_VERIFY( 0 == setsockopt(m_WriteSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&flag, sizeof(int)) );
 #endif
 
+			// drop anything buffered from the last connection
+			m_ReadBufferStart = m_ReadBufferEnd = 0;
+
 			// do connection
 			ConnectThread();
 		}
@@ -272,6 +277,9 @@ void TCPConnection::ClientThread()
 			HELIUM_VERIFY( 0 == setsockopt(m_WriteSocket, IPPROTO_TCP, TCP_NODELAY, (const char*) &flag, sizeof(int)) );
 #endif
 
+			// drop anything buffered from the last connection
+			m_ReadBufferStart = m_ReadBufferEnd = 0;
+
 			// do connection
 			ConnectThread();
 		}
@@ -363,41 +371,90 @@ bool TCPConnection::ReadMessage(Message** msg)
 }
 
 bool TCPConnection::WriteMessage(Message* msg)
+{
+	return WriteMessages(&msg, 1);
+}
+
+bool TCPConnection::WriteMessages(Message** msgs, uint32_t count)
 {
 	HELIUM_IPC_SCOPE_TIMER("");
+	HELIUM_ASSERT( count <= IPC_WRITE_BATCH_SIZE );
 
-	m_WriteHeader.m_ID = msg->GetID();
-	m_WriteHeader.m_TRN = msg->GetTransaction();
-	m_WriteHeader.m_Size = msg->GetSize();
-	m_WriteHeader.m_Type = msg->GetType();
+	// gather every header and payload in the batch so they go out in as few calls as possible
+	SocketBuffer buffers[ IPC_WRITE_BATCH_SIZE * 2 ];
+	uint32_t bufferCount = 0;
+
+	for ( uint32_t i=0; i<count; i++ )
+	{
+		Message* msg = msgs[i];
+		MessageHeader& header = m_WriteHeaders[i];
+
+		header.m_ID = msg->GetID();
+		header.m_TRN = msg->GetTransaction();
+		header.m_Size = msg->GetSize();
+		header.m_Type = msg->GetType();
 
 #if HELIUM_ENDIAN_LITTLE
-	Swizzle(m_WriteHeader.m_ID, true);
-	Swizzle(m_WriteHeader.m_TRN, true);
-	Swizzle(m_WriteHeader.m_Size, true);
-	Swizzle(m_WriteHeader.m_Type, true);
+		Swizzle(header.m_ID, true);
+		Swizzle(header.m_TRN, true);
+		Swizzle(header.m_Size, true);
+		Swizzle(header.m_Type, true);
 #endif
 
+		buffers[ bufferCount ].m_Data = &header;
+		buffers[ bufferCount ].m_Size = sizeof( header );
+		bufferCount++;
+
+		if ( msg->GetSize() )
+		{
+			buffers[ bufferCount ].m_Data = msg->GetData();
+			buffers[ bufferCount ].m_Size = msg->GetSize();
+			bufferCount++;
+		}
+	}
+
 	{
-		HELIUM_IPC_SCOPE_TIMER("Write Message Header");
-		if (!Write( &m_WriteHeader, sizeof( m_WriteHeader ) ))
+		HELIUM_IPC_SCOPE_TIMER("Write Message Batch");
+		if (!WriteBuffers( buffers, bufferCount ))
 		{
 #ifdef IPC_TCP_DEBUG_SOCKETS
-			Helium::Print("%s: Failed to write message header\n", m_Name);
+			Helium::Print("%s: Failed to write %d messages\n", m_Name, count);
 #endif
 			return false;
 		}
 	}
 
+	return true;
+}
+
+bool TCPConnection::WriteBuffers(SocketBuffer* buffers, uint32_t count)
+{
+	while (count > 0)
 	{
-		HELIUM_IPC_SCOPE_TIMER("Write Message Data");
-		if (!Write( msg->GetData(), msg->GetSize() ))
+		uint32_t bytes_put = 0;
+		if (!m_WriteSocket.WriteGather( buffers, count, bytes_put ))
 		{
-#ifdef IPC_TCP_DEBUG_SOCKETS
-			Helium::Print("%s::Failed to write message data\n", m_Name);
-#endif
 			return false;
 		}
+
+		if (m_Terminating)
+		{
+			return false;
+		}
+
+		// skip the buffers that went out completely, and trim the one that went out partially
+		while (count > 0 && bytes_put >= buffers->m_Size)
+		{
+			bytes_put -= buffers->m_Size;
+			buffers++;
+			count--;
+		}
+
+		if (count > 0)
+		{
+			buffers->m_Data = static_cast< uint8_t* >( buffers->m_Data ) + bytes_put;
+			buffers->m_Size -= bytes_put;
+		}
 	}
 
 	return true;
@@ -414,13 +471,27 @@ bool TCPConnection::Read(void* buffer, uint32_t bytes)
 
 	while (bytes_left > 0)
 	{
-		uint32_t count = std::min<uint32_t>(bytes_left, IPC_TCP_BUFFER_SIZE);
+		// serve what we can from data we already pulled off the socket
+		if (m_ReadBufferStart < m_ReadBufferEnd)
+		{
+			uint32_t count = std::min<uint32_t>(bytes_left, m_ReadBufferEnd - m_ReadBufferStart);
+			memcpy(buffer, m_ReadBuffer + m_ReadBufferStart, count);
+			m_ReadBufferStart += count;
+			bytes_left -= count;
+			buffer = ((uint8_t*)buffer) + count;
+			continue;
+		}
+
+		// large reads go straight into the destination, small ones read ahead into our buffer
+		//  so that several small messages (headers and payloads) are parsed from a single receive
+		bool direct = bytes_left >= IPC_TCP_BUFFER_SIZE / 2;
+		uint32_t count = direct ? std::min<uint32_t>(bytes_left, IPC_TCP_BUFFER_SIZE) : IPC_TCP_BUFFER_SIZE;
 
 #ifdef IPC_TCP_DEBUG_SOCKETS_CHUNKS
-		Helium::Print(" %s: Receiving %d bytes...\n", m_Name, count);
+		Helium::Print(" %s: Receiving up to %d bytes...\n", m_Name, count);
 #endif
 
-		if (!m_ReadSocket.Read( buffer, count, bytes_got ))
+		if (!m_ReadSocket.ReadAvailable( direct ? buffer : m_ReadBuffer, count, bytes_got ))
 		{
 #ifdef IPC_TCP_DEBUG_SOCKETS
 			Helium::Print( "%s: ReadSocket failed\n", m_Name );
@@ -436,8 +507,16 @@ bool TCPConnection::Read(void* buffer, uint32_t bytes)
 			return false;
 		}
 
-		bytes_left -= bytes_got;
-		buffer = ((uint8_t*)buffer) + bytes_got;
+		if (direct)
+		{
+			bytes_left -= bytes_got;
+			buffer = ((uint8_t*)buffer) + bytes_got;
+		}
+		else
+		{
+			m_ReadBufferStart = 0;
+			m_ReadBufferEnd = bytes_got;
+		}
 
 #ifdef IPC_TCP_DEBUG_SOCKETS_CHUNKS
 		Helium::Print(" %s: Got %d bytes, %d bytes to go\n", m_Name, bytes_got, bytes_left);
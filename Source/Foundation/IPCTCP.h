@@ -25,6 +25,12 @@ namespace Helium
 			uint16_t       m_WritePort;   // port number for write operations
 			Helium::Socket m_WriteSocket; // socket used for write operations
 
+			uint8_t        m_ReadBuffer[ IPC_TCP_BUFFER_SIZE ]; // bytes pulled off the read socket ahead of the reader
+			uint32_t       m_ReadBufferStart;                   // offset of the first unconsumed byte
+			uint32_t       m_ReadBufferEnd;                     // offset past the last received byte
+
+			MessageHeader  m_WriteHeaders[ IPC_WRITE_BATCH_SIZE ]; // wire headers for the batch being written
+
 		public:
 			TCPConnection();
 			virtual ~TCPConnection();
@@ -40,8 +46,11 @@ namespace Helium
 			virtual void CleanupThread();
 			virtual bool ReadMessage(Message** msg);
 			virtual bool WriteMessage(Message* msg);
+			virtual bool WriteMessages(Message** msgs, uint32_t count);
 			virtual bool Read(void* buffer, uint32_t bytes);
 			virtual bool Write(void* buffer, uint32_t bytes);
+
+			bool WriteBuffers(SocketBuffer* buffers, uint32_t count);
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "Precompile.h"
+#include "Foundation/IPCTCP.h"
+#include "Foundation/TestUtilities.h"
+
+#include "Platform/Atomic.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::IPC;
+using namespace Helium::FoundationTests;
+
+namespace
+{
+	// enough to interleave the producers, the throughput runs are in IPCBenchmarks.cpp
+	const uint32_t LoopbackMessageCount = 2000;
+
+	// keeps no more than one of its messages in flight, so a queue bounded above the number of producers should never drop one
+	struct BoundedProducer
+	{
+		Connection*      m_Connection;
+		MessageQueue*    m_Queue;
+		uint32_t         m_Index;
+		uint32_t         m_Count;
+		volatile int32_t m_Received;
+
+		void Run()
+		{
+			for ( uint32_t i=0; i<m_Count; i++ )
+			{
+				while ( m_Received < static_cast< int32_t >( i ) )
+				{
+					Thread::Yield();
+				}
+
+				Message* msg = m_Connection->CreateMessage( m_Index, sizeof( uint32_t ), 1 );
+				*reinterpret_cast< uint32_t* >( msg->GetData() ) = i;
+				m_Queue->Add( msg );
+			}
+		}
+	};
+}
+
+TEST(Foundation, IPCMessageQueueMaxLength)
+{
+	const uint32_t producerCount = 4;
+	const uint32_t messageCount = 50000;
+	const uint32_t maxLength = producerCount + 1;
+
+	for ( uint32_t mode = 0; mode < 2; mode++ )
+	{
+		MessageQueue queue ( mode ? MessageQueueModes::LockFree : MessageQueueModes::Locked );
+		queue.SetMaxLength( maxLength );
+
+		// only used to make messages, it never connects
+		TCPConnection connection;
+
+		BoundedProducer producers[ producerCount ];
+		CallbackThread threads[ producerCount ];
+		for ( uint32_t i=0; i<producerCount; i++ )
+		{
+			producers[i].m_Connection = &connection;
+			producers[i].m_Queue = &queue;
+			producers[i].m_Index = i;
+			producers[i].m_Count = messageCount;
+			producers[i].m_Received = 0;
+
+			CallbackThread::Entry entry = &CallbackThread::EntryHelper< BoundedProducer, &BoundedProducer::Run >;
+			ASSERT_TRUE( threads[i].Create( entry, &producers[i], "Bounded Producer" ) );
+		}
+
+		// the queue never holds more than one message per producer, so every message has to arrive
+		uint32_t received = 0;
+		bool dropped = false;
+		while ( received < producerCount * messageCount && !dropped )
+		{
+			Message* messages[ maxLength ];
+			uint32_t count = queue.RemoveBatch( messages, maxLength );
+			for ( uint32_t i=0; i<count; i++ )
+			{
+				BoundedProducer& producer = producers[ messages[i]->GetID() ];
+				uint32_t sequence = *reinterpret_cast< uint32_t* >( messages[i]->GetData() );
+				delete messages[i];
+
+				EXPECT_EQ( static_cast< uint32_t >( producer.m_Received ), sequence );
+				dropped |= sequence != static_cast< uint32_t >( producer.m_Received );
+
+				received++;
+				AtomicIncrement( producer.m_Received );
+			}
+		}
+
+		// let any producer that is waiting on a dropped message finish
+		for ( uint32_t i=0; i<producerCount; i++ )
+		{
+			producers[i].m_Received = messageCount;
+			threads[i].Join();
+		}
+
+		EXPECT_FALSE( dropped ) << ( mode ? "lock free" : "locked" );
+	}
+}
+
+TEST(Foundation, IPCLoopbackLocked)
+{
+	LoopbackResult result;
+	RunTCPLoopback( MessageQueueModes::Locked, LoopbackPort(), LoopbackMessageCount, result );
+}
+
+TEST(Foundation, IPCLoopbackLockFree)
+{
+	LoopbackResult result;
+	RunTCPLoopback( MessageQueueModes::LockFree, LoopbackPort() + 2, LoopbackMessageCount, result );
+}
+
+#if HELIUM_OS_LINUX
+TEST(Foundation, IPCLoopbackSharedMemory)
+{
+	LoopbackResult result;
+	RunSharedMemoryLoopback( LoopbackMessageCount, result );
+}
+#endif
@@ -111,7 +111,7 @@ static uint32_t g_Channels = Channels::Normal | Channels::Warning | Channels::Er
 static Level g_Level = Levels::Default;
 static int g_Indent = 0;
 
-static ListenerSignature::Event g_LogEvent;
+static ListenerSignature::ConcurrentEvent g_LogEvent;
 
 void Log::Statement::ApplyIndent( const char* string, std::string& output )
 {
@@ -157,15 +157,11 @@ void Log::Statement::ApplyIndent( const char* string, std::string& output )
 
 void Log::AddListener(const ListenerSignature::Delegate& listener)
 {
-	Helium::MutexScopeLock mutex (g_Mutex);
-
 	g_LogEvent.Add(listener);
 }
 
 void Log::RemoveListener(const ListenerSignature::Delegate& listener)
 {
-	Helium::MutexScopeLock mutex (g_Mutex);
-
 	g_LogEvent.Remove(listener);
 }
 
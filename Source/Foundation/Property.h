@@ -49,6 +49,18 @@ namespace Helium
     public:
         virtual V Get() const = 0;
         virtual bool Set(const V& value) = 0;
+
+        // true if both properties write the same data (through the same setter of the same target)
+        virtual bool Equals(const Property<V>* rhs) const
+        {
+            return this == rhs;
+        }
+
+        // identifies the concrete property class without RTTI, NULL if it can only equal itself
+        virtual const void* GetTypeTag() const
+        {
+            return NULL;
+        }
     };
 
     //
@@ -76,7 +88,12 @@ namespace Helium
         virtual V Get() const;
         virtual bool Set(const V& value);
 
+        virtual bool Equals(const Property<V>* rhs) const;
+        virtual const void* GetTypeTag() const;
+
 	private:
+        static const char       s_TypeTag;
+
         GetterType				m_GetterType;
         union
         {
@@ -119,7 +136,12 @@ namespace Helium
         virtual V Get() const;
         virtual bool Set(const V& value);
 
+        virtual bool Equals(const Property<V>* rhs) const;
+        virtual const void* GetTypeTag() const;
+
 	private:
+        static const char   s_TypeTag;
+
         GetterType			m_GetterType;
         union
         {
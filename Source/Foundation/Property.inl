@@ -117,6 +117,37 @@ bool Helium::StaticProperty< V >::Set(const V& value)
     }
 }
 
+template <class V>
+const char Helium::StaticProperty< V >::s_TypeTag = 0;
+
+template <class V>
+bool Helium::StaticProperty< V >::Equals(const Property<V>* rhs) const
+{
+    if (rhs == this)
+    {
+        return true;
+    }
+
+    if (rhs->GetTypeTag() != GetTypeTag())
+    {
+        return false;
+    }
+
+    const StaticProperty* property = static_cast< const StaticProperty* >( rhs );
+    if (m_SetterType != property->m_SetterType)
+    {
+        return false;
+    }
+
+    return m_SetterType == SetterTypes::Reference ? m_SetReference == property->m_SetReference : m_SetValue == property->m_SetValue;
+}
+
+template <class V>
+const void* Helium::StaticProperty< V >::GetTypeTag() const
+{
+    return &s_TypeTag;
+}
+
 template <class T, class V>
 Helium::MemberProperty< T, V >::MemberProperty(T* o, GetterParam g, SetterReference s)
 {
@@ -244,4 +275,35 @@ bool Helium::MemberProperty< T, V >::Set(const V& value)
             throw PropertyException( "MemberProperty has no compatible set function" );
         }
     }
-}
\ No newline at end of file
+}
+
+template <class T, class V>
+const char Helium::MemberProperty< T, V >::s_TypeTag = 0;
+
+template <class T, class V>
+bool Helium::MemberProperty< T, V >::Equals(const Property<V>* rhs) const
+{
+    if (rhs == this)
+    {
+        return true;
+    }
+
+    if (rhs->GetTypeTag() != GetTypeTag())
+    {
+        return false;
+    }
+
+    const MemberProperty* property = static_cast< const MemberProperty* >( rhs );
+    if (m_Target != property->m_Target || m_SetterType != property->m_SetterType)
+    {
+        return false;
+    }
+
+    return m_SetterType == SetterTypes::Reference ? m_SetReference == property->m_SetReference : m_SetValue == property->m_SetValue;
+}
+
+template <class T, class V>
+const void* Helium::MemberProperty< T, V >::GetTypeTag() const
+{
+    return &s_TypeTag;
+}
@@ -2,7 +2,10 @@
 #include "RPC.h"
 
 #include "Platform/Assert.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
 
+#include "Foundation/Crc32.h"
 #include "Foundation/IPC.h"
 
 #include <string.h>
@@ -14,8 +17,19 @@ using namespace Helium::RPC;
 //#define RPC_DEBUG
 //#define RPC_DEBUG_MSG
 
+namespace
+{
+	// an invocation's message ID is its interface's ID, its invoker's index, and the message ID in the low bits
+	const uint32_t InvokerShift = 8;
+	const uint32_t InterfaceShift = 13;
+	const uint32_t InterfaceMask = ~( ( 1 << InterfaceShift ) - 1 );
+	HELIUM_COMPILE_ASSERT( MAX_INVOKERS == 1 << ( InterfaceShift - InvokerShift ) );
+	HELIUM_COMPILE_ASSERT( MessageIDs::Batch < 1 << InvokerShift );
+}
+
 Interface::Interface(const char* name)
 	: m_Name (name)
+	, m_ID (Crc32(name) & InterfaceMask)
 	, m_Host (NULL)
 	, m_InvokerCount (0)
 {
@@ -30,6 +44,8 @@ void Interface::AddInvoker(InvokerPtr invoker)
 		return;
 	}
 
+	invoker->SetID( m_ID | ( m_InvokerCount << InvokerShift ) | MessageIDs::Invocation );
+
 	m_Invokers[m_InvokerCount++] = invoker;
 }
 
@@ -37,7 +53,7 @@ Invoker* Interface::GetInvoker(const char* name)
 {
 	for ( uint32_t i=0; i<m_InvokerCount; i++ )
 	{
-		if ( !strcmp( m_Invokers[i]->GetName(), name ) )
+		if ( m_Invokers[i]->GetName() && !strcmp( m_Invokers[i]->GetName(), name ) )
 		{
 			return m_Invokers[i];
 		}
@@ -46,6 +62,141 @@ Invoker* Interface::GetInvoker(const char* name)
 	return NULL;
 }
 
+Invoker* Interface::GetInvoker(uint32_t index)
+{
+	return index < m_InvokerCount ? m_Invokers[index] : NULL;
+}
+
+namespace
+{
+	// header in front of each invocation or reply packed into a batch message
+	struct BatchEntry
+	{
+		uint32_t m_ID;
+		int32_t  m_Transaction;
+		uint32_t m_Size;
+	};
+
+	inline void SwizzleEntry(BatchEntry& entry)
+	{
+		Helium::Swizzle( entry.m_ID );
+		Helium::Swizzle( entry.m_Transaction );
+		Helium::Swizzle( entry.m_Size );
+	}
+
+	// copy reply data (args already swizzled) back into the caller's args and payload
+	void CopyReplyData(Args* args, uint32_t argsSize, uint32_t flags, uint8_t* data, uint32_t size)
+	{
+		uint8_t* ptr = data;
+
+		// the reply carries the remote side's pointers, keep ours
+		void* payload = args->m_Payload;
+		uint32_t payloadSize = args->m_PayloadSize;
+
+		if (flags & RPC::Flags::ReplyWithArgs && (uint32_t)(ptr - data) + argsSize <= size)
+		{
+			memcpy(args, ptr, argsSize);
+			args->m_Payload = payload;
+			args->m_PayloadSize = payloadSize;
+			ptr += argsSize;
+		}
+
+		if (flags & RPC::Flags::ReplyWithPayload && payload != NULL && (uint32_t)(ptr - data) + payloadSize <= size)
+		{
+			memcpy(payload, ptr, payloadSize);
+			ptr += payloadSize;
+		}
+	}
+}
+
+Future::Future(int32_t transaction, uint32_t flags, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback)
+	: m_Transaction (transaction)
+	, m_Flags (flags)
+	, m_ArgsSize (argsSize)
+	, m_Swizzler (swizzler)
+	, m_Callback (callback)
+	, m_State (FutureStates::Pending)
+	, m_ReplyData (NULL)
+	, m_ReplySize (0)
+{
+
+}
+
+Future::~Future()
+{
+	IPC::Message::FreeData( m_ReplyData );
+}
+
+Args* Future::GetArgs()
+{
+	if (m_State == FutureStates::Replied && m_Flags & RPC::Flags::ReplyWithArgs && m_ReplySize >= m_ArgsSize)
+	{
+		return (Args*)m_ReplyData;
+	}
+
+	return NULL;
+}
+
+uint8_t* Future::GetPayload()
+{
+	return GetPayloadSize() ? m_ReplyData + ( m_Flags & RPC::Flags::ReplyWithArgs ? m_ArgsSize : 0 ) : NULL;
+}
+
+uint32_t Future::GetPayloadSize()
+{
+	uint32_t offset = m_Flags & RPC::Flags::ReplyWithArgs ? m_ArgsSize : 0;
+
+	if (m_State == FutureStates::Replied && m_Flags & RPC::Flags::ReplyWithPayload && m_ReplySize > offset)
+	{
+		return m_ReplySize - offset;
+	}
+
+	return 0;
+}
+
+bool Future::CopyReply(Args* args)
+{
+	if (m_State != FutureStates::Replied || args == NULL)
+	{
+		return false;
+	}
+
+	CopyReplyData(args, m_ArgsSize, m_Flags, m_ReplyData, m_ReplySize);
+	return true;
+}
+
+void Future::Complete(uint8_t* data, uint32_t size)
+{
+	HELIUM_ASSERT(m_State == FutureStates::Pending);
+
+	m_ReplyData = data;
+	m_ReplySize = size;
+
+	if (m_Flags & RPC::Flags::ReplyWithArgs && m_Swizzler && size >= m_ArgsSize)
+	{
+		m_Swizzler(m_ReplyData);
+	}
+
+	m_State = FutureStates::Replied;
+
+	if (m_Callback.Valid())
+	{
+		m_Callback.Invoke( *this );
+	}
+}
+
+void Future::Fail()
+{
+	HELIUM_ASSERT(m_State == FutureStates::Pending);
+
+	m_State = FutureStates::Failed;
+
+	if (m_Callback.Valid())
+	{
+		m_Callback.Invoke( *this );
+	}
+}
+
 Host::Stack::Stack()
 {
 	Reset();
@@ -86,26 +237,45 @@ void Host::Stack::Pop()
 }
 
 Host::Host()
+	: m_PendingCount (0)
+	, m_BatchCount (0)
+	, m_BatchDepth (0)
 {
 	Reset();
 }
 
 Host::~Host()
 {
-
+	for ( uint32_t i=0; i<m_BatchCount; i++ )
+	{
+		delete m_Batch[i];
+	}
 }
 
 void Host::Reset()
 {
 	m_Connection = NULL;
 	m_ConnectionCount = 0;
+	m_SwizzleRemote = false;
+	m_SwizzleLocal = false;
 
 	memset(m_Interfaces, 0, sizeof(Interface*) * MAX_INTERFACES);
+	m_InterfaceCount = 0;
+
+	FailPending();
+
+	for ( uint32_t i=0; i<m_BatchCount; i++ )
+	{
+		delete m_Batch[i];
+	}
+	m_BatchCount = 0;
+	m_BatchDepth = 0;
 }
 
 void Host::AddInterface(Interface* iface)
 {
-	if (m_InterfaceCount >= MAX_INTERFACES)
+	// invocations find their interface by ID, so two names can't hash the same
+	if (m_InterfaceCount >= MAX_INTERFACES || GetInterface(iface->GetID()) != NULL)
 	{
 		HELIUM_BREAK();
 		return;
@@ -129,202 +299,516 @@ Interface* Host::GetInterface(const char* name)
 	return NULL;
 }
 
+Interface* Host::GetInterface(uint32_t id)
+{
+	for ( uint32_t i=0; i<m_InterfaceCount; i++ )
+	{
+		if ( m_Interfaces[i]->GetID() == id )
+		{
+			return m_Interfaces[i];
+		}
+	}
+
+	return NULL;
+}
+
 void Host::SetConnection(IPC::Connection* con)
 {
 	m_Connection = con;
 	m_ConnectionCount = m_Connection->GetConnectCount();
+	NegotiateByteOrder();
 }
 
-IPC::Message* Host::Create(Invoker* invoker, uint32_t size, int32_t transaction)
+void Host::NegotiateByteOrder()
 {
-	// TODO: Pack the invoker and interface name into the message data
-	invoker->GetName();
-	invoker->GetInterface()->GetName();
+	HELIUM_ASSERT(LOCAL_ENDIANNESS == Helium::Platform::GetEndianness());
+
+	if (m_Connection->GetRemoteVersion() >= SENDER_ORDER_VERSION)
+	{
+		m_SwizzleRemote = SwizzleRequired( m_Connection->GetRemoteEndianness() );
+		m_SwizzleLocal = false;
+	}
+	else
+	{
+		// an older peer sends and expects big endian data
+		m_SwizzleRemote = SwizzleRequired( Helium::Platform::Endiannesses::Big );
+		m_SwizzleLocal = m_SwizzleRemote;
+	}
+
+#ifdef RPC_DEBUG
+	printf("RPC::Peer protocol version %d, swizzling %s\n", m_Connection->GetRemoteVersion(), m_SwizzleRemote ? "on" : "off");
+#endif
+}
 
+IPC::Message* Host::Create(Invoker* invoker, uint32_t size, int32_t transaction)
+{
 	if (transaction != 0)
 	{
-		return m_Connection->CreateMessage(0, size, transaction);
+		return m_Connection->CreateMessage(invoker->GetID(), size, transaction);
 	}
 	else
 	{
-		return m_Connection->CreateMessage(0, size);
+		return m_Connection->CreateMessage(invoker->GetID(), size);
 	}
 }
 
-void Host::Emit(Invoker* invoker, Args* args, uint32_t size, SwizzleFunc swizzler)
+IPC::Message* Host::Marshal(Invoker* invoker, Args* args, uint32_t size)
 {
-	if (Connected())
+	uint32_t total = 0;
+	void* payload = NULL;
+	uint32_t payloadSize = 0;
+
+	if (args != NULL)
 	{
-		if (m_ConnectionCount != m_Connection->GetConnectCount())
+		HELIUM_ASSERT(size > 0);
+		total += size;
+
+		payload = args->m_Payload;
+		payloadSize = args->m_PayloadSize;
+
+		if (payload != NULL)
 		{
-#ifdef RPC_DEBUG
-			printf("RPC::Connection cycled, resetting stack\n");
-#endif
-			m_ConnectionCount = m_Connection->GetConnectCount();
-			m_Stack.Reset();
+			HELIUM_ASSERT(payloadSize > 0);
+			total += payloadSize;
 		}
+	}
 
-		uint32_t size = 0;
+	IPC::Message* message = Create(invoker, total);
+
+	uint8_t* ptr = message->GetData();
 
-		if (args != NULL)
+	// sent in our byte order, the other side swizzles if it has to (unless it is too old to)
+	if (args != NULL)
+	{
+		memcpy(ptr, args, size);
+
+		if (m_SwizzleLocal)
 		{
-			HELIUM_ASSERT(size > 0);
-			size += size;
+			invoker->Swizzle(ptr);
 		}
 
-		if (args->m_Payload != NULL)
+		ptr += size;
+
+		if (payload != NULL)
 		{
-			HELIUM_ASSERT(args->m_PayloadSize > 0);
-			size += args->m_PayloadSize;
+			memcpy(ptr, payload, payloadSize);
+			ptr += payloadSize;
 		}
+	}
 
-		IPC::Message* message = Create(invoker, size);
+	HELIUM_ASSERT((uint32_t)(ptr - message->GetData()) == total);
 
-		uint8_t* ptr = message->GetData();
+	return message;
+}
 
-		if (args != NULL)
+IPC::Message* Host::Prepare(Invoker* invoker, uint32_t argsSize, uint32_t payloadSize, Args*& args)
+{
+	HELIUM_ASSERT(m_Connection && argsSize >= sizeof(Args));
+
+	IPC::Message* message = Create(invoker, argsSize + payloadSize);
+
+	memset(message->GetData(), 0, argsSize);
+
+	args = (Args*)message->GetData();
+	args->m_Host = this;
+	args->m_Payload = payloadSize ? message->GetData() + argsSize : NULL;
+	args->m_PayloadSize = payloadSize;
+
+	return message;
+}
+
+void Host::Post(IPC::Message* msg)
+{
+#ifdef RPC_DEBUG_MSG
+	printf("RPC::Put message id 0x%x, size %d, transaction %d\n", msg->GetID(), msg->GetSize(), msg->GetTransaction());
+#endif
+
+	if (m_BatchDepth > 0)
+	{
+		m_Batch[m_BatchCount++] = msg;
+
+		if (m_BatchCount == MAX_BATCH)
 		{
-			swizzler(args);
+			Flush();
+		}
+	}
+	else if (m_Connection->Send(msg) != IPC::ConnectionStates::Active)
+	{
+		delete msg;
+	}
+}
+
+void Host::BeginBatch()
+{
+	m_BatchDepth++;
+}
+
+void Host::EndBatch()
+{
+	HELIUM_ASSERT(m_BatchDepth > 0);
 
-			memcpy(ptr, args, size);
-			ptr += size;
+	if (--m_BatchDepth == 0)
+	{
+		Flush();
+	}
+}
+
+void Host::Flush()
+{
+	if (m_BatchCount == 0)
+	{
+		return;
+	}
+
+	IPC::Message* message = NULL;
 
-			swizzler(args);
+	if (m_BatchCount == 1)
+	{
+		// nothing to pack with, send as is
+		message = m_Batch[0];
+	}
+	else
+	{
+		uint32_t size = 0;
+		for ( uint32_t i=0; i<m_BatchCount; i++ )
+		{
+			size += sizeof(BatchEntry) + m_Batch[i]->GetSize();
 		}
 
-		if (args->m_Payload != NULL)
+		message = m_Connection->CreateMessage(MessageIDs::Batch, size);
+
+		uint8_t* ptr = message->GetData();
+		for ( uint32_t i=0; i<m_BatchCount; i++ )
 		{
-			memcpy(ptr, args->m_Payload, args->m_PayloadSize);
-			ptr += args->m_PayloadSize;
+			BatchEntry entry;
+			entry.m_ID = m_Batch[i]->GetID();
+			entry.m_Transaction = m_Batch[i]->GetTransaction();
+			entry.m_Size = m_Batch[i]->GetSize();
+
+			if (m_SwizzleLocal)
+			{
+				SwizzleEntry(entry);
+			}
+
+			memcpy(ptr, &entry, sizeof(BatchEntry));
+			ptr += sizeof(BatchEntry);
+
+			if (m_Batch[i]->GetSize())
+			{
+				memcpy(ptr, m_Batch[i]->GetData(), m_Batch[i]->GetSize());
+				ptr += m_Batch[i]->GetSize();
+			}
+
+			delete m_Batch[i];
 		}
 
 		HELIUM_ASSERT((uint32_t)(ptr - message->GetData()) == size);
 
-#ifdef RPC_DEBUG_MSG
-		uint32_t msg_id = message->GetID();
-		uint32_t msg_size = message->GetSize();
+#ifdef RPC_DEBUG
+		printf("RPC::Flushing %d invocations in batch transaction %d\n", m_BatchCount, message->GetTransaction());
 #endif
+	}
 
-		int32_t msg_transaction = message->GetTransaction();
-		if (m_Connection->Send(message)!=IPC::ConnectionStates::Active)
+	m_BatchCount = 0;
+
+	if (m_Connection->Send(message) != IPC::ConnectionStates::Active)
+	{
+		delete message;
+	}
+}
+
+void Host::CheckConnection()
+{
+	if (m_ConnectionCount != m_Connection->GetConnectCount())
+	{
+#ifdef RPC_DEBUG
+		printf("RPC::Connection cycled, resetting stack\n");
+#endif
+		m_ConnectionCount = m_Connection->GetConnectCount();
+		NegotiateByteOrder();
+		m_Stack.Reset();
+
+		// anything queued or in flight belonged to the old connection
+		for ( uint32_t i=0; i<m_BatchCount; i++ )
 		{
-			delete message;
-			return;
+			delete m_Batch[i];
 		}
+		m_BatchCount = 0;
 
-#ifdef RPC_DEBUG_MSG
-		printf("RPC::Put message id 0x%" HELIUM_PRINT_POINTER ", size %d, transaction %d\n", msg_id, msg_size, msg_transaction);
-#endif
+		FailPending();
+	}
+}
 
-		message = NULL; // assume its GONE
+void Host::FailPending()
+{
+	for ( uint32_t i=0; i<MAX_PENDING && m_PendingCount; i++ )
+	{
+		if (m_Pending[i].ReferencesObject())
+		{
+			// release the slot before the callback runs, it may issue new calls
+			FuturePtr future = m_Pending[i];
+			m_Pending[i].Release();
+			m_PendingCount--;
+
+			future->Fail();
+		}
+	}
+}
+
+void Host::Emit(Invoker* invoker, Args* args, uint32_t size, SwizzleFunc swizzler)
+{
+	if (Connected())
+	{
+		CheckConnection();
+
+		IPC::Message* message = Marshal(invoker, args, size);
+
+		int32_t msg_transaction = message->GetTransaction();
 
-		if (args->m_Flags & RPC::Flags::NonBlocking)
+		// calls without args cannot ask for a reply
+		if (args == NULL || args->m_Flags & RPC::Flags::NonBlocking)
 		{
 #ifdef RPC_DEBUG
 			printf("RPC::Emitting async transaction %d\n", msg_transaction);
 #endif
+			Post(message);
+			return;
 		}
-		else
-		{
-			// create frame for call
-			Frame* frame = m_Stack.Push();
 
-			// set the transaction we are blocking on
-			frame->m_ReplyTransaction = msg_transaction;
+		// we are about to block, so anything batched so far has to go out with us
+		Post(message);
+		Flush();
+
+		message = NULL; // assume its GONE
+
+		// create frame for call
+		Frame* frame = m_Stack.Push();
+
+		// set the transaction we are blocking on
+		frame->m_ReplyTransaction = msg_transaction;
 
 #ifdef RPC_DEBUG
-			printf("RPC::Emitting transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
+		printf("RPC::Emitting transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
 #endif
 
-			// process until we retrieve it
-			frame->m_Replied = false;
+		// process until we retrieve it
+		frame->m_Replied = false;
 
-			// process messages until we receive our reply
-			while (Process(true) && !frame->m_Replied);
+		// process messages until we receive our reply
+		while (Process(true) && !frame->m_Replied);
 
-			// if we did not get our reply
-			if (!frame->m_Replied)
-			{
+		// if we did not get our reply
+		if (!frame->m_Replied)
+		{
 #ifdef RPC_DEBUG
-				printf("RPC::Emit failed for transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
+			printf("RPC::Emit failed for transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
 #endif
 
-				// if we didn't reset and the call timed out, pop
-				if (m_Stack.Size())
-				{
-					m_Stack.Pop();
-				}
-			}
-			else
+			// if we didn't reset and the call timed out, pop
+			if (m_Stack.Size())
 			{
+				m_Stack.Pop();
+			}
+		}
+		else
+		{
 #ifdef RPC_DEBUG
-				printf("RPC::Emit success for transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
+			printf("RPC::Emit success for transaction %d, stack size %d\n", msg_transaction, m_Stack.Size());
 #endif
 
-				size = 0;
-				ptr = frame->m_ReplyData;
+			if (m_SwizzleRemote && args->m_Flags & RPC::Flags::ReplyWithArgs && frame->m_ReplySize >= size)
+			{
+				swizzler(frame->m_ReplyData);
+			}
+
+			// do ref args and payload processing here
+			CopyReplyData(args, size, args->m_Flags, frame->m_ReplyData, frame->m_ReplySize);
+
+			// clean up our reply message's memory
+			IPC::Message::FreeData( frame->m_ReplyData );
+
+			// call complete, pop
+			m_Stack.Pop();
+		}
+	}
+}
+
+FuturePtr Host::Call(Invoker* invoker, Args* args, uint32_t size, SwizzleFunc swizzler, const FutureDelegate& callback)
+{
+	if (!Connected() || !HELIUM_VERIFY(args != NULL))
+	{
+		FuturePtr future = new Future(0, 0, size, swizzler, callback);
+		future->Fail();
+		return future;
+	}
+
+	CheckConnection();
 
-				if (args != NULL)
-				{
-					HELIUM_ASSERT(size > 0);
-					size += size;
-				}
+	// the future completes on the reply, so the other side must always send one
+	uint32_t flags = args->m_Flags & ~RPC::Flags::NonBlocking;
+	uint32_t callerFlags = args->m_Flags;
+	args->m_Flags = flags;
 
-				if (args->m_Payload != NULL)
-				{
-					HELIUM_ASSERT(args->m_PayloadSize > 0);
-					size += args->m_PayloadSize;
-				}
+	IPC::Message* message = Marshal(invoker, args, size);
 
-				// do ref args processing here
-				if (args->m_Flags & RPC::Flags::ReplyWithArgs && args != NULL)
-				{
-					swizzler(ptr);
+	args->m_Flags = callerFlags;
 
-					// copy our data BACK
-					memcpy(args, ptr, size);
+	return Track(message, flags, size, swizzler, callback);
+}
 
-					ptr += size;
-				}
+void Host::EmitMessage(Invoker* invoker, IPC::Message* message)
+{
+	if (!Connected())
+	{
+		delete message;
+		return;
+	}
 
-				// do ref payload processing here
-				if (args->m_Flags & RPC::Flags::ReplyWithPayload && args->m_Payload != NULL)
-				{
-					// copy our data BACK
-					memcpy(args->m_Payload, ptr, args->m_PayloadSize);
-					ptr += args->m_PayloadSize;
-				}
+	CheckConnection();
 
-				// clean up our reply message's memory
-				delete[] frame->m_ReplyData;
+	if (message->GetSize() >= sizeof(Args))
+	{
+		Args* args = (Args*)message->GetData();
+		args->m_Flags |= RPC::Flags::NonBlocking;
 
-				// call complete, pop
-				m_Stack.Pop();
+		if (m_SwizzleLocal && message->GetSize() >= invoker->GetArgsSize())
+		{
+			invoker->Swizzle(args);
+		}
+	}
+
+	Post(message);
+}
+
+FuturePtr Host::CallMessage(Invoker* invoker, IPC::Message* message, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback)
+{
+	if (!Connected() || !HELIUM_VERIFY(message->GetSize() >= argsSize && argsSize >= sizeof(Args)))
+	{
+		delete message;
+
+		FuturePtr future = new Future(0, 0, argsSize, swizzler, callback);
+		future->Fail();
+		return future;
+	}
+
+	CheckConnection();
+
+	Args* args = (Args*)message->GetData();
+	args->m_Flags &= ~RPC::Flags::NonBlocking;
+	uint32_t flags = args->m_Flags;
+
+	if (m_SwizzleLocal)
+	{
+		swizzler(args);
+	}
+
+	return Track(message, flags, argsSize, swizzler, callback);
+}
+
+FuturePtr Host::Track(IPC::Message* message, uint32_t flags, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback)
+{
+	int32_t transaction = message->GetTransaction();
+	uint32_t index = (uint32_t)transaction & ( MAX_PENDING - 1 );
+
+	// the reply is only swizzled if the other side's byte order differs
+	SwizzleFunc replySwizzler = m_SwizzleRemote ? swizzler : NULL;
+
+	// transactions are sequential, so an occupied slot means MAX_PENDING calls are in flight
+	while (m_Pending[index].ReferencesObject())
+	{
+		Flush();
+
+		if (!Process(true) && m_Pending[index].ReferencesObject())
+		{
+			delete message;
+
+			FuturePtr future = new Future(transaction, flags, argsSize, replySwizzler, callback);
+			future->Fail();
+			return future;
+		}
+	}
+
+	FuturePtr future = new Future(transaction, flags, argsSize, replySwizzler, callback);
+	m_Pending[index] = future;
+	m_PendingCount++;
+
+#ifdef RPC_DEBUG
+	printf("RPC::Calling transaction %d, %d in flight\n", transaction, m_PendingCount);
+#endif
+
+	Post(message);
+
+	return future;
+}
+
+bool Host::Wait(Future* future, uint32_t timeout)
+{
+	uint64_t start = Timer::GetTickCount();
+
+	while (!future->IsComplete())
+	{
+		Flush();
+
+		if (timeout == 0)
+		{
+			if (!Process(true))
+			{
+				break;
 			}
+
+			continue;
+		}
+
+		// the connection can't wait with a timeout, so poll it
+		if (!Process(false))
+		{
+			if (!Connected() || Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) >= timeout)
+			{
+				break;
+			}
+
+			Thread::Sleep( 1 );
+		}
+	}
+
+	return future->GetState() == FutureStates::Replied;
+}
+
+bool Host::WaitAll()
+{
+	while (m_PendingCount)
+	{
+		Flush();
+
+		if (!Process(true))
+		{
+			return false;
 		}
 	}
+
+	return true;
 }
 
 bool Host::Invoke(IPC::Message* msg)
 {
-	// TODO: Unpack the invoker and interface name from the message data
-	const char* invokerName = NULL;
-	const char* interfaceName = NULL;
+	// the message ID names the interface and invoker
+	uint32_t id = msg->GetID();
 
 	// find the interface
-	Interface* iface = GetInterface(interfaceName);
+	Interface* iface = GetInterface(id & InterfaceMask);
 	if (iface == NULL)
 	{
-		printf("RPC::Unable to find interface '%s'\n", interfaceName);
+		printf("RPC::Unable to find interface 0x%x\n", id & InterfaceMask);
 		delete msg;
 		return true;
 	}
 
 	// find the invoker
-	Invoker* invoker = iface->GetInvoker(invokerName);
+	uint32_t index = ( id & ~InterfaceMask ) >> InvokerShift;
+	Invoker* invoker = iface->GetInvoker(index);
 	if (invoker == NULL)
 	{
-		printf("RPC::Unable to find invoker '%s' in interface '%s'\n", invokerName, interfaceName);
+		printf("RPC::Unable to find invoker %d in interface '%s'\n", index, iface->GetName());
 		delete msg;
 		return true;
 	}
@@ -337,14 +821,15 @@ bool Host::Invoke(IPC::Message* msg)
 
 	// call the function
 	frame->m_MessageTaken = false;
-	invoker->Invoke(msg->GetData(), msg->GetSize());
+	invoker->Invoke(msg->GetData(), msg->GetSize(), m_SwizzleRemote);
 
 	HELIUM_ASSERT(frame->m_Message != NULL);
 	frame->m_Message = NULL;
 
 	Args* args = (Args*)msg->GetData();
 
-	if (args->m_Flags & RPC::Flags::NonBlocking)
+	// calls without args never block
+	if (msg->GetSize() < sizeof(Args) || args->m_Flags & RPC::Flags::NonBlocking)
 	{
 		if (!frame->m_MessageTaken)
 		{
@@ -389,14 +874,17 @@ bool Host::Invoke(IPC::Message* msg)
 		// where to write
 		uint8_t* ptr = reply->GetData();
 
-		// if we have a ref args
+		// if we have a ref args (already in our byte order, which is how replies travel to current peers)
 		if (args->m_Flags & RPC::Flags::ReplyWithArgs)
 		{
-			invoker->Swizzle( msg->GetData() );
-
 			// write to ptr
 			memcpy(ptr, msg->GetData(), argSize);  
 
+			if (m_SwizzleLocal)
+			{
+				invoker->Swizzle(ptr);
+			}
+
 			// incr ptr by amount written
 			ptr += argSize;
 		}
@@ -420,14 +908,8 @@ bool Host::Invoke(IPC::Message* msg)
 		reply = Create(invoker, 0, msg->GetTransaction());
 	}
 
-	if (m_Connection->Send(reply)!= IPC::ConnectionStates::Active)
-	{
-		delete reply;
-	}
-
-#ifdef RPC_DEBUG_MSG
-	printf("RPC::Put message id 0x%" HELIUM_PRINT_POINTER ", size %d, transaction %d\n", reply->GetID(), reply->GetSize(), reply->GetTransaction());
-#endif
+	// replies to a batch are batched too
+	Post(reply);
 
 	if (!frame->m_MessageTaken)
 	{
@@ -472,19 +954,7 @@ bool Host::Process(bool wait)
 
 	if (Connected())
 	{
-		if (m_ConnectionCount != m_Connection->GetConnectCount())
-		{
-#ifdef RPC_DEBUG
-			printf("RPC::Connection cycled, resetting stack\n");
-#endif
-			m_ConnectionCount = m_Connection->GetConnectCount();
-			m_Stack.Reset();
-		}
-
-		if (m_Connection->GetState() != IPC::ConnectionStates::Active)
-		{
-			result = false;
-		}
+		CheckConnection();
 
 		while (result)
 		{
@@ -498,77 +968,161 @@ bool Host::Process(bool wait)
 			}
 
 #ifdef RPC_DEBUG_MSG
-			printf("RPC::Got message id 0x%" HELIUM_PRINT_POINTER ", size %d, transaction %d\n", msg->GetID(), msg->GetSize(), msg->GetTransaction());
+			printf("RPC::Got message id 0x%x, size %d, transaction %d\n", msg->GetID(), msg->GetSize(), msg->GetTransaction());
 #endif
 
-			bool is_reply = m_Connection->CreatedMessage(msg->GetTransaction());
-			if (is_reply && m_Stack.Size() > 0)
+			if (ProcessMessage(msg))
 			{
-				Frame* top = m_Stack.Top();
+				// we have a reply someone is waiting on, break out of processing messages
+				break;
+			}
+		}
+	}
+	else
+	{
+		result = false;
+	}
+
+	return result;
+}
 
-				bool is_current = msg->GetTransaction() == top->m_ReplyTransaction;
-				if (is_current)
-				{
+bool Host::ProcessMessage(IPC::Message* msg)
+{
+	if (msg->GetID() == MessageIDs::Batch)
+	{
+		return ProcessBatch(msg);
+	}
+
+	int32_t transaction = msg->GetTransaction();
+
+	if (m_Connection->CreatedMessage(transaction))
+	{
+		// asynchronous calls are matched by transaction, in any order
+		uint32_t index = (uint32_t)transaction & ( MAX_PENDING - 1 );
+		if (m_Pending[index].ReferencesObject() && m_Pending[index]->GetTransaction() == transaction)
+		{
 #ifdef RPC_DEBUG
-					printf("RPC::Got reply to transaction %d\n", msg->GetTransaction());
+			printf("RPC::Got reply to async transaction %d\n", transaction);
 #endif
 
-					// subsume the message into the frame
-					top->m_Replied = true;
-					top->m_ReplyID = msg->GetID();
-					top->m_ReplyData = msg->TakeData();  // taking this will disconnect it from the message, making delete below *safe*
-					top->m_ReplySize = msg->GetSize();
-
-					// free msg
-					delete msg;
-
-					// we have our reply, break out of processing messages
-					break;
-				}
-				else
-				{
-					printf("RPC::Got reply to transaction %d, however its not a reply for the top of the stack (stack size: %d)\n", msg->GetTransaction(), m_Stack.Size());
-				}
-			}
-			else // else this is not a reply, meaning this is a new invocation
+			// release the slot before the callback runs, it may issue new calls
+			FuturePtr future = m_Pending[index];
+			m_Pending[index].Release();
+			m_PendingCount--;
+
+			uint32_t size = msg->GetSize();
+			future->Complete(msg->TakeData(), size);
+
+			delete msg;
+			return true;
+		}
+
+		if (m_Stack.Size() > 0)
+		{
+			Frame* top = m_Stack.Top();
+
+			bool is_current = transaction == top->m_ReplyTransaction;
+			if (is_current)
 			{
-				int32_t size HELIUM_ASSERT_ONLY = m_Stack.Size();
+#ifdef RPC_DEBUG
+				printf("RPC::Got reply to transaction %d\n", transaction);
+#endif
+
+				// subsume the message into the frame
+				top->m_Replied = true;
+				top->m_ReplyID = msg->GetID();
+				top->m_ReplySize = msg->GetSize();
+				top->m_ReplyData = msg->TakeData();  // taking this will disconnect it from the message, making delete below *safe*
 
-				// allocate a frame for this local call
-				Frame* frame = m_Stack.Push();
+				// free msg
+				delete msg;
 
-				frame->m_ReplyTransaction = msg->GetTransaction();
+				return true;
+			}
+		}
+
+		printf("RPC::Got reply to transaction %d, however its not a reply for the top of the stack or an in-flight call (stack size: %d)\n", transaction, m_Stack.Size());
+		delete msg;
+		return false;
+	}
+
+	// else this is not a reply, meaning this is a new invocation
+	int32_t size HELIUM_ASSERT_ONLY = m_Stack.Size();
+
+	// allocate a frame for this local call
+	Frame* frame = m_Stack.Push();
+
+	frame->m_ReplyTransaction = transaction;
 
 #ifdef RPC_DEBUG
-				printf("RPC::Pushing invocation transaction %d, stack size %d\n", frame->m_ReplyTransaction, m_Stack.Size());
+	printf("RPC::Pushing invocation transaction %d, stack size %d\n", frame->m_ReplyTransaction, m_Stack.Size());
 #endif
 
-				// the one and only call to invoke, this expects our frame to be allocated
-				if (Invoke(msg))
-				{
+	// the one and only call to invoke, this expects our frame to be allocated
+	if (Invoke(msg))
+	{
 #ifdef RPC_DEBUG
-					printf("RPC::Popping invocation transaction %d, stack size %d\n", frame->m_ReplyTransaction, m_Stack.Size());
+		printf("RPC::Popping invocation transaction %d, stack size %d\n", frame->m_ReplyTransaction, m_Stack.Size());
 #endif
 
-					// success, pop the call
-					m_Stack.Pop();
+		// success, pop the call
+		m_Stack.Pop();
 
-					HELIUM_ASSERT(size == m_Stack.Size());
-				}
-				else
-				{
-					printf("RPC::Invocation failed, resetting stack\n");
-					m_Stack.Reset();
-				}
-			}
-		}
+		HELIUM_ASSERT(size == m_Stack.Size());
 	}
 	else
 	{
-		result = false;
+		printf("RPC::Invocation failed, resetting stack\n");
+		m_Stack.Reset();
 	}
 
-	return result;
+	return false;
+}
+
+bool Host::ProcessBatch(IPC::Message* msg)
+{
+	bool replied = false;
+
+	// replies to the invocations in this batch go back as one batch
+	BeginBatch();
+
+	uint8_t* ptr = msg->GetData();
+	uint8_t* end = ptr + msg->GetSize();
+
+	while (ptr + sizeof(BatchEntry) <= end)
+	{
+		BatchEntry entry;
+		memcpy(&entry, ptr, sizeof(BatchEntry));
+		if (m_SwizzleRemote)
+		{
+			SwizzleEntry(entry);
+		}
+		ptr += sizeof(BatchEntry);
+
+		if (entry.m_ID == MessageIDs::Batch || entry.m_Transaction == 0 || entry.m_Size > (uint32_t)(end - ptr))
+		{
+			printf("RPC::Malformed batch in transaction %d\n", msg->GetTransaction());
+			break;
+		}
+
+		IPC::Message* sub = m_Connection->CreateMessage(entry.m_ID, entry.m_Size, entry.m_Transaction);
+		if (entry.m_Size)
+		{
+			memcpy(sub->GetData(), ptr, entry.m_Size);
+			ptr += entry.m_Size;
+		}
+
+		if (ProcessMessage(sub))
+		{
+			replied = true;
+		}
+	}
+
+	EndBatch();
+
+	delete msg;
+
+	return replied;
 }
 
 using namespace Helium::RPC::Test;
@@ -2,6 +2,7 @@
 
 #include "Platform/Types.h"
 #include "Platform/System.h"
+#include "Platform/Runtime.h"
 
 #include "Foundation/API.h"
 #include "Foundation/Endian.h"
@@ -20,20 +21,37 @@ namespace Helium
     {
         typedef void (*SwizzleFunc)(void* data);
 
+        //
+        // RPC data travels in the sender's byte order, and the receiver swizzles only when the peer's differs.
+        //  Peers from before IPC protocol version SENDER_ORDER_VERSION send (and expect) big endian data instead,
+        //  Host negotiates which it is from the connection's handshake.
+        //
+
+        const uint32_t SENDER_ORDER_VERSION = 1;
+
         template <class T>
         inline void Swizzle(T* data)
         {
-#ifdef HELIUM_ENDIAN_LITTLE
             Helium::Swizzle(*data, true);
-#endif
         }
 
         template <class T>
         inline void Swizzle(T& data)
         {
-#ifdef HELIUM_ENDIAN_LITTLE
             Swizzle(&data);
+        }
+
+        // our own byte order, fixed when we are built
+#if HELIUM_ENDIAN_LITTLE
+        const Helium::Platform::Endianness LOCAL_ENDIANNESS = Helium::Platform::Endiannesses::Little;
+#else
+        const Helium::Platform::Endianness LOCAL_ENDIANNESS = Helium::Platform::Endiannesses::Big;
 #endif
+
+        // only the peer's byte order is learned at runtime (from the handshake), so same-endian peers never touch the data
+        inline bool SwizzleRequired(Helium::Platform::Endianness remote)
+        {
+            return remote != LOCAL_ENDIANNESS;
         }
 
         template <class T>
@@ -50,6 +68,23 @@ namespace Helium
         const uint32_t MAX_STACK = 64;
         const uint32_t MAX_INVOKERS = 32;
         const uint32_t MAX_INTERFACES = 32;
+        const uint32_t MAX_PENDING = 256;      // in-flight asynchronous calls per host, power of two
+        const uint32_t MAX_BATCH = 64;         // invocations packed into one message before it is flushed
+
+        //
+        // Message IDs, batches pack several invocations (or replies) into a single IPC message.  The ID of an
+        //  invocation also names what to invoke, see Interface::GetID and Invoker::GetID
+        //
+
+        namespace MessageIDs
+        {
+            enum MessageID
+            {
+                Invocation,
+                Batch,
+            };
+        }
+        typedef MessageIDs::MessageID MessageID;
 
 
         //
@@ -77,6 +112,75 @@ namespace Helium
         typedef Helium::Signature< RPC::Args&>::Delegate ArgsDelegate;
 
 
+        //
+        // Future is the result of an asynchronous call, completed by Host when the reply
+        //  for its transaction arrives (or failed if the connection cycles first)
+        //
+
+        namespace FutureStates
+        {
+            enum FutureState
+            {
+                Pending,
+                Replied,
+                Failed,
+            };
+        }
+        typedef FutureStates::FutureState FutureState;
+
+        class Future;
+        typedef Helium::Signature< Future& >::Delegate FutureDelegate;
+
+        class HELIUM_FOUNDATION_API Future : public Helium::RefCountBase< Future >
+        {
+            friend class Host;
+
+        public:
+            Future(int32_t transaction, uint32_t flags, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback);
+            virtual ~Future();
+
+            FutureState GetState() const
+            {
+                return m_State;
+            }
+
+            bool IsComplete() const
+            {
+                return m_State != FutureStates::Pending;
+            }
+
+            int32_t GetTransaction() const
+            {
+                return m_Transaction;
+            }
+
+            // the args block of the reply (already swizzled), if the call was made with ReplyWithArgs
+            Args* GetArgs();
+
+            // the payload block of the reply, if the call was made with ReplyWithPayload
+            uint8_t* GetPayload();
+            uint32_t GetPayloadSize();
+
+            // copy the reply back into the caller's args and payload, like a blocking Emit does
+            bool CopyReply(Args* args);
+
+        private:
+            void Complete(uint8_t* data, uint32_t size);
+            void Fail();
+
+            int32_t         m_Transaction;
+            uint32_t        m_Flags;
+            uint32_t        m_ArgsSize;
+            SwizzleFunc     m_Swizzler;
+            FutureDelegate  m_Callback;
+
+            FutureState     m_State;
+            uint8_t*        m_ReplyData;
+            uint32_t        m_ReplySize;
+        };
+        typedef Helium::SmartPtr< Future > FuturePtr;
+
+
         //
         // Invoker:
         //  - packages an invocation for dispatch to a remote implementation
@@ -87,8 +191,10 @@ namespace Helium
         {
         public:
             Invoker (Interface* iface, SwizzleFunc swizzler)
-                : m_Interface (iface)
+                : m_Name (NULL)
+                , m_Interface (iface)
                 , m_Swizzler (swizzler)
+                , m_ID (0)
             {
                 HELIUM_ASSERT( iface && swizzler );
             }
@@ -103,7 +209,7 @@ namespace Helium
                 return 0;
             }
 
-            virtual void Invoke(uint8_t* data, uint32_t size) = 0;
+            virtual void Invoke(uint8_t* data, uint32_t size, bool swizzle) = 0;
 
             const char* GetName()
             {
@@ -115,6 +221,16 @@ namespace Helium
                 return m_Interface;
             }
 
+            // the message ID of invocations of this invoker, assigned when it is added to its interface
+            uint32_t GetID()
+            {
+                return m_ID;
+            }
+            void SetID(uint32_t id)
+            {
+                m_ID = id;
+            }
+
             void Swizzle( void* data )
             {
                 m_Swizzler( data );
@@ -124,6 +240,7 @@ namespace Helium
             const char*   m_Name;
             Interface*    m_Interface;
             SwizzleFunc   m_Swizzler;
+            uint32_t      m_ID;
         };
 
         typedef Helium::SmartPtr< Invoker > InvokerPtr;
@@ -152,11 +269,19 @@ namespace Helium
                 return m_Name;
             }
 
+            // a hash of the name, which both sides of a connection agree on
+            uint32_t GetID()
+            {
+                return m_ID;
+            }
+
             void AddInvoker(InvokerPtr invoker);
             Invoker* GetInvoker(const char* name);
+            Invoker* GetInvoker(uint32_t index);
 
         protected:
             const char*   m_Name;
+            uint32_t      m_ID;
             Host*         m_Host;
             InvokerPtr    m_Invokers[MAX_INVOKERS];
             uint32_t      m_InvokerCount;
@@ -182,6 +307,7 @@ namespace Helium
             // set/query local implementations
             void AddInterface(RPC::Interface* iface);
             Interface* GetInterface(const char* name);
+            Interface* GetInterface(uint32_t id);
 
             //
             // IPC connection settings
@@ -200,6 +326,40 @@ namespace Helium
             // helper function to send a single data block
             void Emit(Invoker* invoker, Args* args = NULL, uint32_t size = 0, SwizzleFunc swizzler = NULL);
 
+            // send without blocking, the returned future completes when the reply arrives (the
+            //  callback is invoked from within Dispatch/Wait on the calling thread)
+            FuturePtr Call(Invoker* invoker, Args* args = NULL, uint32_t size = 0, SwizzleFunc swizzler = NULL, const FutureDelegate& callback = FutureDelegate());
+
+            // allocate an outgoing message for args followed by payloadSize bytes to build in place, then
+            //  hand it to EmitMessage or CallMessage (which take ownership) to send it without another copy
+            IPC::Message* Prepare(Invoker* invoker, uint32_t argsSize, uint32_t payloadSize, Args*& args);
+
+            // send a prepared message without expecting a reply
+            void EmitMessage(Invoker* invoker, IPC::Message* message);
+
+            // send a prepared message, the returned future completes when the reply arrives
+            FuturePtr CallMessage(Invoker* invoker, IPC::Message* message, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback = FutureDelegate());
+
+            // process messages until the future completes, false if the connection broke (or timeout
+            //  milliseconds passed, if nonzero) first
+            bool Wait(Future* future, uint32_t timeout = 0);
+
+            // process messages until every in-flight call completes
+            bool WaitAll();
+
+            // number of in-flight asynchronous calls
+            uint32_t GetPendingCount()
+            {
+                return m_PendingCount;
+            }
+
+            // pack sends between Begin and End into as few messages as possible (batches nest)
+            void BeginBatch();
+            void EndBatch();
+
+            // send any invocations packed so far
+            void Flush();
+
             // process data from the other side
             bool Invoke(IPC::Message* msg);
 
@@ -216,6 +376,28 @@ namespace Helium
             // Call this to process all messages in the calling thread, pass true to sleep until the connection breaks
             bool Process(bool wait);
 
+            // handle a single received message, true if it completed a call we are waiting on
+            bool ProcessMessage(IPC::Message* msg);
+
+            // handle each invocation or reply packed in a batch message
+            bool ProcessBatch(IPC::Message* msg);
+
+            // pack args and payload into a new message
+            IPC::Message* Marshal(Invoker* invoker, Args* args, uint32_t size);
+
+            // send or queue a message into the current batch
+            void Post(IPC::Message* msg);
+
+            // send a marshalled call and track it until its reply arrives
+            FuturePtr Track(IPC::Message* message, uint32_t flags, uint32_t argsSize, SwizzleFunc swizzler, const FutureDelegate& callback);
+
+            // pick the byte order for the connected peer
+            void NegotiateByteOrder();
+
+            // reset the stack and fail in-flight calls if the connection cycled
+            void CheckConnection();
+            void FailPending();
+
         private:
             struct Frame
             {
@@ -246,9 +428,18 @@ namespace Helium
 
             IPC::Connection*    m_Connection;
             uint32_t                 m_ConnectionCount;
+            bool                m_SwizzleRemote;         // data from the peer isn't in our byte order
+            bool                m_SwizzleLocal;          // data to the peer has to be converted from our byte order
             Stack               m_Stack;
             Interface*          m_Interfaces[MAX_INTERFACES];
             uint32_t                 m_InterfaceCount;
+
+            FuturePtr           m_Pending[MAX_PENDING];  // in-flight calls, indexed by transaction
+            uint32_t            m_PendingCount;
+
+            IPC::Message*       m_Batch[MAX_BATCH];      // sends waiting to be packed
+            uint32_t            m_BatchCount;
+            uint32_t            m_BatchDepth;
         };
 
         template<class ArgsType>
@@ -270,15 +461,22 @@ namespace Helium
                 return sizeof(ArgsType);
             }
 
-            virtual void Invoke(uint8_t* data, uint32_t size)
+            virtual void Invoke(uint8_t* data, uint32_t size, bool swizzle)
             {
                 if (size)
                 {
-                    m_Swizzler(data);
+                    if (swizzle)
+                    {
+                        m_Swizzler(data);
+                    }
 
                     ArgsType* args = (ArgsType*)data;
 
-                    if ( sizeof(ArgsType) > size )
+                    // the payload is used in place, right after the args
+                    args->m_Payload = NULL;
+                    args->m_PayloadSize = 0;
+
+                    if ( size > sizeof(ArgsType) )
                     {
                         args->m_Payload = data + sizeof(ArgsType);
                         args->m_PayloadSize = size - sizeof(ArgsType);
@@ -295,6 +493,32 @@ namespace Helium
                 m_Interface->GetHost()->Emit(this, args, sizeof(ArgsType), m_Swizzler);
             }
 
+            FuturePtr Call(ArgsType* args, void* payload = NULL, uint32_t size = 0, const FutureDelegate& callback = FutureDelegate())
+            {
+                args->m_Payload = payload;
+                args->m_PayloadSize = size;
+                return m_Interface->GetHost()->Call(this, args, sizeof(ArgsType), m_Swizzler, callback);
+            }
+
+            // build args directly in an outgoing message, args->m_Payload points at payloadSize bytes after them
+            IPC::Message* Prepare(ArgsType*& args, uint32_t payloadSize = 0)
+            {
+                Args* base = NULL;
+                IPC::Message* message = m_Interface->GetHost()->Prepare(this, sizeof(ArgsType), payloadSize, base);
+                args = static_cast< ArgsType* >( base );
+                return message;
+            }
+
+            void Emit(IPC::Message* message)
+            {
+                m_Interface->GetHost()->EmitMessage(this, message);
+            }
+
+            FuturePtr Call(IPC::Message* message, const FutureDelegate& callback = FutureDelegate())
+            {
+                return m_Interface->GetHost()->CallMessage(this, message, sizeof(ArgsType), m_Swizzler, callback);
+            }
+
         private:
             InvokerDelegate m_Delegate;
         };
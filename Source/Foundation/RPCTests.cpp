@@ -0,0 +1,617 @@
+#include "Precompile.h"
+#include "Foundation/RPC.h"
+#include "Foundation/IPC.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+using namespace Helium;
+
+namespace
+{
+	struct RPCTestArgs : RPC::Args
+	{
+		uint32_t m_Value;
+		uint32_t m_Result;
+	};
+}
+
+namespace Helium
+{
+	namespace RPC
+	{
+		template <>
+		inline void Swizzle<RPCTestArgs>(RPCTestArgs* data)
+		{
+			Helium::Swizzle( data->m_Flags );
+			Helium::Swizzle( data->m_PayloadSize );
+			Helium::Swizzle( data->m_Value );
+			Helium::Swizzle( data->m_Result );
+		}
+	}
+}
+
+namespace
+{
+	//
+	// Both ends of a connection in one process: what one side sends is queued for the other, and
+	//  blocking on an empty queue dispatches the other side's host instead, so a test runs on one thread
+	//
+
+	class LoopbackConnection : public IPC::Connection
+	{
+	public:
+		LoopbackConnection()
+			: m_Peer (NULL)
+			, m_PeerHost (NULL)
+			, m_Hold (false)
+			, m_Sent (0)
+		{
+
+		}
+
+		~LoopbackConnection()
+		{
+			for ( std::vector< IPC::Message* >::const_iterator itr = m_Held.begin(), end = m_Held.end(); itr != end; ++itr )
+			{
+				delete *itr;
+			}
+		}
+
+		void Connect(bool server, const char* name, LoopbackConnection* peer, RPC::Host* peerHost)
+		{
+			Initialize( server, name );
+			m_Peer = peer;
+			m_PeerHost = peerHost;
+			SetState( IPC::ConnectionStates::Active );
+		}
+
+		// drop and reestablish the connection, messages in flight are lost
+		void Cycle()
+		{
+			SetState( IPC::ConnectionStates::Closed );
+			m_ReadQueue.Clear();
+			SetState( IPC::ConnectionStates::Active );
+		}
+
+		// keep sent messages back until they are released, optionally in reverse order
+		void Hold()
+		{
+			m_Hold = true;
+		}
+
+		void Release(bool reverse = false)
+		{
+			if ( reverse )
+			{
+				std::reverse( m_Held.begin(), m_Held.end() );
+			}
+
+			for ( std::vector< IPC::Message* >::const_iterator itr = m_Held.begin(), end = m_Held.end(); itr != end; ++itr )
+			{
+				m_Peer->m_ReadQueue.Add( *itr );
+			}
+
+			m_Held.clear();
+			m_Hold = false;
+		}
+
+		// queue a message as if the peer had sent it
+		void Deliver(IPC::Message* msg)
+		{
+			m_ReadQueue.Add( msg );
+		}
+
+		// pretend the handshake came from another kind of peer
+		void SetRemote(Helium::Platform::Endianness endianness, uint32_t version)
+		{
+			m_RemoteEndianness = endianness;
+			m_RemoteVersion = version;
+		}
+
+		uint32_t GetSent()
+		{
+			return m_Sent;
+		}
+
+		virtual IPC::ConnectionState Send(IPC::Message* msg)
+		{
+			if ( GetState() != IPC::ConnectionStates::Active )
+			{
+				return GetState();
+			}
+
+			++m_Sent;
+
+			if ( m_Hold )
+			{
+				m_Held.push_back( msg );
+			}
+			else
+			{
+				m_Peer->m_ReadQueue.Add( msg );
+			}
+
+			return IPC::ConnectionStates::Active;
+		}
+
+		virtual IPC::ConnectionState Receive(IPC::Message** msg, bool wait)
+		{
+			if ( wait && m_ReadQueue.Count() == 0 && m_PeerHost )
+			{
+				m_PeerHost->Dispatch();
+			}
+
+			return Connection::Receive( msg, false );
+		}
+
+	protected:
+		virtual void Close()
+		{
+
+		}
+
+		virtual bool ReadMessage(IPC::Message** msg)
+		{
+			return false;
+		}
+
+		virtual bool WriteMessage(IPC::Message* msg)
+		{
+			return false;
+		}
+
+		virtual bool Read(void* buffer, uint32_t bytes)
+		{
+			return false;
+		}
+
+		virtual bool Write(void* buffer, uint32_t bytes)
+		{
+			return false;
+		}
+
+	private:
+		LoopbackConnection*          m_Peer;
+		RPC::Host*                   m_PeerHost;
+		bool                         m_Hold;
+		uint32_t                     m_Sent;
+		std::vector< IPC::Message* > m_Held;
+	};
+
+	class RPCTestInterface : public RPC::Interface
+	{
+	public:
+		typedef RPC::InvokerTemplate< RPCTestArgs > TestInvoker;
+
+		RPCTestInterface()
+			: Interface ("RPCTest")
+		{
+			m_Double = new TestInvoker ( this, TestInvoker::InvokerDelegate( this, &RPCTestInterface::Double ) );
+			AddInvoker( m_Double );
+
+			m_Ignore = new TestInvoker ( this, TestInvoker::InvokerDelegate( this, &RPCTestInterface::Ignore ) );
+			AddInvoker( m_Ignore );
+		}
+
+		// doubles the value into the result, and increments each byte of the payload
+		void Double( RPCTestArgs& args )
+		{
+			m_Received.push_back( args.m_Value );
+			args.m_Result = args.m_Value * 2;
+
+			uint8_t* payload = static_cast< uint8_t* >( args.m_Payload );
+			for ( uint32_t i = 0; i < args.m_PayloadSize; ++i )
+			{
+				++payload[ i ];
+			}
+		}
+
+		void Ignore( RPCTestArgs& args )
+		{
+			m_Received.push_back( args.m_Value );
+		}
+
+		TestInvoker*            m_Double;
+		TestInvoker*            m_Ignore;
+		std::vector< uint32_t > m_Received;
+	};
+
+	// records the order futures complete in
+	struct FutureLog
+	{
+		std::vector< int32_t > m_Completed;
+		std::vector< int32_t > m_Failed;
+
+		void Done( RPC::Future& future )
+		{
+			if ( future.GetState() == RPC::FutureStates::Replied )
+			{
+				m_Completed.push_back( future.GetTransaction() );
+			}
+			else
+			{
+				m_Failed.push_back( future.GetTransaction() );
+			}
+		}
+	};
+
+	struct RPCLoopback
+	{
+		LoopbackConnection m_ClientConnection;
+		LoopbackConnection m_ServerConnection;
+		RPC::Host          m_Client;
+		RPC::Host          m_Server;
+		RPCTestInterface   m_ClientInterface;
+		RPCTestInterface   m_ServerInterface;
+
+		RPCLoopback()
+		{
+			m_ClientConnection.Connect( false, "RPC Client", &m_ServerConnection, &m_Server );
+			m_ServerConnection.Connect( true, "RPC Server", &m_ClientConnection, &m_Client );
+
+			m_Client.AddInterface( &m_ClientInterface );
+			m_Client.SetConnection( &m_ClientConnection );
+			m_Server.AddInterface( &m_ServerInterface );
+			m_Server.SetConnection( &m_ServerConnection );
+		}
+
+		RPC::FuturePtr Call( uint32_t value, FutureLog* log = NULL, uint32_t flags = RPC::Flags::ReplyWithArgs )
+		{
+			RPCTestArgs args;
+			memset( &args, 0, sizeof( args ) );
+			args.m_Flags = flags;
+			args.m_Value = value;
+
+			RPC::FutureDelegate callback;
+			if ( log )
+			{
+				callback = RPC::FutureDelegate( log, &FutureLog::Done );
+			}
+
+			return m_ClientInterface.m_Double->Call( &args, NULL, 0, callback );
+		}
+	};
+}
+
+TEST(Foundation, RPCCallAndEmit)
+{
+	RPCLoopback loopback;
+
+	// a blocking emit copies the reply args and payload back
+	RPCTestArgs args;
+	memset( &args, 0, sizeof( args ) );
+	args.m_Flags = RPC::Flags::ReplyWithArgs | RPC::Flags::ReplyWithPayload;
+	args.m_Value = 21;
+	uint8_t payload[ 4 ] = { 1, 2, 3, 4 };
+	loopback.m_ClientInterface.m_Double->Emit( &args, payload, sizeof( payload ) );
+	EXPECT_EQ( 42u, args.m_Result );
+	EXPECT_EQ( 2, payload[ 0 ] );
+	EXPECT_EQ( 5, payload[ 3 ] );
+
+	// the future holds the reply (in our byte order) until it is released
+	FutureLog log;
+	RPC::FuturePtr future = loopback.Call( 5, &log );
+	EXPECT_EQ( RPC::FutureStates::Pending, future->GetState() );
+	EXPECT_EQ( 1u, loopback.m_Client.GetPendingCount() );
+	ASSERT_TRUE( loopback.m_Client.Wait( future ) );
+	EXPECT_EQ( RPC::FutureStates::Replied, future->GetState() );
+	EXPECT_EQ( 0u, loopback.m_Client.GetPendingCount() );
+	ASSERT_EQ( 1u, log.m_Completed.size() );
+	EXPECT_EQ( future->GetTransaction(), log.m_Completed[ 0 ] );
+
+	RPCTestArgs* reply = static_cast< RPCTestArgs* >( future->GetArgs() );
+	ASSERT_TRUE( reply != NULL );
+	EXPECT_EQ( 10u, reply->m_Result );
+
+	RPCTestArgs copied;
+	memset( &copied, 0, sizeof( copied ) );
+	EXPECT_TRUE( future->CopyReply( &copied ) );
+	EXPECT_EQ( 10u, copied.m_Result );
+
+	// a call built in the outgoing message
+	RPCTestArgs* prepared = NULL;
+	IPC::Message* message = loopback.m_ClientInterface.m_Double->Prepare( prepared, 2 );
+	prepared->m_Flags = RPC::Flags::ReplyWithPayload;
+	prepared->m_Value = 7;
+	static_cast< uint8_t* >( prepared->m_Payload )[ 0 ] = 8;
+	static_cast< uint8_t* >( prepared->m_Payload )[ 1 ] = 9;
+	future = loopback.m_ClientInterface.m_Double->Call( message );
+	ASSERT_TRUE( loopback.m_Client.Wait( future ) );
+	ASSERT_EQ( 2u, future->GetPayloadSize() );
+	EXPECT_EQ( 9, future->GetPayload()[ 0 ] );
+	EXPECT_EQ( 10, future->GetPayload()[ 1 ] );
+
+	uint32_t received[] = { 21, 5, 7 };
+	EXPECT_EQ( std::vector< uint32_t >( received, received + 3 ), loopback.m_ServerInterface.m_Received );
+}
+
+TEST(Foundation, RPCBatch)
+{
+	RPCLoopback loopback;
+	const uint32_t callCount = 10;
+
+	// the calls go out in one message, and their replies come back in one
+	FutureLog log;
+	RPC::FuturePtr futures[ callCount ];
+	loopback.m_Client.BeginBatch();
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		futures[ i ] = loopback.Call( i, &log );
+	}
+	EXPECT_EQ( 0u, loopback.m_ClientConnection.GetSent() );
+
+	// nested batches go out with the outermost one
+	RPCTestArgs args;
+	memset( &args, 0, sizeof( args ) );
+	args.m_Flags = RPC::Flags::NonBlocking;
+	loopback.m_Client.BeginBatch();
+	loopback.m_ClientInterface.m_Ignore->Emit( &args );
+	loopback.m_Client.EndBatch();
+	EXPECT_EQ( 0u, loopback.m_ClientConnection.GetSent() );
+
+	loopback.m_Client.EndBatch();
+	EXPECT_EQ( 1u, loopback.m_ClientConnection.GetSent() );
+
+	ASSERT_TRUE( loopback.m_Client.WaitAll() );
+	EXPECT_EQ( 1u, loopback.m_ServerConnection.GetSent() );
+	EXPECT_EQ( callCount, log.m_Completed.size() );
+
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		ASSERT_EQ( RPC::FutureStates::Replied, futures[ i ]->GetState() );
+		EXPECT_EQ( i * 2, static_cast< RPCTestArgs* >( futures[ i ]->GetArgs() )->m_Result );
+	}
+
+	// the server ran them in the order they were batched
+	ASSERT_EQ( callCount + 1, loopback.m_ServerInterface.m_Received.size() );
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		EXPECT_EQ( i, loopback.m_ServerInterface.m_Received[ i ] );
+	}
+
+	// a full batch is flushed without waiting for EndBatch
+	loopback.m_Client.BeginBatch();
+	for ( uint32_t i = 0; i < RPC::MAX_BATCH; ++i )
+	{
+		loopback.m_ClientInterface.m_Ignore->Emit( &args );
+	}
+	EXPECT_EQ( 2u, loopback.m_ClientConnection.GetSent() );
+	loopback.m_Client.EndBatch();
+	EXPECT_EQ( 2u, loopback.m_ClientConnection.GetSent() );
+}
+
+TEST(Foundation, RPCOutOfOrderReplies)
+{
+	RPCLoopback loopback;
+	const uint32_t callCount = 8;
+
+	FutureLog log;
+	RPC::FuturePtr futures[ callCount ];
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		futures[ i ] = loopback.Call( 100 + i, &log );
+	}
+	EXPECT_EQ( callCount, loopback.m_Client.GetPendingCount() );
+
+	// the server answers in order, the replies arrive newest first
+	loopback.m_ServerConnection.Hold();
+	while ( loopback.m_Server.Dispatch() );
+	EXPECT_EQ( callCount, loopback.m_ServerInterface.m_Received.size() );
+	loopback.m_ServerConnection.Release( true );
+
+	ASSERT_TRUE( loopback.m_Client.WaitAll() );
+	EXPECT_EQ( 0u, loopback.m_Client.GetPendingCount() );
+	ASSERT_EQ( callCount, log.m_Completed.size() );
+
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		// each future got its own reply, in the order the replies came
+		EXPECT_EQ( futures[ callCount - 1 - i ]->GetTransaction(), log.m_Completed[ i ] );
+		EXPECT_EQ( ( 100 + i ) * 2, static_cast< RPCTestArgs* >( futures[ i ]->GetArgs() )->m_Result );
+	}
+
+	// more calls than there are pending slots wait for slots to free up
+	const uint32_t manyCount = RPC::MAX_PENDING + 16;
+	std::vector< RPC::FuturePtr > many;
+	for ( uint32_t i = 0; i < manyCount; ++i )
+	{
+		many.push_back( loopback.Call( i ) );
+		EXPECT_GE( RPC::MAX_PENDING, loopback.m_Client.GetPendingCount() );
+	}
+
+	ASSERT_TRUE( loopback.m_Client.WaitAll() );
+	for ( uint32_t i = 0; i < manyCount; ++i )
+	{
+		ASSERT_EQ( RPC::FutureStates::Replied, many[ i ]->GetState() );
+		EXPECT_EQ( i * 2, static_cast< RPCTestArgs* >( many[ i ]->GetArgs() )->m_Result );
+	}
+}
+
+TEST(Foundation, RPCFutureTimeout)
+{
+	RPCLoopback loopback;
+
+	// the reply is held back, so the wait times out and the call stays in flight
+	loopback.m_ServerConnection.Hold();
+	FutureLog log;
+	RPC::FuturePtr future = loopback.Call( 3, &log );
+	while ( loopback.m_Server.Dispatch() );
+
+	uint64_t start = Timer::GetTickCount();
+	EXPECT_FALSE( loopback.m_Client.Wait( future, 20 ) );
+	EXPECT_LE( 20.f, Timer::TicksToMilliseconds( Timer::GetTickCount() - start ) );
+	EXPECT_EQ( RPC::FutureStates::Pending, future->GetState() );
+	EXPECT_EQ( 1u, loopback.m_Client.GetPendingCount() );
+	EXPECT_TRUE( log.m_Completed.empty() );
+	EXPECT_TRUE( future->GetArgs() == NULL );
+
+	// and completes once the reply shows up
+	loopback.m_ServerConnection.Release();
+	EXPECT_TRUE( loopback.m_Client.Wait( future, 20 ) );
+	EXPECT_EQ( RPC::FutureStates::Replied, future->GetState() );
+	EXPECT_EQ( 6u, static_cast< RPCTestArgs* >( future->GetArgs() )->m_Result );
+	ASSERT_EQ( 1u, log.m_Completed.size() );
+
+	// a call the other side never answers ends the wait when the connection runs dry
+	loopback.m_ServerConnection.Hold();
+	future = loopback.Call( 4 );
+	EXPECT_FALSE( loopback.m_Client.Wait( future ) );
+	EXPECT_EQ( RPC::FutureStates::Pending, future->GetState() );
+	loopback.m_ServerConnection.Release();
+	EXPECT_TRUE( loopback.m_Client.Wait( future ) );
+}
+
+TEST(Foundation, RPCConnectionCycle)
+{
+	RPCLoopback loopback;
+
+	FutureLog log;
+	RPC::FuturePtr first = loopback.Call( 1, &log );
+	RPC::FuturePtr second = loopback.Call( 2, &log );
+	loopback.m_Client.BeginBatch();
+	loopback.Call( 3, &log );
+
+	// the calls in flight (and the batch) belonged to the old connection, so they fail
+	loopback.m_ServerConnection.Cycle();
+	loopback.m_ClientConnection.Cycle();
+	EXPECT_FALSE( loopback.m_Client.Dispatch() );
+	EXPECT_EQ( RPC::FutureStates::Failed, first->GetState() );
+	EXPECT_EQ( RPC::FutureStates::Failed, second->GetState() );
+	EXPECT_EQ( 0u, loopback.m_Client.GetPendingCount() );
+	EXPECT_EQ( 3u, log.m_Failed.size() );
+	EXPECT_FALSE( loopback.m_Client.Wait( first ) );
+
+	loopback.m_Client.EndBatch();
+	EXPECT_TRUE( loopback.m_ServerInterface.m_Received.empty() );
+
+	// the new connection works as usual
+	RPC::FuturePtr third = loopback.Call( 4, &log );
+	ASSERT_TRUE( loopback.m_Client.Wait( third ) );
+	EXPECT_EQ( 8u, static_cast< RPCTestArgs* >( third->GetArgs() )->m_Result );
+	EXPECT_EQ( 1u, log.m_Completed.size() );
+}
+
+TEST(Foundation, RPCByteOrder)
+{
+	RPCLoopback loopback;
+	Helium::Platform::Endianness opposite = Helium::Platform::GetEndianness() == Helium::Platform::Endiannesses::Little ? Helium::Platform::Endiannesses::Big : Helium::Platform::Endiannesses::Little;
+
+	// a current peer of the other byte order sends in its own order, and gets our order back
+	loopback.m_ServerConnection.SetRemote( opposite, IPC::PROTOCOL_VERSION );
+	loopback.m_Server.SetConnection( &loopback.m_ServerConnection );
+
+	uint8_t payload[ 2 ] = { 0x10, 0x20 };
+	IPC::Message* msg = loopback.m_ServerConnection.CreateMessage( loopback.m_ServerInterface.m_Double->GetID(), sizeof( RPCTestArgs ) + sizeof( payload ), 1 );
+	RPCTestArgs* args = reinterpret_cast< RPCTestArgs* >( msg->GetData() );
+	memset( args, 0, sizeof( RPCTestArgs ) );
+	args->m_Flags = RPC::Flags::ReplyWithArgs | RPC::Flags::ReplyWithPayload;
+	args->m_Value = 0x01020304;
+	memcpy( msg->GetData() + sizeof( RPCTestArgs ), payload, sizeof( payload ) );
+	RPC::Swizzle( args );
+
+	loopback.m_ServerConnection.Deliver( msg );
+	loopback.m_ServerConnection.Hold();
+	EXPECT_FALSE( loopback.m_Server.Dispatch() );
+	ASSERT_EQ( 1u, loopback.m_ServerInterface.m_Received.size() );
+	EXPECT_EQ( 0x01020304u, loopback.m_ServerInterface.m_Received[ 0 ] );
+	loopback.m_ServerConnection.Release();
+
+	IPC::Message* reply = NULL;
+	loopback.m_ClientConnection.Receive( &reply, false );
+	ASSERT_TRUE( reply != NULL );
+	ASSERT_EQ( sizeof( RPCTestArgs ) + sizeof( payload ), reply->GetSize() );
+	EXPECT_EQ( 1, reply->GetTransaction() );
+	RPCTestArgs* replyArgs = reinterpret_cast< RPCTestArgs* >( reply->GetData() );
+	EXPECT_EQ( 0x02040608u, replyArgs->m_Result );
+	EXPECT_EQ( static_cast< uint32_t >( RPC::Flags::ReplyWithArgs | RPC::Flags::ReplyWithPayload ), replyArgs->m_Flags );
+	EXPECT_EQ( 0x11, reply->GetData()[ sizeof( RPCTestArgs ) ] );
+	EXPECT_EQ( 0x21, reply->GetData()[ sizeof( RPCTestArgs ) + 1 ] );
+	delete reply;
+
+	// a peer from before the byte order was negotiated sends and expects big endian, whatever its own order
+	loopback.m_ServerConnection.SetRemote( Helium::Platform::GetEndianness(), 0 );
+	loopback.m_Server.SetConnection( &loopback.m_ServerConnection );
+
+	msg = loopback.m_ServerConnection.CreateMessage( loopback.m_ServerInterface.m_Double->GetID(), sizeof( RPCTestArgs ), 3 );
+	args = reinterpret_cast< RPCTestArgs* >( msg->GetData() );
+	memset( args, 0, sizeof( RPCTestArgs ) );
+	args->m_Flags = RPC::Flags::ReplyWithArgs;
+	args->m_Value = 0x00010002;
+	if ( RPC::SwizzleRequired( Helium::Platform::Endiannesses::Big ) )
+	{
+		RPC::Swizzle( args );
+	}
+
+	loopback.m_ServerConnection.Deliver( msg );
+	loopback.m_ServerConnection.Hold();
+	EXPECT_FALSE( loopback.m_Server.Dispatch() );
+	ASSERT_EQ( 2u, loopback.m_ServerInterface.m_Received.size() );
+	EXPECT_EQ( 0x00010002u, loopback.m_ServerInterface.m_Received[ 1 ] );
+	loopback.m_ServerConnection.Release();
+
+	reply = NULL;
+	loopback.m_ClientConnection.Receive( &reply, false );
+	ASSERT_TRUE( reply != NULL );
+	ASSERT_EQ( sizeof( RPCTestArgs ), reply->GetSize() );
+	replyArgs = reinterpret_cast< RPCTestArgs* >( reply->GetData() );
+	if ( RPC::SwizzleRequired( Helium::Platform::Endiannesses::Big ) )
+	{
+		RPC::Swizzle( replyArgs );
+	}
+	EXPECT_EQ( 0x00020004u, replyArgs->m_Result );
+	delete reply;
+}
+
+TEST(Foundation, RPCByteOrderUnversionedPeers)
+{
+	RPCLoopback loopback;
+
+	// both sides think the other predates versioning, so everything travels big endian and still decodes
+	loopback.m_ClientConnection.SetRemote( Helium::Platform::GetEndianness(), 0 );
+	loopback.m_Client.SetConnection( &loopback.m_ClientConnection );
+	loopback.m_ServerConnection.SetRemote( Helium::Platform::GetEndianness(), 0 );
+	loopback.m_Server.SetConnection( &loopback.m_ServerConnection );
+
+	RPCTestArgs args;
+	memset( &args, 0, sizeof( args ) );
+	args.m_Flags = RPC::Flags::ReplyWithArgs;
+	args.m_Value = 0x01000001;
+	loopback.m_ClientInterface.m_Double->Emit( &args );
+	EXPECT_EQ( 0x02000002u, args.m_Result );
+	EXPECT_EQ( 0x01000001u, args.m_Value );
+
+	RPC::FuturePtr future = loopback.Call( 0x00030000 );
+	ASSERT_TRUE( loopback.m_Client.Wait( future ) );
+	EXPECT_EQ( 0x00060000u, static_cast< RPCTestArgs* >( future->GetArgs() )->m_Result );
+
+	RPCTestArgs* prepared = NULL;
+	IPC::Message* message = loopback.m_ClientInterface.m_Double->Prepare( prepared );
+	prepared->m_Flags = RPC::Flags::ReplyWithArgs;
+	prepared->m_Value = 0x00000500;
+	future = loopback.m_ClientInterface.m_Double->Call( message );
+	ASSERT_TRUE( loopback.m_Client.Wait( future ) );
+	EXPECT_EQ( 0x00000a00u, static_cast< RPCTestArgs* >( future->GetArgs() )->m_Result );
+
+	const uint32_t callCount = 4;
+	RPC::FuturePtr futures[ callCount ];
+	loopback.m_Client.BeginBatch();
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		futures[ i ] = loopback.Call( 0x00010000 * ( i + 1 ) );
+	}
+	loopback.m_Client.EndBatch();
+	ASSERT_TRUE( loopback.m_Client.WaitAll() );
+	for ( uint32_t i = 0; i < callCount; ++i )
+	{
+		EXPECT_EQ( 0x00020000u * ( i + 1 ), static_cast< RPCTestArgs* >( futures[ i ]->GetArgs() )->m_Result );
+	}
+
+	uint32_t received[] = { 0x01000001, 0x00030000, 0x00000500, 0x00010000, 0x00020000, 0x00030000, 0x00040000 };
+	EXPECT_EQ( std::vector< uint32_t >( received, received + 7 ), loopback.m_ServerInterface.m_Received );
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Foundation/Event.h"
+#include "Foundation/IPCTCP.h"
+#include "Foundation/IPCSharedMemory.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Process.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// Helpers shared by the Foundation tests and benchmarks, not part of the library
+//
+
+namespace Helium
+{
+	namespace FoundationTests
+	{
+		struct EventTestArgs
+		{
+			uint32_t m_Value;
+
+			EventTestArgs( uint32_t value = 0 )
+				: m_Value( value )
+			{
+			}
+		};
+
+		typedef Signature< const EventTestArgs&, AtomicRefCountBase > EventTestSignature;
+
+		struct EventCounter
+		{
+			int32_t volatile m_Calls;
+			uint32_t         m_Sum;
+
+			EventCounter()
+				: m_Calls( 0 )
+				, m_Sum( 0 )
+			{
+			}
+
+			void Count( const EventTestArgs& args )
+			{
+				AtomicIncrement( m_Calls );
+				m_Sum += args.m_Value;
+			}
+
+			void Tally( const EventTestArgs& args )
+			{
+				m_Sum += args.m_Value;
+			}
+		};
+
+		const uint32_t LoopbackProducerCount = 4;
+
+		// each test process gets its own block of four ports (two connections, a read and a write port each),
+		//  so concurrent runs on the same machine don't bind each other's ports
+		inline uint16_t LoopbackPort()
+		{
+			return static_cast< uint16_t >( 20000 + ( GetProcessId() % 10000 ) * 4 );
+		}
+
+		// and its own shared memory segment
+		inline std::string LoopbackName()
+		{
+			std::stringstream name;
+			name << "helium_ipc_tests_" << GetProcessId();
+			return name.str();
+		}
+
+		struct LoopbackPayload
+		{
+			uint32_t m_Producer;
+			uint32_t m_Sequence;
+			uint64_t m_SentTicks;
+		};
+
+		struct LoopbackProducer
+		{
+			IPC::Connection* m_Connection;
+			uint32_t         m_Index;
+			uint32_t         m_Count;
+
+			void Run()
+			{
+				for ( uint32_t i=0; i<m_Count; i++ )
+				{
+					IPC::Message* msg = m_Connection->CreateMessage( 1, sizeof( LoopbackPayload ) );
+
+					LoopbackPayload* payload = reinterpret_cast< LoopbackPayload* >( msg->GetData() );
+					payload->m_Producer = m_Index;
+					payload->m_Sequence = i;
+					payload->m_SentTicks = Timer::GetTickCount();
+
+					while ( m_Connection->Send( msg ) != IPC::ConnectionStates::Active )
+					{
+						Thread::Yield();
+					}
+				}
+			}
+		};
+
+		struct LoopbackResult
+		{
+			float64_t               m_ElapsedMs;
+			std::vector< uint64_t > m_Latencies;  // ticks from send to receive, in arrival order
+		};
+
+		inline bool WaitForActive( IPC::Connection& connection )
+		{
+			for ( uint32_t i=0; i<500 && connection.GetState() != IPC::ConnectionStates::Active; i++ )
+			{
+				Thread::Sleep( 10 );
+			}
+
+			return connection.GetState() == IPC::ConnectionStates::Active;
+		}
+
+		// Sends messages from several producer threads through an initialized connection pair and validates
+		//  per-producer ordering, then cleans both connections up
+		inline void RunLoopback( IPC::Connection& server, IPC::Connection& client, uint32_t messageCount, LoopbackResult& result )
+		{
+			ASSERT_TRUE( WaitForActive( server ) );
+			ASSERT_TRUE( WaitForActive( client ) );
+
+			LoopbackProducer producers[ LoopbackProducerCount ];
+			CallbackThread threads[ LoopbackProducerCount ];
+
+			uint64_t startTicks = Timer::GetTickCount();
+
+			for ( uint32_t i=0; i<LoopbackProducerCount; i++ )
+			{
+				producers[i].m_Connection = &client;
+				producers[i].m_Index = i;
+				producers[i].m_Count = messageCount / LoopbackProducerCount;
+
+				CallbackThread::Entry entry = &CallbackThread::EntryHelper< LoopbackProducer, &LoopbackProducer::Run >;
+				ASSERT_TRUE( threads[i].Create( entry, &producers[i], "Loopback Producer" ) );
+			}
+
+			result.m_Latencies.clear();
+			result.m_Latencies.reserve( messageCount );
+
+			uint32_t expected[ LoopbackProducerCount ] = { 0 };
+			while ( result.m_Latencies.size() < messageCount )
+			{
+				IPC::Message* msg = NULL;
+				server.Receive( &msg, true );
+				ASSERT_TRUE( msg != NULL );
+
+				const LoopbackPayload* payload = reinterpret_cast< const LoopbackPayload* >( msg->GetData() );
+				result.m_Latencies.push_back( Timer::GetTickCount() - payload->m_SentTicks );
+
+				ASSERT_LT( payload->m_Producer, LoopbackProducerCount );
+				EXPECT_EQ( expected[ payload->m_Producer ]++, payload->m_Sequence );
+
+				delete msg;
+			}
+
+			result.m_ElapsedMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks );
+
+			for ( uint32_t i=0; i<LoopbackProducerCount; i++ )
+			{
+				threads[i].Join();
+			}
+
+			client.Cleanup();
+			server.Cleanup();
+		}
+
+		inline void RunTCPLoopback( IPC::MessageQueueMode mode, uint16_t port, uint32_t messageCount, LoopbackResult& result )
+		{
+			IPC::TCPConnection server;
+			server.SetReadQueueMode( mode );
+			server.SetWriteQueueMode( mode );
+
+			IPC::TCPConnection client;
+			client.SetReadQueueMode( mode );
+			client.SetWriteQueueMode( mode );
+
+			ASSERT_TRUE( server.Initialize( true, "Loopback Server", "127.0.0.1", port ) );
+			ASSERT_TRUE( client.Initialize( false, "Loopback Client", "127.0.0.1", port ) );
+
+			RunLoopback( server, client, messageCount, result );
+		}
+
+#if HELIUM_OS_LINUX
+		inline void RunSharedMemoryLoopback( uint32_t messageCount, LoopbackResult& result )
+		{
+			IPC::SharedMemoryConnection server;
+			server.SetReadQueueMode( IPC::MessageQueueModes::LockFree );
+			server.SetWriteQueueMode( IPC::MessageQueueModes::LockFree );
+
+			IPC::SharedMemoryConnection client;
+			client.SetReadQueueMode( IPC::MessageQueueModes::LockFree );
+			client.SetWriteQueueMode( IPC::MessageQueueModes::LockFree );
+
+			std::string name = LoopbackName();
+			ASSERT_TRUE( server.Initialize( true, "Loopback Server", name.c_str() ) );
+			ASSERT_TRUE( client.Initialize( false, "Loopback Client", name.c_str() ) );
+
+			RunLoopback( server, client, messageCount, result );
+		}
+#endif
+	}
+}
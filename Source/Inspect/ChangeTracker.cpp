@@ -0,0 +1,125 @@
+#include "Precompile.h"
+#include "Inspect/ChangeTracker.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::Inspect;
+
+ChangeTracker::ChangeTracker( Container* root )
+	: m_Root( root )
+{
+}
+
+ChangeTracker::~ChangeTracker()
+{
+	UntrackAll();
+}
+
+void ChangeTracker::Track( Reflect::Object* object )
+{
+	HELIUM_ASSERT( object );
+	if ( std::find( m_Objects.begin(), m_Objects.end(), object ) == m_Objects.end() )
+	{
+		object->e_Changed.AddMethod( this, &ChangeTracker::ObjectChanged );
+		m_Objects.push_back( object );
+	}
+}
+
+void ChangeTracker::Track( const std::vector< Reflect::Object* >& objects )
+{
+	m_Objects.reserve( m_Objects.size() + objects.size() );
+	for ( std::vector< Reflect::Object* >::const_iterator itr = objects.begin(), end = objects.end(); itr != end; ++itr )
+	{
+		Track( *itr );
+	}
+}
+
+void ChangeTracker::Untrack( Reflect::Object* object )
+{
+	std::vector< Reflect::Object* >::iterator found = std::find( m_Objects.begin(), m_Objects.end(), object );
+	if ( found != m_Objects.end() )
+	{
+		object->e_Changed.RemoveMethod( this, &ChangeTracker::ObjectChanged );
+		m_Objects.erase( found );
+	}
+}
+
+void ChangeTracker::UntrackAll()
+{
+	for ( std::vector< Reflect::Object* >::const_iterator itr = m_Objects.begin(), end = m_Objects.end(); itr != end; ++itr )
+	{
+		(*itr)->e_Changed.RemoveMethod( this, &ChangeTracker::ObjectChanged );
+	}
+
+	m_Objects.clear();
+	m_Changes.clear();
+}
+
+size_t ChangeTracker::Refresh()
+{
+	size_t count = 0;
+	if ( !m_Changes.empty() )
+	{
+		count = Refresh( m_Root );
+		m_Changes.clear();
+	}
+
+	return count;
+}
+
+void ChangeTracker::ObjectChanged( const Reflect::ObjectChangeArgs& args )
+{
+	for ( std::vector< Change >::iterator itr = m_Changes.begin(), end = m_Changes.end(); itr != end; ++itr )
+	{
+		if ( itr->m_Object == args.m_Object )
+		{
+			if ( itr->m_Field == args.m_Field || itr->m_Field == NULL )
+			{
+				return;
+			}
+
+			// the whole object changed, that covers the fields already queued for it
+			if ( args.m_Field == NULL )
+			{
+				itr->m_Field = NULL;
+				return;
+			}
+		}
+	}
+
+	Change change;
+	change.m_Object = args.m_Object;
+	change.m_Field = args.m_Field;
+	m_Changes.push_back( change );
+}
+
+size_t ChangeTracker::Refresh( Control* control )
+{
+	const DataBinding* binding = control->GetBinding();
+	if ( binding )
+	{
+		for ( std::vector< Change >::const_iterator itr = m_Changes.begin(), end = m_Changes.end(); itr != end; ++itr )
+		{
+			if ( binding->IsBoundTo( itr->m_Object, itr->m_Field ) )
+			{
+				// containers read their children too
+				control->Read();
+				return 1;
+			}
+		}
+	}
+
+	size_t count = 0;
+	Container* container = Reflect::SafeCast< Container >( control );
+	if ( container )
+	{
+		const std::vector< ControlPtr >& children = container->GetChildren();
+		for ( std::vector< ControlPtr >::const_iterator itr = children.begin(), end = children.end(); itr != end; ++itr )
+		{
+			count += Refresh( *itr );
+		}
+	}
+
+	return count;
+}
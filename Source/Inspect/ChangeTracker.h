@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Inspect/API.h"
+#include "Inspect/Container.h"
+
+#include "Reflect/Object.h"
+
+namespace Helium
+{
+	namespace Inspect
+	{
+		//
+		// Listens for changes to a set of objects (Object::RaiseChanged) and refreshes just the
+		//  controls bound to the fields that changed instead of reading every control in a canvas
+		//
+
+		class HELIUM_INSPECT_API ChangeTracker : public Helium::RefCountBase< ChangeTracker >
+		{
+		public:
+			ChangeTracker( Container* root );
+			~ChangeTracker();
+
+			inline Container* GetRoot() const;
+
+			// start or stop listening to objects, objects must be untracked (or the tracker destroyed) before they are
+			void Track( Reflect::Object* object );
+			void Track( const std::vector< Reflect::Object* >& objects );
+			void Untrack( Reflect::Object* object );
+			void UntrackAll();
+
+			// are there changes the controls have not been refreshed for
+			inline bool IsDirty() const;
+
+			// reads the controls bound to anything changed since the last refresh, returns the number of controls read
+			size_t Refresh();
+
+		private:
+			void ObjectChanged( const Reflect::ObjectChangeArgs& args );
+			size_t Refresh( Control* control );
+
+			struct Change
+			{
+				const Reflect::Object* m_Object;
+				const Reflect::Field*  m_Field;  // NULL for the whole object
+			};
+
+			Container*                      m_Root;
+			std::vector< Reflect::Object* > m_Objects;
+			std::vector< Change >           m_Changes;
+		};
+
+		typedef Helium::SmartPtr< ChangeTracker > ChangeTrackerPtr;
+	}
+}
+
+#include "Inspect/ChangeTracker.inl"
@@ -0,0 +1,9 @@
+Helium::Inspect::Container* Helium::Inspect::ChangeTracker::GetRoot() const
+{
+	return m_Root;
+}
+
+bool Helium::Inspect::ChangeTracker::IsDirty() const
+{
+	return !m_Changes.empty();
+}
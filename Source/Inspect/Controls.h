@@ -2,6 +2,7 @@
 
 #include "Inspect/Control.h"
 #include "Inspect/Container.h"
+#include "Inspect/VirtualContainer.h"
 #include "Inspect/Canvas.h"
 #include "Inspect/LabelControl.h"
 #include "Inspect/CheckBoxControl.h"
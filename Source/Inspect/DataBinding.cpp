@@ -96,3 +96,127 @@ void Inspect::Insert(std::ostream& stream, const Reflect::Data* val)
 		Insert( stream, &str2 );
 	}
 }
+
+DataStringFormatter::DataStringFormatter( const std::vector< Reflect::Data* >& data, bool perishable )
+	: MultiStringFormatter< Reflect::Data >( data, perishable )
+	, m_StringValid( false )
+	, m_FormatCount( 0 )
+{
+
+}
+
+DataStringFormatter::~DataStringFormatter()
+{
+	for ( std::vector< CachedValue >::iterator itr = m_Cache.begin(), end = m_Cache.end(); itr != end; ++itr )
+	{
+		delete itr->m_Value;
+	}
+}
+
+bool DataStringFormatter::IsBoundTo( const Reflect::Object* object, const Reflect::Field* field ) const
+{
+	for ( std::vector< Reflect::Data* >::const_iterator itr = m_Data.begin(), end = m_Data.end(); itr != end; ++itr )
+	{
+		const Reflect::Pointer& pointer = (*itr)->m_Pointer;
+		if ( pointer.m_Object == object && ( field == NULL || pointer.m_Field == field ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DataStringFormatter::Get(std::string& s) const
+{
+	if ( Update() || !m_StringValid )
+	{
+		bool equal = !m_Cache.empty();
+		for ( size_t i = 1; i < m_Cache.size() && equal; ++i )
+		{
+			equal = m_Data[ i ]->m_Translator->Equals( *m_Cache.front().m_Value, *m_Cache[ i ].m_Value );
+		}
+
+		if ( equal )
+		{
+			m_String = Format( 0 );
+		}
+		else
+		{
+			// nothing bound reads as undefined rather than as several values
+			m_String = m_Data.empty() ? UNDEF_VALUE_STRING : MULTI_VALUE_STRING;
+		}
+
+		m_StringValid = true;
+	}
+
+	s = m_String;
+}
+
+void DataStringFormatter::GetAll(std::vector< std::string >& s) const
+{
+	Update();
+
+	s.resize( m_Cache.size() );
+	for ( size_t i = 0; i < m_Cache.size(); ++i )
+	{
+		s[ i ] = Format( i );
+	}
+}
+
+bool DataStringFormatter::Update() const
+{
+	bool changed = false;
+
+	if ( m_Cache.size() != m_Data.size() )
+	{
+		HELIUM_ASSERT( m_Cache.empty() );
+		m_Cache.resize( m_Data.size() );
+		for ( size_t i = 0; i < m_Data.size(); ++i )
+		{
+			CachedValue& cached = m_Cache[ i ];
+			cached.m_Value = new Reflect::Variable( m_Data[ i ]->m_Translator );
+			cached.m_Value->m_Translator->Copy( m_Data[ i ]->m_Pointer, *cached.m_Value );
+			cached.m_Printed = false;
+		}
+
+		return true;
+	}
+
+	for ( size_t i = 0; i < m_Data.size(); ++i )
+	{
+		const Reflect::Data* data = m_Data[ i ];
+		CachedValue& cached = m_Cache[ i ];
+		if ( !data->m_Translator->Equals( data->m_Pointer, *cached.m_Value ) )
+		{
+			data->m_Translator->Copy( data->m_Pointer, *cached.m_Value );
+			cached.m_Printed = false;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+const std::string& DataStringFormatter::Format( size_t index ) const
+{
+	CachedValue& cached = m_Cache[ index ];
+	if ( !cached.m_Printed )
+	{
+		Reflect::ScalarTranslator* scalar = Reflect::ReflectionCast< Reflect::ScalarTranslator >( cached.m_Value->m_Translator );
+		cached.m_String.clear();
+		if ( scalar )
+		{
+			scalar->Print( *cached.m_Value, m_Buffer );
+			if ( !m_Buffer.IsEmpty() )
+			{
+				cached.m_String.assign( m_Buffer.GetData(), m_Buffer.GetSize() );
+			}
+		}
+
+		cached.m_Printed = true;
+		++m_FormatCount;
+	}
+
+	return cached.m_String;
+}
@@ -141,6 +141,9 @@ namespace Helium
 			virtual void Refresh() = 0;
 			virtual UndoCommandPtr GetUndoCommand() const = 0;
 
+			// does this binding point at the field of the object (any field if NULL), used to refresh only the changed controls
+			inline virtual bool IsBoundTo( const Reflect::Object* object, const Reflect::Field* field ) const;
+
 		protected: 
 			bool m_Significant; 
 		public: 
@@ -285,6 +288,48 @@ namespace Helium
 			virtual void GetAll(std::vector< std::string >& s) const override;
 		};
 
+		//
+		// DataStringFormatter is a MultiStringFormatter for reflected data that keeps a copy of the values it last
+		//  formatted, values are compared with their translator and only the ones that changed are printed again
+		//
+
+		class HELIUM_INSPECT_API DataStringFormatter : public MultiStringFormatter< Reflect::Data >
+		{
+		public:
+			typedef Helium::SmartPtr< DataStringFormatter > Ptr;
+
+			DataStringFormatter( const std::vector< Reflect::Data* >& data, bool perishable = false );
+			virtual ~DataStringFormatter();
+
+			virtual bool IsBoundTo( const Reflect::Object* object, const Reflect::Field* field ) const override;
+
+			virtual void Get(std::string& s) const override;
+			virtual void GetAll(std::vector< std::string >& s) const override;
+
+			// number of times a value was printed, reads of unchanged values don't count
+			inline uint32_t GetFormatCount() const;
+
+		private:
+			struct CachedValue
+			{
+				Reflect::Variable* m_Value;   // copy of the value when it was printed
+				std::string        m_String;  // the value printed
+				bool               m_Printed; // has m_String caught up with m_Value
+			};
+
+			// copies the values that changed since the last call, returns true if any did
+			bool Update() const;
+
+			// the printed value at index, printed now if it changed since
+			const std::string& Format( size_t index ) const;
+
+			mutable std::vector< CachedValue > m_Cache;
+			mutable std::string                m_String;     // the value (or MULTI_VALUE_STRING) handed out by Get
+			mutable bool                       m_StringValid;
+			mutable String                     m_Buffer;
+			mutable uint32_t                   m_FormatCount;
+		};
+
 		//
 		// PropertyStringFormatter handles conversion between a property of T and string
 		//
@@ -42,6 +42,11 @@ bool Helium::Inspect::DataBinding::IsSignificant() const
 	return m_Significant; 
 }
 
+bool Helium::Inspect::DataBinding::IsBoundTo( const Reflect::Object* object, const Reflect::Field* field ) const
+{
+	return false;
+}
+
 void Helium::Inspect::DataBinding::AddChangingListener( const DataChangingSignature::Delegate& listener ) const
 {
 	m_Changing.Add( listener );
@@ -351,6 +356,11 @@ void Helium::Inspect::MultiStringFormatter<T>::GetAll(std::vector< std::string >
 	}
 }
 
+uint32_t Helium::Inspect::DataStringFormatter::GetFormatCount() const
+{
+	return m_FormatCount;
+}
+
 template< class T >
 Helium::Inspect::PropertyStringFormatter<T>::PropertyStringFormatter(const Helium::SmartPtr< Helium::Property<T> >& property)
 	: m_Property(property)
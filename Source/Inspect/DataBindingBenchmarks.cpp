@@ -0,0 +1,82 @@
+#include "Precompile.h"
+#include "Inspect/DataBinding.h"
+#include "Inspect/ChangeTracker.h"
+#include "Inspect/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Inspect;
+using namespace Helium::InspectTests;
+
+HELIUM_DEFINE_CLASS( BoundObject );
+HELIUM_DEFINE_CLASS( CountingWidget );
+
+// prints the time to read a panel of bound objects with and without DataStringFormatter's cache, and to refresh
+//  it through a ChangeTracker, ChangeTrackerRefresh checks which controls are read
+TEST(Inspect, ChangeTrackerRefreshBenchmark)
+{
+	Reflect::Startup();
+
+	{
+		const uint32_t objectCount = 2000;
+		std::vector< StrongPtr< BoundObject > > owners;
+		std::vector< BoundObject* > objects;
+		for ( uint32_t i = 0; i < objectCount; ++i )
+		{
+			owners.push_back( new BoundObject () );
+			objects.push_back( owners.back() );
+		}
+
+		float64_t milliseconds[ 3 ];
+		for ( uint32_t cached = 0; cached < 2; ++cached )
+		{
+			ContainerPtr root = new Container ();
+			std::vector< CountingWidget* > widgets;
+			BuildPanel( root, objects, cached != 0, widgets );
+
+			// reading the whole panel when nothing changed
+			root->Read();
+			uint64_t start = Timer::GetTickCount();
+			for ( uint32_t pass = 0; pass < 10; ++pass )
+			{
+				root->Read();
+			}
+			milliseconds[ cached ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+			EXPECT_EQ( 11u, widgets.back()->m_Reads );
+
+			if ( !cached )
+			{
+				root->Clear();
+				continue;
+			}
+
+			ChangeTracker tracker ( root );
+			std::vector< Reflect::Object* > tracked ( objects.begin(), objects.end() );
+			tracker.Track( tracked );
+
+			start = Timer::GetTickCount();
+			for ( uint32_t pass = 0; pass < 10; ++pass )
+			{
+				for ( uint32_t i = 0; i < 10; ++i )
+				{
+					BoundObject* object = objects[ 100 + pass * 100 + i ];
+					++object->m_Count;
+					object->RaiseChanged( CountField() );
+				}
+				EXPECT_EQ( 10u, tracker.Refresh() );
+			}
+			milliseconds[ 2 ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+			tracker.UntrackAll();
+			root->Clear();
+		}
+
+		printf( "Inspect refresh of %u bound objects x10: formatting every read %.2fms, cached %.2fms (%u controls read each), change tracked %.2fms (10 controls read each)\n",
+			objectCount, milliseconds[ 0 ], milliseconds[ 1 ], objectCount * 2, milliseconds[ 2 ] );
+	}
+
+	Reflect::Shutdown();
+}
@@ -0,0 +1,158 @@
+#include "Precompile.h"
+#include "Inspect/DataBinding.h"
+#include "Inspect/ChangeTracker.h"
+#include "Inspect/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Inspect;
+using namespace Helium::InspectTests;
+
+HELIUM_DEFINE_CLASS( BoundObject );
+HELIUM_DEFINE_CLASS( CountingWidget );
+
+TEST(Inspect, DataStringFormatterCache)
+{
+	Reflect::Startup();
+
+	{
+		std::vector< StrongPtr< BoundObject > > owners;
+		std::vector< BoundObject* > objects;
+		for ( uint32_t i = 0; i < 3; ++i )
+		{
+			owners.push_back( new BoundObject () );
+			objects.push_back( owners.back() );
+		}
+
+		DataStringFormatter::Ptr formatter = new DataStringFormatter( MakeDatas( objects, CountField() ), true );
+
+		// equal values print once, no matter how often they are read
+		std::string value;
+		formatter->Get( value );
+		EXPECT_EQ( "5", value );
+		formatter->Get( value );
+		EXPECT_EQ( "5", value );
+		EXPECT_EQ( 1u, formatter->GetFormatCount() );
+
+		std::vector< std::string > values;
+		formatter->GetAll( values );
+		ASSERT_EQ( 3u, values.size() );
+		EXPECT_EQ( "5", values[ 2 ] );
+		EXPECT_EQ( 3u, formatter->GetFormatCount() );
+
+		// a change prints only the value that changed
+		objects[ 1 ]->m_Count = 7;
+		formatter->Get( value );
+		EXPECT_EQ( MULTI_VALUE_STRING, value );
+		EXPECT_EQ( 3u, formatter->GetFormatCount() );
+		formatter->GetAll( values );
+		EXPECT_EQ( "7", values[ 1 ] );
+		EXPECT_EQ( 4u, formatter->GetFormatCount() );
+
+		EXPECT_TRUE( formatter->Set( "9", DataChangedSignature::Delegate () ) );
+		formatter->Get( value );
+		EXPECT_EQ( "9", value );
+		EXPECT_EQ( 9u, objects[ 2 ]->m_Count );
+
+		EXPECT_TRUE( formatter->IsBoundTo( objects[ 0 ], CountField() ) );
+		EXPECT_TRUE( formatter->IsBoundTo( objects[ 0 ], NULL ) );
+		EXPECT_FALSE( formatter->IsBoundTo( objects[ 0 ], NameField() ) );
+
+		BoundObject other;
+		EXPECT_FALSE( formatter->IsBoundTo( &other, NULL ) );
+
+		// nothing bound is undefined, not several values
+		DataStringFormatter::Ptr unbound = new DataStringFormatter( std::vector< Reflect::Data* >() );
+		unbound->Get( value );
+		EXPECT_EQ( UNDEF_VALUE_STRING, value );
+	}
+
+	Reflect::Shutdown();
+}
+
+TEST(Inspect, ChangeTrackerRefresh)
+{
+	Reflect::Startup();
+
+	{
+		const uint32_t objectCount = 200;
+		std::vector< StrongPtr< BoundObject > > owners;
+		std::vector< BoundObject* > objects;
+		for ( uint32_t i = 0; i < objectCount; ++i )
+		{
+			owners.push_back( new BoundObject () );
+			objects.push_back( owners.back() );
+		}
+
+		for ( uint32_t cached = 0; cached < 2; ++cached )
+		{
+			ContainerPtr root = new Container ();
+			std::vector< CountingWidget* > widgets;
+			BuildPanel( root, objects, cached != 0, widgets );
+
+			// reading the whole panel when nothing changed
+			for ( uint32_t pass = 0; pass < 11; ++pass )
+			{
+				root->Read();
+			}
+			EXPECT_EQ( 11u, widgets.back()->m_Reads );
+			EXPECT_EQ( "Name", widgets.back()->m_Text );
+
+			if ( !cached )
+			{
+				root->Clear();
+				continue;
+			}
+
+			ChangeTracker tracker ( root );
+			std::vector< Reflect::Object* > tracked ( objects.begin(), objects.end() );
+			tracker.Track( tracked );
+			EXPECT_FALSE( tracker.IsDirty() );
+			EXPECT_EQ( 0u, tracker.Refresh() );
+
+			// only the control bound to the changed field is read
+			objects[ 7 ]->m_Count = 42;
+			objects[ 7 ]->RaiseChanged( CountField() );
+			EXPECT_TRUE( tracker.IsDirty() );
+			EXPECT_EQ( 1u, tracker.Refresh() );
+			EXPECT_EQ( 12u, widgets[ 14 ]->m_Reads );
+			EXPECT_EQ( "42", widgets[ 14 ]->m_Text );
+			EXPECT_EQ( 11u, widgets[ 15 ]->m_Reads );
+			EXPECT_EQ( 11u, widgets[ 16 ]->m_Reads );
+			EXPECT_FALSE( tracker.IsDirty() );
+
+			// a change to the whole object reads all of its controls, repeated changes read once
+			objects[ 9 ]->m_Name = "Renamed";
+			objects[ 9 ]->RaiseChanged( NameField() );
+			objects[ 9 ]->RaiseChanged();
+			objects[ 9 ]->RaiseChanged( CountField() );
+			EXPECT_EQ( 2u, tracker.Refresh() );
+			EXPECT_EQ( "Renamed", widgets[ 19 ]->m_Text );
+			EXPECT_EQ( 12u, widgets[ 18 ]->m_Reads );
+
+			// untracked objects are not noticed
+			tracker.Untrack( objects[ 9 ] );
+			objects[ 9 ]->RaiseChanged();
+			EXPECT_FALSE( tracker.IsDirty() );
+
+			for ( uint32_t pass = 0; pass < 10; ++pass )
+			{
+				for ( uint32_t i = 0; i < 10; ++i )
+				{
+					BoundObject* object = objects[ 20 + pass * 10 + i ];
+					++object->m_Count;
+					object->RaiseChanged( CountField() );
+				}
+				EXPECT_EQ( 10u, tracker.Refresh() );
+			}
+			EXPECT_EQ( "6", widgets[ 40 ]->m_Text );
+			EXPECT_EQ( 12u, widgets[ 40 ]->m_Reads );
+
+			tracker.UntrackAll();
+			root->Clear();
+		}
+	}
+
+	Reflect::Shutdown();
+}
@@ -20,8 +20,125 @@ using namespace Helium::Inspect;
 
 EditFilePathSignature::Event Inspect::g_EditFilePath;
 
+//
+// Makes a label and a value control for each visible element of an array or sequence field,
+//  binding them to the element at the same index in every selected instance
+//
+
+class ElementGenerator : public VirtualItemGenerator
+{
+public:
+	// the elements of a fixed size array field
+	ElementGenerator( Interpreter* interpreter, const Field* field, const std::vector< void* >& instances, const std::vector< Reflect::Object* >& objects )
+		: m_Interpreter( interpreter )
+		, m_Field( field )
+		, m_Instances( instances )
+		, m_Objects( objects )
+		, m_Sequence( NULL )
+		, m_ItemTranslator( field->m_Translator )
+	{
+	}
+
+	// the items of a sequence field
+	ElementGenerator( Interpreter* interpreter, const Field* field, const std::vector< Reflect::Pointer >& sequences, SequenceTranslator* sequence )
+		: m_Interpreter( interpreter )
+		, m_Field( field )
+		, m_Sequences( sequences )
+		, m_Sequence( sequence )
+		, m_ItemTranslator( sequence->GetItemTranslator() )
+	{
+	}
+
+	virtual size_t GetItemCount() override
+	{
+		if ( !m_Sequence )
+		{
+			return m_Field->m_Count;
+		}
+
+		// with several objects selected only the elements they all have are shown
+		size_t count = 0;
+		for ( std::vector< Reflect::Pointer >::const_iterator itr = m_Sequences.begin(), end = m_Sequences.end(); itr != end; ++itr )
+		{
+			size_t length = m_Sequence->GetLength( *itr );
+			if ( itr == m_Sequences.begin() || length < count )
+			{
+				count = length;
+			}
+		}
+
+		return count;
+	}
+
+	virtual void CreateItem( Container* item ) override
+	{
+		bool readOnly = ( m_Field->m_Flags & FieldFlags::ReadOnly ) == FieldFlags::ReadOnly;
+
+		LabelPtr label = m_Interpreter->CreateControl<Label>();
+		item->AddChild( label );
+
+		ScalarTranslator* scalar = ReflectionCast< ScalarTranslator >( m_ItemTranslator );
+		if ( scalar && scalar->m_Type == ScalarTypes::Boolean )
+		{
+			CheckBoxPtr checkBox = m_Interpreter->CreateControl<CheckBox>();
+			checkBox->a_IsReadOnly.Set( readOnly );
+			item->AddChild( checkBox );
+		}
+		else
+		{
+			ValuePtr value = m_Interpreter->CreateControl<Value>();
+			value->a_IsReadOnly.Set( readOnly );
+			item->AddChild( value );
+		}
+	}
+
+	virtual void BindItem( Container* item, size_t index ) override
+	{
+		const std::vector< ControlPtr >& children = item->GetChildren();
+		HELIUM_ASSERT( children.size() == 2 );
+
+		// controls keep the first binding they are given, a reused item has to be unbound first
+		Label* label = static_cast< Label* >( children[ 0 ].Ptr() );
+		Control* value = children[ 1 ];
+		label->Bind( NULL );
+		value->Bind( NULL );
+
+		std::stringstream str;
+		str << "[" << index << "]";
+		label->BindText( str.str() );
+
+		std::vector< Data* > datas;
+		if ( m_Sequence )
+		{
+			for ( std::vector< Reflect::Pointer >::const_iterator itr = m_Sequences.begin(), end = m_Sequences.end(); itr != end; ++itr )
+			{
+				datas.push_back( new Data ( m_Sequence->GetItem( *itr, index ), m_ItemTranslator ) );
+			}
+		}
+		else
+		{
+			for ( size_t i = 0; i < m_Instances.size(); ++i )
+			{
+				datas.push_back( new Data ( Pointer ( m_Field, m_Instances[ i ], m_Objects[ i ], static_cast< uint32_t >( index ) ), m_ItemTranslator ) );
+			}
+		}
+
+		value->Bind( new DataStringFormatter( datas, true ) );
+	}
+
+private:
+	Interpreter*                    m_Interpreter;
+	const Field*                    m_Field;
+	std::vector< void* >            m_Instances;    // array fields
+	std::vector< Reflect::Object* > m_Objects;
+	std::vector< Reflect::Pointer > m_Sequences;    // sequence fields
+	SequenceTranslator*             m_Sequence;
+	Translator*                     m_ItemTranslator;
+};
+
 ReflectInterpreter::ReflectInterpreter (Container* container)
 	: Interpreter (container)
+	, m_VirtualizeThreshold( 16 )
 {
 
 }
@@ -158,7 +275,11 @@ void ReflectInterpreter::Interpret( const std::vector< void* >& instances, const
 				container = containersMap[""];
 			}
 
-			if ( field->m_Count > 1 )
+			if ( field->m_Count > m_VirtualizeThreshold && field->m_Translator->IsA( MetaIds::ScalarTranslator ) )
+			{
+				InterpretElements( new ElementGenerator( this, field, instances, objects ), field, container );
+			}
+			else if ( field->m_Count > 1 )
 			{
 				for ( uint32_t i=0; i<field->m_Count; ++i )
 				{
@@ -211,6 +332,10 @@ void ReflectInterpreter::InterpretField( const std::vector< Reflect::Pointer >&
 			InterpretValueField( pointers, translator, field, parent );
 		}
 	}
+	else if ( translator->IsA( MetaIds::SequenceTranslator ) )
+	{
+		InterpretSequenceItemsField( pointers, translator, field, parent );
+	}
 }
 
 void ReflectInterpreter::InterpretValueField( const std::vector< Reflect::Pointer >& pointers, Reflect::Translator* translator, const Field* field, Container* parent )
@@ -320,7 +445,7 @@ void ReflectInterpreter::InterpretValueField( const std::vector< Reflect::Pointe
 		datas.push_back( new Data ( *itr, translator ) );
 	}
 
-	Helium::SmartPtr< MultiStringFormatter<Data> > data = new MultiStringFormatter<Data>( datas, true );
+	DataStringFormatter::Ptr data = new DataStringFormatter( datas, true );
 	container->Bind( data );
 
 	//
@@ -344,11 +469,11 @@ void ReflectInterpreter::InterpretValueField( const std::vector< Reflect::Pointe
 	parent->AddChild(container);
 }
 
-class MultiBitfieldStringFormatter : public MultiStringFormatter<Data>
+class MultiBitfieldStringFormatter : public DataStringFormatter
 {
 public:
 	MultiBitfieldStringFormatter( const Reflect::MetaEnum::Element* element, const std::vector<Data*>& data )
-		: MultiStringFormatter<Data>( data, false )
+		: DataStringFormatter( data, false )
 		, m_EnumerationElement( element )
 	{
 
@@ -358,7 +483,7 @@ public:
 	{
 		// get the full string set
 		std::string bitSet;
-		MultiStringFormatter<Data>::Get( bitSet );
+		DataStringFormatter::Get( bitSet );
 
 		if ( s == "1" )
 		{
@@ -398,12 +523,12 @@ public:
 			bitSet = s;
 		}
 
-		return MultiStringFormatter<Data>::Set( bitSet, emitter );
+		return DataStringFormatter::Set( bitSet, emitter );
 	}
 
 	virtual void Get(std::string& s) const override
 	{
-		MultiStringFormatter<Data>::Get( s );
+		DataStringFormatter::Get( s );
 
 		if ( s.find_first_of( m_EnumerationElement->m_Name ) != std::string::npos )
 		{
@@ -1242,3 +1367,52 @@ void ReflectInterpreter::SetOnRemove( const ButtonClickedArgs& args )
 		}
 	}
 }
+
+void ReflectInterpreter::InterpretSequenceItemsField( const std::vector< Reflect::Pointer >& pointers, Reflect::Translator* translator, const Reflect::Field* field, Container* parent )
+{
+	if ( field->m_Flags & FieldFlags::Hide )
+	{
+		return;
+	}
+
+	// like other fields, only items that print as a value get controls
+	SequenceTranslator* sequence = ReflectionCast< SequenceTranslator >( translator );
+	if ( !sequence->GetItemTranslator()->IsA( MetaIds::ScalarTranslator ) )
+	{
+		return;
+	}
+
+	InterpretElements( new ElementGenerator( this, field, pointers, sequence ), field, parent );
+}
+
+void ReflectInterpreter::InterpretElements( VirtualItemGenerator* generator, const Reflect::Field* field, Container* parent )
+{
+	VirtualItemGeneratorPtr generatorPtr = generator;
+
+	ContainerPtr container = CreateControl<Container>();
+
+	LabelPtr label = CreateControl<Label>();
+	std::string temp;
+	field->GetProperty( "UIName", temp );
+	if ( temp.empty() )
+	{
+		bool converted = Helium::ConvertString( field->m_Name, temp );
+		HELIUM_ASSERT( converted );
+	}
+	label->BindText( temp );
+	label->a_HelpText.Set( field->GetProperty( "HelpText" ) );
+	container->AddChild( label );
+
+	// small containers show everything, large ones start on their first page and build the rest as they scroll
+	VirtualContainerPtr elements = CreateControl<VirtualContainer>();
+	elements->a_HelpText.Set( field->GetProperty( "HelpText" ) );
+	size_t count = generator->GetItemCount();
+	if ( count <= m_VirtualizeThreshold && count > elements->GetVisibleCount() )
+	{
+		elements->SetVisibleRange( 0, count );
+	}
+	elements->SetGenerator( generator );
+	container->AddChild( elements );
+
+	parent->AddChild( container );
+}
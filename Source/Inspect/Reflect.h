@@ -3,6 +3,7 @@
 #include "Inspect/Canvas.h"
 #include "Inspect/Container.h"
 #include "Inspect/Interpreter.h"
+#include "Inspect/VirtualContainer.h"
 
 #include "Application/FileDialog.h"
 
@@ -46,6 +47,17 @@ namespace Helium
 				Container* parent = NULL
 				);
 
+			// arrays and sequences with more elements than this only get controls for the visible range
+			inline uint32_t GetVirtualizeThreshold() const
+			{
+				return m_VirtualizeThreshold;
+			}
+
+			inline void SetVirtualizeThreshold( uint32_t count )
+			{
+				m_VirtualizeThreshold = count;
+			}
+
 		private:
 			void InterpretField( const std::vector< Reflect::Pointer >& pointers, Reflect::Translator* translator, const Reflect::Field* field, Container* parent );
 
@@ -72,6 +84,11 @@ namespace Helium
 			void InterpretSetField( const std::vector< Reflect::Pointer >& pointers, Reflect::Translator* translator, const Reflect::Field* field, Container* parent );
 			void SetOnAdd( const ButtonClickedArgs& args );
 			void SetOnRemove( const ButtonClickedArgs& args );
+
+			void InterpretSequenceItemsField( const std::vector< Reflect::Pointer >& pointers, Reflect::Translator* translator, const Reflect::Field* field, Container* parent );
+			void InterpretElements( VirtualItemGenerator* generator, const Reflect::Field* field, Container* parent );
+
+			uint32_t m_VirtualizeThreshold;
 		};
 
 		typedef Helium::SmartPtr<ReflectInterpreter> ReflectInterpreterPtr;
@@ -0,0 +1,53 @@
+#include "Precompile.h"
+#include "Inspect/Reflect.h"
+#include "Inspect/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Inspect;
+using namespace Helium::InspectTests;
+
+HELIUM_DEFINE_CLASS( LargeObject );
+
+// prints the time to interpret a large object with every element eagerly generated and with virtualization,
+//  VirtualizedReflectInterpreter checks what the virtual containers hold
+TEST(Inspect, VirtualizedReflectInterpreterBenchmark)
+{
+	Reflect::Startup();
+
+	{
+		const size_t sampleCount = 100000;
+		StrongPtr< LargeObject > object = new LargeObject ( sampleCount );
+
+		std::vector< Reflect::Object* > objects;
+		objects.push_back( object );
+
+		float64_t milliseconds[ 2 ];
+		size_t controls[ 2 ];
+		for ( uint32_t virtualize = 0; virtualize < 2; ++virtualize )
+		{
+			ContainerPtr canvas = new Container ();
+			ReflectInterpreterPtr interpreter = new ReflectInterpreter( canvas );
+			if ( !virtualize )
+			{
+				interpreter->SetVirtualizeThreshold( 0xFFFFFFFF );
+			}
+
+			uint64_t start = Timer::GetTickCount();
+			interpreter->Interpret( objects, Reflect::GetMetaClass< LargeObject >() );
+			milliseconds[ virtualize ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+			controls[ virtualize ] = CountControls( canvas );
+
+			canvas->Clear();
+		}
+
+		EXPECT_LT( controls[ 1 ] * 100, controls[ 0 ] );
+		printf( "Inspect canvas for %u samples and a %u element table: eager %.2fms (%u controls), virtualized %.2fms (%u controls)\n",
+			static_cast< uint32_t >( sampleCount ), 1024, milliseconds[ 0 ], static_cast< uint32_t >( controls[ 0 ] ), milliseconds[ 1 ], static_cast< uint32_t >( controls[ 1 ] ) );
+	}
+
+	Reflect::Shutdown();
+}
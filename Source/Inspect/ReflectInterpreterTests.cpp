@@ -0,0 +1,110 @@
+#include "Precompile.h"
+#include "Inspect/Reflect.h"
+#include "Inspect/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Inspect;
+using namespace Helium::InspectTests;
+
+HELIUM_DEFINE_CLASS( LargeObject );
+
+namespace
+{
+	std::string ItemValue( VirtualContainer* container, size_t index )
+	{
+		Container* item = container->GetItem( index );
+		std::string value;
+		if ( item )
+		{
+			EXPECT_TRUE( item->GetChildren()[ 1 ]->ReadStringData( value ) );
+		}
+		return value;
+	}
+}
+
+TEST(Inspect, VirtualizedReflectInterpreter)
+{
+	Reflect::Startup();
+
+	{
+		// enough samples for the eager canvas to dwarf the virtualized one, few enough to build it quickly
+		const size_t sampleCount = 4000;
+		StrongPtr< LargeObject > object = new LargeObject ( sampleCount );
+
+		std::vector< Reflect::Object* > objects;
+		objects.push_back( object );
+
+		// build the same canvas with every element eagerly generated and with virtualization
+		size_t controls[ 2 ];
+		for ( uint32_t virtualize = 0; virtualize < 2; ++virtualize )
+		{
+			ContainerPtr canvas = new Container ();
+			ReflectInterpreterPtr interpreter = new ReflectInterpreter( canvas );
+			if ( !virtualize )
+			{
+				interpreter->SetVirtualizeThreshold( 0xFFFFFFFF );
+			}
+
+			interpreter->Interpret( objects, Reflect::GetMetaClass< LargeObject >() );
+			controls[ virtualize ] = CountControls( canvas );
+
+			std::vector< VirtualContainer* > containers;
+			FindVirtualContainers( canvas, containers );
+			// sequences always go in a virtual container (with everything in view when eager), small arrays never do
+			ASSERT_EQ( virtualize ? 2u : 1u, containers.size() );
+			VirtualContainer* samples = containers[ 0 ];
+			EXPECT_EQ( sampleCount, samples->GetItemCount() );
+
+			if ( virtualize )
+			{
+				VirtualContainer* table = containers[ 1 ];
+				EXPECT_EQ( 1024u, table->GetItemCount() );
+				EXPECT_EQ( "126", ItemValue( table, 63 ) );
+				table->SetVisibleRange( 1024 - VirtualContainer::DefaultVisibleCount, VirtualContainer::DefaultVisibleCount );
+				EXPECT_EQ( "2046", ItemValue( table, 1023 ) );
+
+				EXPECT_EQ( VirtualContainer::DefaultVisibleCount, samples->GetChildren().size() );
+				EXPECT_TRUE( NULL == samples->GetItem( 1000 ) );
+
+				// scrolling rebinds the controls it already has
+				samples->SetVisibleRange( 2000, VirtualContainer::DefaultVisibleCount );
+				EXPECT_EQ( VirtualContainer::DefaultVisibleCount, samples->GetCreatedCount() );
+				EXPECT_EQ( "2000", ItemValue( samples, 2000 ) );
+				EXPECT_EQ( "2063", ItemValue( samples, 2063 ) );
+				EXPECT_TRUE( NULL == samples->GetItem( 0 ) );
+
+				// overlapping ranges leave the items still in view alone
+				Container* kept = samples->GetItem( 2010 );
+				samples->SetVisibleRange( 2010, VirtualContainer::DefaultVisibleCount );
+				EXPECT_EQ( kept, samples->GetItem( 2010 ) );
+				EXPECT_EQ( "2073", ItemValue( samples, 2073 ) );
+				EXPECT_EQ( VirtualContainer::DefaultVisibleCount, samples->GetCreatedCount() );
+
+				// collapsing drops every item control, shrinking the data drops the ones past the end
+				samples->a_IsExpanded.Set( false );
+				EXPECT_TRUE( samples->GetChildren().empty() );
+				samples->a_IsExpanded.Set( true );
+				object->m_Samples.resize( 2020 );
+				samples->Read();
+				EXPECT_EQ( 10u, samples->GetChildren().size() );
+				EXPECT_EQ( VirtualContainer::DefaultVisibleCount, samples->GetCreatedCount() );
+				object->m_Samples.resize( sampleCount );
+			}
+			else
+			{
+				EXPECT_EQ( sampleCount, samples->GetChildren().size() );
+			}
+
+			canvas->Clear();
+		}
+
+		// every sample and table element has its controls when eager, only the ones in view when virtualized
+		EXPECT_LT( controls[ 1 ] * 10, controls[ 0 ] );
+		EXPECT_GT( controls[ 0 ], ( sampleCount + 1024 ) * 2 );
+		EXPECT_LT( controls[ 1 ], VirtualContainer::DefaultVisibleCount * 2 * 4 );
+	}
+
+	Reflect::Shutdown();
+}
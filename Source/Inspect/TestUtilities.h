@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Inspect/DataBinding.h"
+#include "Inspect/Controls.h"
+#include "Inspect/VirtualContainer.h"
+
+#include "Reflect/Object.h"
+#include "Reflect/TranslatorDeduction.h"
+
+#include <vector>
+
+//
+// Helpers shared by the Inspect tests and benchmarks, not part of the library
+//
+
+// a source file of each binary that uses them says HELIUM_DEFINE_CLASS( BoundObject ) and HELIUM_DEFINE_CLASS( CountingWidget )
+class BoundObject : public Helium::Reflect::Object
+{
+public:
+	uint32_t    m_Count;
+	std::string m_Name;
+
+	BoundObject()
+		: m_Count( 5 )
+		, m_Name( "Name" )
+	{
+	}
+
+	HELIUM_DECLARE_CLASS( BoundObject, Helium::Reflect::Object );
+	static void PopulateMetaType( Helium::Reflect::MetaClass& comp );
+};
+
+inline void BoundObject::PopulateMetaType( Helium::Reflect::MetaClass& comp )
+{
+	comp.AddField( &BoundObject::m_Count, "Count" );
+	comp.AddField( &BoundObject::m_Name, "Name" );
+}
+
+// stands in for a toolkit widget, reads the bound string the way a text box would
+class CountingWidget : public Helium::Inspect::Widget
+{
+public:
+	std::string m_Text;
+	uint32_t    m_Reads;
+
+	CountingWidget()
+		: m_Reads( 0 )
+	{
+	}
+
+	HELIUM_DECLARE_CLASS( CountingWidget, Helium::Inspect::Widget );
+
+	virtual void Read() override
+	{
+		m_Control->ReadStringData( m_Text );
+		++m_Reads;
+	}
+
+	virtual bool Write() override
+	{
+		return false;
+	}
+};
+
+// a sequence of any length next to fixed arrays above and below ReflectInterpreter's virtualize threshold,
+//  a source file of each binary that uses it says HELIUM_DEFINE_CLASS( LargeObject )
+class LargeObject : public Helium::Reflect::Object
+{
+public:
+	std::vector< float32_t > m_Samples;
+	uint32_t                 m_Table[ 1024 ];
+	uint32_t                 m_Small[ 4 ];
+
+	LargeObject( size_t sampleCount = 0 )
+		: m_Samples( sampleCount )
+	{
+		for ( size_t i = 0; i < sampleCount; ++i )
+		{
+			m_Samples[ i ] = static_cast< float32_t >( i );
+		}
+
+		for ( uint32_t i = 0; i < 1024; ++i )
+		{
+			m_Table[ i ] = i * 2;
+		}
+
+		for ( uint32_t i = 0; i < 4; ++i )
+		{
+			m_Small[ i ] = i;
+		}
+	}
+
+	HELIUM_DECLARE_CLASS( LargeObject, Helium::Reflect::Object );
+	static void PopulateMetaType( Helium::Reflect::MetaClass& comp );
+};
+
+inline void LargeObject::PopulateMetaType( Helium::Reflect::MetaClass& comp )
+{
+	comp.AddField( &LargeObject::m_Samples, "Samples" );
+	comp.AddField( &LargeObject::m_Table, "Table" );
+	comp.AddField( &LargeObject::m_Small, "Small" );
+}
+
+namespace Helium
+{
+	namespace InspectTests
+	{
+		inline const Reflect::Field* CountField()
+		{
+			return Reflect::GetMetaClass< BoundObject >()->FindField( &BoundObject::m_Count );
+		}
+
+		inline const Reflect::Field* NameField()
+		{
+			return Reflect::GetMetaClass< BoundObject >()->FindField( &BoundObject::m_Name );
+		}
+
+		inline std::vector< Reflect::Data* > MakeDatas( const std::vector< BoundObject* >& objects, const Reflect::Field* field )
+		{
+			std::vector< Reflect::Data* > datas;
+			for ( std::vector< BoundObject* >::const_iterator itr = objects.begin(), end = objects.end(); itr != end; ++itr )
+			{
+				datas.push_back( new Reflect::Data ( Reflect::Pointer ( field, *itr ), field->m_Translator ) );
+			}
+			return datas;
+		}
+
+		// a row of value controls for each object, the way a property panel lists a selection
+		inline void BuildPanel( Inspect::Container* root, const std::vector< BoundObject* >& objects, bool cached, std::vector< CountingWidget* >& widgets )
+		{
+			const Reflect::Field* fields[] = { CountField(), NameField() };
+			for ( std::vector< BoundObject* >::const_iterator itr = objects.begin(), end = objects.end(); itr != end; ++itr )
+			{
+				Inspect::ContainerPtr row = new Inspect::Container ();
+				root->AddChild( row );
+
+				for ( uint32_t i = 0; i < 2; ++i )
+				{
+					std::vector< BoundObject* > selection ( 1, *itr );
+					std::vector< Reflect::Data* > datas = MakeDatas( selection, fields[ i ] );
+
+					Inspect::ValuePtr value = new Inspect::Value ();
+					if ( cached )
+					{
+						value->Bind( new Inspect::DataStringFormatter( datas, true ) );
+					}
+					else
+					{
+						value->Bind( new Inspect::MultiStringFormatter< Reflect::Data >( datas, true ) );
+					}
+
+					CountingWidget* widget = new CountingWidget ();
+					widget->SetControl( value );
+					value->SetWidget( widget );
+					widgets.push_back( widget );
+
+					row->AddChild( value );
+				}
+			}
+		}
+
+		inline size_t CountControls( Inspect::Control* control )
+		{
+			size_t count = 1;
+			Inspect::Container* container = Reflect::SafeCast< Inspect::Container >( control );
+			if ( container )
+			{
+				const std::vector< Inspect::ControlPtr >& children = container->GetChildren();
+				for ( std::vector< Inspect::ControlPtr >::const_iterator itr = children.begin(), end = children.end(); itr != end; ++itr )
+				{
+					count += CountControls( *itr );
+				}
+			}
+
+			return count;
+		}
+
+		inline void FindVirtualContainers( Inspect::Control* control, std::vector< Inspect::VirtualContainer* >& found )
+		{
+			Inspect::Container* container = Reflect::SafeCast< Inspect::Container >( control );
+			if ( !container )
+			{
+				return;
+			}
+
+			Inspect::VirtualContainer* virtualContainer = Reflect::SafeCast< Inspect::VirtualContainer >( control );
+			if ( virtualContainer )
+			{
+				found.push_back( virtualContainer );
+			}
+
+			const std::vector< Inspect::ControlPtr >& children = container->GetChildren();
+			for ( std::vector< Inspect::ControlPtr >::const_iterator itr = children.begin(), end = children.end(); itr != end; ++itr )
+			{
+				FindVirtualContainers( *itr, found );
+			}
+		}
+	}
+}
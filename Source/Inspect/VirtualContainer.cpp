@@ -0,0 +1,173 @@
+#include "Precompile.h"
+#include "Inspect/VirtualContainer.h"
+
+#include "Inspect/Canvas.h"
+
+HELIUM_DEFINE_CLASS( Helium::Inspect::VirtualContainer );
+
+using namespace Helium;
+using namespace Helium::Inspect;
+
+const size_t VirtualContainer::DefaultVisibleCount;
+
+VirtualItemGenerator::~VirtualItemGenerator()
+{
+}
+
+VirtualContainer::VirtualContainer()
+	: a_IsExpanded( true )
+	, m_ItemCount( 0 )
+	, m_First( 0 )
+	, m_Visible( DefaultVisibleCount )
+	, m_Created( 0 )
+{
+	a_IsExpanded.Changed().AddMethod( this, &VirtualContainer::IsExpandedChanged );
+}
+
+VirtualContainer::~VirtualContainer()
+{
+}
+
+void VirtualContainer::SetGenerator( VirtualItemGenerator* generator )
+{
+	Clear();
+	m_Generator = generator;
+	m_Created = 0;
+	Update();
+}
+
+void VirtualContainer::SetVisibleRange( size_t first, size_t count )
+{
+	m_First = first;
+	m_Visible = count;
+	Update();
+
+	if ( IsRealized() )
+	{
+		Base::Read();
+	}
+}
+
+Container* VirtualContainer::GetItem( size_t index ) const
+{
+	if ( m_Indices.empty() || index < m_Indices.front() || index - m_Indices.front() >= m_Children.size() )
+	{
+		return NULL;
+	}
+
+	return static_cast< Container* >( m_Children[ index - m_Indices.front() ].Ptr() );
+}
+
+void VirtualContainer::Read()
+{
+	Update();
+
+	Base::Read();
+}
+
+void VirtualContainer::Clear()
+{
+	Base::Clear();
+
+	m_Indices.clear();
+	m_Spare.clear();
+}
+
+void VirtualContainer::IsExpandedChanged( const Attribute<bool>::ChangeArgs& args )
+{
+	Update();
+
+	if ( IsRealized() )
+	{
+		Base::Read();
+	}
+}
+
+void VirtualContainer::Update()
+{
+	m_ItemCount = m_Generator.ReferencesObject() ? m_Generator->GetItemCount() : 0;
+
+	size_t first = m_First < m_ItemCount ? m_First : m_ItemCount;
+	size_t count = a_IsExpanded.Get() ? m_ItemCount - first : 0;
+	if ( count > m_Visible )
+	{
+		count = m_Visible;
+	}
+
+	// children still showing the same item are left alone, the rest are free to show another one
+	std::vector< ContainerPtr > items ( count );
+	std::vector< ContainerPtr > free;
+	for ( size_t i = 0; i < m_Children.size(); ++i )
+	{
+		Container* child = static_cast< Container* >( m_Children[ i ].Ptr() );
+		size_t index = m_Indices[ i ];
+		if ( index >= first && index - first < count )
+		{
+			items[ index - first ] = child;
+		}
+		else
+		{
+			free.push_back( child );
+		}
+	}
+
+	bool realized = IsRealized();
+	for ( size_t i = 0; i < count; ++i )
+	{
+		if ( items[ i ].ReferencesObject() )
+		{
+			continue;
+		}
+
+		ContainerPtr item;
+		if ( !free.empty() )
+		{
+			item = free.back();
+			free.pop_back();
+		}
+		else if ( !m_Spare.empty() )
+		{
+			item = m_Spare.back();
+			m_Spare.pop_back();
+		}
+		else
+		{
+			item = new Container ();
+			m_Generator->CreateItem( item );
+			++m_Created;
+		}
+
+		m_Generator->BindItem( item, first + i );
+		items[ i ] = item;
+	}
+
+	// anything left over scrolled out of view (or the container collapsed), keep it for later
+	for ( std::vector< ContainerPtr >::const_iterator itr = free.begin(), end = free.end(); itr != end; ++itr )
+	{
+		RemoveChild( *itr );
+		m_Spare.push_back( *itr );
+	}
+
+	// children are kept in item order
+	m_Children.clear();
+	m_Indices.clear();
+	for ( size_t i = 0; i < count; ++i )
+	{
+		Container* item = items[ i ];
+		if ( item->GetParent() == this )
+		{
+			m_Children.push_back( item );
+		}
+		else
+		{
+			AddChild( item );
+
+			if ( realized )
+			{
+				item->Realize( m_Canvas );
+			}
+		}
+
+		m_Indices.push_back( first + i );
+	}
+}
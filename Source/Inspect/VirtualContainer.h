@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Inspect/API.h"
+#include "Inspect/Container.h"
+
+namespace Helium
+{
+	namespace Inspect
+	{
+		//
+		// Builds and binds the controls for the items of a VirtualContainer
+		//
+
+		class HELIUM_INSPECT_API VirtualItemGenerator : public Helium::RefCountBase< VirtualItemGenerator >
+		{
+		public:
+			virtual ~VirtualItemGenerator();
+
+			// the number of items in the data, asked again each time the container refreshes
+			virtual size_t GetItemCount() = 0;
+
+			// fill in the controls of a newly created item
+			virtual void CreateItem( Container* item ) = 0;
+
+			// bind the controls of an item (new or reused) to the data at index
+			virtual void BindItem( Container* item, size_t index ) = 0;
+		};
+		typedef Helium::SmartPtr< VirtualItemGenerator > VirtualItemGeneratorPtr;
+
+		//
+		// Contains controls for only the visible range of a large number of items, scrolling rebinds
+		//  the item controls that leave the range to the items that enter it instead of creating new ones.
+		//  A collapsed container has no item controls at all.
+		//
+
+		class HELIUM_INSPECT_API VirtualContainer : public Container
+		{
+		public:
+			HELIUM_DECLARE_CLASS( VirtualContainer, Container );
+
+			static const size_t DefaultVisibleCount = 64;
+
+			VirtualContainer();
+			~VirtualContainer();
+
+			inline VirtualItemGenerator* GetGenerator() const;
+			void SetGenerator( VirtualItemGenerator* generator );
+
+			inline size_t GetItemCount() const;
+			inline size_t GetFirstVisible() const;
+			inline size_t GetVisibleCount() const;
+
+			// scroll, item controls are made (or rebound) for [first, first + count)
+			void SetVisibleRange( size_t first, size_t count );
+
+			// the controls for an item, NULL if it is not in the visible range
+			Container* GetItem( size_t index ) const;
+
+			// item containers created so far, reused ones are not counted again
+			inline size_t GetCreatedCount() const;
+
+			// picks up changes in the item count before reading
+			virtual void Read() override;
+
+			virtual void Clear() override;
+
+			Attribute< bool > a_IsExpanded;
+
+		private:
+			void IsExpandedChanged( const Attribute<bool>::ChangeArgs& args );
+
+			// brings the item controls in line with the visible range
+			void Update();
+
+			VirtualItemGeneratorPtr     m_Generator;
+			size_t                      m_ItemCount;
+			size_t                      m_First;
+			size_t                      m_Visible;
+			size_t                      m_Created;
+			std::vector< size_t >       m_Indices;  // the item bound to each child
+			std::vector< ContainerPtr > m_Spare;    // item controls waiting to be reused
+		};
+
+		typedef Helium::StrongPtr<VirtualContainer> VirtualContainerPtr;
+	}
+}
+
+#include "Inspect/VirtualContainer.inl"
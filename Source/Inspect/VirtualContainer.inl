@@ -0,0 +1,24 @@
+Helium::Inspect::VirtualItemGenerator* Helium::Inspect::VirtualContainer::GetGenerator() const
+{
+	return m_Generator;
+}
+
+size_t Helium::Inspect::VirtualContainer::GetItemCount() const
+{
+	return m_ItemCount;
+}
+
+size_t Helium::Inspect::VirtualContainer::GetFirstVisible() const
+{
+	return m_First;
+}
+
+size_t Helium::Inspect::VirtualContainer::GetVisibleCount() const
+{
+	return m_Visible;
+}
+
+size_t Helium::Inspect::VirtualContainer::GetCreatedCount() const
+{
+	return m_Created;
+}
@@ -2,6 +2,7 @@
 #include "Math/AlignedBox.h"
 #include "Math/Matrix4.h"
 #include "Math/Frustum.h"
+#include "Math/PointSpan.h"
 
 using namespace Helium;
 
@@ -116,6 +117,73 @@ Vector3 AlignedBox::Test(Vector3 vertex)
 	return vertex;
 }
 
+void AlignedBox::Test(const ConstPointSpan& vertices)
+{
+	const size_t count = vertices.count;
+	if ( count == 0 )
+	{
+		return;
+	}
+
+	Vector3 low ( vertices.x[0], vertices.y[0], vertices.z[0] );
+	Vector3 high ( low );
+	size_t i = 0;
+
+#if HELIUM_MATH_SIMD
+	if ( count >= 4 )
+	{
+		__m128 minX, minY, minZ;
+		SimdKernels::LoadPoints( vertices, 0, minX, minY, minZ );
+		__m128 maxX = minX, maxY = minY, maxZ = minZ;
+
+		for ( i = 4; i + 4 <= count; i += 4 )
+		{
+			__m128 x, y, z;
+			SimdKernels::LoadPoints( vertices, i, x, y, z );
+			minX = _mm_min_ps( minX, x );
+			minY = _mm_min_ps( minY, y );
+			minZ = _mm_min_ps( minZ, z );
+			maxX = _mm_max_ps( maxX, x );
+			maxY = _mm_max_ps( maxY, y );
+			maxZ = _mm_max_ps( maxZ, z );
+		}
+
+		float32_t lanes[6][4];
+		_mm_storeu_ps( lanes[0], minX );
+		_mm_storeu_ps( lanes[1], minY );
+		_mm_storeu_ps( lanes[2], minZ );
+		_mm_storeu_ps( lanes[3], maxX );
+		_mm_storeu_ps( lanes[4], maxY );
+		_mm_storeu_ps( lanes[5], maxZ );
+
+		for ( size_t j=0; j<4; ++j )
+		{
+			low.x = lanes[0][j] < low.x ? lanes[0][j] : low.x;
+			low.y = lanes[1][j] < low.y ? lanes[1][j] : low.y;
+			low.z = lanes[2][j] < low.z ? lanes[2][j] : low.z;
+			high.x = lanes[3][j] > high.x ? lanes[3][j] : high.x;
+			high.y = lanes[4][j] > high.y ? lanes[4][j] : high.y;
+			high.z = lanes[5][j] > high.z ? lanes[5][j] : high.z;
+		}
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		const size_t o = i * vertices.stride;
+		const float32_t x = vertices.x[ o ], y = vertices.y[ o ], z = vertices.z[ o ];
+		low.x = x < low.x ? x : low.x;
+		low.y = y < low.y ? y : low.y;
+		low.z = z < low.z ? z : low.z;
+		high.x = x > high.x ? x : high.x;
+		high.y = y > high.y ? y : high.y;
+		high.z = z > high.z ? z : high.z;
+	}
+
+	Test( low );
+	Test( high );
+}
+
 void AlignedBox::Merge(const AlignedBox& box)
 {
 	if (!seeded)
@@ -176,24 +244,67 @@ void AlignedBox::Merge(const Vector3& position)
 
 void AlignedBox::Transform(const Matrix4& matrix)
 {
-	// get the currents sample bounds
-	V_Vector3 vertices;
-	GetVertices( vertices );
-
-	// reseed this box
-	Reset();
+	Transform( this, this, 1, matrix );
+}
 
-	// iterate and resample the bounds
-	V_Vector3::iterator itr = vertices.begin();
-	V_Vector3::iterator end = vertices.end();
-	for ( ; itr != end; ++itr )
+void AlignedBox::Transform(const AlignedBox* boxes, AlignedBox* result, size_t count, const Matrix4& matrix)
+{
+	// transform the center, and project the half extents onto each axis through the absolute matrix,
+	//  which gives the same bounds as transforming all eight corners
+	const Matrix4& m = matrix;
+
+#if HELIUM_MATH_SIMD
+	const __m128 mask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 row0 = _mm_loadu_ps( &m.x.x ), abs0 = _mm_and_ps( row0, mask );
+	const __m128 row1 = _mm_loadu_ps( &m.y.x ), abs1 = _mm_and_ps( row1, mask );
+	const __m128 row2 = _mm_loadu_ps( &m.z.x ), abs2 = _mm_and_ps( row2, mask );
+	const __m128 row3 = _mm_loadu_ps( &m.t.x );
+
+	for ( size_t i=0; i<count; ++i )
+	{
+		const AlignedBox& box = boxes[i];
+		__m128 low = _mm_setr_ps( box.minimum.x, box.minimum.y, box.minimum.z, 0.f );
+		__m128 high = _mm_setr_ps( box.maximum.x, box.maximum.y, box.maximum.z, 0.f );
+		__m128 c = _mm_mul_ps( _mm_add_ps( high, low ), half );
+		__m128 e = _mm_mul_ps( _mm_sub_ps( high, low ), half );
+
+		__m128 center = _mm_add_ps(
+			_mm_add_ps( _mm_mul_ps( SimdKernels::Swizzle< 0, 0, 0, 0 >( c ), row0 ), _mm_mul_ps( SimdKernels::Swizzle< 1, 1, 1, 1 >( c ), row1 ) ),
+			_mm_add_ps( _mm_mul_ps( SimdKernels::Swizzle< 2, 2, 2, 2 >( c ), row2 ), row3 ) );
+		__m128 extent = _mm_add_ps(
+			_mm_add_ps( _mm_mul_ps( SimdKernels::Swizzle< 0, 0, 0, 0 >( e ), abs0 ), _mm_mul_ps( SimdKernels::Swizzle< 1, 1, 1, 1 >( e ), abs1 ) ),
+			_mm_mul_ps( SimdKernels::Swizzle< 2, 2, 2, 2 >( e ), abs2 ) );
+
+		float32_t lanes[2][4];
+		_mm_storeu_ps( lanes[0], _mm_sub_ps( center, extent ) );
+		_mm_storeu_ps( lanes[1], _mm_add_ps( center, extent ) );
+
+		AlignedBox& out = result[i];
+		out.minimum.Set( lanes[0][0], lanes[0][1], lanes[0][2] );
+		out.maximum.Set( lanes[1][0], lanes[1][1], lanes[1][2] );
+		out.seeded = true;
+	}
+#else
+	for ( size_t i=0; i<count; ++i )
 	{
-		// transform the sample
-		matrix.TransformVertex( *itr );
+		const AlignedBox& box = boxes[i];
+		Vector3 c = box.Center();
+		Vector3 e = (box.maximum - box.minimum) * 0.5f;
+
+		Vector3 center, extent;
+		for ( uint32_t j=0; j<3; ++j )
+		{
+			center[j] = (m[0][j]*c.x) + (m[1][j]*c.y) + (m[2][j]*c.z) + (m[3][j]);
+			extent[j] = (fabs(m[0][j])*e.x) + (fabs(m[1][j])*e.y) + (fabs(m[2][j])*e.z);
+		}
 
-		// test the sample
-		Test( *itr );
+		AlignedBox& out = result[i];
+		out.minimum = center - extent;
+		out.maximum = center + extent;
+		out.seeded = true;
 	}
+#endif
 }
 
 void AlignedBox::GetVertices(V_Vector3& vertices) const
@@ -6,6 +6,7 @@
 namespace Helium
 {
     struct Matrix4;
+    struct ConstPointSpan;
 
     class HELIUM_MATH_API AlignedBox
     {
@@ -65,11 +66,15 @@ namespace Helium
         Vector3         ClosestCorner( const Vector3& v ) const;
 
         Vector3 Test(Vector3 vertex);
+        void Test(const ConstPointSpan& vertices);
 
         void Merge(const AlignedBox& box);
         void Merge(const Vector3& position);
 
         void Transform(const Matrix4& matrix);
+
+        // bounds of each box after transformation, result may be the same array as boxes
+        static void Transform(const AlignedBox* boxes, AlignedBox* result, size_t count, const Matrix4& matrix);
         void GetVertices(V_Vector3& vertices) const;
 
         static void GetWireframe(const V_Vector3& vertices, V_Vector3& lineList, bool clear = true);
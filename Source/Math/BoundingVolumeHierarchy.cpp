@@ -0,0 +1,563 @@
+#include "Precompile.h"
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/Frustum.h"
+
+#include "Platform/Thread.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+namespace
+{
+	typedef BoundingVolumeHierarchy::Node Node;
+
+	const uint32_t BinCount = 16;
+
+	// cost of visiting an interior node relative to testing one primitive
+	const float32_t TraversalCost = 1.0f;
+
+	// subtrees of at least WorkerThreshold primitives that reach WorkerDepth are finished on worker
+	//  threads, so a build uses at most 2^WorkerDepth workers
+	const uint32_t WorkerThreshold = 8192;
+	const uint32_t WorkerDepth = 3;
+
+	// past this depth nodes split at the object median, which bounds the rest of the tree by the log2 of
+	//  the primitive count and keeps the whole tree within MaxDepth
+	const uint32_t MedianDepth = BoundingVolumeHierarchy::MaxDepth - 32;
+
+	inline Vector3 Minimum( const Vector3& a, const Vector3& b )
+	{
+		return Vector3( a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z );
+	}
+
+	inline Vector3 Maximum( const Vector3& a, const Vector3& b )
+	{
+		return Vector3( a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z );
+	}
+
+	// squared distance from a point to the nearest point of a box, zero inside
+	inline float32_t DistanceSquared( const Vector3& point, const Vector3& minimum, const Vector3& maximum )
+	{
+		Vector3 nearest = Maximum( minimum, Minimum( point, maximum ) );
+		Vector3 offset = point - nearest;
+		return offset.Dot( offset );
+	}
+
+	struct Bounds
+	{
+		Vector3 minimum;
+		Vector3 maximum;
+
+		void Reset()
+		{
+			minimum = Vector3( FLT_MAX );
+			maximum = Vector3( -FLT_MAX );
+		}
+
+		void Merge( const Vector3& point )
+		{
+			minimum = Minimum( minimum, point );
+			maximum = Maximum( maximum, point );
+		}
+
+		void Merge( const Vector3& min, const Vector3& max )
+		{
+			minimum = Minimum( minimum, min );
+			maximum = Maximum( maximum, max );
+		}
+
+		// half the surface area, which is all the heuristic needs
+		float32_t HalfArea() const
+		{
+			Vector3 d = maximum - minimum;
+			return d.x < 0.0f ? 0.0f : d.x * d.y + d.y * d.z + d.z * d.x;
+		}
+	};
+
+	struct Bin
+	{
+		Bounds   bounds;
+		uint32_t count;
+	};
+
+	inline uint32_t BinIndex( float32_t centroid, float32_t minimum, float32_t scale )
+	{
+		uint32_t bin = static_cast< uint32_t >( ( centroid - minimum ) * scale );
+		return bin < BinCount ? bin : BinCount - 1;
+	}
+
+	struct BelowSplit
+	{
+		const Vector3* m_Centroids;
+		uint32_t       m_Axis;
+		float32_t      m_Minimum;
+		float32_t      m_Scale;
+		uint32_t       m_Split;
+
+		bool operator()( uint32_t primitive ) const
+		{
+			return BinIndex( m_Centroids[ primitive ][ m_Axis ], m_Minimum, m_Scale ) < m_Split;
+		}
+	};
+
+	struct CentroidLess
+	{
+		const Vector3* m_Centroids;
+		uint32_t       m_Axis;
+
+		bool operator()( uint32_t a, uint32_t b ) const
+		{
+			return m_Centroids[ a ][ m_Axis ] < m_Centroids[ b ][ m_Axis ];
+		}
+	};
+
+	struct Builder
+	{
+		struct Subtree
+		{
+			uint32_t node;
+			uint32_t first;
+			uint32_t count;
+			uint32_t depth;
+		};
+
+		const AlignedBox*     m_Bounds;
+		const Vector3*        m_Centroids;
+		uint32_t*             m_Primitives;  // shared permutation, each subtree only reorders its own range
+		uint32_t              m_MaxLeafSize;
+		bool                  m_Defer;       // leave large subtrees in m_Deferred for the workers
+		std::vector< Node >    m_Nodes;
+		std::vector< Subtree > m_Deferred;
+		Subtree               m_Subtree;     // the subtree a worker builds into its own m_Nodes
+
+		void Run()
+		{
+			m_Nodes.resize( 1 );
+			Build( 0, m_Subtree.first, m_Subtree.count, m_Subtree.depth );
+		}
+
+		void MakeLeaf( uint32_t index, uint32_t first, uint32_t count )
+		{
+			HELIUM_ASSERT( count <= 0xffff );
+			Node& node = m_Nodes[ index ];
+			node.offset = first;
+			node.count = static_cast< uint16_t >( count );
+			node.axis = 0;
+		}
+
+		void Build( uint32_t index, uint32_t first, uint32_t count, uint32_t depth );
+	};
+
+	void Builder::Build( uint32_t index, uint32_t first, uint32_t count, uint32_t depth )
+	{
+		if ( m_Defer && depth == WorkerDepth && count >= WorkerThreshold )
+		{
+			Subtree subtree = { index, first, count, depth };
+			m_Deferred.push_back( subtree );
+			return;
+		}
+
+		uint32_t* begin = m_Primitives + first;
+		uint32_t* end = begin + count;
+
+		Bounds bounds, centroids;
+		bounds.Reset();
+		centroids.Reset();
+		for ( uint32_t* p = begin; p != end; ++p )
+		{
+			const AlignedBox& box = m_Bounds[ *p ];
+			bounds.Merge( box.minimum, box.maximum );
+			centroids.Merge( m_Centroids[ *p ] );
+		}
+
+		m_Nodes[ index ].minimum = bounds.minimum;
+		m_Nodes[ index ].maximum = bounds.maximum;
+
+		if ( count == 1 )
+		{
+			MakeLeaf( index, first, count );
+			return;
+		}
+
+		// sweep the bins of each axis for the plane with the lowest surface area cost
+		const Vector3 extent = centroids.maximum - centroids.minimum;
+		float32_t bestCost = FLT_MAX;
+		uint32_t bestAxis = 0;
+		uint32_t bestSplit = 0;
+
+		for ( uint32_t axis = 0; axis < 3 && depth < MedianDepth; ++axis )
+		{
+			if ( extent[ axis ] <= 0.0f )
+			{
+				continue;
+			}
+
+			const float32_t scale = BinCount / extent[ axis ];
+
+			Bin bins[ BinCount ];
+			for ( uint32_t b = 0; b < BinCount; ++b )
+			{
+				bins[ b ].bounds.Reset();
+				bins[ b ].count = 0;
+			}
+
+			for ( uint32_t* p = begin; p != end; ++p )
+			{
+				Bin& bin = bins[ BinIndex( m_Centroids[ *p ][ axis ], centroids.minimum[ axis ], scale ) ];
+				bin.bounds.Merge( m_Bounds[ *p ].minimum, m_Bounds[ *p ].maximum );
+				bin.count++;
+			}
+
+			float32_t aboveArea[ BinCount ];
+			uint32_t aboveCount[ BinCount ];
+			Bounds above;
+			above.Reset();
+			uint32_t n = 0;
+			for ( uint32_t b = BinCount - 1; b > 0; --b )
+			{
+				above.Merge( bins[ b ].bounds.minimum, bins[ b ].bounds.maximum );
+				n += bins[ b ].count;
+				aboveArea[ b ] = above.HalfArea();
+				aboveCount[ b ] = n;
+			}
+
+			Bounds below;
+			below.Reset();
+			n = 0;
+			for ( uint32_t b = 1; b < BinCount; ++b )
+			{
+				below.Merge( bins[ b - 1 ].bounds.minimum, bins[ b - 1 ].bounds.maximum );
+				n += bins[ b - 1 ].count;
+				if ( n == 0 || aboveCount[ b ] == 0 )
+				{
+					continue;
+				}
+
+				float32_t cost = below.HalfArea() * n + aboveArea[ b ] * aboveCount[ b ];
+				if ( cost < bestCost )
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		const float32_t area = bounds.HalfArea();
+		if ( count <= m_MaxLeafSize && ( bestCost == FLT_MAX || TraversalCost * area + bestCost >= count * area ) )
+		{
+			MakeLeaf( index, first, count );
+			return;
+		}
+
+		uint32_t* middle;
+		if ( bestCost < FLT_MAX )
+		{
+			BelowSplit below = { m_Centroids, bestAxis, centroids.minimum[ bestAxis ], BinCount / extent[ bestAxis ], bestSplit };
+			middle = std::partition( begin, end, below );
+		}
+		else
+		{
+			// too deep for the heuristic or every centroid coincides, split at the object median of the longest axis
+			bestAxis = extent.x >= extent.y ? ( extent.x >= extent.z ? 0 : 2 ) : ( extent.y >= extent.z ? 1 : 2 );
+			middle = begin + count / 2;
+			CentroidLess less = { m_Centroids, bestAxis };
+			std::nth_element( begin, middle, end, less );
+		}
+
+		const uint32_t belowCount = static_cast< uint32_t >( middle - begin );
+		HELIUM_ASSERT( belowCount > 0 && belowCount < count );
+
+		const uint32_t child = static_cast< uint32_t >( m_Nodes.size() );
+		m_Nodes.resize( child + 2 );
+
+		Node& node = m_Nodes[ index ];
+		node.offset = child;
+		node.count = 0;
+		node.axis = static_cast< uint16_t >( bestAxis );
+
+		Build( child, first, belowCount, depth + 1 );
+		Build( child + 1, first + belowCount, count - belowCount, depth + 1 );
+	}
+
+	struct LineTest
+	{
+		Vector3   m_Origin;
+		Vector3   m_InverseDirection;
+		float32_t m_MaxT;
+
+		bool Node( const Vector3& minimum, const Vector3& maximum ) const
+		{
+			return BoundingVolumeHierarchy::IntersectSlabs( minimum, maximum, m_Origin, m_InverseDirection, m_MaxT );
+		}
+
+		bool Primitive( const AlignedBox& box ) const
+		{
+			return Node( box.minimum, box.maximum );
+		}
+	};
+
+	struct FrustumTest
+	{
+		const Frustum* m_Frustum;
+
+		// conservative against Frustum::IntersectsBox, including the point test it uses for tiny boxes
+		bool Node( const Vector3& minimum, const Vector3& maximum ) const
+		{
+			Vector3 c = ( minimum + maximum ) * 0.5f;
+			Vector3 d = maximum - c;
+
+			for ( uint32_t i=0; i<6; i++ )
+			{
+				const Plane& p = (*m_Frustum)[ i ];
+
+				float32_t m = ( c.x * p.A() ) + ( c.y * p.B() ) + ( c.z * p.C() ) + p.D();
+				float32_t n = ( d.x * fabs( p.A() ) ) + ( d.y * fabs( p.B() ) ) + ( d.z * fabs( p.C() ) );
+
+				if ( m + n < -HELIUM_POINT_ON_PLANE_ERROR )
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool Primitive( const AlignedBox& box ) const
+		{
+			return m_Frustum->IntersectsBox( box );
+		}
+	};
+
+	struct SphereTest
+	{
+		Vector3   m_Center;
+		float32_t m_RadiusSquared;
+
+		bool Node( const Vector3& minimum, const Vector3& maximum ) const
+		{
+			return DistanceSquared( m_Center, minimum, maximum ) <= m_RadiusSquared;
+		}
+
+		bool Primitive( const AlignedBox& box ) const
+		{
+			return Node( box.minimum, box.maximum );
+		}
+	};
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+}
+
+void BoundingVolumeHierarchy::Build( const AlignedBox* bounds, size_t count, uint32_t maxLeafSize )
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	HELIUM_ASSERT( maxLeafSize > 0 && maxLeafSize <= 0xffff );
+	HELIUM_ASSERT( count < 0xffffffff );
+
+	Clear();
+
+	if ( count == 0 )
+	{
+		return;
+	}
+
+	std::vector< Vector3 > centroids ( count );
+	m_Primitives.resize( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		centroids[ i ] = bounds[ i ].Center();
+		m_Primitives[ i ] = static_cast< uint32_t >( i );
+	}
+
+	Builder builder;
+	builder.m_Bounds = bounds;
+	builder.m_Centroids = &centroids.front();
+	builder.m_Primitives = &m_Primitives.front();
+	builder.m_MaxLeafSize = maxLeafSize;
+	builder.m_Defer = true;
+	builder.m_Nodes.reserve( 2 * count / maxLeafSize + 1 );
+	builder.m_Nodes.resize( 1 );
+	builder.Build( 0, 0, static_cast< uint32_t >( count ), 0 );
+
+	// the top of the tree is built, finish the large subtrees it left behind in parallel
+	const size_t workerCount = builder.m_Deferred.size();
+	HELIUM_ASSERT( workerCount <= ( 1 << WorkerDepth ) );
+
+	Builder workers[ 1 << WorkerDepth ];
+	CallbackThread threads[ 1 << WorkerDepth ];
+	bool running[ 1 << WorkerDepth ];
+
+	for ( size_t i=0; i<workerCount; ++i )
+	{
+		Builder& worker = workers[ i ];
+		worker.m_Bounds = bounds;
+		worker.m_Centroids = builder.m_Centroids;
+		worker.m_Primitives = builder.m_Primitives;
+		worker.m_MaxLeafSize = maxLeafSize;
+		worker.m_Defer = false;
+		worker.m_Subtree = builder.m_Deferred[ i ];
+
+		CallbackThread::Entry entry = &CallbackThread::EntryHelper< Builder, &Builder::Run >;
+		running[ i ] = threads[ i ].Create( entry, &worker, "Bounding Volume Hierarchy Build" );
+		if ( !running[ i ] )
+		{
+			worker.Run();
+		}
+	}
+
+	m_Nodes.swap( builder.m_Nodes );
+
+	// splice each subtree in, its root replaces the placeholder the top level left and the rest are
+	//  appended, so children still always follow their parent
+	for ( size_t i=0; i<workerCount; ++i )
+	{
+		if ( running[ i ] )
+		{
+			threads[ i ].Join();
+		}
+
+		const std::vector< Node >& nodes = workers[ i ].m_Nodes;
+		const uint32_t base = static_cast< uint32_t >( m_Nodes.size() ) - 1;
+
+		Node& root = m_Nodes[ workers[ i ].m_Subtree.node ];
+		root = nodes.front();
+		if ( !root.IsLeaf() )
+		{
+			root.offset += base;
+		}
+
+		const size_t first = m_Nodes.size();
+		m_Nodes.insert( m_Nodes.end(), nodes.begin() + 1, nodes.end() );
+		for ( size_t n = first; n < m_Nodes.size(); ++n )
+		{
+			if ( !m_Nodes[ n ].IsLeaf() )
+			{
+				m_Nodes[ n ].offset += base;
+			}
+		}
+	}
+
+	m_Bounds.resize( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		m_Bounds[ i ] = bounds[ m_Primitives[ i ] ];
+	}
+}
+
+void BoundingVolumeHierarchy::Refit( const AlignedBox* bounds )
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	for ( size_t i=0; i<m_Primitives.size(); ++i )
+	{
+		m_Bounds[ i ] = bounds[ m_Primitives[ i ] ];
+	}
+
+	// children always follow their parent, so walking backwards refits every child before its parent
+	for ( size_t i = m_Nodes.size(); i-- > 0; )
+	{
+		Node& node = m_Nodes[ i ];
+		if ( node.IsLeaf() )
+		{
+			node.minimum = m_Bounds[ node.offset ].minimum;
+			node.maximum = m_Bounds[ node.offset ].maximum;
+			for ( uint32_t p = node.offset + 1, end = node.offset + node.count; p < end; ++p )
+			{
+				node.minimum = Minimum( node.minimum, m_Bounds[ p ].minimum );
+				node.maximum = Maximum( node.maximum, m_Bounds[ p ].maximum );
+			}
+		}
+		else
+		{
+			const Node& below = m_Nodes[ node.offset ];
+			const Node& above = m_Nodes[ node.offset + 1 ];
+			node.minimum = Minimum( below.minimum, above.minimum );
+			node.maximum = Maximum( below.maximum, above.maximum );
+		}
+	}
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	m_Nodes.clear();
+	m_Primitives.clear();
+	m_Bounds.clear();
+}
+
+template< class TestT >
+void BoundingVolumeHierarchy::Traverse( const TestT& test, std::vector< uint32_t >& result ) const
+{
+	if ( m_Nodes.empty() )
+	{
+		return;
+	}
+
+	uint32_t stack[ MaxDepth ];
+	uint32_t depth = 0;
+	uint32_t index = 0;
+
+	for (;;)
+	{
+		const Node& node = m_Nodes[ index ];
+		if ( test.Node( node.minimum, node.maximum ) )
+		{
+			if ( !node.IsLeaf() )
+			{
+				stack[ depth++ ] = node.offset + 1;
+				index = node.offset;
+				continue;
+			}
+
+			for ( uint32_t i = node.offset, end = node.offset + node.count; i < end; ++i )
+			{
+				if ( test.Primitive( m_Bounds[ i ] ) )
+				{
+					result.push_back( m_Primitives[ i ] );
+				}
+			}
+		}
+
+		if ( depth == 0 )
+		{
+			break;
+		}
+
+		index = stack[ --depth ];
+	}
+}
+
+void BoundingVolumeHierarchy::IntersectRay( const Line& ray, std::vector< uint32_t >& result ) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	LineTest test = { ray.m_Origin, InverseDirection( ray ), FLT_MAX };
+	Traverse( test, result );
+}
+
+void BoundingVolumeHierarchy::IntersectSegment( const Line& segment, std::vector< uint32_t >& result ) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	LineTest test = { segment.m_Origin, InverseDirection( segment ), 1.0f };
+	Traverse( test, result );
+}
+
+void BoundingVolumeHierarchy::IntersectFrustum( const Frustum& frustum, std::vector< uint32_t >& result ) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	FrustumTest test = { &frustum };
+	Traverse( test, result );
+}
+
+void BoundingVolumeHierarchy::IntersectSphere( const Vector3& center, float32_t radius, std::vector< uint32_t >& result ) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	SphereTest test = { center, radius * radius };
+	Traverse( test, result );
+}
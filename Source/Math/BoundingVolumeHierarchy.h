@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Math/API.h"
+#include "Math/AlignedBox.h"
+#include "Math/Line.h"
+
+#include <float.h>
+#include <vector>
+
+namespace Helium
+{
+	class Frustum;
+
+	//
+	// Bounding volume hierarchy over primitives described only by their AlignedBox bounds.  The tree is
+	//  built top down with a binned surface area heuristic, large builds finish their lower subtrees on
+	//  worker threads.  Queries report every primitive whose bounds pass, the exact primitive test is
+	//  left to the caller.
+	//
+
+	class HELIUM_MATH_API BoundingVolumeHierarchy
+	{
+	public:
+		// the build keeps the tree at or under this depth, so traversal can use a fixed stack
+		static const uint32_t MaxDepth = 64;
+
+		struct Node
+		{
+			Vector3  minimum;
+			Vector3  maximum;
+			uint32_t offset;  // first primitive of a leaf, the first of the two children of an interior node
+			uint16_t count;   // primitive count of a leaf, zero for interior nodes
+			uint16_t axis;    // split axis of an interior node
+
+			bool IsLeaf() const
+			{
+				return count != 0;
+			}
+		};
+
+		BoundingVolumeHierarchy();
+
+		// builds the tree over count primitives, bounds[i] bounds primitive i
+		void Build( const AlignedBox* bounds, size_t count, uint32_t maxLeafSize = 4 );
+
+		// updates the bounds of every node after primitives move, bounds must hold the same primitives
+		//  as the last build (quality will degrade as primitives move far from where they were built)
+		void Refit( const AlignedBox* bounds );
+
+		void Clear();
+
+		size_t GetPrimitiveCount() const
+		{
+			return m_Primitives.size();
+		}
+
+		size_t GetNodeCount() const
+		{
+			return m_Nodes.size();
+		}
+
+		const Node& GetNode( size_t index ) const
+		{
+			return m_Nodes[ index ];
+		}
+
+		// index of the primitive at position i in leaf order
+		uint32_t GetPrimitive( size_t index ) const
+		{
+			return m_Primitives[ index ];
+		}
+
+		// candidate queries, indices of the primitives whose bounds intersect are appended to result
+		//  (rays start at m_Origin and pass through m_Point, segments end at m_Point)
+		void IntersectRay( const Line& ray, std::vector< uint32_t >& result ) const;
+		void IntersectSegment( const Line& segment, std::vector< uint32_t >& result ) const;
+		void IntersectFrustum( const Frustum& frustum, std::vector< uint32_t >& result ) const;
+		void IntersectSphere( const Vector3& center, float32_t radius, std::vector< uint32_t >& result ) const;
+
+		// finds the nearest primitive along m_Origin + t * ( m_Point - m_Origin ) for t in [0, t], visiting
+		//  nodes front to back.  test( primitive, t ) is called for each candidate and returns true after
+		//  lowering t to a closer hit.  On return t and primitive describe the nearest hit, if any
+		template< class TestT >
+		bool Raycast( const Line& ray, TestT& test, float32_t& t, uint32_t& primitive ) const;
+
+		// slab test of a box against a line between its origin and maxT, see InverseDirection()
+		static inline bool IntersectSlabs( const Vector3& minimum, const Vector3& maximum, const Vector3& origin, const Vector3& inverseDirection, float32_t maxT );
+		static inline Vector3 InverseDirection( const Line& line );
+
+	private:
+		template< class TestT >
+		void Traverse( const TestT& test, std::vector< uint32_t >& result ) const;
+
+		std::vector< Node >       m_Nodes;
+		std::vector< uint32_t >   m_Primitives;  // primitive indices in leaf order
+		std::vector< AlignedBox > m_Bounds;      // primitive bounds in leaf order
+	};
+}
+
+#include "Math/BoundingVolumeHierarchy.inl"
@@ -0,0 +1,120 @@
+/// Test a box against the part of a line between its origin and maxT.
+///
+/// @param[in] minimum           Box minimum.
+/// @param[in] maximum           Box maximum.
+/// @param[in] origin            Line origin.
+/// @param[in] inverseDirection  Per component reciprocal of the line direction, see InverseDirection().
+/// @param[in] maxT              Farthest parameter along the line to consider.
+///
+/// @return  True if the line passes through the box before maxT.
+bool Helium::BoundingVolumeHierarchy::IntersectSlabs( const Vector3& minimum, const Vector3& maximum, const Vector3& origin, const Vector3& inverseDirection, float32_t maxT )
+{
+	float32_t tNear = 0.0f;
+	float32_t tFar = maxT;
+
+	for ( uint32_t i=0; i<3; ++i )
+	{
+		float32_t t0 = ( minimum[ i ] - origin[ i ] ) * inverseDirection[ i ];
+		float32_t t1 = ( maximum[ i ] - origin[ i ] ) * inverseDirection[ i ];
+		if ( t0 > t1 )
+		{
+			float32_t swap = t0;
+			t0 = t1;
+			t1 = swap;
+		}
+
+		// widen the far distance by a few ulps so rounding can never cull a box the line grazes
+		t1 *= 1.0f + 2.0f * FLT_EPSILON;
+
+		tNear = t0 > tNear ? t0 : tNear;
+		tFar = t1 < tFar ? t1 : tFar;
+	}
+
+	return tNear <= tFar;
+}
+
+/// Reciprocal of each component of the line direction.  Components that are zero are replaced by a tiny
+/// value of the same sign so the slab test never multiplies zero by infinity.
+///
+/// @param[in] line  Line to invert.
+///
+/// @return  Reciprocal direction.
+Helium::Vector3 Helium::BoundingVolumeHierarchy::InverseDirection( const Line& line )
+{
+	Vector3 direction = line.m_Point - line.m_Origin;
+	Vector3 result;
+
+	for ( uint32_t i=0; i<3; ++i )
+	{
+		float32_t d = direction[ i ];
+		if ( fabs( d ) < 1e-20f )
+		{
+			d = d < 0.0f ? -1e-20f : 1e-20f;
+		}
+
+		result[ i ] = 1.0f / d;
+	}
+
+	return result;
+}
+
+/// Find the nearest primitive hit along a ray.
+///
+/// @param[in]     ray        Ray from m_Origin towards m_Point, t is measured in units of m_Point - m_Origin.
+/// @param[in]     test       Exact primitive test, bool test( uint32_t primitive, float32_t& t ), which
+///                           returns true only for hits closer than the incoming t and lowers t to match.
+/// @param[in,out] t          Farthest parameter to consider, set to the nearest hit on return.
+/// @param[out]    primitive  Index of the nearest primitive hit.
+///
+/// @return  True if any primitive was hit.
+template< class TestT >
+bool Helium::BoundingVolumeHierarchy::Raycast( const Line& ray, TestT& test, float32_t& t, uint32_t& primitive ) const
+{
+	if ( m_Nodes.empty() )
+	{
+		return false;
+	}
+
+	const Vector3 direction = ray.m_Point - ray.m_Origin;
+	const Vector3 inverseDirection = InverseDirection( ray );
+	bool hit = false;
+
+	uint32_t stack[ MaxDepth ];
+	uint32_t depth = 0;
+	uint32_t index = 0;
+
+	for (;;)
+	{
+		const Node& node = m_Nodes[ index ];
+		if ( IntersectSlabs( node.minimum, node.maximum, ray.m_Origin, inverseDirection, t ) )
+		{
+			if ( !node.IsLeaf() )
+			{
+				// visit the child nearer the origin first so later hits can cull the far one
+				const uint32_t nearChild = direction[ node.axis ] < 0.0f ? 1 : 0;
+				stack[ depth++ ] = node.offset + ( 1 - nearChild );
+				index = node.offset + nearChild;
+				continue;
+			}
+
+			for ( uint32_t i = node.offset, end = node.offset + node.count; i < end; ++i )
+			{
+				const AlignedBox& bounds = m_Bounds[ i ];
+				if ( IntersectSlabs( bounds.minimum, bounds.maximum, ray.m_Origin, inverseDirection, t ) && test( m_Primitives[ i ], t ) )
+				{
+					primitive = m_Primitives[ i ];
+					hit = true;
+				}
+			}
+		}
+
+		if ( depth == 0 )
+		{
+			break;
+		}
+
+		index = stack[ --depth ];
+	}
+
+	return hit;
+}
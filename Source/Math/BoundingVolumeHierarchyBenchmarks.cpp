@@ -0,0 +1,75 @@
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <float.h>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+namespace
+{
+	const uint32_t RandomSeed = 54321;
+}
+
+// prints the time to build, refit and raycast a 200k triangle tree against brute force, BoundingVolumeHierarchyParallelBuild checks the results
+TEST(Math, BoundingVolumeHierarchyBenchmark)
+{
+	Random random ( RandomSeed );
+	Triangles triangles ( random, 200000, 100.f );
+
+	BoundingVolumeHierarchy bvh;
+
+	uint64_t start = Timer::GetTickCount();
+	bvh.Build( &triangles.bounds.front(), triangles.bounds.size() );
+	float64_t buildMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	start = Timer::GetTickCount();
+	bvh.Refit( &triangles.bounds.front() );
+	float64_t refitMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	const uint32_t rayCount = 200;
+	std::vector< Line > rays;
+	for ( uint32_t i=0; i<rayCount; ++i )
+	{
+		rays.push_back( RandomRay( random, 100.f ) );
+	}
+
+	uint32_t bruteHits = 0;
+	start = Timer::GetTickCount();
+	for ( uint32_t r=0; r<rayCount; ++r )
+	{
+		float32_t nearest = FLT_MAX;
+		for ( uint32_t i=0; i<triangles.bounds.size(); ++i )
+		{
+			float32_t t;
+			if ( triangles.RayHit( rays[ r ], i, &t ) && t < nearest )
+			{
+				nearest = t;
+			}
+		}
+
+		bruteHits += nearest < FLT_MAX;
+	}
+	float64_t bruteMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	uint32_t bvhHits = 0;
+	start = Timer::GetTickCount();
+	for ( uint32_t r=0; r<rayCount; ++r )
+	{
+		NearestHit test = { &triangles, &rays[ r ] };
+		float32_t t = FLT_MAX;
+		uint32_t primitive;
+		bvhHits += bvh.Raycast( rays[ r ], test, t, primitive );
+	}
+	float64_t bvhMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "BVH over %u triangles: build %.1f ms, refit %.1f ms, %u nearest hit rays %.2f ms (brute force %.1f ms)\n",
+		static_cast< uint32_t >( triangles.bounds.size() ), buildMs, refitMs, rayCount, bvhMs, bruteMs );
+
+	EXPECT_EQ( bruteHits, bvhHits );
+}
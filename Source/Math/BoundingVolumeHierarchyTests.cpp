@@ -0,0 +1,236 @@
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/Frustum.h"
+#include "Math/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+namespace
+{
+	const uint32_t RandomSeed = 54321;
+
+	std::vector< uint32_t > Sorted( std::vector< uint32_t > indices )
+	{
+		std::sort( indices.begin(), indices.end() );
+		return indices;
+	}
+
+	// checks every query against a brute force pass over all primitives
+	void ExpectQueriesMatchBruteForce( const BoundingVolumeHierarchy& bvh, const Triangles& triangles, Random& random, float32_t extent )
+	{
+		const uint32_t count = static_cast< uint32_t >( triangles.bounds.size() );
+		std::vector< uint32_t > candidates, expected, actual;
+
+		for ( uint32_t q=0; q<50; ++q )
+		{
+			Line ray = RandomRay( random, extent );
+
+			expected.clear();
+			float32_t nearest = FLT_MAX;
+			for ( uint32_t i=0; i<count; ++i )
+			{
+				float32_t t;
+				if ( triangles.RayHit( ray, i, &t ) )
+				{
+					expected.push_back( i );
+					nearest = std::min( nearest, t );
+				}
+			}
+
+			candidates.clear();
+			bvh.IntersectRay( ray, candidates );
+			actual.clear();
+			for ( size_t i=0; i<candidates.size(); ++i )
+			{
+				if ( triangles.RayHit( ray, candidates[ i ] ) )
+				{
+					actual.push_back( candidates[ i ] );
+				}
+			}
+			EXPECT_EQ( expected, Sorted( actual ) );
+
+			NearestHit test = { &triangles, &ray };
+			float32_t t = FLT_MAX;
+			uint32_t primitive = 0;
+			EXPECT_EQ( !expected.empty(), bvh.Raycast( ray, test, t, primitive ) );
+			if ( !expected.empty() )
+			{
+				EXPECT_EQ( nearest, t );
+			}
+
+			// a segment long enough to cross a good part of the scene
+			Line segment ( ray.m_Origin, ray.m_Origin + ( ray.m_Point - ray.m_Origin ) * extent * 0.5f );
+
+			expected.clear();
+			for ( uint32_t i=0; i<count; ++i )
+			{
+				if ( triangles.SegmentHit( segment, i ) )
+				{
+					expected.push_back( i );
+				}
+			}
+
+			candidates.clear();
+			bvh.IntersectSegment( segment, candidates );
+			actual.clear();
+			for ( size_t i=0; i<candidates.size(); ++i )
+			{
+				if ( triangles.SegmentHit( segment, candidates[ i ] ) )
+				{
+					actual.push_back( candidates[ i ] );
+				}
+			}
+			EXPECT_EQ( expected, Sorted( actual ) );
+
+			Vector3 center = random.NextVector( extent );
+			float32_t radius = ( random.Next() + 1.f ) * extent * 0.1f;
+
+			expected.clear();
+			for ( uint32_t i=0; i<count; ++i )
+			{
+				if ( triangles.bounds[ i ].IntersectsSphere( center, radius ) )
+				{
+					expected.push_back( i );
+				}
+			}
+
+			actual.clear();
+			bvh.IntersectSphere( center, radius, actual );
+			EXPECT_EQ( expected, Sorted( actual ) );
+		}
+
+		Frustum frustum = TestFrustum( 30.f );
+
+		expected.clear();
+		for ( uint32_t i=0; i<count; ++i )
+		{
+			if ( frustum.IntersectsBox( triangles.bounds[ i ] ) )
+			{
+				expected.push_back( i );
+			}
+		}
+
+		actual.clear();
+		bvh.IntersectFrustum( frustum, actual );
+		EXPECT_EQ( expected, Sorted( actual ) );
+	}
+
+	// every primitive in exactly one leaf and every node bounding what is below it
+	void ExpectWellFormed( const BoundingVolumeHierarchy& bvh, const std::vector< AlignedBox >& bounds )
+	{
+		std::vector< uint32_t > seen ( bounds.size(), 0 );
+		for ( size_t n=0; n<bvh.GetNodeCount(); ++n )
+		{
+			const BoundingVolumeHierarchy::Node& node = bvh.GetNode( n );
+			AlignedBox box ( node.minimum, node.maximum );
+
+			if ( node.IsLeaf() )
+			{
+				for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+				{
+					const AlignedBox& primitive = bounds[ bvh.GetPrimitive( i ) ];
+					seen[ bvh.GetPrimitive( i ) ]++;
+					EXPECT_TRUE( primitive.minimum.x >= box.minimum.x && primitive.maximum.x <= box.maximum.x );
+					EXPECT_TRUE( primitive.minimum.y >= box.minimum.y && primitive.maximum.y <= box.maximum.y );
+					EXPECT_TRUE( primitive.minimum.z >= box.minimum.z && primitive.maximum.z <= box.maximum.z );
+				}
+			}
+			else
+			{
+				ASSERT_GT( node.offset, n );
+				ASSERT_LT( node.offset + 1, bvh.GetNodeCount() );
+				for ( uint32_t c = node.offset; c < node.offset + 2; ++c )
+				{
+					const BoundingVolumeHierarchy::Node& child = bvh.GetNode( c );
+					EXPECT_TRUE( child.minimum.x >= box.minimum.x && child.maximum.x <= box.maximum.x );
+					EXPECT_TRUE( child.minimum.y >= box.minimum.y && child.maximum.y <= box.maximum.y );
+					EXPECT_TRUE( child.minimum.z >= box.minimum.z && child.maximum.z <= box.maximum.z );
+				}
+			}
+		}
+
+		EXPECT_EQ( bounds.size(), static_cast< size_t >( std::count( seen.begin(), seen.end(), 1u ) ) );
+	}
+}
+
+TEST(Math, BoundingVolumeHierarchyQueries)
+{
+	Random random ( RandomSeed );
+	Triangles triangles ( random, 4000, 20.f );
+
+	BoundingVolumeHierarchy bvh;
+	bvh.Build( &triangles.bounds.front(), triangles.bounds.size() );
+	ExpectWellFormed( bvh, triangles.bounds );
+	ExpectQueriesMatchBruteForce( bvh, triangles, random, 20.f );
+
+	// move a third of the triangles across the scene, the refit tree must still find all of them
+	for ( size_t i=0; i<triangles.bounds.size(); i += 3 )
+	{
+		Vector3 offset = random.NextVector( 10.f );
+		for ( size_t j=0; j<3; ++j )
+		{
+			triangles.vertices[ i * 3 + j ] += offset;
+		}
+	}
+
+	triangles.UpdateBounds();
+	bvh.Refit( &triangles.bounds.front() );
+	ExpectWellFormed( bvh, triangles.bounds );
+	ExpectQueriesMatchBruteForce( bvh, triangles, random, 20.f );
+}
+
+TEST(Math, BoundingVolumeHierarchyDegenerate)
+{
+	BoundingVolumeHierarchy bvh;
+	std::vector< uint32_t > result;
+
+	bvh.Build( NULL, 0 );
+	bvh.IntersectSphere( Vector3::Zero, 1.f, result );
+	EXPECT_TRUE( result.empty() );
+
+	// coincident boxes have no centroid extent to bin, so the build must fall back to median splits
+	std::vector< AlignedBox > bounds ( 1000, AlignedBox( Vector3( -1.f, -1.f, -1.f ), Vector3( 1.f, 1.f, 1.f ) ) );
+	bvh.Build( &bounds.front(), bounds.size() );
+	ExpectWellFormed( bvh, bounds );
+
+	bvh.IntersectSphere( Vector3::Zero, 0.5f, result );
+	EXPECT_EQ( bounds.size(), result.size() );
+}
+
+TEST(Math, BoundingVolumeHierarchyParallelBuild)
+{
+	// large enough for the top of the tree to hand subtrees to worker threads
+	Random random ( RandomSeed );
+	Triangles triangles ( random, 200000, 100.f );
+
+	BoundingVolumeHierarchy bvh;
+	bvh.Build( &triangles.bounds.front(), triangles.bounds.size() );
+	bvh.Refit( &triangles.bounds.front() );
+	ExpectWellFormed( bvh, triangles.bounds );
+
+	for ( uint32_t r=0; r<20; ++r )
+	{
+		Line ray = RandomRay( random, 100.f );
+
+		float32_t nearest = FLT_MAX;
+		for ( uint32_t i=0; i<triangles.bounds.size(); ++i )
+		{
+			float32_t t;
+			if ( triangles.RayHit( ray, i, &t ) && t < nearest )
+			{
+				nearest = t;
+			}
+		}
+
+		NearestHit test = { &triangles, &ray };
+		float32_t t = FLT_MAX;
+		uint32_t primitive;
+		EXPECT_EQ( nearest < FLT_MAX, bvh.Raycast( ray, test, t, primitive ) );
+		EXPECT_EQ( nearest, t );
+	}
+}
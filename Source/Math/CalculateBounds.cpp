@@ -1,11 +1,466 @@
 #include "Precompile.h"
 #include "Math/CalculateBounds.h"
+#include "Math/PointSpan.h"
+
+#include "Platform/Semaphore.h"
+#include "Platform/Thread.h"
+
+#include <float.h>
 
 using namespace Helium;
 
 static const float32_t epsilon = 1.0e-10F;
 static const int32_t sweeps = 32;
 
+namespace
+{
+    // clouds of at least this many points are split across MaxTasks threads, smaller ones are
+    // reduced on the calling thread without starting any
+    const int32_t ParallelThreshold = 65536;
+    const uint32_t MaxTasks = 8;
+
+    // SIMD sums run in float lanes for this many points, then fold into double precision
+    const int32_t BlockSize = 1024;
+
+    // most points the fast sphere will add to its support set before settling for the enclosing sphere it has
+    const int32_t MaxSupportPoints = 256;
+
+    // runs reductions over one cloud, the calling thread takes the first chunk of the points and
+    // MaxTasks - 1 worker threads the rest.  The workers are started once and kept for every
+    // reduction over the cloud (the fast sphere makes a couple hundred) instead of each time.
+    class ReductionWorkers : NonCopyable
+    {
+    public:
+        explicit ReductionWorkers( int32_t count )
+            : m_Count( count )
+            , m_TaskCount( count >= ParallelThreshold ? MaxTasks : 1 )
+        {
+            for ( uint32_t i = 1; i < m_TaskCount; i++ )
+            {
+                Worker& worker = m_Workers[ i - 1 ];
+                CallbackThread::Entry entry = &CallbackThread::EntryHelper< Worker, &Worker::Run >;
+                worker.m_Running = worker.m_Thread.Create( entry, &worker, "Bounding Volume Reduction" );
+            }
+        }
+
+        ~ReductionWorkers()
+        {
+            for ( uint32_t i = 1; i < m_TaskCount; i++ )
+            {
+                Worker& worker = m_Workers[ i - 1 ];
+                if ( worker.m_Running )
+                {
+                    worker.m_Quit = true;
+                    worker.m_Work.Increment();
+                    worker.m_Thread.Join();
+                }
+            }
+        }
+
+        // splits the points between tasks and runs them, returning how many tasks hold results
+        template< class TaskT >
+        uint32_t Reduce( TaskT* tasks )
+        {
+            const int32_t chunk = ( m_Count + (int32_t)m_TaskCount - 1 ) / (int32_t)m_TaskCount;
+
+            for ( uint32_t i = 0; i < m_TaskCount; i++ )
+            {
+                tasks[ i ].m_Begin = MIN( m_Count, (int32_t)i * chunk );
+                tasks[ i ].m_End = MIN( m_Count, tasks[ i ].m_Begin + chunk );
+
+                if ( i > 0 )
+                {
+                    Worker& worker = m_Workers[ i - 1 ];
+                    if ( worker.m_Running )
+                    {
+                        worker.m_Entry = &CallbackThread::EntryHelper< TaskT, &TaskT::Run >;
+                        worker.m_Task = &tasks[ i ];
+                        worker.m_Work.Increment();
+                    }
+                    else
+                    {
+                        tasks[ i ].Run();
+                    }
+                }
+            }
+
+            tasks[ 0 ].Run();
+
+            for ( uint32_t i = 1; i < m_TaskCount; i++ )
+            {
+                Worker& worker = m_Workers[ i - 1 ];
+                if ( worker.m_Running )
+                {
+                    worker.m_Done.Decrement();
+                }
+            }
+
+            return m_TaskCount;
+        }
+
+    private:
+        struct Worker
+        {
+            CallbackThread          m_Thread;
+            Semaphore               m_Work;
+            Semaphore               m_Done;
+            CallbackThread::Entry   m_Entry;
+            void*                   m_Task;
+            volatile bool           m_Quit;
+            bool                    m_Running;
+
+            Worker()
+                : m_Entry( NULL )
+                , m_Task( NULL )
+                , m_Quit( false )
+                , m_Running( false )
+            {
+            }
+
+            void Run()
+            {
+                while ( true )
+                {
+                    m_Work.Decrement();
+                    if ( m_Quit )
+                    {
+                        break;
+                    }
+
+                    m_Entry( m_Task );
+                    m_Done.Increment();
+                }
+            }
+        };
+
+        const int32_t   m_Count;
+        const uint32_t  m_TaskCount;
+        Worker          m_Workers[ MaxTasks - 1 ];
+    };
+
+#if HELIUM_MATH_SIMD
+    inline float32_t HorizontalMin( __m128 v )
+    {
+        v = _mm_min_ps( v, SimdKernels::Swizzle< 2, 3, 0, 1 >( v ) );
+        return _mm_cvtss_f32( _mm_min_ps( v, SimdKernels::Swizzle< 1, 0, 3, 2 >( v ) ) );
+    }
+
+    inline float32_t HorizontalMax( __m128 v )
+    {
+        v = _mm_max_ps( v, SimdKernels::Swizzle< 2, 3, 0, 1 >( v ) );
+        return _mm_cvtss_f32( _mm_max_ps( v, SimdKernels::Swizzle< 1, 0, 3, 2 >( v ) ) );
+    }
+
+    inline float64_t HorizontalSum( __m128 v )
+    {
+        return _mm_cvtss_f32( SimdKernels::HorizontalAdd( v ) );
+    }
+#endif
+
+    struct SumTask
+    {
+        const Vector3*  m_Points;
+        int32_t         m_Begin;
+        int32_t         m_End;
+        float64_t       m_Sum[3];
+
+        void Run()
+        {
+            m_Sum[0] = m_Sum[1] = m_Sum[2] = 0.0;
+            int32_t i = m_Begin;
+
+#if HELIUM_MATH_SIMD
+            const ConstPointSpan span ( m_Points, m_End );
+            while ( i + 4 <= m_End )
+            {
+                __m128 sx = _mm_setzero_ps();
+                __m128 sy = _mm_setzero_ps();
+                __m128 sz = _mm_setzero_ps();
+
+                for ( const int32_t blockEnd = MIN( m_End, i + BlockSize ); i + 4 <= blockEnd; i += 4 )
+                {
+                    __m128 x, y, z;
+                    SimdKernels::LoadPoints( span, i, x, y, z );
+                    sx = _mm_add_ps( sx, x );
+                    sy = _mm_add_ps( sy, y );
+                    sz = _mm_add_ps( sz, z );
+                }
+
+                m_Sum[0] += HorizontalSum( sx );
+                m_Sum[1] += HorizontalSum( sy );
+                m_Sum[2] += HorizontalSum( sz );
+            }
+#endif
+
+            for ( ; i < m_End; i++ )
+            {
+                m_Sum[0] += m_Points[i].x;
+                m_Sum[1] += m_Points[i].y;
+                m_Sum[2] += m_Points[i].z;
+            }
+        }
+    };
+
+    // sums of the products of the offsets from the mean, in the order xx yy zz xy xz yz
+    struct CovarianceTask
+    {
+        const Vector3*  m_Points;
+        Vector3         m_Mean;
+        int32_t         m_Begin;
+        int32_t         m_End;
+        float64_t       m_Sum[6];
+
+        void Run()
+        {
+            for ( int32_t j = 0; j < 6; j++ )
+            {
+                m_Sum[j] = 0.0;
+            }
+
+            int32_t i = m_Begin;
+
+#if HELIUM_MATH_SIMD
+            const ConstPointSpan span ( m_Points, m_End );
+            const __m128 mx = _mm_set1_ps( m_Mean.x );
+            const __m128 my = _mm_set1_ps( m_Mean.y );
+            const __m128 mz = _mm_set1_ps( m_Mean.z );
+
+            while ( i + 4 <= m_End )
+            {
+                __m128 s[6];
+                for ( int32_t j = 0; j < 6; j++ )
+                {
+                    s[j] = _mm_setzero_ps();
+                }
+
+                for ( const int32_t blockEnd = MIN( m_End, i + BlockSize ); i + 4 <= blockEnd; i += 4 )
+                {
+                    __m128 x, y, z;
+                    SimdKernels::LoadPoints( span, i, x, y, z );
+                    x = _mm_sub_ps( x, mx );
+                    y = _mm_sub_ps( y, my );
+                    z = _mm_sub_ps( z, mz );
+
+                    s[0] = _mm_add_ps( s[0], _mm_mul_ps( x, x ) );
+                    s[1] = _mm_add_ps( s[1], _mm_mul_ps( y, y ) );
+                    s[2] = _mm_add_ps( s[2], _mm_mul_ps( z, z ) );
+                    s[3] = _mm_add_ps( s[3], _mm_mul_ps( x, y ) );
+                    s[4] = _mm_add_ps( s[4], _mm_mul_ps( x, z ) );
+                    s[5] = _mm_add_ps( s[5], _mm_mul_ps( y, z ) );
+                }
+
+                for ( int32_t j = 0; j < 6; j++ )
+                {
+                    m_Sum[j] += HorizontalSum( s[j] );
+                }
+            }
+#endif
+
+            for ( ; i < m_End; i++ )
+            {
+                float32_t x = m_Points[i].x - m_Mean.x;
+                float32_t y = m_Points[i].y - m_Mean.y;
+                float32_t z = m_Points[i].z - m_Mean.z;
+
+                m_Sum[0] += x * x;
+                m_Sum[1] += y * y;
+                m_Sum[2] += z * z;
+                m_Sum[3] += x * y;
+                m_Sum[4] += x * z;
+                m_Sum[5] += y * z;
+            }
+        }
+    };
+
+    // range of the projections of the points onto three axes
+    struct ExtentTask
+    {
+        const Vector3*  m_Points;
+        const Vector3*  m_Axes;
+        int32_t         m_Begin;
+        int32_t         m_End;
+        float32_t       m_Minimum[3];
+        float32_t       m_Maximum[3];
+
+        void Run()
+        {
+            for ( int32_t j = 0; j < 3; j++ )
+            {
+                m_Minimum[j] = FLT_MAX;
+                m_Maximum[j] = -FLT_MAX;
+            }
+
+            int32_t i = m_Begin;
+
+#if HELIUM_MATH_SIMD
+            if ( i + 4 <= m_End )
+            {
+                const ConstPointSpan span ( m_Points, m_End );
+                __m128 minimum[3], maximum[3];
+                for ( int32_t j = 0; j < 3; j++ )
+                {
+                    minimum[j] = _mm_set1_ps( FLT_MAX );
+                    maximum[j] = _mm_set1_ps( -FLT_MAX );
+                }
+
+                for ( ; i + 4 <= m_End; i += 4 )
+                {
+                    __m128 x, y, z;
+                    SimdKernels::LoadPoints( span, i, x, y, z );
+
+                    for ( int32_t j = 0; j < 3; j++ )
+                    {
+                        __m128 a = _mm_add_ps( _mm_add_ps(
+                            _mm_mul_ps( x, _mm_set1_ps( m_Axes[j].x ) ),
+                            _mm_mul_ps( y, _mm_set1_ps( m_Axes[j].y ) ) ),
+                            _mm_mul_ps( z, _mm_set1_ps( m_Axes[j].z ) ) );
+                        minimum[j] = _mm_min_ps( minimum[j], a );
+                        maximum[j] = _mm_max_ps( maximum[j], a );
+                    }
+                }
+
+                for ( int32_t j = 0; j < 3; j++ )
+                {
+                    m_Minimum[j] = HorizontalMin( minimum[j] );
+                    m_Maximum[j] = HorizontalMax( maximum[j] );
+                }
+            }
+#endif
+
+            for ( ; i < m_End; i++ )
+            {
+                for ( int32_t j = 0; j < 3; j++ )
+                {
+                    float32_t a = m_Points[i].Dot( m_Axes[j] );
+                    m_Minimum[j] = MIN( m_Minimum[j], a );
+                    m_Maximum[j] = MAX( m_Maximum[j], a );
+                }
+            }
+        }
+    };
+
+    // the point farthest from m_From
+    struct FarthestTask
+    {
+        const Vector3*  m_Points;
+        Vector3         m_From;
+        int32_t         m_Begin;
+        int32_t         m_End;
+        float32_t       m_DistanceSquared;
+        int32_t         m_Index;
+
+        void Run()
+        {
+            m_DistanceSquared = -1.0f;
+            m_Index = -1;
+
+            int32_t i = m_Begin;
+
+#if HELIUM_MATH_SIMD
+            if ( i + 4 <= m_End )
+            {
+                const ConstPointSpan span ( m_Points, m_End );
+                const __m128 fx = _mm_set1_ps( m_From.x );
+                const __m128 fy = _mm_set1_ps( m_From.y );
+                const __m128 fz = _mm_set1_ps( m_From.z );
+                const __m128i four = _mm_set1_epi32( 4 );
+
+                __m128 best = _mm_set1_ps( -1.0f );
+                __m128i bestIndex = _mm_set1_epi32( -1 );
+                __m128i index = _mm_setr_epi32( i, i + 1, i + 2, i + 3 );
+
+                for ( ; i + 4 <= m_End; i += 4 )
+                {
+                    __m128 x, y, z;
+                    SimdKernels::LoadPoints( span, i, x, y, z );
+                    x = _mm_sub_ps( x, fx );
+                    y = _mm_sub_ps( y, fy );
+                    z = _mm_sub_ps( z, fz );
+
+                    __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+                    __m128i farther = _mm_castps_si128( _mm_cmpgt_ps( d, best ) );
+                    best = _mm_max_ps( best, d );
+                    bestIndex = _mm_or_si128( _mm_and_si128( farther, index ), _mm_andnot_si128( farther, bestIndex ) );
+                    index = _mm_add_epi32( index, four );
+                }
+
+                float32_t lanes[4];
+                int32_t indices[4];
+                _mm_storeu_ps( lanes, best );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( indices ), bestIndex );
+
+                for ( int32_t j = 0; j < 4; j++ )
+                {
+                    if ( lanes[j] > m_DistanceSquared )
+                    {
+                        m_DistanceSquared = lanes[j];
+                        m_Index = indices[j];
+                    }
+                }
+            }
+#endif
+
+            for ( ; i < m_End; i++ )
+            {
+                float32_t d = ( m_Points[i] - m_From ).LengthSquared();
+                if ( d > m_DistanceSquared )
+                {
+                    m_DistanceSquared = d;
+                    m_Index = i;
+                }
+            }
+        }
+    };
+
+    void Extents( const Vector3* points, int32_t count, const Vector3* axes, float32_t* minimum, float32_t* maximum )
+    {
+        ExtentTask tasks[ MaxTasks ];
+        for ( uint32_t i = 0; i < MaxTasks; i++ )
+        {
+            tasks[i].m_Points = points;
+            tasks[i].m_Axes = axes;
+        }
+
+        ReductionWorkers workers ( count );
+        uint32_t taskCount = workers.Reduce( tasks );
+
+        for ( int32_t j = 0; j < 3; j++ )
+        {
+            minimum[j] = tasks[0].m_Minimum[j];
+            maximum[j] = tasks[0].m_Maximum[j];
+            for ( uint32_t i = 1; i < taskCount; i++ )
+            {
+                minimum[j] = MIN( minimum[j], tasks[i].m_Minimum[j] );
+                maximum[j] = MAX( maximum[j], tasks[i].m_Maximum[j] );
+            }
+        }
+    }
+
+    int32_t Farthest( ReductionWorkers& workers, const Vector3* points, const Vector3& from, float32_t& distanceSquared )
+    {
+        FarthestTask tasks[ MaxTasks ];
+        for ( uint32_t i = 0; i < MaxTasks; i++ )
+        {
+            tasks[i].m_Points = points;
+            tasks[i].m_From = from;
+        }
+
+        uint32_t taskCount = workers.Reduce( tasks );
+
+        uint32_t best = 0;
+        for ( uint32_t i = 1; i < taskCount; i++ )
+        {
+            if ( tasks[i].m_DistanceSquared > tasks[best].m_DistanceSquared )
+            {
+                best = i;
+            }
+        }
+
+        distanceSquared = tasks[best].m_DistanceSquared;
+        return tasks[best].m_Index;
+    }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -38,6 +493,9 @@ BoundingVolumeGenerator::BoundingVolumeGenerator(Vector3* points, int32_t point_
     case BSPHERE_OPTIMIZED:
         CalculateSystemMethod2();
         break;
+    case BSPHERE_FAST:
+        CalculateSystemFastSphere();
+        break;
     }
 }
 
@@ -97,34 +555,53 @@ void BoundingVolumeGenerator::CalculateSystem()
     if (m_PointCnt==0)
         return;
 
-    // First Calculate the average Position
-    m_Mean = Vector3(0,0,0);
-    for (int32_t i=0;i<m_PointCnt;i++)
+    // The mean and covariance are each summed over chunks of the cloud in parallel, and in double
+    // precision so large clouds do not lose the contribution of their later points
+    SumTask sums[ MaxTasks ];
+    for (uint32_t i=0;i<MaxTasks;i++)
     {
-        m_Mean+=m_Points[i];
+        sums[i].m_Points = m_Points;
     }
-    m_Mean/=(float32_t)m_PointCnt;
 
-    // Calculate the covariance matrix  
-    m_Covariant = Matrix3(Vector3 (0, 0, 0), Vector3 (0, 0, 0), Vector3 (0, 0, 0));
-    for (int32_t i=0;i<m_PointCnt;i++)
+    ReductionWorkers workers ( m_PointCnt );
+    uint32_t taskCount = workers.Reduce( sums );
+
+    float64_t mean[3] = { 0.0, 0.0, 0.0 };
+    for (uint32_t i=0;i<taskCount;i++)
     {
-        m_Covariant[0].x += (m_Points[i].x - m_Mean.x)*(m_Points[i].x - m_Mean.x);
-        m_Covariant[1].y += (m_Points[i].y - m_Mean.y)*(m_Points[i].y - m_Mean.y);
-        m_Covariant[2].z += (m_Points[i].z - m_Mean.z)*(m_Points[i].z - m_Mean.z);
+        for (int32_t j=0;j<3;j++)
+        {
+            mean[j] += sums[i].m_Sum[j];
+        }
+    }
+    m_Mean = Vector3( (float32_t)(mean[0]/m_PointCnt), (float32_t)(mean[1]/m_PointCnt), (float32_t)(mean[2]/m_PointCnt) );
 
-        m_Covariant[0].y += (m_Points[i].x - m_Mean.x)*(m_Points[i].y-m_Mean.y);
-        m_Covariant[0].z += (m_Points[i].x - m_Mean.x)*(m_Points[i].z-m_Mean.z);
-        m_Covariant[1].z += (m_Points[i].y - m_Mean.y)*(m_Points[i].z-m_Mean.z);
+    // Calculate the covariance matrix
+    CovarianceTask products[ MaxTasks ];
+    for (uint32_t i=0;i<MaxTasks;i++)
+    {
+        products[i].m_Points = m_Points;
+        products[i].m_Mean = m_Mean;
     }
 
-    // covariance matrix is symmetric so copy the elements
-    m_Covariant[1].x = m_Covariant[0].y;
-    m_Covariant[2].x = m_Covariant[0].z;
-    m_Covariant[2].y = m_Covariant[1].z;
+    taskCount = workers.Reduce( products );
+
+    float64_t covariance[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for (uint32_t i=0;i<taskCount;i++)
+    {
+        for (int32_t j=0;j<6;j++)
+        {
+            covariance[j] += products[i].m_Sum[j];
+        }
+    }
 
-    // divide the matrix by the point count
-    m_Covariant/=(float32_t)m_PointCnt;
+    // covariance matrix is symmetric so the off diagonal elements are shared
+    m_Covariant[0].x = (float32_t)(covariance[0]/m_PointCnt);
+    m_Covariant[1].y = (float32_t)(covariance[1]/m_PointCnt);
+    m_Covariant[2].z = (float32_t)(covariance[2]/m_PointCnt);
+    m_Covariant[0].y = m_Covariant[1].x = (float32_t)(covariance[3]/m_PointCnt);
+    m_Covariant[0].z = m_Covariant[2].x = (float32_t)(covariance[4]/m_PointCnt);
+    m_Covariant[1].z = m_Covariant[2].y = (float32_t)(covariance[5]/m_PointCnt);
 
     CalculateEigenSystem();
 }
@@ -267,27 +744,12 @@ BoundingVolumeGenerator::OBB BoundingVolumeGenerator::GetPrincipleAxisOBB()
     // cloud in the PCA axis, this gives us the bounds of the bounding
     // box. From this we can calculate the center of the bounding box
     // which is all the info we need.
-    float32_t mina,maxa;
-    float32_t minb,maxb;
-    float32_t minc,maxc;
-    mina = maxa = m_Points[0].Dot(m_EigenVectors[0]);
-    minb = maxb = m_Points[0].Dot(m_EigenVectors[1]);
-    minc = maxc = m_Points[0].Dot(m_EigenVectors[2]);
+    float32_t mins[3], maxs[3];
+    Extents( m_Points, m_PointCnt, &m_EigenVectors[0], mins, maxs );
 
-    for (int32_t i=1;i<m_PointCnt;i++)
-    {
-        float32_t a = m_Points[i].Dot(m_EigenVectors[0]);
-        mina = MIN(mina,a);
-        maxa = MAX(maxa,a);
-
-        float32_t b = m_Points[i].Dot(m_EigenVectors[1]);
-        minb = MIN(minb,b);
-        maxb = MAX(maxb,b);
-
-        float32_t c = m_Points[i].Dot(m_EigenVectors[2]);
-        minc = MIN(minc,c);
-        maxc = MAX(maxc,c);
-    }
+    float32_t mina = mins[0], maxa = maxs[0];
+    float32_t minb = mins[1], maxb = maxs[1];
+    float32_t minc = mins[2], maxc = maxs[2];
 
     // calculate the average extents to get the center point
     float32_t a = (mina+maxa)/2.0f;
@@ -324,7 +786,7 @@ BoundingVolumeGenerator::BSphere BoundingVolumeGenerator::GetPrincipleAxisBoundi
 {
     BSphere result;
 
-    if ( (m_volumeGenerationMethod == BSPHERE_OPTIMIZED) || (m_volumeGenerationMethod == BSPHERE_QUICK) )
+    if ( (m_volumeGenerationMethod == BSPHERE_OPTIMIZED) || (m_volumeGenerationMethod == BSPHERE_QUICK) || (m_volumeGenerationMethod == BSPHERE_FAST) )
     {
         result.m_Center = m_Center;
         result.m_Radius = sqrtf(m_RadSqr);
@@ -456,24 +918,14 @@ BoundingVolumeGenerator::AABB BoundingVolumeGenerator::GetAABB()
 
     AABB result;
 
-    float32_t minx,maxx;
-    float32_t miny,maxy;
-    float32_t minz,maxz;
-    minx = maxx = m_Points[0].x;
-    miny = maxy = m_Points[0].y;
-    minz = maxz = m_Points[0].z;
-
-    for (int32_t i=1;i<m_PointCnt;i++)
-    {
-        minx = MIN(minx,m_Points[i].x);
-        maxx = MAX(maxx,m_Points[i].x);
+    static const Vector3 axes[3] = { Vector3( 1.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ), Vector3( 0.0f, 0.0f, 1.0f ) };
 
-        miny = MIN(miny,m_Points[i].y);
-        maxy = MAX(maxy,m_Points[i].y);
+    float32_t mins[3], maxs[3];
+    Extents( m_Points, m_PointCnt, axes, mins, maxs );
 
-        minz = MIN(minz,m_Points[i].z);
-        maxz = MAX(maxz,m_Points[i].z);
-    }
+    float32_t minx = mins[0], maxx = maxs[0];
+    float32_t miny = mins[1], maxy = maxs[1];
+    float32_t minz = mins[2], maxz = maxs[2];
 
     // center is the middle of the extents
     result.m_Center.x = (minx+maxx)/2.0f;
@@ -955,6 +1407,51 @@ void BoundingVolumeGenerator::CalculateSystemMethod2(void)
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  CalculateSystemFastSphere()
+//
+//  Converges on the same sphere as CalculateSystemMethod2 while only running MiniSphere over a
+//  small support set. The set starts with Ritter's approximate diameter and grows by the point
+//  farthest outside the current sphere until every point is inside, so nearly all of the work is
+//  in the farthest point scans, which are linear in the point count and run in parallel.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////
+void BoundingVolumeGenerator::CalculateSystemFastSphere(void)
+{
+    SphereInit();
+
+    if (m_PointCnt <= 0)
+        return;
+
+    // the farthest point from an arbitrary point, and then the farthest point from that
+    ReductionWorkers workers ( m_PointCnt );
+    float32_t distsqr;
+    int32_t a = Farthest( workers, m_Points, m_Points[0], distsqr );
+    int32_t b = Farthest( workers, m_Points, m_Points[a], distsqr );
+
+    m_PointList.clear();
+    m_PointList.push_back( m_Points[a] );
+    m_PointList.push_back( m_Points[b] );
+
+    for (int32_t i = 0; i < MaxSupportPoints; i++)
+    {
+        MiniSphere();
+
+        int32_t outside = Farthest( workers, m_Points, m_Center, distsqr );
+        if ( distsqr <= m_RadSqr + (m_RadSqr * 0.000001f) )
+        {
+            break;
+        }
+
+        // move to front, the recursion meets the newest support point first which keeps it shallow
+        m_PointList.insert( m_PointList.begin(), m_Points[outside] );
+    }
+
+    // safety -- make sure bsphere fully encompasses the geometry
+    m_RadSqr = MAX( m_RadSqr, distsqr );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
 
 
 
@@ -29,6 +29,7 @@ namespace Helium
             PRINCIPAL_AXIS = 0,
             BSPHERE_QUICK,
             BSPHERE_OPTIMIZED,
+            BSPHERE_FAST,
         };
 
         ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,6 +88,17 @@ namespace Helium
         OBB     GetPrincipleAxisOBB();
         BSphere GetPrincipleAxisBoundingSphere();
 
+        // mean and covariance of the point cloud, only computed by the principal axis methods
+        const Vector3& GetMean() const
+        {
+            return m_Mean;
+        }
+
+        const Matrix3& GetCovariance() const
+        {
+            return m_Covariant;
+        }
+
     private:
         void CalculateSystem();
         void CalculateEigenSystem();
@@ -109,6 +121,7 @@ namespace Helium
         float32_t                     m_RadSqr;
 
         void    CalculateSystemMethod2(void);
+        void    CalculateSystemFastSphere(void);
 
         bool    SphereInside          (Vector3 &v);
 
@@ -0,0 +1,74 @@
+#include "Math/CalculateBounds.h"
+#include "Math/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+// prints the time for the fast and optimized bounding spheres, BoundingVolumeFastSphere checks they agree
+TEST(Math, BoundingVolumeSphereBenchmark)
+{
+	std::vector< Vector3 > points = BoundsTestCloud( 200000 );
+	const int32_t count = static_cast< int32_t >( points.size() );
+
+	uint64_t start = Timer::GetTickCount();
+	BoundingVolumeGenerator::BSphere fast = BoundingVolumeGenerator( &points.front(), count, BoundingVolumeGenerator::BSPHERE_FAST ).GetPrincipleAxisBoundingSphere();
+	float64_t fastMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	start = Timer::GetTickCount();
+	BoundingVolumeGenerator::BSphere optimized = BoundingVolumeGenerator( &points.front(), count, BoundingVolumeGenerator::BSPHERE_OPTIMIZED ).GetPrincipleAxisBoundingSphere();
+	float64_t optimizedMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "Bounding sphere of %d points: fast %.2f ms, optimized %.2f ms\n", count, fastMs, optimizedMs );
+
+	EXPECT_TRUE( IsFinite( fast.m_Radius ) && IsFinite( optimized.m_Radius ) );
+}
+
+// prints the time for the principal axes against a single threaded pass over the same moments, BoundingVolumeCovariance checks they agree
+TEST(Math, BoundingVolumeCovarianceBenchmark)
+{
+	std::vector< Vector3 > points = BoundsTestCloud( 300000 );
+	const int32_t count = static_cast< int32_t >( points.size() );
+
+	uint64_t start = Timer::GetTickCount();
+	BoundingVolumeGenerator generator ( &points.front(), count, BoundingVolumeGenerator::PRINCIPAL_AXIS );
+	BoundingVolumeGenerator::OBB obb = generator.GetPrincipleAxisOBB();
+	BoundingVolumeGenerator::AABB aabb = generator.GetAABB();
+	float64_t parallelMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	start = Timer::GetTickCount();
+	Vector3 mean;
+	for ( int32_t i=0; i<count; ++i )
+	{
+		mean += points[i];
+	}
+	mean /= static_cast< float32_t >( count );
+
+	float32_t covariance[3][3] = { { 0.f } };
+	Vector3 minimum = points[0], maximum = points[0];
+	for ( int32_t i=0; i<count; ++i )
+	{
+		Vector3 d = points[i] - mean;
+		for ( uint32_t r=0; r<3; ++r )
+		{
+			for ( uint32_t c=0; c<3; ++c )
+			{
+				covariance[r][c] += d[r] * d[c];
+			}
+
+			minimum[r] = std::min( minimum[r], points[i][r] );
+			maximum[r] = std::max( maximum[r], points[i][r] );
+		}
+	}
+	float64_t serialMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "Principal axes of %d points: %.2f ms (reference moments and extents %.2f ms)\n", count, parallelMs, serialMs );
+
+	EXPECT_TRUE( IsFinite( obb.m_Axis[0].Length() ) && IsFinite( aabb.m_Extents.Length() ) && IsFinite( covariance[0][0] ) );
+}
@@ -1,5 +1,6 @@
 #include "Precompile.h"
 #include "Math/Float16.h"
+#include "Math/Simd.h"
 #include "Foundation/Math.h"
 
 namespace Helium
@@ -42,8 +43,10 @@ namespace Helium
                 ( FLOAT32_EXPONENT_BIAS - FLOAT16_EXPONENT_BIAS + 1 ) -
                 exponent;
 
+            // Shifting by the full width of the type is undefined, so spell out that everything shifts off.
             result.components.exponent = 0;
-            result.components.mantissa = static_cast< uint16_t >( mantissa >> mantissaShift );
+            result.components.mantissa = static_cast< uint16_t >(
+                mantissaShift < 32 ? mantissa >> mantissaShift : 0 );
         }
         else if( exponent > FLOAT32_EXPONENT_BIAS + ( FLOAT16_EXPONENT_MAX - FLOAT16_EXPONENT_BIAS - 1 ) )
         {
@@ -107,4 +110,145 @@ namespace Helium
 
         return result;
     }
+
+#if HELIUM_MATH_SIMD && !HELIUM_MATH_F16C
+    /// Convert four Float32 values to Float16 values with the same truncation, clamping and infinity handling as
+    /// Float32To16(), leaving each result in the low half of its 32-bit lane.
+    static __m128i Float32To16Simd( __m128 value )
+    {
+        const __m128i bits = _mm_castps_si128( value );
+        const __m128i sign = _mm_and_si128( _mm_srli_epi32( bits, 16 ), _mm_set1_epi32( 0x8000 ) );
+        const __m128i magnitude = _mm_and_si128( bits, _mm_set1_epi32( 0x7fffffff ) );
+
+        // Normalized results drop the extra exponent bias and the low mantissa bits.
+        __m128i result = _mm_srli_epi32( _mm_sub_epi32( magnitude, _mm_set1_epi32( 0x38000000 ) ), 13 );
+
+        // Denormalized results are the value in units of the smallest half denormal, 2^-24, truncated.  Both the
+        // scale and the conversion are exact, so this matches shifting the mantissa.
+        const __m128i denormal = _mm_cvttps_epi32( _mm_mul_ps( _mm_castsi128_ps( magnitude ), _mm_set1_ps( 16777216.0f ) ) );
+        const __m128i small = _mm_cmplt_epi32( magnitude, _mm_set1_epi32( 0x38800000 ) );
+        result = _mm_or_si128( _mm_and_si128( small, denormal ), _mm_andnot_si128( small, result ) );
+
+        // Values too large to represent clamp to the largest half, and infinity and NaN become infinity.
+        const __m128i large = _mm_cmpgt_epi32( magnitude, _mm_set1_epi32( 0x477fffff ) );
+        result = _mm_or_si128( _mm_and_si128( large, _mm_set1_epi32( 0x7bff ) ), _mm_andnot_si128( large, result ) );
+        const __m128i infinite = _mm_cmpgt_epi32( magnitude, _mm_set1_epi32( 0x7f7fffff ) );
+        result = _mm_or_si128( _mm_and_si128( infinite, _mm_set1_epi32( 0x7c00 ) ), _mm_andnot_si128( infinite, result ) );
+
+        return _mm_or_si128( result, sign );
+    }
+
+    /// Convert four Float16 values, one in the low half of each 32-bit lane, to Float32 values the same way as
+    /// Float16To32().
+    static __m128 Float16To32Simd( __m128i value )
+    {
+        const __m128i sign = _mm_slli_epi32( _mm_and_si128( value, _mm_set1_epi32( 0x8000 ) ), 16 );
+        const __m128i magnitude = _mm_and_si128( value, _mm_set1_epi32( 0x7fff ) );
+
+        // Normalized values move the exponent and mantissa up and add the extra exponent bias.
+        __m128i result = _mm_add_epi32( _mm_slli_epi32( magnitude, 13 ), _mm_set1_epi32( 0x38000000 ) );
+
+        // Denormalized values (and zero) are the mantissa in units of 2^-24, which converts exactly.
+        const __m128i denormal = _mm_castps_si128( _mm_mul_ps( _mm_cvtepi32_ps( magnitude ), _mm_set1_ps( 5.9604644775390625e-8f ) ) );
+        const __m128i small = _mm_cmplt_epi32( magnitude, _mm_set1_epi32( 0x0400 ) );
+        result = _mm_or_si128( _mm_and_si128( small, denormal ), _mm_andnot_si128( small, result ) );
+
+        // Infinity and NaN both become infinity.
+        const __m128i infinite = _mm_cmpgt_epi32( magnitude, _mm_set1_epi32( 0x7bff ) );
+        result = _mm_or_si128( _mm_and_si128( infinite, _mm_set1_epi32( 0x7f800000 ) ), _mm_andnot_si128( infinite, result ) );
+
+        return _mm_castsi128_ps( _mm_or_si128( result, sign ) );
+    }
+#endif
+
+    /// Convert an array of single-precision values to half-precision.
+    ///
+    /// Each value is converted exactly as Float32To16() would convert it, several at a time when F16C or SSE2 is
+    /// available.
+    ///
+    /// @param[in]  source       Values to convert.
+    /// @param[out] destination  Half-precision results, may not overlap source.
+    /// @param[in]  count        Number of values.
+    ///
+    /// @see ConvertFloat16ToFloat32()
+    void ConvertFloat32ToFloat16( const float32_t* source, uint16_t* destination, size_t count )
+    {
+        size_t i = 0;
+
+#if HELIUM_MATH_F16C
+        // F16C truncates the same way and clamps on overflow when rounding toward zero, but it keeps NaN, so clear
+        // the mantissa of NaN inputs first to turn them into infinity.
+        const __m128i exponentMask = _mm_set1_epi32( 0x7f800000 );
+        const __m128i mantissaMask = _mm_set1_epi32( 0x007fffff );
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128i bits = _mm_loadu_si128( reinterpret_cast< const __m128i* >( source + i ) );
+            __m128i special = _mm_cmpeq_epi32( _mm_and_si128( bits, exponentMask ), exponentMask );
+            bits = _mm_andnot_si128( _mm_and_si128( special, mantissaMask ), bits );
+
+            __m128i result = _mm_cvtps_ph( _mm_castsi128_ps( bits ), _MM_FROUND_TO_ZERO );
+            _mm_storel_epi64( reinterpret_cast< __m128i* >( destination + i ), result );
+        }
+#elif HELIUM_MATH_SIMD
+        for( ; i + 8 <= count; i += 8 )
+        {
+            // Sign extend the low halves so the signed saturating pack keeps all 16 bits.
+            __m128i low = Float32To16Simd( _mm_loadu_ps( source + i ) );
+            __m128i high = Float32To16Simd( _mm_loadu_ps( source + i + 4 ) );
+            low = _mm_srai_epi32( _mm_slli_epi32( low, 16 ), 16 );
+            high = _mm_srai_epi32( _mm_slli_epi32( high, 16 ), 16 );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( destination + i ), _mm_packs_epi32( low, high ) );
+        }
+#endif
+
+        for( ; i < count; ++i )
+        {
+            Float32 value;
+            value.value = source[ i ];
+            destination[ i ] = Float32To16( value ).packed;
+        }
+    }
+
+    /// Convert an array of half-precision values to single-precision.
+    ///
+    /// Each value is converted exactly as Float16To32() would convert it, several at a time when F16C or SSE2 is
+    /// available.
+    ///
+    /// @param[in]  source       Values to convert.
+    /// @param[out] destination  Single-precision results, may not overlap source.
+    /// @param[in]  count        Number of values.
+    ///
+    /// @see ConvertFloat32ToFloat16()
+    void ConvertFloat16ToFloat32( const uint16_t* source, float32_t* destination, size_t count )
+    {
+        size_t i = 0;
+
+#if HELIUM_MATH_F16C
+        // F16C converts exactly but keeps NaN, so clear the mantissa of NaN results to turn them into infinity.
+        const __m128i exponentMask = _mm_set1_epi32( 0x7f800000 );
+        const __m128i mantissaMask = _mm_set1_epi32( 0x007fffff );
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128i result = _mm_castps_si128( _mm_cvtph_ps( _mm_loadl_epi64( reinterpret_cast< const __m128i* >( source + i ) ) ) );
+            __m128i special = _mm_cmpeq_epi32( _mm_and_si128( result, exponentMask ), exponentMask );
+            result = _mm_andnot_si128( _mm_and_si128( special, mantissaMask ), result );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( destination + i ), result );
+        }
+#elif HELIUM_MATH_SIMD
+        const __m128i zero = _mm_setzero_si128();
+        for( ; i + 8 <= count; i += 8 )
+        {
+            __m128i halves = _mm_loadu_si128( reinterpret_cast< const __m128i* >( source + i ) );
+            _mm_storeu_ps( destination + i, Float16To32Simd( _mm_unpacklo_epi16( halves, zero ) ) );
+            _mm_storeu_ps( destination + i + 4, Float16To32Simd( _mm_unpackhi_epi16( halves, zero ) ) );
+        }
+#endif
+
+        for( ; i < count; ++i )
+        {
+            Float16 value;
+            value.packed = source[ i ];
+            destination[ i ] = Float16To32( value ).value;
+        }
+    }
 }
@@ -75,6 +75,9 @@ namespace Helium
     HELIUM_MATH_API Float16 Float32To16( Float32 value );
     HELIUM_MATH_API Float32 Float16To32( Float16 value );
 
+    HELIUM_MATH_API void ConvertFloat32ToFloat16( const float32_t* source, uint16_t* destination, size_t count );
+    HELIUM_MATH_API void ConvertFloat16ToFloat32( const uint16_t* source, float32_t* destination, size_t count );
+
     inline uint16_t FloatToHalf( float32_t f )
     {
         Float32 temp;
@@ -0,0 +1,60 @@
+#include "Math/Float16.h"
+#include "Math/Simd.h"
+#include "Math/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+// prints the time to convert a million floats to half and back in bulk and one at a time, the Float16 tests check they agree
+TEST(Math, Float16Benchmark)
+{
+	const size_t count = 1 << 20;
+	Random random ( 1357 );
+	std::vector< float32_t > floats ( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		floats[ i ] = random.Next() * 1000.f;
+	}
+
+	std::vector< uint16_t > halves ( count );
+	uint64_t start = Timer::GetTickCount();
+	ConvertFloat32ToFloat16( &floats.front(), &halves.front(), count );
+	float64_t bulkTo16Ms = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	std::vector< float32_t > roundTrip ( count );
+	start = Timer::GetTickCount();
+	ConvertFloat16ToFloat32( &halves.front(), &roundTrip.front(), count );
+	float64_t bulkTo32Ms = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	std::vector< uint16_t > scalarHalves ( count );
+	start = Timer::GetTickCount();
+	for ( size_t i=0; i<count; ++i )
+	{
+		Float32 value;
+		value.value = floats[ i ];
+		scalarHalves[ i ] = Float32To16( value ).packed;
+	}
+	float64_t scalarTo16Ms = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	std::vector< float32_t > scalarRoundTrip ( count );
+	start = Timer::GetTickCount();
+	for ( size_t i=0; i<count; ++i )
+	{
+		Float16 half;
+		half.packed = scalarHalves[ i ];
+		scalarRoundTrip[ i ] = Float16To32( half ).value;
+	}
+	float64_t scalarTo32Ms = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "Float16 conversion of %u values (SIMD %d, F16C %d): to half bulk %.2f ms, one at a time %.2f ms; to float bulk %.2f ms, one at a time %.2f ms\n",
+		static_cast< uint32_t >( count ), HELIUM_MATH_SIMD, HELIUM_MATH_F16C, bulkTo16Ms, scalarTo16Ms, bulkTo32Ms, scalarTo32Ms );
+
+	EXPECT_TRUE( halves == scalarHalves );
+	EXPECT_TRUE( roundTrip == scalarRoundTrip );
+}
@@ -0,0 +1,97 @@
+#include "Math/Float16.h"
+#include "Math/Simd.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+using namespace Helium;
+
+namespace
+{
+	uint32_t Bits( float32_t value )
+	{
+		uint32_t bits;
+		memcpy( &bits, &value, sizeof( bits ) );
+		return bits;
+	}
+
+	float32_t FromBits( uint32_t bits )
+	{
+		float32_t value;
+		memcpy( &value, &bits, sizeof( value ) );
+		return value;
+	}
+}
+
+TEST(Math, Float16ToFloat32Exhaustive)
+{
+	std::vector< uint16_t > halves ( 65536 );
+	for ( uint32_t i=0; i<65536; ++i )
+	{
+		halves[ i ] = static_cast< uint16_t >( i );
+	}
+
+	std::vector< float32_t > floats ( halves.size() );
+	ConvertFloat16ToFloat32( &halves.front(), &floats.front(), halves.size() );
+
+	std::vector< uint16_t > roundTrip ( halves.size() );
+	ConvertFloat32ToFloat16( &floats.front(), &roundTrip.front(), floats.size() );
+
+	for ( uint32_t i=0; i<65536; ++i )
+	{
+		Float16 half;
+		half.packed = halves[ i ];
+		Float32 expected = Float16To32( half );
+		ASSERT_EQ( expected.packed, Bits( floats[ i ] ) ) << "half 0x" << std::hex << i;
+
+		// every half survives the trip through single precision, except NaN which both paths turn into infinity
+		const bool nan = half.components.exponent == 0x1f && half.components.mantissa != 0;
+		ASSERT_EQ( nan ? ( halves[ i ] & 0xfc00 ) : halves[ i ], roundTrip[ i ] ) << "half 0x" << std::hex << i;
+		ASSERT_EQ( Float32To16( expected ).packed, roundTrip[ i ] ) << "half 0x" << std::hex << i;
+	}
+}
+
+TEST(Math, Float32ToFloat16MatchesScalar)
+{
+	// a stride through every float bit pattern, plus every value near the half range where truncation, denormals
+	//  and clamping all happen
+	std::vector< float32_t > floats;
+	for ( uint64_t bits=0; bits<=0xffffffffull; bits += 4099 )
+	{
+		floats.push_back( FromBits( static_cast< uint32_t >( bits ) ) );
+	}
+
+	for ( uint32_t exponent = 96; exponent <= 145; ++exponent )
+	{
+		for ( uint32_t mantissa = 0; mantissa < ( 1 << 23 ); mantissa += 61 )
+		{
+			floats.push_back( FromBits( ( exponent << 23 ) | mantissa ) );
+			floats.push_back( FromBits( 0x80000000 | ( exponent << 23 ) | mantissa ) );
+		}
+	}
+
+	const float32_t specials[] = { 0.f, -0.f, 65504.f, 65519.f, 65520.f, 65536.f, -65536.f, 1e10f, -1e10f,
+		FromBits( 0x7f800000 ), FromBits( 0xff800000 ), FromBits( 0x7fc00000 ), FromBits( 0xffc00001 ), FromBits( 0x00000001 ) };
+	floats.insert( floats.end(), specials, specials + HELIUM_ARRAY_COUNT( specials ) );
+
+	std::vector< uint16_t > halves ( floats.size() );
+
+	ConvertFloat32ToFloat16( &floats.front(), &halves.front(), floats.size() );
+
+	uint32_t mismatches = 0;
+	for ( size_t i=0; i<floats.size(); ++i )
+	{
+		Float32 value;
+		value.value = floats[ i ];
+		if ( Float32To16( value ).packed != halves[ i ] )
+		{
+			ADD_FAILURE() << "float 0x" << std::hex << Bits( floats[ i ] ) << " gave 0x" << halves[ i ] << " expected 0x" << Float32To16( value ).packed;
+			if ( ++mismatches > 10 )
+			{
+				break;
+			}
+		}
+	}
+}
@@ -2,6 +2,7 @@
 #include "Math/Frustum.h"
 #include "Math/Polygon.h"
 #include "Math/Line.h"
+#include "Math/PointSpan.h"
 
 using namespace Helium;
 
@@ -45,6 +46,113 @@ inline static ClipCode GetClipCode(const Frustum& f, const Vector3& p)
 	return static_cast<ClipCode>(c);
 }
 
+// the corner shared by three planes, false if they don't meet at a single point
+inline static bool IntersectPlanes(const Plane& p1, const Plane& p2, const Plane& p3, Vector3& result)
+{
+	Vector3 n1, n2, n3;
+	p1.GetNormal(n1);
+	p2.GetNormal(n2);
+	p3.GetNormal(n3);
+
+	Vector3 n23 = n2.Cross(n3);
+	float32_t denominator = n1.Dot(n23);
+	if (fabs(denominator) < HELIUM_VALUE_NEAR_ZERO)
+	{
+		return false;
+	}
+
+	result = ((n23 * -p1.D()) + (n3.Cross(n1) * -p2.D()) + (n1.Cross(n2) * -p3.D())) / denominator;
+	return true;
+}
+
+// separating axis test between a box and the frustum, after the frustum planes have failed to separate them
+inline static bool Separated(const Frustum& f, const AlignedBox& box)
+{
+	const Plane* sides[4] = { &f.top, &f.left, &f.bottom, &f.right };
+	const Plane* caps[2] = { &f.front, &f.back };
+
+	Vector3 corners[8];
+	for (int32_t i=0; i<2; i++)
+	{
+		for (int32_t j=0; j<4; j++)
+		{
+			if (!IntersectPlanes(*caps[i], *sides[j], *sides[(j+1)%4], corners[i*4+j]))
+			{
+				// degenerate frustum, keep the conservative plane test result
+				return false;
+			}
+		}
+	}
+
+	// box face normals
+	for (uint32_t axis=0; axis<3; axis++)
+	{
+		float32_t low = corners[0][axis], high = corners[0][axis];
+		for (int32_t i=1; i<8; i++)
+		{
+			low = corners[i][axis] < low ? corners[i][axis] : low;
+			high = corners[i][axis] > high ? corners[i][axis] : high;
+		}
+
+		if (high < box.minimum[axis] || low > box.maximum[axis])
+		{
+			return true;
+		}
+	}
+
+	// the frustum edges run along the intersection of each adjacent pair of planes
+	Vector3 edges[12];
+	for (int32_t j=0; j<4; j++)
+	{
+		Vector3 n1, n2, n3;
+		sides[j]->GetNormal(n1);
+		sides[(j+1)%4]->GetNormal(n2);
+		edges[j] = n1.Cross(n2);
+
+		f.front.GetNormal(n3);
+		edges[4+j] = n3.Cross(n1);
+
+		f.back.GetNormal(n3);
+		edges[8+j] = n3.Cross(n1);
+	}
+
+	Vector3 center = box.Center();
+	Vector3 extent = box.maximum - center;
+
+	for (int32_t i=0; i<12; i++)
+	{
+		for (uint32_t axis=0; axis<3; axis++)
+		{
+			// box axis cross edge, with the box axis being a unit basis vector
+			Vector3 a;
+			a[(axis+1)%3] = -edges[i][(axis+2)%3];
+			a[(axis+2)%3] = edges[i][(axis+1)%3];
+			if (a.LengthSquared() < HELIUM_VALUE_NEAR_ZERO)
+			{
+				continue;
+			}
+
+			float32_t c = center.Dot(a);
+			float32_t r = (extent.x * fabs(a.x)) + (extent.y * fabs(a.y)) + (extent.z * fabs(a.z));
+
+			float32_t low = corners[0].Dot(a), high = low;
+			for (int32_t k=1; k<8; k++)
+			{
+				float32_t d = corners[k].Dot(a);
+				low = d < low ? d : low;
+				high = d > high ? d : high;
+			}
+
+			if (high < c - r || low > c + r)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 Frustum::Frustum(const Matrix4& m)
 {
 	if (m == Matrix4::Zero)
@@ -368,24 +476,7 @@ bool Frustum::IntersectsBox(const AlignedBox& box, bool precise) const
 
 		if ( precise )
 		{
-			// TODO: This precise test should be using separated axis testing instead of triangle decimation
-			V_Vector3 vertices;
-			vertices.reserve(8);
-			box.GetVertices(vertices);
-
-			V_Vector3 triangleList;
-			triangleList.reserve(36);
-			AlignedBox::GetTriangulated(vertices, triangleList);
-
-			for ( int i=0; i<36; i+=3 )
-			{
-				if ( IntersectsTriangle( triangleList[i], triangleList[i+1], triangleList[i+2] ) )
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return !Separated( *this, box );
 		}
 	}
 
@@ -416,3 +507,153 @@ bool Frustum::Contains(const AlignedBox& box) const
 
 	return true;
 }
+
+bool Frustum::IntersectsSphere(const Vector3& center, const float32_t radius) const
+{
+	for (int32_t i=0; i<6; i++)
+	{
+		const Plane& p = (*this)[i];
+
+		// planes aren't necessarily unit length, so scale the radius instead of the distance
+		Vector3 normal;
+		p.GetNormal(normal);
+
+		if (p.DistanceAbove(center) < -radius * normal.Length())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Frustum::IntersectsBoxes(const AlignedBox* boxes, size_t count, uint32_t* visible) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	for (size_t i=0; i<(count+31)/32; i++)
+	{
+		visible[i] = 0;
+	}
+
+	size_t i = 0;
+
+#if HELIUM_MATH_SIMD
+	HELIUM_COMPILE_ASSERT( sizeof( AlignedBox ) % sizeof( float32_t ) == 0 );
+	const size_t stride = sizeof( AlignedBox ) / sizeof( float32_t );
+
+	__m128 a[6], b[6], c[6], d[6], absA[6], absB[6], absC[6];
+	const __m128 mask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+	for (int32_t j=0; j<6; j++)
+	{
+		const Plane& p = (*this)[j];
+		a[j] = _mm_set1_ps( p.A() );
+		b[j] = _mm_set1_ps( p.B() );
+		c[j] = _mm_set1_ps( p.C() );
+		d[j] = _mm_set1_ps( p.D() );
+		absA[j] = _mm_and_ps( a[j], mask );
+		absB[j] = _mm_and_ps( b[j], mask );
+		absC[j] = _mm_and_ps( c[j], mask );
+	}
+
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 tinyLength = _mm_set1_ps( HELIUM_LINEAR_INTERSECTION_ERROR );
+	const __m128 pointError = _mm_set1_ps( -HELIUM_POINT_ON_PLANE_ERROR );
+
+	// four boxes per iteration, one box per lane, against each plane in turn
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 minX, minY, minZ, maxX, maxY, maxZ;
+		const AlignedBox* box = boxes + i;
+		SimdKernels::LoadPoints( ConstPointSpan( &box->minimum.x, &box->minimum.y, &box->minimum.z, 4, stride ), 0, minX, minY, minZ );
+		SimdKernels::LoadPoints( ConstPointSpan( &box->maximum.x, &box->maximum.y, &box->maximum.z, 4, stride ), 0, maxX, maxY, maxZ );
+
+		__m128 cx = _mm_mul_ps( _mm_add_ps( minX, maxX ), half );
+		__m128 cy = _mm_mul_ps( _mm_add_ps( minY, maxY ), half );
+		__m128 cz = _mm_mul_ps( _mm_add_ps( minZ, maxZ ), half );
+		__m128 dx = _mm_sub_ps( maxX, cx );
+		__m128 dy = _mm_sub_ps( maxY, cy );
+		__m128 dz = _mm_sub_ps( maxZ, cz );
+
+		// boxes smaller than the intersection error are tested as points, like IntersectsBox
+		__m128 sx = _mm_sub_ps( maxX, minX ), sy = _mm_sub_ps( maxY, minY ), sz = _mm_sub_ps( maxZ, minZ );
+		__m128 length = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( sx, sx ), _mm_mul_ps( sy, sy ) ), _mm_mul_ps( sz, sz ) ) );
+		__m128 tiny = _mm_cmplt_ps( length, tinyLength );
+		__m128 threshold = _mm_and_ps( tiny, pointError );
+		__m128 extentMask = _mm_andnot_ps( tiny, _mm_castsi128_ps( _mm_set1_epi32( -1 ) ) );
+
+		__m128 inside = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+		for (int32_t j=0; j<6; j++)
+		{
+			__m128 m = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, a[j] ), _mm_mul_ps( cy, b[j] ) ), _mm_mul_ps( cz, c[j] ) ), d[j] );
+			__m128 n = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, absA[j] ), _mm_mul_ps( dy, absB[j] ) ), _mm_mul_ps( dz, absC[j] ) );
+			inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( m, _mm_and_ps( n, extentMask ) ), threshold ) );
+		}
+
+		visible[ i / 32 ] |= static_cast< uint32_t >( _mm_movemask_ps( inside ) ) << ( i % 32 );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		if ( IntersectsBox( boxes[i] ) )
+		{
+			visible[ i / 32 ] |= 1u << ( i % 32 );
+		}
+	}
+}
+
+void Frustum::IntersectsSpheres(const ConstPointSpan& centers, const float32_t* radii, uint32_t* visible) const
+{
+	HELIUM_MATH_FUNCTION_TIMER();
+
+	const size_t count = centers.count;
+	for (size_t i=0; i<(count+31)/32; i++)
+	{
+		visible[i] = 0;
+	}
+
+	size_t i = 0;
+
+#if HELIUM_MATH_SIMD
+	__m128 a[6], b[6], c[6], d[6], length[6];
+	for (int32_t j=0; j<6; j++)
+	{
+		const Plane& p = (*this)[j];
+		Vector3 normal;
+		p.GetNormal(normal);
+
+		a[j] = _mm_set1_ps( p.A() );
+		b[j] = _mm_set1_ps( p.B() );
+		c[j] = _mm_set1_ps( p.C() );
+		d[j] = _mm_set1_ps( p.D() );
+		length[j] = _mm_set1_ps( normal.Length() );
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 x, y, z;
+		SimdKernels::LoadPoints( centers, i, x, y, z );
+		__m128 negativeRadius = _mm_sub_ps( zero, _mm_loadu_ps( radii + i ) );
+
+		__m128 inside = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+		for (int32_t j=0; j<6; j++)
+		{
+			__m128 distance = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, a[j] ), _mm_mul_ps( y, b[j] ) ), _mm_mul_ps( z, c[j] ) ), d[j] );
+			inside = _mm_and_ps( inside, _mm_cmpge_ps( distance, _mm_mul_ps( negativeRadius, length[j] ) ) );
+		}
+
+		visible[ i / 32 ] |= static_cast< uint32_t >( _mm_movemask_ps( inside ) ) << ( i % 32 );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		const size_t o = i * centers.stride;
+		if ( IntersectsSphere( Vector3( centers.x[ o ], centers.y[ o ], centers.z[ o ] ), radii[i] ) )
+		{
+			visible[ i / 32 ] |= 1u << ( i % 32 );
+		}
+	}
+}
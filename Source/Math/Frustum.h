@@ -6,6 +6,8 @@
 
 namespace Helium
 {
+    struct ConstPointSpan;
+
     class HELIUM_MATH_API Frustum
     {
     public:
@@ -74,6 +76,12 @@ namespace Helium
         bool IntersectsSegment(const Vector3& point1, const Vector3& point2) const;
         bool IntersectsTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2) const;
         bool IntersectsBox(const AlignedBox& box, bool precise = false) const;
+        bool IntersectsSphere(const Vector3& center, const float32_t radius) const;
         bool Contains(const AlignedBox& box) const;
+
+        // bulk culling, bit (i % 32) of visible[i / 32] is set if element i intersects the frustum,
+        //  and visible must hold (count + 31) / 32 words
+        void IntersectsBoxes(const AlignedBox* boxes, size_t count, uint32_t* visible) const;
+        void IntersectsSpheres(const ConstPointSpan& centers, const float32_t* radii, uint32_t* visible) const;
     };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Math/Matrix3.h"
 #include "Math/AngleAxis.h"
 #include "Math/EulerAngles.h"
+#include "Math/PointSpan.h"
 #include "Reflect/TranslatorDeduction.h"
 
 HELIUM_DEFINE_BASE_STRUCT( Helium::Matrix4 );
@@ -209,4 +210,43 @@ Matrix4 Matrix4::RotateZ(float32_t theta)
 	m[1][0] = sin(theta);
 	m[0][1] = -m[1][0];
 	return m;
-}
\ No newline at end of file
+}
+
+void Matrix4::TransformVertices(const ConstPointSpan& vertices, const PointSpan& result) const
+{
+	HELIUM_ASSERT( vertices.count == result.count );
+
+	const Matrix4& m = *this;
+	const size_t count = vertices.count;
+	size_t i = 0;
+
+#if HELIUM_MATH_SIMD
+	const __m128 m00 = _mm_set1_ps( m[0][0] ), m01 = _mm_set1_ps( m[0][1] ), m02 = _mm_set1_ps( m[0][2] );
+	const __m128 m10 = _mm_set1_ps( m[1][0] ), m11 = _mm_set1_ps( m[1][1] ), m12 = _mm_set1_ps( m[1][2] );
+	const __m128 m20 = _mm_set1_ps( m[2][0] ), m21 = _mm_set1_ps( m[2][1] ), m22 = _mm_set1_ps( m[2][2] );
+	const __m128 m30 = _mm_set1_ps( m[3][0] ), m31 = _mm_set1_ps( m[3][1] ), m32 = _mm_set1_ps( m[3][2] );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 x, y, z;
+		SimdKernels::LoadPoints( vertices, i, x, y, z );
+
+		__m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m00 ), _mm_mul_ps( y, m10 ) ), _mm_add_ps( _mm_mul_ps( z, m20 ), m30 ) );
+		__m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m01 ), _mm_mul_ps( y, m11 ) ), _mm_add_ps( _mm_mul_ps( z, m21 ), m31 ) );
+		__m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m02 ), _mm_mul_ps( y, m12 ) ), _mm_add_ps( _mm_mul_ps( z, m22 ), m32 ) );
+
+		SimdKernels::StorePoints( result, i, rx, ry, rz );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		const size_t in = i * vertices.stride;
+		const size_t out = i * result.stride;
+		const float32_t x = vertices.x[ in ], y = vertices.y[ in ], z = vertices.z[ in ];
+
+		result.x[ out ] = (m[0][0]*x) + (m[1][0]*y) + (m[2][0]*z) + (m[3][0]);
+		result.y[ out ] = (m[0][1]*x) + (m[1][1]*y) + (m[2][1]*z) + (m[3][1]);
+		result.z[ out ] = (m[0][2]*x) + (m[1][2]*y) + (m[2][2]*z) + (m[3][2]);
+	}
+}
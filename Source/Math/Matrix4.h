@@ -20,6 +20,8 @@
 namespace Helium
 {
 	struct Matrix3;
+	struct ConstPointSpan;
+	struct PointSpan;
 	class EulerAngles;
 	class AngleAxis;
 
@@ -193,6 +195,9 @@ namespace Helium
 		void                  TransformVertex (Vector3& v) const;
 		void                  TransformNormal (Vector3& n) const;
 
+		// TransformVertex over a span of points, result may be the same span as vertices
+		void                  TransformVertices (const ConstPointSpan& vertices, const PointSpan& result) const;
+
 		void                  Decompose (Scale& scale, Matrix3& rotate, Vector3& translate) const;
 		void                  Decompose (Scale& scale, Shear& shear, Matrix3& rotate, Vector3& translate) const;
 
@@ -239,40 +244,22 @@ namespace Helium
 
 	inline Matrix4& Matrix4::operator*=(const Matrix4& b)
 	{
-		Matrix4 a (*this);
-		Matrix4 &result = *this;
-		result = Matrix4::Zero;
-
-		for (unsigned row=0; row<4; row++)
-			for (unsigned col=0; col<4; col++)
-				for (unsigned mid=0; mid<4; mid++)
-					result[row][col] += a[row][mid]*b[mid][col];
-
-		return result;
+		MathKernels::MultiplyMatrix4( &x.x, &b.x.x, &x.x );
+		return *this;
 	}
 
 	inline Matrix4 Matrix4::operator*(const Matrix4& b) const
 	{
-		Matrix4 a (*this);
-		Matrix4 result = Matrix4::Zero;
-
-		for (unsigned row=0; row<4; row++)
-			for (unsigned col=0; col<4; col++)
-				for (unsigned mid=0; mid<4; mid++)
-					result[row][col] += a[row][mid]*b[mid][col];
-
+		Matrix4 result;
+		MathKernels::MultiplyMatrix4( &x.x, &b.x.x, &result.x.x );
 		return result;
 	}
 
 	inline Vector4 Matrix4::operator*(const Vector4& v) const
 	{
-		const Matrix4& m (*this);
-
-		return Vector4(
-			(m[0][0]*v[0]) + (m[1][0]*v[1]) + (m[2][0]*v[2]) + (m[3][0]*v[3]),
-			(m[0][1]*v[0]) + (m[1][1]*v[1]) + (m[2][1]*v[2]) + (m[3][1]*v[3]),
-			(m[0][2]*v[0]) + (m[1][2]*v[1]) + (m[2][2]*v[2]) + (m[3][2]*v[3]),
-			(m[0][3]*v[0]) + (m[1][3]*v[1]) + (m[2][3]*v[2]) + (m[3][3]*v[3]));
+		Vector4 result;
+		MathKernels::TransformVector4( &x.x, &v.x, &result.x );
+		return result;
 	}
 
 	inline float32_t Matrix4::Determinant() const
@@ -288,57 +275,8 @@ namespace Helium
 
 	inline Matrix4& Matrix4::Invert()
 	{
-		typedef float array1d[16];
-		array1d& a = reinterpret_cast<array1d&>( x );
-		Matrix4 result;
-
-		float32_t a0 = a[ 0]*a[ 5] - a[ 1]*a[ 4];
-		float32_t a1 = a[ 0]*a[ 6] - a[ 2]*a[ 4];
-		float32_t a2 = a[ 0]*a[ 7] - a[ 3]*a[ 4];
-		float32_t a3 = a[ 1]*a[ 6] - a[ 2]*a[ 5];
-		float32_t a4 = a[ 1]*a[ 7] - a[ 3]*a[ 5];
-		float32_t a5 = a[ 2]*a[ 7] - a[ 3]*a[ 6];
-		float32_t b0 = a[ 8]*a[13] - a[ 9]*a[12];
-		float32_t b1 = a[ 8]*a[14] - a[10]*a[12];
-		float32_t b2 = a[ 8]*a[15] - a[11]*a[12];
-		float32_t b3 = a[ 9]*a[14] - a[10]*a[13];
-		float32_t b4 = a[ 9]*a[15] - a[11]*a[13];
-		float32_t b5 = a[10]*a[15] - a[11]*a[14];
-
-		float32_t d = a0*b5-a1*b4+a2*b3+a3*b2-a4*b1+a5*b0;
-		if (fabs(d) <= 0.f)
-		{
-			return *this = Zero;
-		}
-
-		result[0][0] = + a[ 5]*b5 - a[ 6]*b4 + a[ 7]*b3;
-		result[1][0] = - a[ 4]*b5 + a[ 6]*b2 - a[ 7]*b1;
-		result[2][0] = + a[ 4]*b4 - a[ 5]*b2 + a[ 7]*b0;
-		result[3][0] = - a[ 4]*b3 + a[ 5]*b1 - a[ 6]*b0;
-		result[0][1] = - a[ 1]*b5 + a[ 2]*b4 - a[ 3]*b3;
-		result[1][1] = + a[ 0]*b5 - a[ 2]*b2 + a[ 3]*b1;
-		result[2][1] = - a[ 0]*b4 + a[ 1]*b2 - a[ 3]*b0;
-		result[3][1] = + a[ 0]*b3 - a[ 1]*b1 + a[ 2]*b0;
-		result[0][2] = + a[13]*a5 - a[14]*a4 + a[15]*a3;
-		result[1][2] = - a[12]*a5 + a[14]*a2 - a[15]*a1;
-		result[2][2] = + a[12]*a4 - a[13]*a2 + a[15]*a0;
-		result[3][2] = - a[12]*a3 + a[13]*a1 - a[14]*a0;
-		result[0][3] = - a[ 9]*a5 + a[10]*a4 - a[11]*a3;
-		result[1][3] = + a[ 8]*a5 - a[10]*a2 + a[11]*a1;
-		result[2][3] = - a[ 8]*a4 + a[ 9]*a2 - a[11]*a0;
-		result[3][3] = + a[ 8]*a3 - a[ 9]*a1 + a[10]*a0;
-
-		float32_t d_inverse = ((float32_t)1.0)/d;
-
-		for (int32_t row = 0; row < 4; row++)
-		{
-			for (int32_t col = 0; col < 4; col++)
-			{
-				result[row][col] *= d_inverse;
-			}
-		}
-
-		return *this = result;
+		MathKernels::InvertMatrix4( &x.x, &x.x );
+		return *this;
 	}
 
 	inline Matrix4 Matrix4::Inverted() const
@@ -349,43 +287,7 @@ namespace Helium
 
 	inline Matrix4& Matrix4::AffineInvert()
 	{
-		Matrix4 m = *this;
-		Matrix4 &result = *this;
-
-		float32_t det1 = ((m[1][1] * m[2][2]) - (m[1][2] * m[2][1]));
-		float32_t det2 = ((m[0][2] * m[2][1]) - (m[0][1] * m[2][2]));
-		float32_t det3 = ((m[0][1] * m[1][2]) - (m[0][2] * m[1][1]));
-		float32_t det = (m[0][0] * det1) + (m[1][0] * det2) + (m[2][0] * det3);
-
-		if (det != 0)
-		{
-			if (fabs(1.0/det) < HELIUM_ANGLE_NEAR_ZERO)
-			{
-				return *this = Matrix4 ();
-			}
-			else
-			{
-				result[0][0] = det1 / det;
-				result[1][0] = ((m[2][0] * m[1][2]) - (m[1][0] * m[2][2])) / det;
-				result[2][0] = ((m[1][0] * m[2][1]) - (m[2][0] * m[1][1])) / det;
-				result[0][1] = det2 / det;
-				result[1][1] = ((m[0][0] * m[2][2]) - (m[2][0] * m[0][2])) / det;
-				result[2][1] = ((m[2][0] * m[0][1]) - (m[0][0] * m[2][1])) / det;
-				result[0][2] = det3 / det;
-				result[1][2] = ((m[1][0] * m[0][2]) - (m[0][0] * m[1][2])) / det;
-				result[2][2] = ((m[0][0] * m[1][1]) - (m[1][0] * m[0][1])) / det;
-			}
-		}
-
-		result[3][0] = -((m[3][0] * result[0][0]) + (m[3][1] * result[1][0]) + (m[3][2] * result[2][0]));
-		result[3][1] = -((m[3][0] * result[0][1]) + (m[3][1] * result[1][1]) + (m[3][2] * result[2][1]));
-		result[3][2] = -((m[3][0] * result[0][2]) + (m[3][1] * result[1][2]) + (m[3][2] * result[2][2]));
-
-		result.x[3] = 0;
-		result.y[3] = 0;
-		result.z[3] = 0;
-		result.t[3] = 1;
-
+		MathKernels::AffineInvertMatrix4( &x.x, &x.x );
 		return *this;
 	}
 
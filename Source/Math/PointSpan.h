@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Math/API.h"
+#include "Math/Simd.h"
+#include "Math/Vector3.h"
+
+namespace Helium
+{
+	//
+	// A view of count points whose components are stride floats apart from one point to the next.  Three
+	//  separate arrays with a stride of 1 is structure of arrays, and a Vector3 array is a stride of 3.
+	//
+
+	struct ConstPointSpan
+	{
+		const float32_t* x;
+		const float32_t* y;
+		const float32_t* z;
+		size_t           stride;
+		size_t           count;
+
+		ConstPointSpan( const float32_t* px, const float32_t* py, const float32_t* pz, size_t n, size_t s = 1 )
+			: x( px ), y( py ), z( pz ), stride( s ), count( n )
+		{
+		}
+
+		ConstPointSpan( const Vector3* points, size_t n )
+			: x( &points->x ), y( &points->y ), z( &points->z ), stride( sizeof( Vector3 ) / sizeof( float32_t ) ), count( n )
+		{
+		}
+
+		bool IsArrays() const
+		{
+			return stride == 1;
+		}
+
+		bool IsPacked() const
+		{
+			return stride == 3 && y == x + 1 && z == x + 2;
+		}
+	};
+
+	struct PointSpan
+	{
+		float32_t* x;
+		float32_t* y;
+		float32_t* z;
+		size_t     stride;
+		size_t     count;
+
+		PointSpan( float32_t* px, float32_t* py, float32_t* pz, size_t n, size_t s = 1 )
+			: x( px ), y( py ), z( pz ), stride( s ), count( n )
+		{
+		}
+
+		PointSpan( Vector3* points, size_t n )
+			: x( &points->x ), y( &points->y ), z( &points->z ), stride( sizeof( Vector3 ) / sizeof( float32_t ) ), count( n )
+		{
+		}
+
+		operator ConstPointSpan() const
+		{
+			return ConstPointSpan( x, y, z, count, stride );
+		}
+
+		bool IsArrays() const
+		{
+			return stride == 1;
+		}
+
+		bool IsPacked() const
+		{
+			return stride == 3 && y == x + 1 && z == x + 2;
+		}
+	};
+
+#if HELIUM_MATH_SIMD
+	namespace SimdKernels
+	{
+		// loads points [i, i+4) into one register per component
+		inline void LoadPoints( const ConstPointSpan& span, size_t i, __m128& x, __m128& y, __m128& z )
+		{
+			if ( span.IsArrays() )
+			{
+				x = _mm_loadu_ps( span.x + i );
+				y = _mm_loadu_ps( span.y + i );
+				z = _mm_loadu_ps( span.z + i );
+			}
+			else if ( span.IsPacked() )
+			{
+				// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+				const float32_t* p = span.x + i * 3;
+				__m128 a = _mm_loadu_ps( p + 0 );
+				__m128 b = _mm_loadu_ps( p + 4 );
+				__m128 c = _mm_loadu_ps( p + 8 );
+
+				x = Shuffle< 0, 2, 0, 2 >( Shuffle< 0, 0, 3, 3 >( a, a ), Shuffle< 2, 2, 1, 1 >( b, c ) );
+				y = Shuffle< 0, 2, 0, 2 >( Shuffle< 1, 1, 0, 0 >( a, b ), Shuffle< 3, 3, 2, 2 >( b, c ) );
+				z = Shuffle< 0, 2, 0, 2 >( Shuffle< 2, 2, 1, 1 >( a, b ), Shuffle< 0, 0, 3, 3 >( c, c ) );
+			}
+			else
+			{
+				const size_t s = span.stride;
+				const size_t o = i * s;
+				x = _mm_setr_ps( span.x[ o ], span.x[ o + s ], span.x[ o + s * 2 ], span.x[ o + s * 3 ] );
+				y = _mm_setr_ps( span.y[ o ], span.y[ o + s ], span.y[ o + s * 2 ], span.y[ o + s * 3 ] );
+				z = _mm_setr_ps( span.z[ o ], span.z[ o + s ], span.z[ o + s * 2 ], span.z[ o + s * 3 ] );
+			}
+		}
+
+		// stores one register per component to points [i, i+4)
+		inline void StorePoints( const PointSpan& span, size_t i, __m128 x, __m128 y, __m128 z )
+		{
+			if ( span.IsArrays() )
+			{
+				_mm_storeu_ps( span.x + i, x );
+				_mm_storeu_ps( span.y + i, y );
+				_mm_storeu_ps( span.z + i, z );
+			}
+			else if ( span.IsPacked() )
+			{
+				float32_t* p = span.x + i * 3;
+				_mm_storeu_ps( p + 0, Shuffle< 0, 2, 0, 2 >( Shuffle< 0, 0, 0, 0 >( x, y ), Shuffle< 0, 0, 1, 1 >( z, x ) ) );
+				_mm_storeu_ps( p + 4, Shuffle< 0, 2, 0, 2 >( Shuffle< 1, 1, 1, 1 >( y, z ), Shuffle< 2, 2, 2, 2 >( x, y ) ) );
+				_mm_storeu_ps( p + 8, Shuffle< 0, 2, 0, 2 >( Shuffle< 2, 2, 3, 3 >( z, x ), Shuffle< 3, 3, 3, 3 >( y, z ) ) );
+			}
+			else
+			{
+				float32_t lanes[3][4];
+				_mm_storeu_ps( lanes[0], x );
+				_mm_storeu_ps( lanes[1], y );
+				_mm_storeu_ps( lanes[2], z );
+
+				const size_t s = span.stride;
+				for ( size_t j=0; j<4; ++j )
+				{
+					const size_t o = ( i + j ) * s;
+					span.x[ o ] = lanes[0][j];
+					span.y[ o ] = lanes[1][j];
+					span.z[ o ] = lanes[2][j];
+				}
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,475 @@
+#pragma once
+
+#include "Platform/System.h"
+#include "Platform/Types.h"
+
+#include "Foundation/Math.h"
+
+//
+// Vector and matrix kernels shared by Vector4 and Matrix4.  Matrices are 16 floats, row major, and
+//  vectors are transformed as rows (v * M).  ScalarKernels are always built, so they can be checked
+//  and timed against SimdKernels; MathKernels aliases whichever one the operators use.
+//
+// Define HELIUM_MATH_SIMD to 0 to force the scalar path on x86.  AVX and F16C paths are used when the
+//  compiler targets them (-mavx, -mf16c, /arch:AVX).
+//
+
+#ifndef HELIUM_MATH_SIMD
+# if HELIUM_CPU_X86 && ( defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) )
+#  define HELIUM_MATH_SIMD 1
+# else
+#  define HELIUM_MATH_SIMD 0
+# endif
+#endif
+
+#ifndef HELIUM_MATH_AVX
+# if HELIUM_MATH_SIMD && defined( __AVX__ )
+#  define HELIUM_MATH_AVX 1
+# else
+#  define HELIUM_MATH_AVX 0
+# endif
+#endif
+
+#ifndef HELIUM_MATH_F16C
+# if HELIUM_MATH_SIMD && defined( __F16C__ )
+#  define HELIUM_MATH_F16C 1
+# else
+#  define HELIUM_MATH_F16C 0
+# endif
+#endif
+
+#if HELIUM_MATH_SIMD
+# include <emmintrin.h>
+#endif
+
+#if HELIUM_MATH_AVX || HELIUM_MATH_F16C
+# include <immintrin.h>
+#endif
+
+namespace Helium
+{
+	namespace ScalarKernels
+	{
+		inline void MultiplyMatrix4( const float32_t* a, const float32_t* b, float32_t* result )
+		{
+			float32_t temp[16];
+
+			for (unsigned row=0; row<4; row++)
+			{
+				for (unsigned col=0; col<4; col++)
+				{
+					float32_t sum = 0.f;
+					for (unsigned mid=0; mid<4; mid++)
+					{
+						sum += a[row*4+mid]*b[mid*4+col];
+					}
+					temp[row*4+col] = sum;
+				}
+			}
+
+			for (unsigned i=0; i<16; i++)
+			{
+				result[i] = temp[i];
+			}
+		}
+
+		inline void TransformVector4( const float32_t* m, const float32_t* v, float32_t* result )
+		{
+			float32_t x = (m[ 0]*v[0]) + (m[ 4]*v[1]) + (m[ 8]*v[2]) + (m[12]*v[3]);
+			float32_t y = (m[ 1]*v[0]) + (m[ 5]*v[1]) + (m[ 9]*v[2]) + (m[13]*v[3]);
+			float32_t z = (m[ 2]*v[0]) + (m[ 6]*v[1]) + (m[10]*v[2]) + (m[14]*v[3]);
+			float32_t w = (m[ 3]*v[0]) + (m[ 7]*v[1]) + (m[11]*v[2]) + (m[15]*v[3]);
+
+			result[0] = x;
+			result[1] = y;
+			result[2] = z;
+			result[3] = w;
+		}
+
+		// returns false and zeroes the result if the matrix is singular
+		inline bool InvertMatrix4( const float32_t* a, float32_t* result )
+		{
+			float32_t a0 = a[ 0]*a[ 5] - a[ 1]*a[ 4];
+			float32_t a1 = a[ 0]*a[ 6] - a[ 2]*a[ 4];
+			float32_t a2 = a[ 0]*a[ 7] - a[ 3]*a[ 4];
+			float32_t a3 = a[ 1]*a[ 6] - a[ 2]*a[ 5];
+			float32_t a4 = a[ 1]*a[ 7] - a[ 3]*a[ 5];
+			float32_t a5 = a[ 2]*a[ 7] - a[ 3]*a[ 6];
+			float32_t b0 = a[ 8]*a[13] - a[ 9]*a[12];
+			float32_t b1 = a[ 8]*a[14] - a[10]*a[12];
+			float32_t b2 = a[ 8]*a[15] - a[11]*a[12];
+			float32_t b3 = a[ 9]*a[14] - a[10]*a[13];
+			float32_t b4 = a[ 9]*a[15] - a[11]*a[13];
+			float32_t b5 = a[10]*a[15] - a[11]*a[14];
+
+			float32_t d = a0*b5-a1*b4+a2*b3+a3*b2-a4*b1+a5*b0;
+			if (fabs(d) <= 0.f)
+			{
+				for (unsigned i=0; i<16; i++)
+				{
+					result[i] = 0.f;
+				}
+				return false;
+			}
+
+			float32_t r[16];
+			r[ 0] = + a[ 5]*b5 - a[ 6]*b4 + a[ 7]*b3;
+			r[ 4] = - a[ 4]*b5 + a[ 6]*b2 - a[ 7]*b1;
+			r[ 8] = + a[ 4]*b4 - a[ 5]*b2 + a[ 7]*b0;
+			r[12] = - a[ 4]*b3 + a[ 5]*b1 - a[ 6]*b0;
+			r[ 1] = - a[ 1]*b5 + a[ 2]*b4 - a[ 3]*b3;
+			r[ 5] = + a[ 0]*b5 - a[ 2]*b2 + a[ 3]*b1;
+			r[ 9] = - a[ 0]*b4 + a[ 1]*b2 - a[ 3]*b0;
+			r[13] = + a[ 0]*b3 - a[ 1]*b1 + a[ 2]*b0;
+			r[ 2] = + a[13]*a5 - a[14]*a4 + a[15]*a3;
+			r[ 6] = - a[12]*a5 + a[14]*a2 - a[15]*a1;
+			r[10] = + a[12]*a4 - a[13]*a2 + a[15]*a0;
+			r[14] = - a[12]*a3 + a[13]*a1 - a[14]*a0;
+			r[ 3] = - a[ 9]*a5 + a[10]*a4 - a[11]*a3;
+			r[ 7] = + a[ 8]*a5 - a[10]*a2 + a[11]*a1;
+			r[11] = - a[ 8]*a4 + a[ 9]*a2 - a[11]*a0;
+			r[15] = + a[ 8]*a3 - a[ 9]*a1 + a[10]*a0;
+
+			float32_t d_inverse = ((float32_t)1.0)/d;
+
+			for (unsigned i=0; i<16; i++)
+			{
+				result[i] = r[i] * d_inverse;
+			}
+
+			return true;
+		}
+
+		// inverts the upper 3x3 and the translation of a matrix with a (0, 0, 0, 1) last column
+		inline void AffineInvertMatrix4( const float32_t* a, float32_t* result )
+		{
+			float32_t m[16];
+			for (unsigned i=0; i<16; i++)
+			{
+				m[i] = result[i] = a[i];
+			}
+
+			float32_t det1 = ((m[5] * m[10]) - (m[6] * m[9]));
+			float32_t det2 = ((m[2] * m[9]) - (m[1] * m[10]));
+			float32_t det3 = ((m[1] * m[6]) - (m[2] * m[5]));
+			float32_t det = (m[0] * det1) + (m[4] * det2) + (m[8] * det3);
+
+			if (det != 0)
+			{
+				if (fabs(1.0/det) < HELIUM_ANGLE_NEAR_ZERO)
+				{
+					for (unsigned i=0; i<16; i++)
+					{
+						result[i] = ( i % 5 ) ? 0.f : 1.f;
+					}
+					return;
+				}
+				else
+				{
+					result[0] = det1 / det;
+					result[4] = ((m[8] * m[6]) - (m[4] * m[10])) / det;
+					result[8] = ((m[4] * m[9]) - (m[8] * m[5])) / det;
+					result[1] = det2 / det;
+					result[5] = ((m[0] * m[10]) - (m[8] * m[2])) / det;
+					result[9] = ((m[8] * m[1]) - (m[0] * m[9])) / det;
+					result[2] = det3 / det;
+					result[6] = ((m[4] * m[2]) - (m[0] * m[6])) / det;
+					result[10] = ((m[0] * m[5]) - (m[4] * m[1])) / det;
+				}
+			}
+
+			result[12] = -((m[12] * result[0]) + (m[13] * result[4]) + (m[14] * result[8]));
+			result[13] = -((m[12] * result[1]) + (m[13] * result[5]) + (m[14] * result[9]));
+			result[14] = -((m[12] * result[2]) + (m[13] * result[6]) + (m[14] * result[10]));
+
+			result[3] = 0;
+			result[7] = 0;
+			result[11] = 0;
+			result[15] = 1;
+		}
+
+		inline float32_t DotVector4( const float32_t* a, const float32_t* b )
+		{
+			return (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+		}
+
+		inline void CrossVector4( const float32_t* a, const float32_t* b, float32_t* result )
+		{
+			float32_t x = a[1]*b[2] - a[2]*b[1];
+			float32_t y = a[2]*b[0] - a[0]*b[2];
+			float32_t z = a[0]*b[1] - a[1]*b[0];
+
+			result[0] = x;
+			result[1] = y;
+			result[2] = z;
+			result[3] = 0;
+		}
+
+		inline void NormalizeVector4( float32_t* v )
+		{
+			float32_t lenSqr = DotVector4( v, v );
+			float32_t len = lenSqr <= 0 ? 0 : sqrt(lenSqr);
+
+			if (len > HELIUM_DIVISOR_NEAR_ZERO)
+			{
+				v[0] /= len;
+				v[1] /= len;
+				v[2] /= len;
+				v[3] /= len;
+			}
+			else
+			{
+				v[0] = v[1] = v[2] = v[3] = 0;
+			}
+		}
+	}
+
+#if HELIUM_MATH_SIMD
+
+	namespace SimdKernels
+	{
+		// lanes x and y come from a, z and w from b, each named by source lane index
+		template< int x, int y, int z, int w >
+		inline __m128 Shuffle( __m128 a, __m128 b )
+		{
+			return _mm_shuffle_ps( a, b, _MM_SHUFFLE( w, z, y, x ) );
+		}
+
+		template< int x, int y, int z, int w >
+		inline __m128 Swizzle( __m128 v )
+		{
+			return _mm_shuffle_ps( v, v, _MM_SHUFFLE( w, z, y, x ) );
+		}
+
+		// Matrix4 and Vector4 only guarantee float alignment, so every load and store is unaligned
+
+		inline void MultiplyMatrix4( const float32_t* a, const float32_t* b, float32_t* result )
+		{
+# if HELIUM_MATH_AVX
+			// two rows of a per register, each 128 bit lane broadcasts its own row's elements
+			__m256 b0 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b +  0 ) );
+			__m256 b1 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b +  4 ) );
+			__m256 b2 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b +  8 ) );
+			__m256 b3 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b + 12 ) );
+
+			__m256 a01 = _mm256_loadu_ps( a + 0 );
+			__m256 a23 = _mm256_loadu_ps( a + 8 );
+
+			__m256 r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x00 ), b0 );
+			r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x55 ), b1 ) );
+			r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xaa ), b2 ) );
+			r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xff ), b3 ) );
+
+			__m256 r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x00 ), b0 );
+			r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x55 ), b1 ) );
+			r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xaa ), b2 ) );
+			r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xff ), b3 ) );
+
+			_mm256_storeu_ps( result + 0, r01 );
+			_mm256_storeu_ps( result + 8, r23 );
+# else
+			__m128 b0 = _mm_loadu_ps( b +  0 );
+			__m128 b1 = _mm_loadu_ps( b +  4 );
+			__m128 b2 = _mm_loadu_ps( b +  8 );
+			__m128 b3 = _mm_loadu_ps( b + 12 );
+
+			// each result row is a linear combination of the rows of b, so result may alias a or b
+			__m128 rows[4];
+			for (unsigned row=0; row<4; row++)
+			{
+				__m128 r = _mm_loadu_ps( a + row*4 );
+				__m128 sum = _mm_mul_ps( Swizzle< 0, 0, 0, 0 >( r ), b0 );
+				sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 1, 1, 1, 1 >( r ), b1 ) );
+				sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 2, 2, 2, 2 >( r ), b2 ) );
+				sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 3, 3, 3, 3 >( r ), b3 ) );
+				rows[row] = sum;
+			}
+
+			_mm_storeu_ps( result +  0, rows[0] );
+			_mm_storeu_ps( result +  4, rows[1] );
+			_mm_storeu_ps( result +  8, rows[2] );
+			_mm_storeu_ps( result + 12, rows[3] );
+# endif
+		}
+
+		inline void TransformVector4( const float32_t* m, const float32_t* v, float32_t* result )
+		{
+			__m128 r = _mm_loadu_ps( v );
+			__m128 sum = _mm_mul_ps( Swizzle< 0, 0, 0, 0 >( r ), _mm_loadu_ps( m + 0 ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 1, 1, 1, 1 >( r ), _mm_loadu_ps( m +  4 ) ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 2, 2, 2, 2 >( r ), _mm_loadu_ps( m +  8 ) ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( Swizzle< 3, 3, 3, 3 >( r ), _mm_loadu_ps( m + 12 ) ) );
+			_mm_storeu_ps( result, sum );
+		}
+
+		// 2x2 block helpers for InvertMatrix4, each register holds a row major 2x2 matrix
+		inline __m128 Multiply2x2( __m128 a, __m128 b )
+		{
+			return _mm_add_ps( _mm_mul_ps( a, Swizzle< 0, 3, 0, 3 >( b ) ),
+				_mm_mul_ps( Swizzle< 1, 0, 3, 2 >( a ), Swizzle< 2, 1, 2, 1 >( b ) ) );
+		}
+
+		// adjugate(a) * b
+		inline __m128 AdjointMultiply2x2( __m128 a, __m128 b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( Swizzle< 3, 3, 0, 0 >( a ), b ),
+				_mm_mul_ps( Swizzle< 1, 1, 2, 2 >( a ), Swizzle< 2, 3, 0, 1 >( b ) ) );
+		}
+
+		// a * adjugate(b)
+		inline __m128 MultiplyAdjoint2x2( __m128 a, __m128 b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( a, Swizzle< 3, 0, 3, 0 >( b ) ),
+				_mm_mul_ps( Swizzle< 1, 0, 3, 2 >( a ), Swizzle< 2, 1, 2, 1 >( b ) ) );
+		}
+
+		// block inverse over the four 2x2 sub matrices, returns false and zeroes the result if singular
+		inline bool InvertMatrix4( const float32_t* m, float32_t* result )
+		{
+			__m128 r0 = _mm_loadu_ps( m +  0 );
+			__m128 r1 = _mm_loadu_ps( m +  4 );
+			__m128 r2 = _mm_loadu_ps( m +  8 );
+			__m128 r3 = _mm_loadu_ps( m + 12 );
+
+			__m128 A = _mm_movelh_ps( r0, r1 );
+			__m128 B = _mm_movehl_ps( r1, r0 );
+			__m128 C = _mm_movelh_ps( r2, r3 );
+			__m128 D = _mm_movehl_ps( r3, r2 );
+
+			// determinants of the blocks as ( |A| |B| |C| |D| )
+			__m128 detSub = _mm_sub_ps(
+				_mm_mul_ps( Shuffle< 0, 2, 0, 2 >( r0, r2 ), Shuffle< 1, 3, 1, 3 >( r1, r3 ) ),
+				_mm_mul_ps( Shuffle< 1, 3, 1, 3 >( r0, r2 ), Shuffle< 0, 2, 0, 2 >( r1, r3 ) ) );
+			__m128 detA = Swizzle< 0, 0, 0, 0 >( detSub );
+			__m128 detB = Swizzle< 1, 1, 1, 1 >( detSub );
+			__m128 detC = Swizzle< 2, 2, 2, 2 >( detSub );
+			__m128 detD = Swizzle< 3, 3, 3, 3 >( detSub );
+
+			__m128 DC = AdjointMultiply2x2( D, C );
+			__m128 AB = AdjointMultiply2x2( A, B );
+			__m128 X = _mm_sub_ps( _mm_mul_ps( detD, A ), Multiply2x2( B, DC ) );
+			__m128 W = _mm_sub_ps( _mm_mul_ps( detA, D ), Multiply2x2( C, AB ) );
+			__m128 Y = _mm_sub_ps( _mm_mul_ps( detB, C ), MultiplyAdjoint2x2( D, AB ) );
+			__m128 Z = _mm_sub_ps( _mm_mul_ps( detC, B ), MultiplyAdjoint2x2( A, DC ) );
+
+			__m128 det = _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) );
+			__m128 trace = _mm_mul_ps( AB, Swizzle< 0, 2, 1, 3 >( DC ) );
+			trace = _mm_add_ps( trace, Swizzle< 2, 3, 0, 1 >( trace ) );
+			trace = _mm_add_ps( trace, Swizzle< 1, 0, 3, 2 >( trace ) );
+			det = _mm_sub_ps( det, trace );
+
+			if ( _mm_cvtss_f32( det ) == 0.f )
+			{
+				__m128 zero = _mm_setzero_ps();
+				_mm_storeu_ps( result +  0, zero );
+				_mm_storeu_ps( result +  4, zero );
+				_mm_storeu_ps( result +  8, zero );
+				_mm_storeu_ps( result + 12, zero );
+				return false;
+			}
+
+			__m128 inverseDet = _mm_div_ps( _mm_setr_ps( 1.f, -1.f, -1.f, 1.f ), det );
+			X = _mm_mul_ps( X, inverseDet );
+			Y = _mm_mul_ps( Y, inverseDet );
+			Z = _mm_mul_ps( Z, inverseDet );
+			W = _mm_mul_ps( W, inverseDet );
+
+			_mm_storeu_ps( result +  0, Shuffle< 3, 1, 3, 1 >( X, Y ) );
+			_mm_storeu_ps( result +  4, Shuffle< 2, 0, 2, 0 >( X, Y ) );
+			_mm_storeu_ps( result +  8, Shuffle< 3, 1, 3, 1 >( Z, W ) );
+			_mm_storeu_ps( result + 12, Shuffle< 2, 0, 2, 0 >( Z, W ) );
+			return true;
+		}
+
+		// cross product of the xyz lanes, w comes out zero
+		inline __m128 Cross( __m128 a, __m128 b )
+		{
+			__m128 c = _mm_sub_ps(
+				_mm_mul_ps( a, Swizzle< 1, 2, 0, 3 >( b ) ),
+				_mm_mul_ps( Swizzle< 1, 2, 0, 3 >( a ), b ) );
+			return Swizzle< 1, 2, 0, 3 >( c );
+		}
+
+		// the sum of all lanes, in every lane
+		inline __m128 HorizontalAdd( __m128 v )
+		{
+			v = _mm_add_ps( v, Swizzle< 2, 3, 0, 1 >( v ) );
+			return _mm_add_ps( v, Swizzle< 1, 0, 3, 2 >( v ) );
+		}
+
+		inline void AffineInvertMatrix4( const float32_t* m, float32_t* result )
+		{
+			const __m128 mask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+			__m128 r0 = _mm_and_ps( _mm_loadu_ps( m + 0 ), mask );
+			__m128 r1 = _mm_and_ps( _mm_loadu_ps( m + 4 ), mask );
+			__m128 r2 = _mm_and_ps( _mm_loadu_ps( m + 8 ), mask );
+			__m128 t = _mm_loadu_ps( m + 12 );
+
+			// the columns of the inverse are the cross products of the rows, over the determinant
+			__m128 c0 = Cross( r1, r2 );
+			__m128 c1 = Cross( r2, r0 );
+			__m128 c2 = Cross( r0, r1 );
+			float32_t det = _mm_cvtss_f32( HorizontalAdd( _mm_mul_ps( r0, c0 ) ) );
+
+			if (det != 0)
+			{
+				if (fabs(1.0/det) < HELIUM_ANGLE_NEAR_ZERO)
+				{
+					ScalarKernels::AffineInvertMatrix4( m, result );
+					return;
+				}
+
+				__m128 inverseDet = _mm_set1_ps( 1.f / det );
+				r0 = _mm_mul_ps( c0, inverseDet );
+				r1 = _mm_mul_ps( c1, inverseDet );
+				r2 = _mm_mul_ps( c2, inverseDet );
+				__m128 r3 = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+			}
+
+			// a singular upper 3x3 is left as is, but the translation is still applied through it
+			__m128 translate = _mm_mul_ps( Swizzle< 0, 0, 0, 0 >( t ), r0 );
+			translate = _mm_add_ps( translate, _mm_mul_ps( Swizzle< 1, 1, 1, 1 >( t ), r1 ) );
+			translate = _mm_add_ps( translate, _mm_mul_ps( Swizzle< 2, 2, 2, 2 >( t ), r2 ) );
+			translate = _mm_sub_ps( _mm_setr_ps( 0.f, 0.f, 0.f, 1.f ), translate );
+
+			_mm_storeu_ps( result +  0, r0 );
+			_mm_storeu_ps( result +  4, r1 );
+			_mm_storeu_ps( result +  8, r2 );
+			_mm_storeu_ps( result + 12, translate );
+		}
+
+		inline float32_t DotVector4( const float32_t* a, const float32_t* b )
+		{
+			return _mm_cvtss_f32( HorizontalAdd( _mm_mul_ps( _mm_loadu_ps( a ), _mm_loadu_ps( b ) ) ) );
+		}
+
+		inline void CrossVector4( const float32_t* a, const float32_t* b, float32_t* result )
+		{
+			_mm_storeu_ps( result, Cross( _mm_loadu_ps( a ), _mm_loadu_ps( b ) ) );
+		}
+
+		inline void NormalizeVector4( float32_t* v )
+		{
+			__m128 r = _mm_loadu_ps( v );
+			float32_t len = _mm_cvtss_f32( _mm_sqrt_ss( HorizontalAdd( _mm_mul_ps( r, r ) ) ) );
+
+			if (len > HELIUM_DIVISOR_NEAR_ZERO)
+			{
+				_mm_storeu_ps( v, _mm_mul_ps( r, _mm_set1_ps( 1.f / len ) ) );
+			}
+			else
+			{
+				_mm_storeu_ps( v, _mm_setzero_ps() );
+			}
+		}
+	}
+
+	namespace MathKernels = SimdKernels;
+
+#else
+
+	namespace MathKernels = ScalarKernels;
+
+#endif
+}
@@ -0,0 +1,208 @@
+#include "Math/AlignedBox.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix4.h"
+#include "Math/PointSpan.h"
+#include "Math/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <float.h>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+namespace
+{
+	const uint32_t BenchmarkIterations = 1000000;
+	const uint32_t BenchmarkRounds = 5;
+
+	const uint32_t RandomSeed = 12345;
+
+	void RecordBest( float64_t& bestMs, uint64_t startTicks )
+	{
+		bestMs = std::min( bestMs, Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks ) );
+	}
+}
+
+// prints the time spent in each kernel on the scalar and the build selected paths, MatrixKernelsMatchScalar checks they agree
+TEST( Math, MatrixKernelsBenchmark )
+{
+	Random random ( RandomSeed );
+
+	const uint32_t count = 64;
+	Matrix4 matrices[ count ];
+	Vector4 vectors[ count ];
+	for ( uint32_t i=0; i<count; ++i )
+	{
+		matrices[i] = RandomAffine( random );
+		vectors[i] = Vector4( random.Next(), random.Next(), random.Next(), 1.f );
+	}
+
+	struct Timing
+	{
+		const char* name;
+		float64_t   scalarMs;
+		float64_t   selectedMs;
+	};
+
+	Timing timings[5] =
+	{
+		{ "Matrix4 * Matrix4", DBL_MAX, DBL_MAX },
+		{ "Matrix4 * Vector4", DBL_MAX, DBL_MAX },
+		{ "Invert", DBL_MAX, DBL_MAX },
+		{ "AffineInvert", DBL_MAX, DBL_MAX },
+		{ "Vector4 Normalize", DBL_MAX, DBL_MAX },
+	};
+
+	float32_t sink = 0.f;
+	Matrix4 result;
+	Vector4 transformed[ count ];
+
+	// the best of several rounds, alternating paths, so one slow time slice doesn't decide it
+	for ( uint32_t pass=0; pass<BenchmarkRounds*2; ++pass )
+	{
+		bool scalar = pass % 2 == 0;
+
+		uint64_t start = Timer::GetTickCount();
+		for ( uint32_t i=0; i<BenchmarkIterations; ++i )
+		{
+			const Matrix4& a = matrices[ i % count ];
+			const Matrix4& b = matrices[ ( i + 1 ) % count ];
+			scalar ? ScalarKernels::MultiplyMatrix4( &a.x.x, &b.x.x, &result.x.x ) : MathKernels::MultiplyMatrix4( &a.x.x, &b.x.x, &result.x.x );
+			sink += result.t.x;
+		}
+		RecordBest( scalar ? timings[0].scalarMs : timings[0].selectedMs, start );
+
+		// summed after the loop, a running sum would time the adds instead of the kernel
+		start = Timer::GetTickCount();
+		for ( uint32_t i=0; i<BenchmarkIterations; ++i )
+		{
+			const Matrix4& m = matrices[ i % count ];
+			const Vector4& v = vectors[ ( i + 1 ) % count ];
+			Vector4& r = transformed[ i % count ];
+			scalar ? ScalarKernels::TransformVector4( &m.x.x, &v.x, &r.x ) : MathKernels::TransformVector4( &m.x.x, &v.x, &r.x );
+		}
+		RecordBest( scalar ? timings[1].scalarMs : timings[1].selectedMs, start );
+
+		for ( uint32_t i=0; i<count; ++i )
+		{
+			sink += transformed[i].x;
+		}
+
+		start = Timer::GetTickCount();
+		for ( uint32_t i=0; i<BenchmarkIterations; ++i )
+		{
+			const Matrix4& m = matrices[ i % count ];
+			scalar ? ScalarKernels::InvertMatrix4( &m.x.x, &result.x.x ) : MathKernels::InvertMatrix4( &m.x.x, &result.x.x );
+			sink += result.t.x;
+		}
+		RecordBest( scalar ? timings[2].scalarMs : timings[2].selectedMs, start );
+
+		start = Timer::GetTickCount();
+		for ( uint32_t i=0; i<BenchmarkIterations; ++i )
+		{
+			const Matrix4& m = matrices[ i % count ];
+			scalar ? ScalarKernels::AffineInvertMatrix4( &m.x.x, &result.x.x ) : MathKernels::AffineInvertMatrix4( &m.x.x, &result.x.x );
+			sink += result.t.x;
+		}
+		RecordBest( scalar ? timings[3].scalarMs : timings[3].selectedMs, start );
+
+		// normalized in place, copying each one into a temporary first stalls the kernel's vector load on the copy's float stores
+		Vector4 normalized[ count ];
+		for ( uint32_t i=0; i<count; ++i )
+		{
+			normalized[i] = vectors[i];
+		}
+
+		start = Timer::GetTickCount();
+		for ( uint32_t i=0; i<BenchmarkIterations; ++i )
+		{
+			Vector4& v = normalized[ i % count ];
+			scalar ? ScalarKernels::NormalizeVector4( &v.x ) : MathKernels::NormalizeVector4( &v.x );
+			sink += v.x;
+		}
+		RecordBest( scalar ? timings[4].scalarMs : timings[4].selectedMs, start );
+	}
+
+	printf( "Math kernels, best of %u rounds of %u iterations (SIMD %d, AVX %d):\n", BenchmarkRounds, BenchmarkIterations, HELIUM_MATH_SIMD, HELIUM_MATH_AVX );
+	for ( uint32_t i=0; i<HELIUM_ARRAY_COUNT( timings ); ++i )
+	{
+		printf( "  %-20s scalar %7.2f ms, selected %7.2f ms\n", timings[i].name, timings[i].scalarMs, timings[i].selectedMs );
+	}
+
+	EXPECT_TRUE( IsFinite( sink ) );
+}
+
+// prints the time to transform and bound a mesh sized point buffer one point at a time and in batch, PointSpanKernels checks they agree
+TEST( Math, PointSpanBenchmark )
+{
+	Random random ( RandomSeed );
+	Matrix4 matrix = RandomAffine( random );
+
+	const size_t count = 1 << 20;
+	V_Vector3 points ( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		points[i] = Vector3( random.Next(), random.Next(), random.Next() );
+	}
+
+	V_Vector3 perPoint ( points );
+	AlignedBox perPointBounds;
+	uint64_t start = Timer::GetTickCount();
+	for ( V_Vector3::iterator itr = perPoint.begin(), end = perPoint.end(); itr != end; ++itr )
+	{
+		matrix.TransformVertex( *itr );
+		perPointBounds.Test( *itr );
+	}
+	float64_t perPointMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	V_Vector3 batched ( points );
+	AlignedBox batchedBounds;
+	start = Timer::GetTickCount();
+	PointSpan span ( &batched[0], count );
+	matrix.TransformVertices( span, span );
+	batchedBounds.Test( span );
+	float64_t batchedMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "Transform and bound %u points: per point %.2f ms, batched %.2f ms\n", static_cast< uint32_t >( count ), perPointMs, batchedMs );
+
+	EXPECT_TRUE( perPointBounds.seeded && batchedBounds.seeded );
+}
+
+// prints the time to cull a million boxes one at a time and in bulk, FrustumBulkCulling checks they agree
+TEST( Math, FrustumCullingBenchmark )
+{
+	Random random ( RandomSeed );
+	Frustum frustum = TestFrustum( 100.f );
+
+	const size_t count = 1 << 20;
+	std::vector< AlignedBox > boxes ( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		boxes[i] = RandomBox( random );
+	}
+
+	std::vector< uint32_t > expected ( count / 32 );
+	uint64_t start = Timer::GetTickCount();
+	for ( size_t i=0; i<count; ++i )
+	{
+		if ( frustum.IntersectsBox( boxes[i] ) )
+		{
+			expected[ i / 32 ] |= 1u << ( i % 32 );
+		}
+	}
+	float64_t singleMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	std::vector< uint32_t > visible ( count / 32 );
+	start = Timer::GetTickCount();
+	frustum.IntersectsBoxes( &boxes[0], count, &visible[0] );
+	float64_t bulkMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+	printf( "Frustum cull %u boxes: one at a time %.2f ms, bulk %.2f ms\n", static_cast< uint32_t >( count ), singleMs, bulkMs );
+
+	EXPECT_TRUE( expected == visible );
+}
@@ -0,0 +1,230 @@
+#include "Math/AlignedBox.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix4.h"
+#include "Math/PointSpan.h"
+#include "Math/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+namespace
+{
+	const float32_t KernelTolerance = 1e-3f;
+
+	const uint32_t RandomSeed = 12345;
+
+	Matrix4 RandomGeneral( Random& random )
+	{
+		Matrix4 m;
+		for ( uint32_t i=0; i<16; ++i )
+		{
+			m.GetArray1d()[i] = random.Next();
+		}
+
+		// keep it well conditioned
+		for ( uint32_t i=0; i<4; ++i )
+		{
+			m[i][i] += 4.f;
+		}
+
+		return m;
+	}
+
+	void ExpectNear( const float32_t* expected, const float32_t* actual, uint32_t count, float32_t tolerance )
+	{
+		for ( uint32_t i=0; i<count; ++i )
+		{
+			EXPECT_NEAR( expected[i], actual[i], tolerance ) << "element " << i;
+		}
+	}
+}
+
+TEST( Math, MatrixKernelsMatchScalar )
+{
+	Random random ( RandomSeed );
+
+	for ( uint32_t i=0; i<256; ++i )
+	{
+		Matrix4 a = RandomGeneral( random );
+		Matrix4 b = RandomAffine( random );
+		Vector4 v ( random.Next(), random.Next(), random.Next(), 1.f );
+
+		Matrix4 expected, actual;
+		ScalarKernels::MultiplyMatrix4( &a.x.x, &b.x.x, &expected.x.x );
+		actual = a * b;
+		ExpectNear( &expected.x.x, &actual.x.x, 16, KernelTolerance );
+
+		actual = a;
+		actual *= b;
+		ExpectNear( &expected.x.x, &actual.x.x, 16, KernelTolerance );
+
+		Vector4 expectedVector, actualVector;
+		ScalarKernels::TransformVector4( &b.x.x, &v.x, &expectedVector.x );
+		actualVector = b * v;
+		ExpectNear( &expectedVector.x, &actualVector.x, 4, KernelTolerance );
+
+		EXPECT_TRUE( ScalarKernels::InvertMatrix4( &a.x.x, &expected.x.x ) );
+		actual = a.Inverted();
+		ExpectNear( &expected.x.x, &actual.x.x, 16, KernelTolerance );
+		Matrix4 product = a * actual;
+		ExpectNear( &Matrix4::Identity.x.x, &product.x.x, 16, KernelTolerance );
+
+		ScalarKernels::AffineInvertMatrix4( &b.x.x, &expected.x.x );
+		actual = b.AffineInverted();
+		ExpectNear( &expected.x.x, &actual.x.x, 16, KernelTolerance );
+		product = b * actual;
+		ExpectNear( &Matrix4::Identity.x.x, &product.x.x, 16, KernelTolerance );
+	}
+
+	EXPECT_TRUE( Matrix4::Zero.Inverted() == Matrix4::Zero );
+}
+
+TEST( Math, VectorKernelsMatchScalar )
+{
+	Random random ( RandomSeed );
+
+	for ( uint32_t i=0; i<256; ++i )
+	{
+		Vector4 a ( random.Next(), random.Next(), random.Next(), random.Next() );
+		Vector4 b ( random.Next(), random.Next(), random.Next(), random.Next() );
+
+		EXPECT_NEAR( ScalarKernels::DotVector4( &a.x, &b.x ), a.Dot( b ), KernelTolerance );
+
+		Vector4 expected;
+		ScalarKernels::CrossVector4( &a.x, &b.x, &expected.x );
+		Vector4 actual = a.Cross( b );
+		ExpectNear( &expected.x, &actual.x, 4, KernelTolerance );
+
+		expected = a;
+		ScalarKernels::NormalizeVector4( &expected.x );
+		actual = a.Normalized();
+		ExpectNear( &expected.x, &actual.x, 4, KernelTolerance );
+	}
+
+	EXPECT_TRUE( Vector4::Zero.Normalized() == Vector4::Zero );
+}
+
+TEST( Math, PointSpanKernels )
+{
+	Random random ( RandomSeed );
+	Matrix4 matrix = RandomAffine( random );
+
+	// not a multiple of four, so the scalar tail runs too
+	const size_t count = 103;
+	V_Vector3 points ( count );
+	V_Vector4 padded ( count );
+	std::vector< float32_t > xs ( count ), ys ( count ), zs ( count );
+	AlignedBox expectedBounds;
+	for ( size_t i=0; i<count; ++i )
+	{
+		points[i] = Vector3( random.Next() * 10.f, random.Next() * 10.f, random.Next() * 10.f );
+		padded[i] = Vector4( points[i] );
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+		zs[i] = points[i].z;
+		expectedBounds.Test( points[i] );
+	}
+
+	AlignedBox bounds;
+	bounds.Test( ConstPointSpan( &points[0], count ) );
+	EXPECT_TRUE( bounds.minimum == expectedBounds.minimum && bounds.maximum == expectedBounds.maximum );
+
+	bounds.Reset();
+	bounds.Test( ConstPointSpan( &xs[0], &ys[0], &zs[0], count ) );
+	EXPECT_TRUE( bounds.minimum == expectedBounds.minimum && bounds.maximum == expectedBounds.maximum );
+
+	V_Vector3 transformed ( count );
+	matrix.TransformVertices( ConstPointSpan( &points[0], count ), PointSpan( &transformed[0], count ) );
+	matrix.TransformVertices( ConstPointSpan( &xs[0], &ys[0], &zs[0], count ), PointSpan( &xs[0], &ys[0], &zs[0], count ) );
+	matrix.TransformVertices( ConstPointSpan( &padded[0].x, &padded[0].y, &padded[0].z, count, 4 ), PointSpan( &padded[0].x, &padded[0].y, &padded[0].z, count, 4 ) );
+
+	for ( size_t i=0; i<count; ++i )
+	{
+		Vector3 expected = points[i];
+		matrix.TransformVertex( expected );
+
+		ExpectNear( &expected.x, &transformed[i].x, 3, KernelTolerance );
+		EXPECT_NEAR( expected.x, xs[i], KernelTolerance );
+		EXPECT_NEAR( expected.y, ys[i], KernelTolerance );
+		EXPECT_NEAR( expected.z, zs[i], KernelTolerance );
+		ExpectNear( &expected.x, &padded[i].x, 3, KernelTolerance );
+		EXPECT_EQ( 0.f, padded[i].w );
+	}
+
+	AlignedBox boxes[ 9 ];
+	for ( size_t i=0; i<HELIUM_ARRAY_COUNT( boxes ); ++i )
+	{
+		boxes[i].Test( points[ i * 2 ] );
+		boxes[i].Test( points[ i * 2 + 1 ] );
+	}
+
+	AlignedBox transformedBoxes[ HELIUM_ARRAY_COUNT( boxes ) ];
+	AlignedBox::Transform( boxes, transformedBoxes, HELIUM_ARRAY_COUNT( boxes ), matrix );
+	for ( size_t i=0; i<HELIUM_ARRAY_COUNT( boxes ); ++i )
+	{
+		// reference: the bounds of the eight transformed corners
+		V_Vector3 corners;
+		boxes[i].GetVertices( corners );
+
+		AlignedBox expected;
+		for ( size_t j=0; j<corners.size(); ++j )
+		{
+			matrix.TransformVertex( corners[j] );
+			expected.Test( corners[j] );
+		}
+
+		ExpectNear( &expected.minimum.x, &transformedBoxes[i].minimum.x, 3, KernelTolerance );
+		ExpectNear( &expected.maximum.x, &transformedBoxes[i].maximum.x, 3, KernelTolerance );
+		EXPECT_TRUE( transformedBoxes[i].seeded );
+	}
+}
+
+TEST( Math, FrustumBulkCulling )
+{
+	Random random ( RandomSeed );
+	Frustum frustum = TestFrustum( 100.f );
+
+	const size_t count = 1003;
+	std::vector< AlignedBox > boxes ( count );
+	V_Vector3 centers ( count );
+	std::vector< float32_t > radii ( count );
+	for ( size_t i=0; i<count; ++i )
+	{
+		boxes[i] = RandomBox( random );
+		if ( i % 7 == 0 )
+		{
+			// smaller than the intersection error, tested as a point
+			boxes[i].maximum = boxes[i].minimum;
+		}
+
+		centers[i] = boxes[i].Center();
+		radii[i] = random.Next() * 5.f + 5.f;
+	}
+
+	std::vector< uint32_t > visible ( ( count + 31 ) / 32 );
+	frustum.IntersectsBoxes( &boxes[0], count, &visible[0] );
+
+	size_t visibleCount = 0;
+	for ( size_t i=0; i<count; ++i )
+	{
+		bool expected = frustum.IntersectsBox( boxes[i] );
+		bool actual = ( visible[ i / 32 ] & ( 1u << ( i % 32 ) ) ) != 0;
+		EXPECT_EQ( expected, actual ) << "box " << i;
+		visibleCount += actual ? 1 : 0;
+	}
+
+	EXPECT_GT( visibleCount, 0u );
+	EXPECT_LT( visibleCount, count );
+
+	frustum.IntersectsSpheres( ConstPointSpan( &centers[0], count ), &radii[0], &visible[0] );
+	for ( size_t i=0; i<count; ++i )
+	{
+		bool expected = frustum.IntersectsSphere( centers[i], radii[i] );
+		bool actual = ( visible[ i / 32 ] & ( 1u << ( i % 32 ) ) ) != 0;
+		EXPECT_EQ( expected, actual ) << "sphere " << i;
+	}
+}
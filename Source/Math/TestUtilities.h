@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Math/AlignedBox.h"
+#include "Math/Frustum.h"
+#include "Math/Line.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+
+#include <vector>
+
+//
+// Helpers shared by the Math tests, not part of the library
+//
+
+namespace Helium
+{
+	namespace MathTests
+	{
+		// deterministic linear congruential generator, so every run tests the same data
+		struct Random
+		{
+			uint32_t state;
+
+			Random( uint32_t seed ) : state( seed ) {}
+
+			// uniform in [-1, 1)
+			float32_t Next()
+			{
+				state = state * 1664525 + 1013904223;
+				return static_cast< float32_t >( state >> 8 ) / static_cast< float32_t >( 1 << 23 ) - 1.f;
+			}
+
+			Vector3 NextVector( float32_t scale )
+			{
+				float32_t x = Next() * scale;
+				float32_t y = Next() * scale;
+				float32_t z = Next() * scale;
+				return Vector3( x, y, z );
+			}
+		};
+
+		// rotation, non-uniform scale and translation
+		inline Matrix4 RandomAffine( Random& random )
+		{
+			Matrix4 m = Matrix4::RotateX( random.Next() * 3.f ) * Matrix4::RotateY( random.Next() * 3.f ) * Matrix4::RotateZ( random.Next() * 3.f );
+			m *= Matrix4( Scale( 1.5f + random.Next(), 1.5f + random.Next(), 1.5f + random.Next() ) );
+			m.t = Vector4( random.Next() * 100.f, random.Next() * 100.f, random.Next() * 100.f, 1.f );
+			return m;
+		}
+
+		// a box of half extent 1 to 2, scattered in and around TestFrustum( 100.f )
+		inline AlignedBox RandomBox( Random& random )
+		{
+			Vector3 center ( random.Next() * 100.f, random.Next() * 100.f, random.Next() * 100.f - 50.f );
+			Vector3 extent ( random.Next() + 1.f, random.Next() + 1.f, random.Next() + 1.f );
+			return AlignedBox( center - extent, center + extent );
+		}
+
+		// 90 degree frustum looking down -z from z = -1 to z = -farDistance, planes normalized as 4-vectors like Frustum( const Matrix4& )
+		inline Frustum TestFrustum( float32_t farDistance )
+		{
+			Frustum frustum;
+			frustum.right.p = Vector4( -1.f, 0.f, -1.f, 0.f );
+			frustum.left.p = Vector4( 1.f, 0.f, -1.f, 0.f );
+			frustum.top.p = Vector4( 0.f, -1.f, -1.f, 0.f );
+			frustum.bottom.p = Vector4( 0.f, 1.f, -1.f, 0.f );
+			frustum.front.p = Vector4( 0.f, 0.f, -1.f, -1.f );
+			frustum.back.p = Vector4( 0.f, 0.f, 1.f, farDistance );
+
+			for ( uint32_t i=0; i<6; ++i )
+			{
+				frustum[i].Normalize();
+			}
+
+			return frustum;
+		}
+
+		// triangle soup with per triangle bounds, the primitives the BoundingVolumeHierarchy tests build over
+		struct Triangles
+		{
+			std::vector< Vector3 >    vertices;
+			std::vector< AlignedBox > bounds;
+
+			// count small triangles scattered through a cube of the given half size
+			Triangles( Random& random, size_t count, float32_t extent )
+				: vertices( count * 3 )
+				, bounds( count )
+			{
+				for ( size_t i=0; i<count; ++i )
+				{
+					Vector3 center = random.NextVector( extent );
+					for ( size_t j=0; j<3; ++j )
+					{
+						vertices[ i * 3 + j ] = center + random.NextVector( 1.f );
+					}
+				}
+
+				UpdateBounds();
+			}
+
+			void UpdateBounds()
+			{
+				for ( size_t i=0; i<bounds.size(); ++i )
+				{
+					bounds[ i ].Reset();
+					for ( size_t j=0; j<3; ++j )
+					{
+						bounds[ i ].Test( vertices[ i * 3 + j ] );
+					}
+				}
+			}
+
+			bool RayHit( const Line& ray, uint32_t i, float32_t* t = NULL ) const
+			{
+				float32_t scale;
+				if ( ray.IntersectsTriangle( vertices[ i * 3 ], vertices[ i * 3 + 1 ], vertices[ i * 3 + 2 ], NULL, NULL, &scale ) && scale >= 0.f )
+				{
+					if ( t )
+					{
+						*t = scale;
+					}
+
+					return true;
+				}
+
+				return false;
+			}
+
+			bool SegmentHit( const Line& segment, uint32_t i ) const
+			{
+				return segment.IntersectSegmentTriangle( vertices[ i * 3 ], vertices[ i * 3 + 1 ], vertices[ i * 3 + 2 ] );
+			}
+		};
+
+		// exact test a caller would hand to Raycast
+		struct NearestHit
+		{
+			const Triangles* triangles;
+			const Line*      ray;
+
+			bool operator()( uint32_t primitive, float32_t& t ) const
+			{
+				float32_t hit;
+				if ( triangles->RayHit( *ray, primitive, &hit ) && hit < t )
+				{
+					t = hit;
+					return true;
+				}
+
+				return false;
+			}
+		};
+
+		inline Line RandomRay( Random& random, float32_t extent )
+		{
+			Vector3 origin = random.NextVector( extent );
+			return Line( origin, origin + random.NextVector( 1.f ) );
+		}
+
+		// deterministic cloud, flattened and rotated so its principal axes are not the world axes
+		inline std::vector< Vector3 > BoundsTestCloud( size_t count )
+		{
+			std::vector< Vector3 > points ( count );
+			Random random ( 2468 );
+			for ( size_t i=0; i<count; ++i )
+			{
+				float32_t x = random.Next() * 40.f;
+				float32_t y = random.Next() * 10.f;
+				float32_t z = random.Next() * 2.f;
+
+				Vector3 p ( x, y, z );
+				points[i] = Vector3( p.x * 0.8f - p.y * 0.6f + 100.f, p.x * 0.6f + p.y * 0.8f - 50.f, p.z + 25.f );
+			}
+
+			return points;
+		}
+	}
+}
@@ -1,5 +1,126 @@
-#include "gtest/gtest.h"
-
-TEST(Math, NullTest)
-{
-}
\ No newline at end of file
+#include "Math/CalculateBounds.h"
+#include "Math/Frustum.h"
+#include "Math/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MathTests;
+
+TEST(Math, NullTest)
+{
+}
+
+TEST(Math, FrustumPreciseBox)
+{
+	Frustum frustum = TestFrustum( 10.f );
+
+	AlignedBox inside ( Vector3( -0.5f, -0.5f, -3.f ), Vector3( 0.5f, 0.5f, -2.f ) );
+	EXPECT_TRUE( frustum.IntersectsBox( inside ) );
+	EXPECT_TRUE( frustum.IntersectsBox( inside, true ) );
+
+	AlignedBox beyond ( Vector3( -1.f, -1.f, -20.f ), Vector3( 1.f, 1.f, -15.f ) );
+	EXPECT_FALSE( frustum.IntersectsBox( beyond ) );
+	EXPECT_FALSE( frustum.IntersectsBox( beyond, true ) );
+
+	AlignedBox straddling ( Vector3( 2.5f, 2.5f, -3.1f ), Vector3( 3.f, 3.f, -2.9f ) );
+	EXPECT_TRUE( frustum.IntersectsBox( straddling, true ) );
+
+	AlignedBox enclosing ( Vector3( -100.f, -100.f, -100.f ), Vector3( 100.f, 100.f, 100.f ) );
+	EXPECT_TRUE( frustum.IntersectsBox( enclosing, true ) );
+
+	// passes every plane on its own, but lies beside the far corner of the frustum
+	AlignedBox beside ( Vector3( 11.f, -1.f, -20.f ), Vector3( 20.f, 1.f, 0.f ) );
+	EXPECT_TRUE( frustum.IntersectsBox( beside ) );
+	EXPECT_FALSE( frustum.IntersectsBox( beside, true ) );
+}
+
+TEST(Math, BoundingVolumeFastSphere)
+{
+	const size_t counts[] = { 1, 2, 7, 5000, 200000 };
+	for ( size_t c=0; c<HELIUM_ARRAY_COUNT( counts ); ++c )
+	{
+		std::vector< Vector3 > points = BoundsTestCloud( counts[c] );
+		const int32_t count = static_cast< int32_t >( points.size() );
+
+		BoundingVolumeGenerator::BSphere fast = BoundingVolumeGenerator( &points.front(), count, BoundingVolumeGenerator::BSPHERE_FAST ).GetPrincipleAxisBoundingSphere();
+		BoundingVolumeGenerator::BSphere optimized = BoundingVolumeGenerator( &points.front(), count, BoundingVolumeGenerator::BSPHERE_OPTIMIZED ).GetPrincipleAxisBoundingSphere();
+
+		for ( int32_t i=0; i<count; ++i )
+		{
+			ASSERT_LE( ( points[i] - fast.m_Center ).Length(), fast.m_Radius * 1.0001f );
+		}
+
+		// never looser than the full MiniSphere pass, and only tighter where its degenerate cases fall back to a box
+		EXPECT_LE( fast.m_Radius, optimized.m_Radius * 1.0001f + 1e-5f );
+		EXPECT_NEAR( optimized.m_Radius, fast.m_Radius, 1e-3f * optimized.m_Radius + 1e-5f );
+	}
+}
+
+TEST(Math, BoundingVolumeCovariance)
+{
+	std::vector< Vector3 > points = BoundsTestCloud( 300000 );
+	const int32_t count = static_cast< int32_t >( points.size() );
+
+	BoundingVolumeGenerator generator ( &points.front(), count, BoundingVolumeGenerator::PRINCIPAL_AXIS );
+	BoundingVolumeGenerator::OBB obb = generator.GetPrincipleAxisOBB();
+	BoundingVolumeGenerator::AABB aabb = generator.GetAABB();
+
+	// the single threaded float accumulation the generator used to do
+	Vector3 mean;
+	for ( int32_t i=0; i<count; ++i )
+	{
+		mean += points[i];
+	}
+	mean /= static_cast< float32_t >( count );
+
+	float32_t covariance[3][3] = { { 0.f } };
+	Vector3 minimum = points[0], maximum = points[0];
+	for ( int32_t i=0; i<count; ++i )
+	{
+		Vector3 d = points[i] - mean;
+		for ( uint32_t r=0; r<3; ++r )
+		{
+			for ( uint32_t c=0; c<3; ++c )
+			{
+				covariance[r][c] += d[r] * d[c];
+			}
+
+			minimum[r] = std::min( minimum[r], points[i][r] );
+			maximum[r] = std::max( maximum[r], points[i][r] );
+		}
+	}
+
+	EXPECT_TRUE( generator.GetMean().Equal( mean, 1e-2f ) );
+	for ( uint32_t r=0; r<3; ++r )
+	{
+		for ( uint32_t c=0; c<3; ++c )
+		{
+			float32_t expected = covariance[r][c] / count;
+			EXPECT_NEAR( expected, generator.GetCovariance()( r, c ), 1e-4f * fabs( expected ) + 1e-3f );
+		}
+	}
+
+	EXPECT_TRUE( aabb.m_Center.Equal( ( minimum + maximum ) * 0.5f, 1e-4f ) );
+	EXPECT_TRUE( aabb.m_Extents.Equal( ( maximum - minimum ) * 0.5f, 1e-4f ) );
+
+	// the cloud is a rotated 80 x 20 x 4 box, so the principal box should come back close to that
+	float32_t lengths[3] = { obb.m_Axis[0].Length() * 2.f, obb.m_Axis[1].Length() * 2.f, obb.m_Axis[2].Length() * 2.f };
+	std::sort( lengths, lengths + 3 );
+	EXPECT_NEAR( 4.f, lengths[0], 0.1f );
+	EXPECT_NEAR( 20.f, lengths[1], 0.1f );
+	EXPECT_NEAR( 80.f, lengths[2], 0.1f );
+
+	for ( int32_t i=0; i<count; ++i )
+	{
+		Vector3 d = points[i] - obb.m_Center;
+		for ( uint32_t a=0; a<3; ++a )
+		{
+			float32_t length = obb.m_Axis[a].Length();
+			ASSERT_LE( fabs( d.Dot( obb.m_Axis[a] ) / length ), length * 1.0001f + 1e-4f );
+		}
+	}
+}
@@ -6,6 +6,7 @@
 #include "Math/API.h"
 #include "Foundation/Math.h"
 #include "Math/Vector3.h"
+#include "Math/Simd.h"
 
 namespace Helium
 {
@@ -93,16 +94,8 @@ namespace Helium
 
 	inline Vector4& Vector4::Normalize() 
 	{ 
-		float32_t len = this->Length();
-
-		if (len > HELIUM_DIVISOR_NEAR_ZERO)
-		{
-			return *this /= len;
-		}
-		else
-		{
-			return *this = Vector4 (0, 0, 0, 0);
-		}
+		MathKernels::NormalizeVector4( &x );
+		return *this;
 	}
 
 	inline Vector4 Vector4::Normalized() const 
@@ -113,11 +106,13 @@ namespace Helium
 
 	inline float32_t Vector4::Dot(const Vector4& v) const
 	{
-		return (x * v.x + y * v.y + z * v.z + w * v.w);
+		return MathKernels::DotVector4( &x, &v.x );
 	}
 
 	inline Vector4 Vector4::Cross(const Vector4& v) const
 	{
-		return Vector4 (y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x, 0);
+		Vector4 result;
+		MathKernels::CrossVector4( &x, &v.x, &result.x );
+		return result;
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Foundation/Endian.h"
 #include "Foundation/FileStream.h"
+#include "Foundation/HashMap.h"
 #include "Foundation/Numeric.h"
 
 #include "Reflect/Object.h"
@@ -10,6 +11,9 @@
 #include "Reflect/Registry.h"
 #include "Reflect/TranslatorDeduction.h"
 
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+
 #include <time.h>
 
 HELIUM_DEFINE_BASE_STRUCT( Helium::Persist::BsonDate );
@@ -462,6 +466,200 @@ void ArchiveWriterBson::SerializeTranslator( bson* b, const char* name, Pointer
 	}
 }
 
+namespace
+{
+	typedef HashMap< const MetaStruct*, BsonFieldMap* > BsonFieldMapTable;
+
+	// the published table is never changed, a miss adds its map to a copy (under the mutex) and publishes that,
+	//  so decoding threads look their maps up without locking, the tables replaced are freed by Cleanup
+	BsonFieldMapTable* volatile        g_FieldMaps = NULL;
+	DynamicArray< BsonFieldMapTable* > g_RetiredFieldMaps;
+	Mutex                              g_FieldMapsMutex;
+
+	const BsonFieldMap* FindFieldMap( const BsonFieldMapTable* table, const MetaStruct* structure )
+	{
+		if ( table )
+		{
+			BsonFieldMapTable::ConstIterator found = table->Find( structure );
+			if ( found != table->End() )
+			{
+				return found->Second();
+			}
+		}
+
+		return NULL;
+	}
+
+	void PopulateFieldMap( BsonFieldMap& map, const MetaStruct* structure )
+	{
+		// base fields first, matching the order SerializeInstance writes them
+		if ( structure->m_Base )
+		{
+			PopulateFieldMap( map, structure->m_Base );
+		}
+
+		for ( DynamicArray< Field >::ConstIterator itr = structure->m_Fields.Begin(), end = structure->m_Fields.End(); itr != end; ++itr )
+		{
+			BsonFieldMap::Entry entry;
+			entry.name = itr->m_Name;
+			entry.field = &*itr;
+			entry.scalar = -1;
+
+			if ( itr->m_Count == 1 && itr->m_Translator->IsA( MetaIds::ScalarTranslator ) )
+			{
+				ScalarTranslator* scalar = static_cast< ScalarTranslator* >( itr->m_Translator );
+				if ( scalar->m_Type != ScalarTypes::String )
+				{
+					entry.scalar = scalar->m_Type;
+				}
+			}
+
+			map.entries.Add( entry );
+		}
+	}
+
+	template< class T >
+	bool DecodeNumber( T value, void* address, int32_t type )
+	{
+		bool clamp = true;
+		switch ( type )
+		{
+		case ScalarTypes::Unsigned8:
+			RangeCastInteger( value, *static_cast< uint8_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Unsigned16:
+			RangeCastInteger( value, *static_cast< uint16_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Unsigned32:
+			RangeCastInteger( value, *static_cast< uint32_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Unsigned64:
+			RangeCastInteger( value, *static_cast< uint64_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Signed8:
+			RangeCastInteger( value, *static_cast< int8_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Signed16:
+			RangeCastInteger( value, *static_cast< int16_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Signed32:
+			RangeCastInteger( value, *static_cast< int32_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Signed64:
+			RangeCastInteger( value, *static_cast< int64_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Float32:
+			RangeCastFloat( value, *static_cast< float32_t* >( address ), clamp );
+			break;
+
+		case ScalarTypes::Float64:
+			RangeCastFloat( value, *static_cast< float64_t* >( address ), clamp );
+			break;
+
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+	// same conversions as ArchiveReaderBson::DeserializeTranslator, without building a Pointer or checking the translator,
+	//  false when the element does not match the field's type so the caller takes the general path for it
+	bool DecodeScalar( bson_iterator* i, void* address, int32_t type )
+	{
+		switch ( bson_iterator_type( i ) )
+		{
+		case BSON_BOOL:
+			if ( type != ScalarTypes::Boolean )
+			{
+				return false;
+			}
+
+			*static_cast< bool* >( address ) = bson_iterator_bool( i ) != 0;
+			return true;
+
+		case BSON_INT:
+			return DecodeNumber( bson_iterator_int( i ), address, type );
+
+		case BSON_LONG:
+			return DecodeNumber( bson_iterator_long( i ), address, type );
+
+		case BSON_DOUBLE:
+			return DecodeNumber( bson_iterator_double( i ), address, type );
+
+		default:
+			return false;
+		}
+	}
+}
+
+const BsonFieldMap* BsonFieldMap::Get( const MetaStruct* structure )
+{
+	// the table is only reached through the pointer it was published with (after it was filled in)
+	const BsonFieldMap* found = FindFieldMap( g_FieldMaps, structure );
+	if ( found )
+	{
+		return found;
+	}
+
+	MutexScopeLock lock ( g_FieldMapsMutex );
+
+	// another thread may have added it while we waited
+	BsonFieldMapTable* table = g_FieldMaps;
+	found = FindFieldMap( table, structure );
+	if ( found )
+	{
+		return found;
+	}
+
+	BsonFieldMap* map = new BsonFieldMap;
+	PopulateFieldMap( *map, structure );
+
+	BsonFieldMapTable* published = table ? new BsonFieldMapTable ( *table ) : new BsonFieldMapTable;
+	published->Insert( BsonFieldMapTable::ValueType( structure, map ) );
+	AtomicExchangePointerRelease( reinterpret_cast< void* volatile & >( g_FieldMaps ), published );
+
+	// a reader may still be searching the old table
+	if ( table )
+	{
+		g_RetiredFieldMaps.Push( table );
+	}
+
+	return map;
+}
+
+void BsonFieldMap::Cleanup()
+{
+	MutexScopeLock lock ( g_FieldMapsMutex );
+
+	BsonFieldMapTable* table = g_FieldMaps;
+	if ( table )
+	{
+		for ( BsonFieldMapTable::Iterator itr = table->Begin(), end = table->End(); itr != end; ++itr )
+		{
+			delete itr->Second();
+		}
+
+		delete table;
+		AtomicExchangePointer( reinterpret_cast< void* volatile & >( g_FieldMaps ), NULL );
+	}
+
+	for ( DynamicArray< BsonFieldMapTable* >::Iterator itr = g_RetiredFieldMaps.Begin(), end = g_RetiredFieldMaps.End(); itr != end; ++itr )
+	{
+		delete *itr;
+	}
+
+	g_RetiredFieldMaps.Clear();
+}
+
 void ArchiveReaderBson::Startup()
 {
 	Register( "bson", &AllocateReader );
@@ -470,6 +668,8 @@ void ArchiveReaderBson::Startup()
 void ArchiveReaderBson::Shutdown()
 {
 	Unregister( "bson" );
+
+	BsonFieldMap::Cleanup();
 }
 
 SmartPtr< ArchiveReader > ArchiveReaderBson::AllocateReader( const FilePath& path, Reflect::ObjectResolver* resolver )
@@ -500,10 +700,45 @@ void ArchiveReaderBson::ReadFromBson( bson_iterator* i, const ObjectPtr& object,
 	archive.DeserializeInstance( i, object.Ptr(), object->GetMetaClass(), object );
 }
 
+void ArchiveReaderBson::ReadFromBson( const bson* document, ObjectPtr& object, const MetaClass* defaultType, ObjectResolver* resolver, uint32_t flags )
+{
+	const MetaClass* type = defaultType;
+
+	// _type is written right after _id, so this only looks at the first couple elements
+	bson_iterator i[1];
+	bson_iterator_init( i, document );
+	while ( bson_iterator_next( i ) )
+	{
+		if ( !strcmp( bson_iterator_key( i ), "_type" ) )
+		{
+			if ( bson_iterator_type( i ) == BSON_STRING )
+			{
+				const MetaClass* storedType = Registry::GetInstance()->GetMetaClass( bson_iterator_string( i ) );
+				if ( storedType )
+				{
+					type = storedType;
+				}
+			}
+			break;
+		}
+	}
+
+	object = type ? type->m_Creator() : NULL;
+	if ( object.ReferencesObject() )
+	{
+		ArchiveReaderBson archive( NULL, resolver, flags );
+		archive.m_Direct = true;
+
+		bson_iterator_init( i, document );
+		archive.DecodeInstance( i, object.Ptr(), object->GetMetaClass(), object );
+	}
+}
+
 ArchiveReaderBson::ArchiveReaderBson( const FilePath& path, ObjectResolver* resolver, uint32_t flags )
 	: ArchiveReader( path, resolver, flags )
 	, m_Stream( NULL )
 	, m_Size( 0 )
+	, m_Direct( false )
 {
 
 }
@@ -512,6 +747,7 @@ ArchiveReaderBson::ArchiveReaderBson( Stream *stream, ObjectResolver* resolver,
 	: ArchiveReader( resolver, flags )
 	, m_Stream( NULL )
 	, m_Size( 0 )
+	, m_Direct( false )
 {
 	m_Stream.Reset( stream );
 	m_Stream.Orphan( true );
@@ -696,6 +932,44 @@ void ArchiveReaderBson::DeserializeInstance( bson_iterator* i, void* instance, c
 	object->PostDeserialize( NULL );
 }
 
+void ArchiveReaderBson::DecodeInstance( bson_iterator* i, void* instance, const MetaStruct* structure, Object* object )
+{
+#if PERSIST_ARCHIVE_VERBOSE
+	Log::Print("Decoding %s\n", structure->m_Name);
+#endif
+	object->PreDeserialize( NULL );
+
+	const BsonFieldMap* map = BsonFieldMap::Get( structure );
+	size_t hint = 0;
+
+	while( bson_iterator_next( i ) )
+	{
+		const char* key = bson_iterator_key( i );
+		const BsonFieldMap::Entry* entry = map->Find( key, hint );
+		if ( entry )
+		{
+			const Field* field = entry->field;
+			object->PreDeserialize( field );
+
+			if ( entry->scalar < 0 || !DecodeScalar( i, static_cast< uint8_t* >( instance ) + field->m_Offset, entry->scalar ) )
+			{
+				DeserializeField( i, instance, field, object );
+			}
+
+			object->PostDeserialize( field );
+		}
+		else if ( strcmp( key, "_type" ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				"ArchiveReaderBson::DecodeInstance - Could not find field '%s'\n",
+				key);
+		}
+	}
+
+	object->PostDeserialize( NULL );
+}
+
 void ArchiveReaderBson::DeserializeField( bson_iterator* i, void* instance, const Field* field, Object* object )
 {
 #if PERSIST_ARCHIVE_VERBOSE
@@ -973,7 +1247,14 @@ void ArchiveReaderBson::DeserializeTranslator( bson_iterator* i, Pointer pointer
 
 				bson_iterator elem[1];
 				bson_iterator_subiterator( i, elem );
-				DeserializeInstance( elem, pointer.m_Address,  structure->GetMetaStruct(), object );
+				if ( m_Direct )
+				{
+					DecodeInstance( elem, pointer.m_Address, structure->GetMetaStruct(), object );
+				}
+				else
+				{
+					DeserializeInstance( elem, pointer.m_Address,  structure->GetMetaStruct(), object );
+				}
 			}
 			else if ( translator->GetMetaId() == MetaIds::AssociationTranslator )
 			{
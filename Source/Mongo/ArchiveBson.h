@@ -114,6 +114,27 @@ namespace Helium
 			static void PopulateMetaType( Helium::Reflect::MetaStruct& structure );
 		};
 
+		// Precomputed key to field mapping of a MetaStruct (including its bases), in the order the writer
+		//  emits fields, so consecutive lookups while decoding a document are usually a single compare
+		struct HELIUM_MONGO_API BsonFieldMap
+		{
+			struct Entry
+			{
+				const char*           name;
+				const Reflect::Field* field;
+				int32_t               scalar; // ScalarType decoded straight into field memory, or -1
+			};
+
+			DynamicArray< Entry > entries;
+
+			// cached per MetaStruct, safe to call from any thread (and lock free once a struct's map is built)
+			static const BsonFieldMap* Get( const Reflect::MetaStruct* structure );
+			static void Cleanup();
+
+			// hint is the entry after the last match, and is advanced past this one
+			inline const Entry* Find( const char* key, size_t& hint ) const;
+		};
+
 		class HELIUM_MONGO_API ArchiveWriterBson : public ArchiveWriter
 		{
 		public:
@@ -151,6 +172,10 @@ namespace Helium
 			static void ReadFromStream( Stream& stream, DynamicArray< Reflect::ObjectPtr > & objects, Reflect::ObjectResolver* resolver = NULL, uint32_t flags = 0 );
 			static void ReadFromBson( bson_iterator* i, const Reflect::ObjectPtr& object, Reflect::ObjectResolver* resolver = NULL, uint32_t flags = 0 );
 
+			// single pass read of a whole document: allocates the type named by its _type element (or defaultType)
+			//  and decodes the document into it through cached field maps, scalars going straight to field memory
+			static void ReadFromBson( const bson* document, Reflect::ObjectPtr& object, const Reflect::MetaClass* defaultType, Reflect::ObjectResolver* resolver = NULL, uint32_t flags = 0 );
+
 			ArchiveReaderBson( const FilePath& path, Reflect::ObjectResolver* resolver = NULL, uint32_t flags = 0x0 );
 			ArchiveReaderBson( Stream *stream, Reflect::ObjectResolver* resolver = NULL, uint32_t flags = 0x0 );
 			
@@ -164,6 +189,7 @@ namespace Helium
 			void Start();
 			bool ReadNext( Reflect::ObjectPtr &object, size_t index );
 			void DeserializeInstance( bson_iterator* i, void* instance, const Reflect::MetaStruct* composite, Reflect::Object* object );
+			void DecodeInstance( bson_iterator* i, void* instance, const Reflect::MetaStruct* composite, Reflect::Object* object );
 			void DeserializeField( bson_iterator* i, void* instance, const Reflect::Field* field, Reflect::Object* object );
 			void DeserializeTranslator( bson_iterator* i, Reflect::Pointer pointer, Reflect::Translator* translator, const Reflect::Field* field, Reflect::Object* object );
 
@@ -172,6 +198,7 @@ namespace Helium
 			int64_t                 m_Size;
 			bson                    m_Bson[1];
 			bson_iterator           m_Next[1];
+			bool                    m_Direct; // decode nested structures through field maps
 		};
 	}
 }
@@ -56,4 +56,26 @@ bool Helium::Persist::BsonObjectId::operator>( const BsonObjectId& rhs ) const
 Helium::Persist::BsonObjectId::operator bool() const
 {
 	return *this != BsonObjectId::Null;
-}
\ No newline at end of file
+}
+
+const Helium::Persist::BsonFieldMap::Entry* Helium::Persist::BsonFieldMap::Find( const char* key, size_t& hint ) const
+{
+	const size_t count = entries.GetSize();
+	for ( size_t n=0; n<count; ++n )
+	{
+		size_t index = hint + n;
+		if ( index >= count )
+		{
+			index -= count;
+		}
+
+		const Entry& entry = entries[ index ];
+		if ( !strcmp( entry.name, key ) )
+		{
+			hint = index + 1;
+			return &entry;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,53 @@
+#include "Precompile.h"
+
+#include "Mongo/Mongo.h"
+#include "Mongo/TestUtilities.h"
+
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Helium;
+using namespace Helium::MongoTests;
+
+HELIUM_DEFINE_BASE_STRUCT( DecodePoint );
+HELIUM_DEFINE_CLASS( DecodeBase );
+HELIUM_DEFINE_CLASS( DecodeDerived );
+
+// prints the time to decode a mixed corpus with the iterator walk and the single pass decoder, needs no mongod,
+//  MongoDecode checks that both produce the same objects
+TEST( Mongo, MongoDecodeBenchmark )
+{
+	MongoScope scope;
+
+	const size_t count = 10000;
+	std::vector< bson > corpus ( count );
+	ASSERT_NO_FATAL_FAILURE( BuildDecodeCorpus( corpus ) );
+
+	std::vector< StrongPtr< DecodeBase > > walked ( count );
+	uint64_t startTicks = Timer::GetTickCount();
+	for ( size_t i=0; i<count; ++i )
+	{
+		walked[i] = ReadByIterator( &corpus[i] );
+	}
+	float64_t walkedMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks );
+
+	std::vector< StrongPtr< DecodeBase > > decoded ( count );
+	startTicks = Timer::GetTickCount();
+	for ( size_t i=0; i<count; ++i )
+	{
+		decoded[i] = ReadInOnePass( &corpus[i] );
+	}
+	float64_t decodedMs = Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks );
+
+	for ( size_t i=0; i<count; ++i )
+	{
+		EXPECT_TRUE( decoded[i].ReferencesObject() );
+		bson_destroy( &corpus[i] );
+	}
+
+	printf( "BSON decode of %u documents: iterator walk %.2f ms, single pass %.2f ms\n",
+		static_cast< uint32_t >( count ), walkedMs, decodedMs );
+}
@@ -4,6 +4,8 @@
 #include "Foundation/Log.h"
 #include "Foundation/MemoryStream.h"
 
+#include "Platform/Timer.h"
+
 HELIUM_DEFINE_CLASS( Helium::Mongo::Model );
 
 using namespace Helium;
@@ -108,28 +110,174 @@ const char* Mongo::GetErrorString( int status )
 	return "Unknown error";
 }
 
+// create an object of the type stored in the document (or defaultType) and read the document into it
+static StrongPtr< Model > ReadDocument( const bson* document, const Reflect::MetaClass* defaultType )
+{
+	// the type info encoded in the BSON (if any) overrides defaultType
+	StrongPtr< Model > object;
+
+	try
+	{
+		Helium::Persist::ArchiveReaderBson::ReadFromBson( document, reinterpret_cast< Helium::Reflect::ObjectPtr& >( object ), defaultType );
+	}
+	catch ( Helium::Exception& ex )
+	{
+		Helium::Log::Error( "Failed to parse BSON in query result: %s\n", ex.What() );
+		object = NULL;
+	}
+
+	if ( object.ReferencesObject() && !object->IsA( Reflect::GetMetaClass< Model >() ) )
+	{
+		Helium::Log::Error( "Query result type %s is not a Model\n", object->GetMetaClass()->m_Name );
+		object = NULL;
+	}
+
+	return object;
+}
+
+// Double buffered decoding: the caller's thread copies the raw documents of the next batch out of the
+//  cursor (the connection stays on the database's thread) and the decode thread turns them into objects
+//  while the caller consumes the current batch
+struct Cursor::Prefetcher
+{
+	struct Buffer
+	{
+		DynamicArray< uint8_t >            data;    // raw documents back to back
+		DynamicArray< size_t >             offsets; // start of each document in data
+		DynamicArray< StrongPtr< Model > > objects; // decoded documents, NULL where decoding failed
+		size_t                             next;    // next object to hand out
+	};
+
+	Prefetcher( size_t batchSize, const Reflect::MetaClass* defaultType )
+		: batchSize( batchSize )
+		, defaultType( defaultType )
+		, current( NULL )
+		, decoding( NULL )
+		, quit( false )
+	{
+		buffers[0].next = buffers[1].next = 0;
+	}
+
+	~Prefetcher()
+	{
+		if ( decoding )
+		{
+			decoded.Decrement();
+		}
+
+		quit = true;
+		work.Increment();
+		thread.Join();
+	}
+
+	bool Start()
+	{
+		return thread.Create( &CallbackThread::EntryHelper< Prefetcher, &Prefetcher::DecodeThread >, this, "Mongo Cursor Prefetch" );
+	}
+
+	// copy the next batch of raw documents out of the cursor, and hand them to the decode thread
+	void Fetch( mongo_cursor* cursor, Buffer* buffer )
+	{
+		buffer->data.Clear();
+		buffer->offsets.Clear();
+		buffer->objects.Clear();
+		buffer->next = 0;
+
+		while ( buffer->offsets.GetSize() < batchSize && mongo_cursor_next( cursor ) == MONGO_OK )
+		{
+			buffer->offsets.Add( buffer->data.GetSize() );
+			buffer->data.AddArray( reinterpret_cast< const uint8_t* >( bson_data( &cursor->current ) ), bson_size( &cursor->current ) );
+		}
+
+		if ( !buffer->offsets.IsEmpty() )
+		{
+			decoding = buffer;
+			work.Increment();
+		}
+	}
+
+	void DecodeThread()
+	{
+		while ( true )
+		{
+			work.Decrement();
+
+			if ( quit )
+			{
+				break;
+			}
+
+			Buffer* buffer = decoding;
+			buffer->objects.Reserve( buffer->offsets.GetSize() );
+			for ( size_t i=0; i<buffer->offsets.GetSize(); ++i )
+			{
+				bson document[1];
+				HELIUM_VERIFY( BSON_OK == bson_init_finished_data( document, reinterpret_cast< char* >( buffer->data.GetData() + buffer->offsets[i] ), false ) );
+				buffer->objects.Add( ReadDocument( document, defaultType ) );
+				bson_destroy( document );
+			}
+
+			decoded.Increment();
+		}
+	}
+
+	size_t                    batchSize;
+	const Reflect::MetaClass* defaultType;
+	Buffer                    buffers[2];
+	Buffer*                   current;  // being consumed by the caller
+	Buffer*                   decoding; // owned by the decode thread until 'decoded' is signaled
+	CallbackThread            thread;
+	Semaphore                 work;
+	Semaphore                 decoded;
+	volatile bool             quit;
+};
+
 Cursor::Cursor( Database* db, mongo_cursor* cursor )
 	: db( db )
 	, cursor( cursor )
+	, prefetch( NULL )
 {
 }
 
 Cursor::Cursor( const Cursor& rhs )
 	: db( rhs.db )
 	, cursor( rhs.cursor )
+	, prefetch( rhs.prefetch )
 {
 	rhs.db = NULL;
 	rhs.cursor = NULL;
+	rhs.prefetch = NULL;
 }
 
 Cursor::~Cursor()
 {
+	delete this->prefetch;
+
 	if ( this->cursor )
 	{
 		mongo_cursor_destroy( this->cursor );
 	}
 }
 
+bool Cursor::SetPrefetch( size_t batchSize, const Reflect::MetaClass* defaultType )
+{
+	if ( !HELIUM_VERIFY( db ) || !HELIUM_VERIFY( cursor ) || !HELIUM_VERIFY( prefetch == NULL ) || !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
+	{
+		return false;
+	}
+
+	prefetch = new Prefetcher( batchSize ? batchSize : 1, defaultType );
+	if ( !prefetch->Start() )
+	{
+		delete prefetch;
+		prefetch = NULL;
+		return false;
+	}
+
+	prefetch->Fetch( cursor, &prefetch->buffers[0] );
+	return true;
+}
+
 Helium::StrongPtr< Model > Cursor::Next( const Reflect::MetaClass* defaultType )
 {
 	if ( !HELIUM_VERIFY( db ) || !HELIUM_VERIFY( cursor ) || !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
@@ -137,52 +285,50 @@ Helium::StrongPtr< Model > Cursor::Next( const Reflect::MetaClass* defaultType )
 		return NULL;
 	}
 
-	Helium::StrongPtr< Model > object;
-
-	while ( !object.ReferencesObject() && mongo_cursor_next( cursor ) == MONGO_OK )
+	if ( prefetch )
 	{
-		const Reflect::MetaClass* type = defaultType;
+		HELIUM_ASSERT( defaultType == prefetch->defaultType );
 
-		// if we have type info encoded in the BSON, use it instead of the defaultType
-		bson_iterator i[1];
-		if ( BSON_STRING == bson_find( i, &cursor->current, "_type" ) )
+		while ( true )
 		{
-			const char* typeName = bson_iterator_string( i );
-			HELIUM_ASSERT( typeName );
-			const Reflect::MetaClass* storedType = Reflect::Registry::GetInstance()->GetMetaClass( typeName );
-			if ( storedType )
+			Prefetcher::Buffer* current = prefetch->current;
+			while ( current && current->next < current->objects.GetSize() )
 			{
-				type = storedType;
+				Helium::StrongPtr< Model > object = current->objects[ current->next ];
+				current->objects[ current->next++ ] = NULL;
+				if ( object.ReferencesObject() )
+				{
+					return object;
+				}
 			}
-		}
-
-		if ( type )
-		{
-			object = Reflect::AssertCast< Model >( type->m_Creator() );
-		}
-
-		if ( object.ReferencesObject() )
-		{
-			bson_iterator_init( i, &cursor->current );
 
-			try
+			if ( prefetch->decoding == NULL )
 			{
-				Helium::Persist::ArchiveReaderBson::ReadFromBson( i, reinterpret_cast< Helium::Reflect::ObjectPtr& >( object ) );
-			}
-			catch ( Helium::Exception& ex )
-			{
-				Helium::Log::Error( "Failed to parse BSON in query result: %s\n", ex.What() );
-				object = NULL;
+				return NULL;
 			}
+
+			// take the decoded batch, and start on the one after it before handing out objects
+			prefetch->decoded.Decrement();
+			Prefetcher::Buffer* ready = prefetch->decoding;
+			prefetch->decoding = NULL;
+			prefetch->Fetch( cursor, ready == &prefetch->buffers[0] ? &prefetch->buffers[1] : &prefetch->buffers[0] );
+			prefetch->current = ready;
 		}
 	}
 
+	Helium::StrongPtr< Model > object;
+
+	while ( !object.ReferencesObject() && mongo_cursor_next( cursor ) == MONGO_OK )
+	{
+		object = ReadDocument( &cursor->current, defaultType );
+	}
+
 	return object;
 }
 
 bool Cursor::Next( const Helium::StrongPtr< Model >& object )
 {
-	if ( !HELIUM_VERIFY( db ) || !HELIUM_VERIFY( cursor ) || !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
+	if ( !HELIUM_VERIFY( db ) || !HELIUM_VERIFY( cursor ) || !HELIUM_VERIFY( prefetch == NULL ) || !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
 	{
 		return false;
 	}
@@ -584,8 +730,7 @@ Cursor Database::Find( const char* collection, const bson* query, int limit, int
 	ns += ".";
 	ns += collection;
 
-	// we don't currently support specifying fields because we need to ensure _type is sent back, and
-	//  merging bson documents is difficult/impossible with the current version of the bson api
+	// all fields, use the projection overload to request specific ones
 	mongo_cursor* c = mongo_find( conn, ns.GetData(), query, NULL, limit, skip, options );
 	if ( c )
 	{
@@ -597,6 +742,41 @@ Cursor Database::Find( const char* collection, const bson* query, int limit, int
 	}
 }
 
+Cursor Database::Find( const char* collection, const bson* query, const char* const* fields, size_t fieldCount, int limit, int skip, int options )
+{
+	if ( !HELIUM_VERIFY_MSG( IsCorrectThread(), "Database access from improper thread" ) )
+	{
+		return Cursor();
+	}
+
+	Helium::String ns ( name );
+	ns += ".";
+	ns += collection;
+
+	// _type is always needed to create the right type of object, _id is returned unless excluded
+	bson projection[1];
+	HELIUM_VERIFY( BSON_OK == bson_init( projection ) );
+	HELIUM_VERIFY( BSON_OK == bson_append_int( projection, "_type", 1 ) );
+	for ( size_t i=0; i<fieldCount; ++i )
+	{
+		HELIUM_VERIFY( BSON_OK == bson_append_int( projection, fields[i], 1 ) );
+	}
+	HELIUM_VERIFY( BSON_OK == bson_finish( projection ) );
+
+	// the projection is only read when the query is sent
+	mongo_cursor* c = mongo_find( conn, ns.GetData(), query, projection, limit, skip, options );
+	bson_destroy( projection );
+
+	if ( c )
+	{
+		return Cursor( this, c );
+	}
+	else
+	{
+		return Cursor();
+	}
+}
+
 
 bool Database::Remove( const char* collection, const bson* query )
 {
@@ -617,3 +797,504 @@ bool Database::Remove( const char* collection, const bson* query )
 
 	return true;
 }
+
+
+BulkWriter::BulkWriter( Database* db, BulkOperation operation, const char* collection, bool ordered )
+	: db( db )
+	, operation( operation )
+	, collection( collection ? collection : "" )
+	, ordered( ordered )
+	, maxCount( HELIUM_MONGO_BULK_MAX_COUNT )
+	, maxBytes( HELIUM_MONGO_BULK_MAX_BYTES )
+	, metaClass( NULL )
+	, filling( &batches[0] )
+	, serializing( NULL )
+	, quit( false )
+	, stopped( false )
+	, batchCount( 0 )
+	, writtenCount( 0 )
+	, failedCount( 0 )
+{
+	for ( size_t i=0; i<HELIUM_ARRAY_COUNT( batches ); ++i )
+	{
+		batches[i].failed = 0;
+	}
+
+	mongo_write_concern_init( acknowledged );
+	acknowledged->w = 1;
+	mongo_write_concern_finish( acknowledged );
+
+	mongo_write_concern_init( unacknowledged );
+	unacknowledged->w = 0;
+	mongo_write_concern_finish( unacknowledged );
+
+	HELIUM_VERIFY( thread.Create( &CallbackThread::EntryHelper< BulkWriter, &BulkWriter::SerializeThread >, this, "Mongo Bulk Writer" ) );
+}
+
+BulkWriter::~BulkWriter()
+{
+	Flush();
+
+	quit = true;
+	work.Increment();
+	thread.Join();
+
+	for ( size_t i=0; i<HELIUM_ARRAY_COUNT( batches ); ++i )
+	{
+		Release( batches[i].documents );
+		Release( batches[i].conditions );
+	}
+
+	mongo_write_concern_destroy( acknowledged );
+	mongo_write_concern_destroy( unacknowledged );
+}
+
+void BulkWriter::SetBatchLimits( size_t maxCount, size_t maxBytes )
+{
+	HELIUM_ASSERT( filling->objects.IsEmpty() && serializing == NULL );
+
+	this->maxCount = maxCount ? maxCount : 1;
+	this->maxBytes = maxBytes;
+}
+
+bool BulkWriter::Add( const StrongPtr< Model >& object )
+{
+	if ( !HELIUM_VERIFY( object ) || !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
+	{
+		return false;
+	}
+
+	if ( stopped )
+	{
+		++failedCount;
+		return false;
+	}
+
+	if ( metaClass == NULL )
+	{
+		metaClass = object->GetMetaClass();
+	}
+	else if ( collection.IsEmpty() && !HELIUM_VERIFY_MSG( metaClass == object->GetMetaClass(), "Objects of different types need a collection to be specified" ) )
+	{
+		return false;
+	}
+
+	filling->objects.Add( object );
+
+	if ( filling->objects.GetSize() >= maxCount )
+	{
+		Submit();
+	}
+
+	return !stopped;
+}
+
+bool BulkWriter::Flush()
+{
+	if ( !HELIUM_VERIFY_MSG( db->IsCorrectThread(), "Database access from improper thread" ) )
+	{
+		return false;
+	}
+
+	Submit();
+	Finish();
+
+	return failedCount == 0;
+}
+
+void BulkWriter::Submit()
+{
+	if ( filling->objects.IsEmpty() )
+	{
+		return;
+	}
+
+	// collect the batch the serializer finished, and hand it the one we just filled
+	Batch* ready = NULL;
+	if ( serializing )
+	{
+		serialized.Decrement();
+		ready = serializing;
+	}
+
+	serializing = filling;
+	work.Increment();
+
+	// send while the serializer works on the next batch
+	if ( ready )
+	{
+		Send( ready );
+		filling = ready;
+	}
+	else
+	{
+		filling = serializing == &batches[0] ? &batches[1] : &batches[0];
+	}
+}
+
+void BulkWriter::Finish()
+{
+	if ( serializing )
+	{
+		serialized.Decrement();
+
+		Batch* ready = serializing;
+		serializing = NULL;
+		Send( ready );
+	}
+}
+
+void BulkWriter::SerializeThread()
+{
+	while ( true )
+	{
+		work.Decrement();
+
+		if ( quit )
+		{
+			break;
+		}
+
+		Serialize( serializing );
+
+		serialized.Increment();
+	}
+}
+
+void BulkWriter::Serialize( Batch* batch )
+{
+	batch->pending.Clear();
+	batch->pendingConditions.Clear();
+	batch->failed = 0;
+
+	for ( size_t i=0; i<batch->objects.GetSize(); ++i )
+	{
+		Model* object = batch->objects[i];
+
+		if ( operation == BulkOperations::Insert )
+		{
+			if ( !HELIUM_VERIFY( object->id == BsonObjectId::Null ) )
+			{
+				batch->failed++;
+				if ( ordered )
+				{
+					break;
+				}
+				continue;
+			}
+
+			bson_oid_gen( (bson_oid_t*)object->id.bytes );
+		}
+		else if ( object->id == BsonObjectId::Null )
+		{
+			// upserting a new object
+			bson_oid_gen( (bson_oid_t*)object->id.bytes );
+		}
+
+		bson_oid_t oid[1];
+		MemoryCopy( oid, object->id.bytes, sizeof( bson_oid_t ) );
+
+		bson* b = Acquire( batch->documents, batch->pending.GetSize() );
+		bool result = true;
+		try
+		{
+			if ( operation == BulkOperations::Insert )
+			{
+				HELIUM_VERIFY( BSON_OK == bson_append_oid( b, "_id", oid ) );
+				HELIUM_VERIFY( BSON_OK == bson_append_string( b, "_type", object->GetMetaClass()->m_Name ) );
+				ArchiveWriterBson::WriteToBson( batch->objects[i], b );
+			}
+			else
+			{
+				HELIUM_VERIFY( BSON_OK == bson_append_start_object( b, "$set" ) );
+				HELIUM_VERIFY( BSON_OK == bson_append_string( b, "_type", object->GetMetaClass()->m_Name ) );
+				ArchiveWriterBson::WriteToBson( batch->objects[i], b );
+				HELIUM_VERIFY( BSON_OK == bson_append_finish_object( b ) );
+			}
+		}
+		catch ( Helium::Exception& )
+		{
+			Log::Error( "Failed to generate BSON for object\n" );
+			result = false;
+		}
+		HELIUM_VERIFY( BSON_OK == bson_finish( b ) );
+
+		if ( !result )
+		{
+			batch->failed++;
+			if ( ordered )
+			{
+				break;
+			}
+			continue;
+		}
+
+		if ( operation == BulkOperations::Upsert )
+		{
+			bson* cond = Acquire( batch->conditions, batch->pendingConditions.GetSize() );
+			HELIUM_VERIFY( BSON_OK == bson_append_oid( cond, "_id", oid ) );
+			HELIUM_VERIFY( BSON_OK == bson_finish( cond ) );
+			batch->pendingConditions.Add( cond );
+		}
+
+		batch->pending.Add( b );
+	}
+}
+
+void BulkWriter::Send( Batch* batch )
+{
+	BulkWriteResult result;
+	result.batch = batchCount++;
+	result.count = batch->objects.GetSize();
+	result.written = 0;
+	result.error = MONGO_OK;
+
+	if ( !stopped )
+	{
+		String ns = GetNamespace( db->GetName(), collection.IsEmpty() ? NULL : collection.GetData(), metaClass );
+
+		// split the batch so no single write exceeds the byte limit
+		size_t start = 0;
+		size_t bytes = 0;
+		bool ok = true;
+		for ( size_t i=0; i<batch->pending.GetSize() && ok; ++i )
+		{
+			size_t size = bson_size( batch->pending[i] );
+			if ( i > start && bytes + size > maxBytes )
+			{
+				ok = operation == BulkOperations::Insert ? SendInserts( batch, ns.GetData(), start, i, result ) : SendUpserts( batch, ns.GetData(), start, i, result );
+				ok = ok || !ordered;
+				start = i;
+				bytes = 0;
+			}
+			bytes += size;
+		}
+
+		if ( ok && start < batch->pending.GetSize() )
+		{
+			ok = operation == BulkOperations::Insert ? SendInserts( batch, ns.GetData(), start, batch->pending.GetSize(), result ) : SendUpserts( batch, ns.GetData(), start, batch->pending.GetSize(), result );
+		}
+
+		if ( ordered && ( !ok || batch->failed ) )
+		{
+			stopped = true;
+		}
+	}
+	else
+	{
+		result.error = db->GetConnection()->err;
+	}
+
+	writtenCount += result.written;
+	failedCount += result.count - result.written;
+
+	if ( callback.Valid() )
+	{
+		callback.Invoke( result );
+	}
+
+	// drop our references, the bson buffers are kept for the next batch
+	batch->objects.Clear();
+	batch->pending.Clear();
+	batch->pendingConditions.Clear();
+	batch->failed = 0;
+}
+
+bool BulkWriter::SendInserts( Batch* batch, const char* ns, size_t start, size_t end, BulkWriteResult& result )
+{
+	mongo* conn = db->GetConnection();
+
+	if ( MONGO_OK != mongo_insert_batch( conn, ns, const_cast< const bson** >( batch->pending.GetData() + start ), static_cast< int >( end - start ), acknowledged, ordered ? 0x0 : MONGO_CONTINUE_ON_ERROR ) )
+	{
+		Log::Error( "mongo_insert_batch failed: %s\n", GetErrorString( conn->err ) );
+		// call IsConnected to update the value of the isConnected flag.
+		db->IsConnected( true );
+		if ( result.error == MONGO_OK )
+		{
+			result.error = conn->err;
+		}
+		return false;
+	}
+
+	result.written += end - start;
+	return true;
+}
+
+bool BulkWriter::SendUpserts( Batch* batch, const char* ns, size_t start, size_t end, BulkWriteResult& result )
+{
+	mongo* conn = db->GetConnection();
+
+	for ( size_t i=start; i<end; ++i )
+	{
+		// ordered writes acknowledge each update so we stop at the first failure, unordered ones
+		//  pipeline the updates and acknowledge only the last one
+		mongo_write_concern* concern = ( ordered || i == end - 1 ) ? acknowledged : unacknowledged;
+
+		if ( MONGO_OK != mongo_update( conn, ns, batch->pendingConditions[i], batch->pending[i], MONGO_UPDATE_UPSERT, concern ) )
+		{
+			Log::Error( "mongo_update failed: %s\n", GetErrorString( conn->err ) );
+			// call IsConnected to update the value of the isConnected flag.
+			db->IsConnected( true );
+			if ( result.error == MONGO_OK )
+			{
+				result.error = conn->err;
+			}
+			return false;
+		}
+
+		if ( ordered )
+		{
+			result.written++;
+		}
+	}
+
+	if ( !ordered )
+	{
+		result.written += end - start;
+	}
+
+	return true;
+}
+
+bson* BulkWriter::Acquire( DynamicArray< bson* >& pool, size_t index )
+{
+	if ( index < pool.GetSize() )
+	{
+		// start the document over with a buffer as large as it grew to last time, so refilling it does not grow it again
+		bson* b = pool[ index ];
+		int size = bson_buffer_size( b );
+		bson_destroy( b );
+		bson_init_size( b, size );
+		return b;
+	}
+
+	bson* b = new bson;
+	HELIUM_VERIFY( BSON_OK == bson_init( b ) );
+	pool.Add( b );
+	return b;
+}
+
+void BulkWriter::Release( DynamicArray< bson* >& pool )
+{
+	for ( size_t i=0; i<pool.GetSize(); ++i )
+	{
+		bson_destroy( pool[i] );
+		delete pool[i];
+	}
+
+	pool.Clear();
+}
+
+DatabasePool::DatabasePool( const char* name, const char* addr, uint16_t port, size_t maxConnections )
+	: name( name )
+	, addr( addr )
+	, port( port )
+	, maxConnections( maxConnections ? maxConnections : 1 )
+	, pingInterval( HELIUM_MONGO_POOL_PING_INTERVAL_MS )
+{
+	for ( size_t i=0; i<this->maxConnections; ++i )
+	{
+		available.Increment();
+	}
+}
+
+DatabasePool::~DatabasePool()
+{
+	MutexScopeLock lock ( mutex );
+
+	HELIUM_ASSERT_MSG( idle.GetSize() == connections.GetSize(), "Destroying a pool with connections checked out" );
+
+	for ( size_t i=0; i<connections.GetSize(); ++i )
+	{
+		delete connections[i];
+	}
+}
+
+Database* DatabasePool::Checkout()
+{
+	available.Decrement();
+
+	Helium::ThreadId threadId = Thread::GetCurrentId();
+	uint64_t now = Timer::GetTickCount();
+
+	Database* db = NULL;
+	uint64_t idleTicks = 0;
+	{
+		MutexScopeLock lock ( mutex );
+
+		// prefer the connection this thread used last, then the most recently used one
+		size_t found = Invalid< size_t >();
+		for ( size_t i=0; i<idle.GetSize(); ++i )
+		{
+			if ( idle[i].lastThread == threadId )
+			{
+				found = i;
+				break;
+			}
+		}
+
+		if ( found == Invalid< size_t >() && !idle.IsEmpty() )
+		{
+			found = idle.GetSize() - 1;
+		}
+
+		if ( found != Invalid< size_t >() )
+		{
+			db = idle[ found ].db;
+			idleTicks = now - idle[ found ].lastUsedTicks;
+			idle.RemoveSwap( found );
+		}
+		else
+		{
+			// we hold a count from 'available', so there is room for another connection
+			HELIUM_ASSERT( connections.GetSize() < maxConnections );
+			db = new Database ( name.GetData() );
+			connections.Add( db );
+		}
+	}
+
+	if ( !Prepare( db, idleTicks ) )
+	{
+		Return( db );
+		return NULL;
+	}
+
+	return db;
+}
+
+void DatabasePool::Return( Database* db )
+{
+	HELIUM_ASSERT( db );
+
+	{
+		MutexScopeLock lock ( mutex );
+
+		Entry entry;
+		entry.db = db;
+		entry.lastThread = Thread::GetCurrentId();
+		entry.lastUsedTicks = Timer::GetTickCount();
+		idle.Add( entry );
+	}
+
+	available.Increment();
+}
+
+size_t DatabasePool::GetIdleCount()
+{
+	MutexScopeLock lock ( mutex );
+	return idle.GetSize() + ( maxConnections - connections.GetSize() );
+}
+
+bool DatabasePool::Prepare( Database* db, uint64_t idleTicks )
+{
+	// bind the connection to the thread checking it out
+	db->SetThread();
+
+	bool ping = Timer::TicksToMilliseconds( idleTicks ) >= pingInterval;
+	if ( db->IsConnected( ping ) )
+	{
+		return true;
+	}
+
+	return db->Connect( addr.GetData(), port );
+}
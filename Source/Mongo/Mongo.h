@@ -3,8 +3,10 @@
 #include "API.h"
 
 #include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
 #include "Platform/Thread.h"
 
+#include "Foundation/Event.h"
 #include "Foundation/Log.h"
 #include "Foundation/String.h"
 #include "Foundation/ReferenceCounting.h"
@@ -19,6 +21,10 @@
 #include <functional>
 
 #define HELIUM_MONGO_DEFAULT_PORT ( 27017 )
+#define HELIUM_MONGO_BULK_MAX_COUNT ( 1000 )
+#define HELIUM_MONGO_BULK_MAX_BYTES ( 8 * 1024 * 1024 )
+#define HELIUM_MONGO_POOL_DEFAULT_SIZE ( 8 )
+#define HELIUM_MONGO_POOL_PING_INTERVAL_MS ( 5000 )
 
 namespace Helium
 {
@@ -58,12 +64,19 @@ namespace Helium
 			// get a single result object from the cursor, specifying the type to allocate if one is not specified in the data
 			Helium::StrongPtr< Model > Next( const Reflect::MetaClass* defaultType );
 
-			// read a single object into an existing instance
+			// read a single object into an existing instance (not available while prefetching)
 			bool Next( const Helium::StrongPtr< Model >& object );
 
+			// decode documents into objects on a background thread, batchSize at a time, while the caller
+			//  consumes the previous batch; Next must then be called with the same defaultType
+			bool SetPrefetch( size_t batchSize, const Reflect::MetaClass* defaultType );
+
 		private:
+			struct Prefetcher;
+
 			mutable Database*     db;
 			mutable mongo_cursor* cursor;
+			mutable Prefetcher*   prefetch;
 		};
 
 		class HELIUM_MONGO_API Database : public Helium::NonCopyable
@@ -115,6 +128,9 @@ namespace Helium
 			//  collection == NULL uses collection named for the type specified in the cursor object
 			Cursor Find( const char* collection, const bson* query = NULL, int limit = 0, int skip = 0, int options = 0 );
 
+			// find with a projection, only the named fields (plus _id and _type) are sent back and deserialized
+			Cursor Find( const char* collection, const bson* query, const char* const* fields, size_t fieldCount, int limit = 0, int skip = 0, int options = 0 );
+
 			// remove
 			//  collection == NULL uses collection named for the type specified in the cursor object
 			//  query == NULL will remove all objects by default
@@ -126,6 +142,154 @@ namespace Helium
 			mongo                conn[1];
 			Helium::ThreadId threadId;
 		};
+
+		namespace BulkOperations
+		{
+			enum Type
+			{
+				Insert, // insert new objects, ids are generated just before serialization
+				Upsert, // update objects by id, inserting any that do not exist yet
+			};
+		}
+		typedef BulkOperations::Type BulkOperation;
+
+		// acknowledgement of a single batch sent by a BulkWriter
+		struct HELIUM_MONGO_API BulkWriteResult
+		{
+			size_t batch;   // sequence number of the batch
+			size_t count;   // objects in the batch
+			size_t written; // objects acknowledged by the server
+			int    error;   // MONGO_OK, or the connection error of the first failed write
+		};
+		typedef Helium::Signature< const BulkWriteResult& >::Delegate BulkWriteDelegate;
+
+		// Streams objects to the server in batches bounded by count and bytes.  The next batch is serialized
+		//  on a background thread while the current one is in flight, and BSON buffers are reused between
+		//  batches.  Sends happen on the calling thread, which must be the database's thread.
+		class HELIUM_MONGO_API BulkWriter : public Helium::NonCopyable
+		{
+		public:
+			// ordered writes stop at the first failure, unordered writes continue past it
+			BulkWriter( Database* db, BulkOperation operation = BulkOperations::Insert, const char* collection = NULL, bool ordered = true );
+			~BulkWriter();
+
+			// batch limits, call before the first Add
+			void SetBatchLimits( size_t maxCount, size_t maxBytes );
+
+			// receives the acknowledgement of each batch
+			inline void SetCallback( const BulkWriteDelegate& callback );
+
+			// queue an object, sending a batch when one is full, false once an ordered write has failed
+			bool Add( const Helium::StrongPtr< Model >& object );
+
+			// send everything queued and wait for it to be acknowledged
+			bool Flush();
+
+			inline size_t GetWrittenCount() const;
+			inline size_t GetFailedCount() const;
+
+		private:
+			struct Batch
+			{
+				Helium::DynamicArray< Helium::StrongPtr< Model > > objects;
+				Helium::DynamicArray< bson* >                      documents;  // insert documents, or upsert ops
+				Helium::DynamicArray< bson* >                      conditions; // upsert conditions
+				Helium::DynamicArray< bson* >                      pending;    // serialized documents to send
+				Helium::DynamicArray< bson* >                      pendingConditions;
+				size_t                                             failed;     // objects that failed to serialize
+			};
+
+			void SerializeThread();
+			void Serialize( Batch* batch );
+			void Send( Batch* batch );
+			bool SendInserts( Batch* batch, const char* ns, size_t start, size_t end, BulkWriteResult& result );
+			bool SendUpserts( Batch* batch, const char* ns, size_t start, size_t end, BulkWriteResult& result );
+			void Submit();
+			void Finish();
+
+			static bson* Acquire( Helium::DynamicArray< bson* >& pool, size_t index );
+			static void  Release( Helium::DynamicArray< bson* >& pool );
+
+			Database*               db;
+			BulkOperation           operation;
+			Helium::String          collection;
+			bool                    ordered;
+			size_t                  maxCount;
+			size_t                  maxBytes;
+			BulkWriteDelegate       callback;
+			const Reflect::MetaClass* metaClass;  // type of the first object, names the default collection
+			mongo_write_concern     acknowledged[1];
+			mongo_write_concern     unacknowledged[1];
+
+			Batch                   batches[2];
+			Batch*                  filling;     // accumulating objects on the caller's thread
+			Batch*                  serializing; // owned by the serializer thread until 'serialized' is signaled
+			Helium::CallbackThread  thread;
+			Helium::Semaphore       work;
+			Helium::Semaphore       serialized;
+			volatile bool           quit;
+
+			bool                    stopped;     // an ordered write failed
+			size_t                  batchCount;
+			size_t                  writtenCount;
+			size_t                  failedCount;
+		};
+
+		// A bounded set of connections shared by worker threads.  Checkout hands the calling thread a connected
+		//  Database bound to it (preferring the one that thread used last), blocking while all are checked out.
+		//  Connections idle for longer than the ping interval are health checked, and reconnected if need be.
+		class HELIUM_MONGO_API DatabasePool : public Helium::NonCopyable
+		{
+		public:
+			DatabasePool( const char* name, const char* addr, uint16_t port = HELIUM_MONGO_DEFAULT_PORT, size_t maxConnections = HELIUM_MONGO_POOL_DEFAULT_SIZE );
+			~DatabasePool();
+
+			inline void SetPingInterval( uint32_t milliseconds );
+
+			// NULL if a connection could not be made
+			Database* Checkout();
+			void Return( Database* db );
+
+			inline size_t GetMaxConnections() const;
+			size_t GetIdleCount();
+
+		private:
+			struct Entry
+			{
+				Database*        db;
+				Helium::ThreadId lastThread;
+				uint64_t         lastUsedTicks;
+			};
+
+			bool Prepare( Database* db, uint64_t idleTicks );
+
+			Helium::String                 name;
+			Helium::String                 addr;
+			uint16_t                       port;
+			size_t                         maxConnections;
+			uint32_t                       pingInterval;
+
+			Helium::Mutex                  mutex;
+			Helium::Semaphore              available; // one count per connection not checked out
+			Helium::DynamicArray< Entry >  idle;
+			Helium::DynamicArray< Database* > connections;
+		};
+
+		// Checks a Database out of a pool for the lifetime of the scope
+		class HELIUM_MONGO_API PooledDatabase : public Helium::NonCopyable
+		{
+		public:
+			inline PooledDatabase( DatabasePool& pool );
+			inline ~PooledDatabase();
+
+			inline bool IsValid() const;
+			inline Database* operator->() const;
+			inline Database& operator*() const;
+
+		private:
+			DatabasePool& pool;
+			Database*     db;
+		};
 	}
 }
 
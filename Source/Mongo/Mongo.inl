@@ -45,4 +45,60 @@ void Helium::Mongo::Database::SetThread( Helium::ThreadId threadId )
 bool Helium::Mongo::Database::IsCorrectThread() const
 {
 	return this->threadId == Thread::GetCurrentId();
+}
+
+void Helium::Mongo::BulkWriter::SetCallback( const BulkWriteDelegate& callback )
+{
+	this->callback = callback;
+}
+
+size_t Helium::Mongo::BulkWriter::GetWrittenCount() const
+{
+	return writtenCount;
+}
+
+size_t Helium::Mongo::BulkWriter::GetFailedCount() const
+{
+	return failedCount;
+}
+
+void Helium::Mongo::DatabasePool::SetPingInterval( uint32_t milliseconds )
+{
+	this->pingInterval = milliseconds;
+}
+
+size_t Helium::Mongo::DatabasePool::GetMaxConnections() const
+{
+	return maxConnections;
+}
+
+Helium::Mongo::PooledDatabase::PooledDatabase( DatabasePool& pool )
+	: pool( pool )
+	, db( pool.Checkout() )
+{
+}
+
+Helium::Mongo::PooledDatabase::~PooledDatabase()
+{
+	if ( db )
+	{
+		pool.Return( db );
+	}
+}
+
+bool Helium::Mongo::PooledDatabase::IsValid() const
+{
+	return db != NULL;
+}
+
+Helium::Mongo::Database* Helium::Mongo::PooledDatabase::operator->() const
+{
+	HELIUM_ASSERT( db );
+	return db;
+}
+
+Helium::Mongo::Database& Helium::Mongo::PooledDatabase::operator*() const
+{
+	HELIUM_ASSERT( db );
+	return *db;
 }
\ No newline at end of file
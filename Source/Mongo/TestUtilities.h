@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Mongo/Mongo.h"
+
+#include "Reflect/Registry.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+//
+// Helpers shared by the Mongo tests and benchmarks, not part of the library
+//
+
+// a source file of each binary that uses them says HELIUM_DEFINE_BASE_STRUCT( DecodePoint ),
+//  HELIUM_DEFINE_CLASS( DecodeBase ) and HELIUM_DEFINE_CLASS( DecodeDerived )
+struct DecodePoint : Helium::Reflect::Struct
+{
+	float32_t x;
+	float32_t y;
+	float32_t z;
+
+	DecodePoint() : x( 0.f ), y( 0.f ), z( 0.f ) {}
+
+	bool operator==( const DecodePoint& rhs ) const
+	{
+		return x == rhs.x && y == rhs.y && z == rhs.z;
+	}
+
+	HELIUM_DECLARE_BASE_STRUCT( DecodePoint );
+	static void PopulateMetaType( Helium::Reflect::MetaStruct& type )
+	{
+		type.AddField( &DecodePoint::x, "x" );
+		type.AddField( &DecodePoint::y, "y" );
+		type.AddField( &DecodePoint::z, "z" );
+	}
+};
+
+class DecodeBase : public Helium::Mongo::Model
+{
+public:
+	uint32_t       count;
+	float64_t      score;
+	bool           flag;
+	Helium::String name;
+
+	DecodeBase() : count( 0 ), score( 0.0 ), flag( false ) {}
+
+	HELIUM_DECLARE_CLASS( DecodeBase, Helium::Mongo::Model );
+	static void PopulateMetaType( Helium::Reflect::MetaStruct& type )
+	{
+		type.AddField( &DecodeBase::count, "count" );
+		type.AddField( &DecodeBase::score, "score" );
+		type.AddField( &DecodeBase::flag, "flag" );
+		type.AddField( &DecodeBase::name, "name" );
+	}
+};
+
+class DecodeDerived : public DecodeBase
+{
+public:
+	int16_t                 small;
+	DecodePoint             position;
+	std::vector< uint32_t > samples;
+
+	DecodeDerived() : small( 0 ) {}
+
+	HELIUM_DECLARE_CLASS( DecodeDerived, DecodeBase );
+	static void PopulateMetaType( Helium::Reflect::MetaStruct& type )
+	{
+		type.AddField( &DecodeDerived::small, "small" );
+		type.AddField( &DecodeDerived::position, "position" );
+		type.AddField( &DecodeDerived::samples, "samples" );
+	}
+};
+
+namespace Helium
+{
+	namespace MongoTests
+	{
+		// initializes the driver for a test, and cleans it up however the test ends (skipped, or on a failed assert)
+		struct MongoScope
+		{
+			MongoScope()
+			{
+				Mongo::Initialize();
+			}
+
+			~MongoScope()
+			{
+				Mongo::Cleanup();
+			}
+		};
+
+		// alternating base and derived objects with their _id and _type up front, the caller destroys the documents
+		inline void BuildDecodeCorpus( std::vector< bson >& corpus )
+		{
+			for ( size_t i=0; i<corpus.size(); ++i )
+			{
+				StrongPtr< DecodeBase > object = ( i % 2 ) ? new DecodeBase : new DecodeDerived;
+				object->count = static_cast< uint32_t >( i );
+				object->score = i * 0.5;
+				object->flag = ( i % 3 ) == 0;
+				object->name = "decode";
+
+				if ( DecodeDerived* derived = Reflect::SafeCast< DecodeDerived >( object.Ptr() ) )
+				{
+					derived->small = static_cast< int16_t >( -static_cast< int32_t >( i % 1000 ) );
+					derived->position.x = 1.f;
+					derived->position.y = static_cast< float32_t >( i );
+					derived->position.z = -1.f;
+					for ( uint32_t j=0; j<8; ++j )
+					{
+						derived->samples.push_back( j * static_cast< uint32_t >( i ) );
+					}
+				}
+
+				bson* b = &corpus[i];
+				bson_oid_t oid[1];
+				bson_oid_gen( oid );
+				ASSERT_EQ( BSON_OK, bson_init( b ) );
+				ASSERT_EQ( BSON_OK, bson_append_oid( b, "_id", oid ) );
+				ASSERT_EQ( BSON_OK, bson_append_string( b, "_type", object->GetMetaClass()->m_Name ) );
+				Persist::ArchiveWriterBson::WriteToBson( reinterpret_cast< Reflect::ObjectPtr& >( object ), b );
+				ASSERT_EQ( BSON_OK, bson_finish( b ) );
+			}
+		}
+
+		// the pre-existing path: find _type, create, then walk the document resolving each key by crc
+		inline StrongPtr< DecodeBase > ReadByIterator( const bson* document )
+		{
+			const Reflect::MetaClass* type = Reflect::GetMetaClass< DecodeBase >();
+
+			bson_iterator i[1];
+			if ( BSON_STRING == bson_find( i, document, "_type" ) )
+			{
+				type = Reflect::Registry::GetInstance()->GetMetaClass( bson_iterator_string( i ) );
+			}
+
+			StrongPtr< DecodeBase > object = Reflect::AssertCast< DecodeBase >( type->m_Creator() );
+			bson_iterator_init( i, document );
+			Persist::ArchiveReaderBson::ReadFromBson( i, reinterpret_cast< Reflect::ObjectPtr& >( object ) );
+			return object;
+		}
+
+		// the single pass decoder
+		inline StrongPtr< DecodeBase > ReadInOnePass( const bson* document )
+		{
+			StrongPtr< DecodeBase > object;
+			Persist::ArchiveReaderBson::ReadFromBson( document, reinterpret_cast< Reflect::ObjectPtr& >( object ), Reflect::GetMetaClass< DecodeBase >() );
+			return object;
+		}
+	}
+}
@@ -1,13 +1,246 @@
 #include "Precompile.h"
 
 #include "Mongo/Mongo.h"
+#include "Mongo/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
 
-#include "gtest/gtest.h"
-
 using namespace Helium;
+using namespace Helium::MongoTests;
 
 TEST( Mongo, MongoStartupShutdown )
 {
 	Mongo::Initialize();
 	Mongo::Cleanup();
 }
+
+namespace
+{
+	struct BulkWriteCounter
+	{
+		size_t batches;
+		size_t written;
+
+		void Acknowledged( const Mongo::BulkWriteResult& result )
+		{
+			EXPECT_EQ( MONGO_OK, result.error );
+			++batches;
+			written += result.written;
+		}
+	};
+}
+
+// requires a mongod listening on the default port, and is skipped otherwise
+TEST( Mongo, MongoBulkWrite )
+{
+	MongoScope scope;
+
+	Mongo::Database db ( "helium_mongo_tests" );
+	if ( !db.Connect( "127.0.0.1" ) )
+	{
+		GTEST_SKIP() << "no mongod listening on 127.0.0.1";
+	}
+
+	db.DropCollection( "bulk" );
+
+	const size_t count = 2500;
+	DynamicArray< StrongPtr< Mongo::Model > > objects;
+	for ( size_t i=0; i<count; ++i )
+	{
+		objects.Add( new Mongo::Model );
+	}
+
+	BulkWriteCounter counter = { 0, 0 };
+
+	{
+		Mongo::BulkWriter writer ( &db, Mongo::BulkOperations::Insert, "bulk", false );
+		writer.SetBatchLimits( 1000, HELIUM_MONGO_BULK_MAX_BYTES );
+		writer.SetCallback( Mongo::BulkWriteDelegate( &counter, &BulkWriteCounter::Acknowledged ) );
+		for ( size_t i=0; i<count; ++i )
+		{
+			EXPECT_TRUE( writer.Add( objects[i] ) );
+		}
+		EXPECT_TRUE( writer.Flush() );
+		EXPECT_EQ( count, writer.GetWrittenCount() );
+	}
+
+	EXPECT_EQ( 3u, counter.batches );
+	EXPECT_EQ( count, counter.written );
+	EXPECT_EQ( count, static_cast< size_t >( db.GetCollectionCount( "bulk" ) ) );
+
+	// upserting the same objects again must not add documents
+	{
+		Mongo::BulkWriter writer ( &db, Mongo::BulkOperations::Upsert, "bulk", true );
+		for ( size_t i=0; i<count; ++i )
+		{
+			EXPECT_TRUE( writer.Add( objects[i] ) );
+		}
+		EXPECT_TRUE( writer.Flush() );
+		EXPECT_EQ( count, writer.GetWrittenCount() );
+	}
+
+	EXPECT_EQ( count, static_cast< size_t >( db.GetCollectionCount( "bulk" ) ) );
+
+	db.Drop();
+}
+
+namespace
+{
+	struct PoolWorker
+	{
+		Mongo::DatabasePool* pool;
+		volatile int32_t*    failures;
+
+		void Run()
+		{
+			for ( int i=0; i<50; ++i )
+			{
+				Mongo::PooledDatabase db ( *pool );
+				if ( !db.IsValid() || !db->IsCorrectThread() || db->GetServerTime() < 0 )
+				{
+					AtomicIncrement( *failures );
+				}
+			}
+		}
+	};
+}
+
+// requires a mongod listening on the default port, and is skipped otherwise
+TEST( Mongo, MongoDatabasePool )
+{
+	MongoScope scope;
+
+	Mongo::DatabasePool pool ( "helium_mongo_tests", "127.0.0.1", HELIUM_MONGO_DEFAULT_PORT, 2 );
+
+	bool connected = false;
+	{
+		Mongo::PooledDatabase db ( pool );
+		connected = db.IsValid();
+	}
+
+	if ( !connected )
+	{
+		GTEST_SKIP() << "no mongod listening on 127.0.0.1";
+	}
+
+	volatile int32_t failures = 0;
+
+	const size_t workerCount = 4;
+	PoolWorker workers[ workerCount ];
+	CallbackThread threads[ workerCount ];
+	for ( size_t i=0; i<workerCount; ++i )
+	{
+		workers[i].pool = &pool;
+		workers[i].failures = &failures;
+		ASSERT_TRUE( threads[i].Create( &CallbackThread::EntryHelper< PoolWorker, &PoolWorker::Run >, &workers[i], "Pool Worker" ) );
+	}
+
+	for ( size_t i=0; i<workerCount; ++i )
+	{
+		threads[i].Join();
+	}
+
+	EXPECT_EQ( 0, failures );
+	EXPECT_EQ( 2u, pool.GetIdleCount() );
+}
+
+// requires a mongod listening on the default port, and is skipped otherwise
+TEST( Mongo, MongoCursorPrefetch )
+{
+	MongoScope scope;
+
+	Mongo::Database db ( "helium_mongo_tests" );
+	if ( !db.Connect( "127.0.0.1" ) )
+	{
+		GTEST_SKIP() << "no mongod listening on 127.0.0.1";
+	}
+
+	db.DropCollection( "prefetch" );
+
+	const size_t count = 1000;
+	{
+		Mongo::BulkWriter writer ( &db, Mongo::BulkOperations::Insert, "prefetch" );
+		for ( size_t i=0; i<count; ++i )
+		{
+			writer.Add( new Mongo::Model );
+		}
+		EXPECT_TRUE( writer.Flush() );
+	}
+
+	size_t found = 0;
+	Mongo::Cursor cursor = db.Find( "prefetch" );
+	ASSERT_TRUE( cursor.SetPrefetch( 64, Reflect::GetMetaClass< Mongo::Model >() ) );
+	while ( StrongPtr< Mongo::Model > object = cursor.Next< Mongo::Model >() )
+	{
+		EXPECT_TRUE( object->id != Persist::BsonObjectId::Null );
+		++found;
+	}
+	EXPECT_EQ( count, found );
+
+	const char* fields[] = { "_id" };
+	found = 0;
+	Mongo::Cursor projected = db.Find( "prefetch", NULL, fields, HELIUM_ARRAY_COUNT( fields ) );
+	while ( projected.Next< Mongo::Model >() )
+	{
+		++found;
+	}
+	EXPECT_EQ( count, found );
+
+	db.Drop();
+}
+
+HELIUM_DEFINE_BASE_STRUCT( DecodePoint );
+HELIUM_DEFINE_CLASS( DecodeBase );
+HELIUM_DEFINE_CLASS( DecodeDerived );
+
+// the single pass decoder must agree with the iterator walk on a mixed corpus, needs no mongod
+TEST( Mongo, MongoDecode )
+{
+	MongoScope scope;
+
+	std::vector< bson > corpus ( 100 );
+	ASSERT_NO_FATAL_FAILURE( BuildDecodeCorpus( corpus ) );
+
+	for ( size_t i=0; i<corpus.size(); ++i )
+	{
+		StrongPtr< DecodeBase > walked = ReadByIterator( &corpus[i] );
+		StrongPtr< DecodeBase > decoded = ReadInOnePass( &corpus[i] );
+		bson_destroy( &corpus[i] );
+
+		ASSERT_TRUE( decoded.ReferencesObject() );
+		EXPECT_EQ( walked->GetMetaClass(), decoded->GetMetaClass() );
+		EXPECT_TRUE( walked->id == decoded->id );
+		EXPECT_EQ( walked->count, decoded->count );
+		EXPECT_EQ( walked->score, decoded->score );
+		EXPECT_EQ( walked->flag, decoded->flag );
+		EXPECT_TRUE( walked->name == decoded->name );
+
+		DecodeDerived* lhs = Reflect::SafeCast< DecodeDerived >( walked.Ptr() );
+		DecodeDerived* rhs = Reflect::SafeCast< DecodeDerived >( decoded.Ptr() );
+		if ( lhs && rhs )
+		{
+			EXPECT_EQ( lhs->small, rhs->small );
+			EXPECT_TRUE( lhs->position == rhs->position );
+			EXPECT_TRUE( lhs->samples == rhs->samples );
+		}
+	}
+
+	// elements that do not match their field's type go down the general path, which leaves those fields alone
+	bson mismatched[1];
+	ASSERT_EQ( BSON_OK, bson_init( mismatched ) );
+	ASSERT_EQ( BSON_OK, bson_append_string( mismatched, "_type", Reflect::GetMetaClass< DecodeBase >()->m_Name ) );
+	ASSERT_EQ( BSON_OK, bson_append_bool( mismatched, "count", 1 ) );
+	ASSERT_EQ( BSON_OK, bson_append_int( mismatched, "flag", 1 ) );
+	ASSERT_EQ( BSON_OK, bson_append_int( mismatched, "score", 3 ) );
+	ASSERT_EQ( BSON_OK, bson_finish( mismatched ) );
+
+	StrongPtr< DecodeBase > decoded = ReadInOnePass( mismatched );
+	bson_destroy( mismatched );
+
+	ASSERT_TRUE( decoded.ReferencesObject() );
+	EXPECT_EQ( 0u, decoded->count );
+	EXPECT_FALSE( decoded->flag );
+	EXPECT_EQ( 3.0, decoded->score );
+}
@@ -5,6 +5,8 @@
 
 #include <pthread.h>
 #include <errno.h>
+#include <time.h>
+#include <sys/time.h>
 
 using namespace Helium;
 
@@ -17,7 +19,16 @@ void event_init(Condition::Handle* evt, bool manual_reset, bool initial_state)
     evt->is_signaled = initial_state;
     evt->waiting_threads = 0;
 
+#if HELIUM_OS_LINUX
+    // time out against the monotonic clock so wall clock changes don't stretch or cut short waits
+    pthread_condattr_t attr;
+    pthread_condattr_init (&attr);
+    pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+    pthread_cond_init (&evt->condition, &attr);
+    pthread_condattr_destroy (&attr);
+#else
     pthread_cond_init (&evt->condition, NULL);
+#endif
     pthread_mutex_init (&evt->lock, NULL);
 }
 
@@ -170,8 +181,22 @@ bool Condition::Wait()
 
 bool Condition::Wait( uint32_t timeoutMs )
 {
+    // pthread_cond_timedwait takes an absolute time
     struct timespec spec;
-    spec.tv_sec = timeoutMs / 1000;
-    spec.tv_nsec = ( timeoutMs % 1000 ) * 1000000;
+#if HELIUM_OS_LINUX
+    clock_gettime( CLOCK_MONOTONIC, &spec );
+#else
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    spec.tv_sec = now.tv_sec;
+    spec.tv_nsec = now.tv_usec * 1000;
+#endif
+    spec.tv_sec += timeoutMs / 1000;
+    spec.tv_nsec += ( timeoutMs % 1000 ) * 1000000;
+    if ( spec.tv_nsec >= 1000000000 )
+    {
+        spec.tv_sec += 1;
+        spec.tv_nsec -= 1000000000;
+    }
     return event_wait(&m_Handle, &spec);
 }
\ No newline at end of file
@@ -69,6 +69,28 @@ namespace Helium
 		Handle m_Handle;
 	};
 
+	//
+	// Read-only view of a whole file, mapped into memory
+	//
+
+	class HELIUM_PLATFORM_API MappedFile : NonCopyable
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool IsOpen() const;
+		bool Open( const char* filename );  // fails for empty files, there is nothing to map
+		void Close();
+
+		inline const void* GetData() const;
+		inline size_t GetSize() const;
+
+	private:
+		const void* m_Data;
+		size_t      m_Size;
+	};
+
 	//
 	// File status
 	//
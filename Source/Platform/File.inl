@@ -1,3 +1,13 @@
+const void* Helium::MappedFile::GetData() const
+{
+	return m_Data;
+}
+
+size_t Helium::MappedFile::GetSize() const
+{
+	return m_Size;
+}
+
 const std::string& Helium::Directory::GetPath()
 {
 	return m_Path;
@@ -9,6 +9,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -145,6 +146,62 @@ int64_t File::GetSize() const
 	return status.st_size;
 }
 
+//
+// Mapped files
+//
+
+MappedFile::MappedFile()
+	: m_Data( NULL )
+	, m_Size( 0 )
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::IsOpen() const
+{
+	return m_Data != NULL;
+}
+
+bool MappedFile::Open( const char* filename )
+{
+	Close();
+
+	int handle = open( filename, O_RDONLY );
+	if ( handle < 0 )
+	{
+		return false;
+	}
+
+	// the mapping keeps the file alive on its own
+	struct stat status;
+	if ( 0 == fstat( handle, &status ) && status.st_size > 0 )
+	{
+		void* data = mmap( NULL, static_cast< size_t >( status.st_size ), PROT_READ, MAP_PRIVATE, handle, 0 );
+		if ( data != MAP_FAILED )
+		{
+			m_Data = data;
+			m_Size = static_cast< size_t >( status.st_size );
+		}
+	}
+
+	close( handle );
+	return IsOpen();
+}
+
+void MappedFile::Close()
+{
+	if ( m_Data )
+	{
+		munmap( const_cast< void* >( m_Data ), m_Size );
+		m_Data = NULL;
+		m_Size = 0;
+	}
+}
+
 //
 // File stats
 //
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <fstream>
 #include <stdio.h>
+#include <string.h>
 #include <vector>
 
 using namespace Helium;
@@ -212,4 +213,30 @@ TEST( PlatformFileTest, MakePathMakeFileAndMove )
 	f.Open( newFilePath.c_str(), FileMode::Read );
 	ASSERT_FALSE( f.IsOpen() );
 	f.Close();
-}
\ No newline at end of file
+}
+
+TEST( PlatformFileTest, MapFile )
+{
+	const char* fileName = "foo4.data";
+	const char contents[] = "mapped contents";
+
+	File f;
+	ASSERT_TRUE( f.Open( fileName, FileMode::Write ) );
+	ASSERT_TRUE( f.Write( contents, sizeof( contents ) ) );
+	f.Close();
+
+	MappedFile mapped;
+	ASSERT_TRUE( mapped.Open( fileName ) );
+	ASSERT_EQ( sizeof( contents ), mapped.GetSize() );
+	ASSERT_EQ( 0, memcmp( contents, mapped.GetData(), sizeof( contents ) ) );
+	mapped.Close();
+	ASSERT_FALSE( mapped.IsOpen() );
+
+	// empty files have nothing to map
+	ASSERT_TRUE( f.Open( fileName, FileMode::Write ) );
+	f.Close();
+	ASSERT_FALSE( mapped.Open( fileName ) );
+	ASSERT_FALSE( mapped.Open( "foo5.data" ) );
+
+	ASSERT_TRUE( DeleteFile( fileName ) );
+}
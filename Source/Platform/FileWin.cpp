@@ -197,6 +197,68 @@ int64_t File::GetSize() const
 	return ( bResult ? fileSize.QuadPart : -1 );
 }
 
+//
+// Mapped files
+//
+
+MappedFile::MappedFile()
+	: m_Data( NULL )
+	, m_Size( 0 )
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::IsOpen() const
+{
+	return m_Data != NULL;
+}
+
+bool MappedFile::Open( const char* filename )
+{
+	Close();
+
+	HELIUM_TCHAR_TO_WIDE( filename, convertedFilename );
+	HANDLE file = ::CreateFile( convertedFilename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+
+	// the view keeps the file and the mapping alive on its own
+	LARGE_INTEGER fileSize;
+	if ( ::GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 )
+	{
+		HANDLE mapping = ::CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( mapping )
+		{
+			m_Data = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+			if ( m_Data )
+			{
+				m_Size = static_cast< size_t >( fileSize.QuadPart );
+			}
+
+			::CloseHandle( mapping );
+		}
+	}
+
+	::CloseHandle( file );
+	return IsOpen();
+}
+
+void MappedFile::Close()
+{
+	if ( m_Data )
+	{
+		::UnmapViewOfFile( m_Data );
+		m_Data = NULL;
+		m_Size = 0;
+	}
+}
+
 //
 // File stats
 //
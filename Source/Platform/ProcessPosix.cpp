@@ -96,7 +96,14 @@ void Helium::SpawnKill( ProcessHandle handle )
 
 int Helium::GetProcessId( ProcessHandle handle )
 {
-	return handle;
+	if ( handle == HELIUM_INVALID_PROCESS )
+	{
+		return getpid();
+	}
+	else
+	{
+		return handle;
+	}
 }
 
 std::string Helium::GetProcessString()
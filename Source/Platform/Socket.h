@@ -46,6 +46,13 @@ namespace Helium
 	}
 	typedef SocketProtocols::SocketProtocol SocketProtocol;
 
+	// A single buffer for a gathered write
+	struct SocketBuffer
+	{
+		void*    m_Data;
+		uint32_t m_Size;
+	};
+
 	class HELIUM_PLATFORM_API Socket : NonCopyable
 	{
 	public:
@@ -53,18 +60,18 @@ namespace Helium
 		typedef uintptr_t Handle;
 		struct Overlapped
 		{
-			uintptr_t Internal;
-			uintptr_t InternalHigh;
-			union
-			{
-				struct
-				{
-					int32_t Offset;
-					int32_t OffsetHigh;
-				} s;
-				void* Pointer;
-			};
-
+			uintptr_t Internal;
+			uintptr_t InternalHigh;
+			union
+			{
+				struct
+				{
+					int32_t Offset;
+					int32_t OffsetHigh;
+				} s;
+				void* Pointer;
+			};
+
 			void* hEvent;
 		};
 #else
@@ -94,6 +101,13 @@ namespace Helium
 		bool Read( void* buffer, uint32_t bytes, uint32_t& read, sockaddr_in* peer = NULL );
 		bool Write( void* buffer, uint32_t bytes, uint32_t& wrote, const char *ip = NULL, uint16_t port = 0 );
 
+		// Read whatever has arrived (blocking until there is something), up to the size of the buffer
+		bool ReadAvailable( void* buffer, uint32_t bytes, uint32_t& read );
+
+		// Write several buffers with a single call, may write less than the total like Write()
+		static const uint32_t MaxGatherBuffers = 128;
+		bool WriteGather( const SocketBuffer* buffers, uint32_t count, uint32_t& wrote );
+
 		// Poll the state of a socket
 		static int Select( Handle range, fd_set* read_set, fd_set* write_set, timeval* timeout );
 
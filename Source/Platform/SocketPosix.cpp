@@ -3,6 +3,9 @@
 
 #include "Platform/Console.h"
 #include "Platform/Assert.h"
+#include "Platform/Atomic.h"
+
+#include <sys/uio.h>
 
 #if HELIUM_OS_LINUX
 # include <pthread.h>
@@ -83,11 +86,12 @@ bool Socket::Create(SocketProtocol protocol)
 
 void Socket::Close()
 {
-	if ( m_Handle >= 0 )
+	// connection threads and their owner can race to close, only one of them gets the handle
+	Handle handle = AtomicExchange( reinterpret_cast< volatile int32_t& >( m_Handle ), InvalidHandleValue );
+	if ( handle >= 0 )
 	{
-		::shutdown(m_Handle, SHUT_RDWR);
-		HELIUM_VERIFY( ::close(m_Handle) == 0 );
-		m_Handle = InvalidHandleValue;
+		::shutdown(handle, SHUT_RDWR);
+		HELIUM_VERIFY( ::close(handle) == 0 );
 	}
 }
 
@@ -230,6 +234,41 @@ bool Socket::Write(void* buffer, uint32_t bytes, uint32_t& wrote, const char* ip
 	return true;
 }
 
+bool Socket::ReadAvailable(void* buffer, uint32_t bytes, uint32_t& read)
+{
+	int32_t local_read = ::recv( m_Handle, (char*)buffer, bytes, 0 );
+	if (local_read < 0)
+	{
+		return false;
+	}
+
+	read = local_read;
+
+	return true;
+}
+
+bool Socket::WriteGather(const SocketBuffer* buffers, uint32_t count, uint32_t& wrote)
+{
+	HELIUM_ASSERT( count <= MaxGatherBuffers );
+
+	iovec vectors[ MaxGatherBuffers ];
+	for ( uint32_t i=0; i<count; i++ )
+	{
+		vectors[i].iov_base = buffers[i].m_Data;
+		vectors[i].iov_len = buffers[i].m_Size;
+	}
+
+	int32_t local_wrote = ::writev( m_Handle, vectors, count );
+	if (local_wrote < 0)
+	{
+		return false;
+	}
+
+	wrote = local_wrote;
+
+	return true;
+}
+
 int Socket::Select(Handle range, fd_set* read_set, fd_set* write_set, timeval* timeout)
 {
 	return ::select(range, read_set, write_set, 0, timeout);
@@ -343,6 +343,74 @@ bool Socket::Write( void* buffer, uint32_t bytes, uint32_t& wrote, const char* i
 	return true;
 }
 
+bool Socket::ReadAvailable( void* buffer, uint32_t bytes, uint32_t& read )
+{
+	// overlapped reads already complete with whatever has arrived
+	return Read( buffer, bytes, read );
+}
+
+bool Socket::WriteGather( const SocketBuffer* buffers, uint32_t count, uint32_t& wrote )
+{
+	HELIUM_ASSERT( count <= MaxGatherBuffers );
+
+	WSABUF bufs[ MaxGatherBuffers ];
+	uint32_t bytes = 0;
+	for ( uint32_t i=0; i<count; i++ )
+	{
+		bufs[i].buf = (CHAR*)buffers[i].m_Data;
+		bufs[i].len = buffers[i].m_Size;
+		bytes += buffers[i].m_Size;
+	}
+
+	if (bytes == 0)
+	{
+		return true;
+	}
+
+	DWORD flags = 0;
+	DWORD wrote_local = 0;
+
+	::ResetEvent( m_Overlapped.hEvent );
+
+	int wsa_result = ::WSASend(m_Handle, bufs, count, &wrote_local, 0, reinterpret_cast<LPWSAOVERLAPPED>(&m_Overlapped), NULL);
+	if ( wsa_result != 0 )
+	{
+		int last_error = WSAGetLastError();
+		if ( last_error != WSA_IO_PENDING )
+		{
+			Helium::Print("Failed to initiate overlapped write (%d)\n", last_error);
+			return false;
+		}
+		else
+		{
+			HANDLE events[] = { m_TerminateIo, m_Overlapped.hEvent };
+			DWORD result = ::WSAWaitForMultipleEvents(2, events, FALSE, INFINITE, FALSE);
+			HELIUM_ASSERT( result != WAIT_FAILED );
+
+			if ( (result - WSA_WAIT_EVENT_0) == 0 )
+			{
+				Helium::Print("Socket session was terminated from another thread\n");
+				return false;
+			}
+
+			if ( !::WSAGetOverlappedResult(m_Handle, reinterpret_cast<LPWSAOVERLAPPED>(&m_Overlapped), &wrote_local, false, &flags) )
+			{
+				Helium::Print("Failed write (%d)\n", WSAGetLastError());
+				return false;
+			}
+		}
+	}
+
+	if (wrote_local == 0)
+	{
+		return false;
+	}
+
+	wrote = (uint32_t)wrote_local;
+
+	return true;
+}
+
 int Socket::Select( Handle range, fd_set* read_set, fd_set* write_set, timeval* timeout )
 {
 	return ::select( 0, read_set, write_set, 0, timeout);
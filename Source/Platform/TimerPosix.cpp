@@ -4,8 +4,7 @@
 #include "Platform/System.h"
 #include "Platform/Assert.h"
 
-#include <unistd.h>
-#include <sys/times.h>
+#include <time.h>
 
 using namespace Helium;
 
@@ -19,8 +18,10 @@ using namespace Helium;
 /// @see GetTicksPerSecond(), GetSecondsPerTick(), GetSeconds()
 uint64_t Timer::GetTickCount()
 {
-    struct tms timing = { 0 };
-    return times( &timing );
+    // times() only counts scheduler ticks (usually 100 Hz), use the monotonic clock in nanoseconds instead
+    struct timespec now = { 0 };
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return static_cast< uint64_t >( now.tv_sec ) * 1000000000ULL + static_cast< uint64_t >( now.tv_nsec );
 }
 
 /// Get the number of timer ticks per second.
@@ -32,9 +33,7 @@ uint64_t Timer::GetTicksPerSecond()
 {
 	if ( sm_ticksPerSecond == 0 )
 	{
-		uint64_t ticksPerSecond = sysconf(_SC_CLK_TCK);
-		HELIUM_ASSERT( ticksPerSecond != 0 );
-		sm_ticksPerSecond = ticksPerSecond;
+		sm_ticksPerSecond = 1000000000ULL;
 	}
 
 	return sm_ticksPerSecond;
@@ -49,9 +48,7 @@ float64_t Timer::GetSecondsPerTick()
 {
 	if ( sm_secondsPerTick == 0 )
 	{
-		uint64_t ticksPerSecond = sysconf(_SC_CLK_TCK);
-		HELIUM_ASSERT( ticksPerSecond != 0 );
-		sm_secondsPerTick = 1.0 / static_cast< float64_t >( ticksPerSecond );
+		sm_secondsPerTick = 1.0 / static_cast< float64_t >( GetTicksPerSecond() );
 	}
 
 	return sm_secondsPerTick;
@@ -252,7 +252,7 @@ const Field* MetaStruct::FindFieldByOffset(uint32_t offset) const
 	// TODO: Implement binary search
 	for ( const MetaStruct* current = this; current != NULL; current = current->m_Base )
 	{
-		if ( current->m_Fields.GetSize() && offset >= current->m_Fields.GetFirst().m_Offset && offset <= current->m_Fields.GetFirst().m_Offset )
+		if ( current->m_Fields.GetSize() && offset >= current->m_Fields.GetFirst().m_Offset && offset <= current->m_Fields.GetLast().m_Offset )
 		{
 			DynamicArray< Field >::ConstIterator itr = current->m_Fields.Begin();
 			DynamicArray< Field >::ConstIterator end = current->m_Fields.End();
@@ -6,6 +6,7 @@
 
 #include "Reflect/Registry.h"
 #include "Reflect/MetaClass.h"
+#include "Reflect/ObjectChanges.h"
 #include "Reflect/Registry.h"
 #include "Reflect/TranslatorDeduction.h"
 
@@ -170,7 +171,7 @@ Object::Object()
 
 Object::~Object()
 {
-
+	ForgetChanges( this );
 }
 
 void* Object::operator new( size_t bytes )
@@ -331,5 +332,15 @@ ObjectPtr Object::Clone()
 
 void Object::RaiseChanged( const Field* field ) const
 {
-	e_Changed.Raise( ObjectChangeArgs( this, field ) );
+	Reflect::RaiseChanged( ObjectChangeArgs( this, field ) );
+}
+
+void Object::AddChangedListener( const Field* field, const ObjectChangeSignature::Delegate& listener ) const
+{
+	Reflect::AddChangedListener( this, field, listener );
+}
+
+void Object::RemoveChangedListener( const Field* field, const ObjectChangeSignature::Delegate& listener ) const
+{
+	Reflect::RemoveChangedListener( this, field, listener );
 }
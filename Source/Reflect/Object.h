@@ -165,6 +165,10 @@ namespace Helium
 			// Raise the modification event manually, null field mean ambiguous/multiple changes
 			virtual void RaiseChanged( const Field* field = NULL ) const;
 
+			// Listen for changes to a single field (or any change, if NULL) without hearing about the other fields
+			void AddChangedListener( const Field* field, const ObjectChangeSignature::Delegate& listener ) const;
+			void RemoveChangedListener( const Field* field, const ObjectChangeSignature::Delegate& listener ) const;
+
 			// Notify a particular field was changed
 			template< class FieldT >
 			void FieldChanged( FieldT* fieldAddress ) const;
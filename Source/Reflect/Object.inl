@@ -19,7 +19,7 @@ template< class ObjectT, class FieldT >
 void Helium::Reflect::Object::ChangeField( FieldT ObjectT::* pointerToMember, const FieldT& newValue )
 {
     // set the field via pointer-to-member on the deduced templated type (!)
-    this->*pointerToMember = newValue;
+    static_cast< ObjectT* >( this )->*pointerToMember = newValue;
 
     // find the field in our reflection information
     const Reflect::Field* field = GetMetaClass()->FindField( pointerToMember );
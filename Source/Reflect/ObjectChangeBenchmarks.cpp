@@ -0,0 +1,73 @@
+#include "Precompile.h"
+
+#include "Reflect/TestUtilities.h"
+#include "Platform/Timer.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Reflect;
+using namespace Helium::ReflectTests;
+
+HELIUM_DEFINE_CLASS( ChangingObject );
+
+// prints the time for observers of one field to ignore changes to another, filtering e_Changed and with field
+//  listeners, and to hear a batch of changes to their field; the ChangeBatch test checks the batched delivery
+TEST(Reflect, FieldChangedListenersBenchmark)
+{
+	Reflect::Startup();
+
+	{
+		const uint32_t observerCount = 1000;
+		const uint32_t changeCount = 10000;
+
+		// the same observers, all watching A, while B is edited: filtering on e_Changed and subscribing to A
+		StrongPtr< ChangingObject > broadcast = new ChangingObject ();
+		StrongPtr< ChangingObject > indexed = new ChangingObject ();
+		std::vector< ChangeCounter > observers ( observerCount, ChangeCounter( FieldA() ) );
+		for ( uint32_t i = 0; i < observerCount; ++i )
+		{
+			broadcast->e_Changed.AddMethod( &observers[ i ], &ChangeCounter::Filter );
+			indexed->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &observers[ i ], &ChangeCounter::Changed ) );
+		}
+
+		float64_t milliseconds[ 3 ];
+		ChangingObject* objects[ 2 ] = { broadcast, indexed };
+		for ( uint32_t i = 0; i < 2; ++i )
+		{
+			uint64_t start = Timer::GetTickCount();
+			for ( uint32_t change = 0; change < changeCount; ++change )
+			{
+				objects[ i ]->ChangeField( &ChangingObject::m_B, change );
+			}
+			milliseconds[ i ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+		}
+
+		// editing A in a batch notifies the observers once
+		uint64_t start = Timer::GetTickCount();
+		{
+			ChangeBatch batch;
+			for ( uint32_t change = 0; change < changeCount; ++change )
+			{
+				indexed->ChangeField( &ChangingObject::m_A, change );
+			}
+		}
+		milliseconds[ 2 ] = Timer::TicksToMilliseconds( Timer::GetTickCount() - start );
+
+		for ( uint32_t i = 0; i < observerCount; ++i )
+		{
+			EXPECT_EQ( 1u, observers[ i ].m_Changes );
+		}
+
+		for ( uint32_t i = 0; i < observerCount; ++i )
+		{
+			broadcast->e_Changed.RemoveMethod( &observers[ i ], &ChangeCounter::Filter );
+			indexed->RemoveChangedListener( FieldA(), ObjectChangeSignature::Delegate( &observers[ i ], &ChangeCounter::Changed ) );
+		}
+
+		printf( "%u changes to a field %u observers ignore: e_Changed filtering %.2fms, field listeners %.2fms; %u batched changes to their field %.2fms\n",
+			changeCount, observerCount, milliseconds[ 0 ], milliseconds[ 1 ], changeCount, milliseconds[ 2 ] );
+	}
+
+	Reflect::Shutdown();
+}
@@ -0,0 +1,162 @@
+#include "Precompile.h"
+
+#include "Reflect/TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+using namespace Helium;
+using namespace Helium::Reflect;
+using namespace Helium::ReflectTests;
+
+HELIUM_DEFINE_CLASS( ChangingObject );
+
+namespace
+{
+	// releases whichever of its two objects did not change, while that one's change may still be waiting in a batch
+	struct ChangeReleaser
+	{
+		StrongPtr< ChangingObject > m_Objects[ 2 ];
+		uint32_t                    m_Changes;
+
+		ChangeReleaser()
+			: m_Changes( 0 )
+		{
+		}
+
+		void Changed( const ObjectChangeArgs& args )
+		{
+			++m_Changes;
+			m_Objects[ args.m_Object == m_Objects[ 0 ].Get() ? 1 : 0 ].Release();
+		}
+	};
+}
+
+TEST(Reflect, FieldChangedListeners)
+{
+	Reflect::Startup();
+
+	{
+		StrongPtr< ChangingObject > object = new ChangingObject ();
+
+		ChangeCounter a, b, whole, broadcast;
+		object->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &a, &ChangeCounter::Changed ) );
+		object->AddChangedListener( FieldB(), ObjectChangeSignature::Delegate( &b, &ChangeCounter::Changed ) );
+		object->AddChangedListener( NULL, ObjectChangeSignature::Delegate( &whole, &ChangeCounter::Changed ) );
+		object->e_Changed.AddMethod( &broadcast, &ChangeCounter::Changed );
+
+		object->RaiseChanged( FieldA() );
+		EXPECT_EQ( 1u, a.m_Changes );
+		EXPECT_EQ( 0u, b.m_Changes );
+		EXPECT_EQ( 1u, whole.m_Changes );
+		EXPECT_EQ( 1u, broadcast.m_Changes );
+
+		object->ChangeField( &ChangingObject::m_B, 7u );
+		EXPECT_EQ( 1u, a.m_Changes );
+		EXPECT_EQ( 1u, b.m_Changes );
+
+		// an ambiguous change goes to everyone
+		object->RaiseChanged();
+		EXPECT_EQ( 2u, a.m_Changes );
+		EXPECT_EQ( 2u, b.m_Changes );
+		EXPECT_EQ( 3u, whole.m_Changes );
+		EXPECT_EQ( 1u, a.m_WholeChanges );
+
+		object->RemoveChangedListener( FieldA(), ObjectChangeSignature::Delegate( &a, &ChangeCounter::Changed ) );
+		object->RaiseChanged( FieldA() );
+		EXPECT_EQ( 2u, a.m_Changes );
+		EXPECT_EQ( 4u, whole.m_Changes );
+
+		// listeners of other objects are left alone, and go away with their object
+		StrongPtr< ChangingObject > other = new ChangingObject ();
+		ChangeCounter otherA;
+		other->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &otherA, &ChangeCounter::Changed ) );
+		object->RaiseChanged( FieldA() );
+		EXPECT_EQ( 0u, otherA.m_Changes );
+		other = NULL;
+
+		object->e_Changed.RemoveMethod( &broadcast, &ChangeCounter::Changed );
+		object->RemoveChangedListener( FieldB(), ObjectChangeSignature::Delegate( &b, &ChangeCounter::Changed ) );
+		object->RemoveChangedListener( NULL, ObjectChangeSignature::Delegate( &whole, &ChangeCounter::Changed ) );
+	}
+
+	Reflect::Shutdown();
+}
+
+TEST(Reflect, ChangeBatch)
+{
+	Reflect::Startup();
+
+	{
+		StrongPtr< ChangingObject > object = new ChangingObject ();
+		ChangeCounter a, c, broadcast;
+		object->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &a, &ChangeCounter::Changed ) );
+		object->AddChangedListener( FieldC(), ObjectChangeSignature::Delegate( &c, &ChangeCounter::Changed ) );
+		object->e_Changed.AddMethod( &broadcast, &ChangeCounter::Changed );
+
+		// a bulk edit is heard once per field, when the outermost batch ends
+		{
+			ChangeBatch batch;
+			for ( uint32_t i = 0; i < 100; ++i )
+			{
+				object->ChangeField( &ChangingObject::m_A, i );
+				object->ChangeField( &ChangingObject::m_B, i );
+			}
+
+			{
+				ChangeBatch nested;
+				object->RaiseChanged( FieldC() );
+			}
+
+			EXPECT_EQ( 0u, broadcast.m_Changes );
+			EXPECT_EQ( 0u, c.m_Changes );
+		}
+		EXPECT_EQ( 3u, broadcast.m_Changes );
+		EXPECT_EQ( 1u, a.m_Changes );
+		EXPECT_EQ( 1u, c.m_Changes );
+		EXPECT_EQ( 99u, object->m_A );
+
+		// a change to the whole object covers the changes to its fields
+		{
+			ChangeBatch batch;
+			object->RaiseChanged( FieldA() );
+			object->RaiseChanged();
+			object->RaiseChanged( FieldC() );
+		}
+		EXPECT_EQ( 4u, broadcast.m_Changes );
+		EXPECT_EQ( 1u, broadcast.m_WholeChanges );
+		EXPECT_EQ( 2u, a.m_Changes );
+		EXPECT_EQ( 2u, c.m_Changes );
+
+		// objects that go away before the batch ends are dropped
+		{
+			ChangeBatch batch;
+			StrongPtr< ChangingObject > temporary = new ChangingObject ();
+			ChangeCounter temporaryA;
+			temporary->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &temporaryA, &ChangeCounter::Changed ) );
+			temporary->RaiseChanged( FieldA() );
+			temporary = NULL;
+			object->RaiseChanged( FieldA() );
+		}
+		EXPECT_EQ( 3u, a.m_Changes );
+
+		// and so are objects a listener destroys while the batch is being delivered
+		ChangeReleaser releaser;
+		{
+			ChangeBatch batch;
+			for ( uint32_t i = 0; i < 2; ++i )
+			{
+				releaser.m_Objects[ i ] = new ChangingObject ();
+				releaser.m_Objects[ i ]->AddChangedListener( FieldA(), ObjectChangeSignature::Delegate( &releaser, &ChangeReleaser::Changed ) );
+				releaser.m_Objects[ i ]->RaiseChanged( FieldA() );
+			}
+		}
+		EXPECT_EQ( 1u, releaser.m_Changes );
+		EXPECT_NE( releaser.m_Objects[ 0 ].ReferencesObject(), releaser.m_Objects[ 1 ].ReferencesObject() );
+
+		object->e_Changed.RemoveMethod( &broadcast, &ChangeCounter::Changed );
+		object->RemoveChangedListener( FieldA(), ObjectChangeSignature::Delegate( &a, &ChangeCounter::Changed ) );
+		object->RemoveChangedListener( FieldC(), ObjectChangeSignature::Delegate( &c, &ChangeCounter::Changed ) );
+	}
+
+	Reflect::Shutdown();
+}
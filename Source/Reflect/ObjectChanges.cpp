@@ -0,0 +1,313 @@
+#include "Precompile.h"
+#include "Reflect/ObjectChanges.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/Thread.h"
+#include "Foundation/SmartPtr.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace Helium;
+using namespace Helium::Reflect;
+
+typedef std::pair< const Object*, const Field* > ChangeKey;
+typedef std::vector< ObjectChangeSignature::Delegate > V_ChangeListener;
+
+// the listeners of one ( object, field ), never changed once published: subscribing and unsubscribing publish
+//  a new list, so a raise holds on to the lists it found and calls them after letting go of the lock, without
+//  copying (or being the one to destroy) any delegate that the map still shares
+struct ChangeListenerList : public AtomicRefCountBase< ChangeListenerList >
+{
+	V_ChangeListener m_Delegates;
+};
+typedef SmartPtr< ChangeListenerList > ChangeListenerListPtr;
+typedef std::vector< ChangeListenerListPtr > V_ChangeListenerList;
+typedef std::map< ChangeKey, ChangeListenerListPtr > M_ChangeListeners;
+
+// the changes queued by the open batches of one thread
+struct PendingChanges
+{
+	uint32_t                        m_Depth;
+	std::vector< ObjectChangeArgs > m_Changes;
+
+	PendingChanges()
+		: m_Depth( 0 )
+	{
+	}
+};
+
+// the changes a closed batch is handing out on one thread, kept where ForgetChanges can drop the objects that
+//  the listeners destroy before their turn comes (a listener closing a batch of its own delivers on top of it)
+struct DeliveringChanges
+{
+	std::vector< ObjectChangeArgs > m_Changes;
+	DeliveringChanges*              m_Outer;
+
+	DeliveringChanges()
+		: m_Outer( NULL )
+	{
+	}
+};
+
+static Helium::Mutex g_ListenersMutex;
+static M_ChangeListeners g_Listeners;
+static int32_t volatile g_ListenerCount = 0;
+
+static ThreadLocal< PendingChanges > g_PendingChanges;
+static int32_t volatile g_OpenBatches = 0;
+
+static ThreadLocal< DeliveringChanges > g_DeliveringChanges;
+static int32_t volatile g_DeliveringBatches = 0;
+
+static bool SortChanges( const ObjectChangeArgs& lhs, const ObjectChangeArgs& rhs )
+{
+	return lhs.m_Object != rhs.m_Object ? lhs.m_Object < rhs.m_Object : lhs.m_Field < rhs.m_Field;
+}
+
+static void RaiseListeners( const ObjectChangeArgs& args )
+{
+	V_ChangeListenerList lists;
+
+	{
+		Helium::MutexScopeLock lock ( g_ListenersMutex );
+
+		M_ChangeListeners::const_iterator end = g_Listeners.end();
+		if ( args.m_Field )
+		{
+			M_ChangeListeners::const_iterator found = g_Listeners.find( ChangeKey( args.m_Object, NULL ) );
+			if ( found != end )
+			{
+				lists.push_back( found->second );
+			}
+
+			found = g_Listeners.find( ChangeKey( args.m_Object, args.m_Field ) );
+			if ( found != end )
+			{
+				lists.push_back( found->second );
+			}
+		}
+		else
+		{
+			// the whole object changed, everyone listening to any of its fields hears about it
+			M_ChangeListeners::const_iterator itr = g_Listeners.lower_bound( ChangeKey( args.m_Object, NULL ) );
+			for ( ; itr != end && itr->first.first == args.m_Object; ++itr )
+			{
+				lists.push_back( itr->second );
+			}
+		}
+	}
+
+	// called without the lock, listeners are free to subscribe and unsubscribe
+	for ( V_ChangeListenerList::const_iterator list = lists.begin(), listEnd = lists.end(); list != listEnd; ++list )
+	{
+		const V_ChangeListener& delegates = ( *list )->m_Delegates;
+		for ( V_ChangeListener::const_iterator itr = delegates.begin(), end = delegates.end(); itr != end; ++itr )
+		{
+			itr->Invoke( args );
+		}
+	}
+}
+
+static void Deliver( const ObjectChangeArgs& args )
+{
+	args.m_Object->e_Changed.Raise( args );
+
+	if ( g_ListenerCount )
+	{
+		RaiseListeners( args );
+	}
+}
+
+void Reflect::RaiseChanged( const ObjectChangeArgs& args )
+{
+	if ( g_OpenBatches )
+	{
+		PendingChanges* pending = g_PendingChanges.GetPointer();
+		if ( pending )
+		{
+			pending->m_Changes.push_back( args );
+			return;
+		}
+	}
+
+	Deliver( args );
+}
+
+void Reflect::AddChangedListener( const Object* object, const Field* field, const ObjectChangeSignature::Delegate& listener )
+{
+	HELIUM_ASSERT( object );
+
+	ChangeListenerListPtr updated = new ChangeListenerList ();
+
+	Helium::MutexScopeLock lock ( g_ListenersMutex );
+	ChangeListenerListPtr& list = g_Listeners[ ChangeKey( object, field ) ];
+	if ( list )
+	{
+		updated->m_Delegates.reserve( list->m_Delegates.size() + 1 );
+		updated->m_Delegates.insert( updated->m_Delegates.end(), list->m_Delegates.begin(), list->m_Delegates.end() );
+	}
+	updated->m_Delegates.push_back( listener );
+	list = updated;
+	AtomicIncrement( g_ListenerCount );
+}
+
+void Reflect::RemoveChangedListener( const Object* object, const Field* field, const ObjectChangeSignature::Delegate& listener )
+{
+	Helium::MutexScopeLock lock ( g_ListenersMutex );
+
+	M_ChangeListeners::iterator found = g_Listeners.find( ChangeKey( object, field ) );
+	if ( found != g_Listeners.end() )
+	{
+		const V_ChangeListener& listeners = found->second->m_Delegates;
+		for ( size_t i = 0; i < listeners.size(); ++i )
+		{
+			if ( listeners[ i ].Equals( listener ) )
+			{
+				AtomicDecrement( g_ListenerCount );
+
+				if ( listeners.size() == 1 )
+				{
+					g_Listeners.erase( found );
+				}
+				else
+				{
+					ChangeListenerListPtr updated = new ChangeListenerList ();
+					updated->m_Delegates.reserve( listeners.size() - 1 );
+					updated->m_Delegates.insert( updated->m_Delegates.end(), listeners.begin(), listeners.begin() + i );
+					updated->m_Delegates.insert( updated->m_Delegates.end(), listeners.begin() + i + 1, listeners.end() );
+					found->second = updated;
+				}
+
+				break;
+			}
+		}
+	}
+}
+
+void Reflect::ForgetChanges( const Object* object )
+{
+	if ( g_ListenerCount )
+	{
+		Helium::MutexScopeLock lock ( g_ListenersMutex );
+
+		M_ChangeListeners::iterator itr = g_Listeners.lower_bound( ChangeKey( object, NULL ) );
+		while ( itr != g_Listeners.end() && itr->first.first == object )
+		{
+			AtomicAdd( g_ListenerCount, -static_cast< int32_t >( itr->second->m_Delegates.size() ) );
+			g_Listeners.erase( itr++ );
+		}
+	}
+
+	if ( g_OpenBatches )
+	{
+		PendingChanges* pending = g_PendingChanges.GetPointer();
+		if ( pending )
+		{
+			std::vector< ObjectChangeArgs >& changes = pending->m_Changes;
+			for ( size_t i = 0; i < changes.size(); )
+			{
+				if ( changes[ i ].m_Object == object )
+				{
+					changes[ i ] = changes.back();
+					changes.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+	}
+
+	if ( g_DeliveringBatches )
+	{
+		for ( DeliveringChanges* delivering = g_DeliveringChanges.GetPointer(); delivering; delivering = delivering->m_Outer )
+		{
+			std::vector< ObjectChangeArgs >& changes = delivering->m_Changes;
+			for ( size_t i = 0; i < changes.size(); ++i )
+			{
+				if ( changes[ i ].m_Object == object )
+				{
+					changes[ i ].m_Object = NULL;
+				}
+			}
+		}
+	}
+}
+
+ChangeBatch::ChangeBatch()
+{
+	PendingChanges* pending = g_PendingChanges.GetPointer();
+	if ( !pending )
+	{
+		pending = new PendingChanges ();
+		g_PendingChanges.SetPointer( pending );
+		AtomicIncrement( g_OpenBatches );
+	}
+
+	++pending->m_Depth;
+}
+
+ChangeBatch::~ChangeBatch()
+{
+	PendingChanges* pending = g_PendingChanges.GetPointer();
+	HELIUM_ASSERT( pending && pending->m_Depth );
+	if ( --pending->m_Depth )
+	{
+		return;
+	}
+
+	// close the batch before delivering, changes raised by the listeners go out right away
+	DeliveringChanges delivering;
+	std::vector< ObjectChangeArgs >& changes = delivering.m_Changes;
+	changes.swap( pending->m_Changes );
+	g_PendingChanges.SetPointer( NULL );
+	AtomicDecrement( g_OpenBatches );
+	delete pending;
+
+	std::sort( changes.begin(), changes.end(), &SortChanges );
+
+	size_t count = 0;
+	const Object* wholeObject = NULL;
+	for ( size_t i = 0; i < changes.size(); ++i )
+	{
+		const ObjectChangeArgs& change = changes[ i ];
+		if ( change.m_Object == wholeObject )
+		{
+			continue;
+		}
+
+		if ( count > 0 && change.m_Object == changes[ count - 1 ].m_Object && change.m_Field == changes[ count - 1 ].m_Field )
+		{
+			continue;
+		}
+
+		// NULL sorts first, a change to the whole object covers the rest of its changes
+		if ( change.m_Field == NULL )
+		{
+			wholeObject = change.m_Object;
+		}
+
+		changes[ count++ ] = change;
+	}
+	changes.erase( changes.begin() + count, changes.end() );
+
+	delivering.m_Outer = g_DeliveringChanges.GetPointer();
+	g_DeliveringChanges.SetPointer( &delivering );
+	AtomicIncrement( g_DeliveringBatches );
+
+	for ( size_t i = 0; i < changes.size(); ++i )
+	{
+		// the listeners get a copy, ForgetChanges clears the entry if one of them destroys the object
+		if ( changes[ i ].m_Object )
+		{
+			ObjectChangeArgs change = changes[ i ];
+			Deliver( change );
+		}
+	}
+
+	g_DeliveringChanges.SetPointer( delivering.m_Outer );
+	AtomicDecrement( g_DeliveringBatches );
+}
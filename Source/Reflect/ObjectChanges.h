@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Reflect/API.h"
+#include "Reflect/Object.h"
+
+namespace Helium
+{
+	namespace Reflect
+	{
+		//
+		// Change notification, Object::RaiseChanged ends up here
+		//  Listeners subscribed to a single field are indexed by ( object, field ), so a change only calls the
+		//  listeners of the field that changed (and those of the whole object) instead of every listener
+		//
+
+		// raise a change on the object's e_Changed and its field listeners (or queue it inside a ChangeBatch)
+		HELIUM_REFLECT_API void RaiseChanged( const ObjectChangeArgs& args );
+
+		// subscribe to changes of a field of an object, a NULL field receives every change to the object
+		HELIUM_REFLECT_API void AddChangedListener( const Object* object, const Field* field, const ObjectChangeSignature::Delegate& listener );
+		HELIUM_REFLECT_API void RemoveChangedListener( const Object* object, const Field* field, const ObjectChangeSignature::Delegate& listener );
+
+		// drops the listeners and queued changes of an object that is going away
+		HELIUM_REFLECT_API void ForgetChanges( const Object* object );
+
+		//
+		// Holds the changes raised on this thread until the outermost batch goes out of scope, then
+		//  raises each changed field once (a change to the whole object covers all of its fields)
+		//
+
+		class HELIUM_REFLECT_API ChangeBatch : NonCopyable
+		{
+		public:
+			ChangeBatch();
+			~ChangeBatch();
+		};
+	}
+}
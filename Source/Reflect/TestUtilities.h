@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Reflect/Object.h"
+#include "Reflect/ObjectChanges.h"
+#include "Reflect/TranslatorDeduction.h"
+
+//
+// Helpers shared by the Reflect tests and benchmarks, not part of the library
+//
+
+// a source file of each binary that uses it says HELIUM_DEFINE_CLASS( ChangingObject )
+class ChangingObject : public Helium::Reflect::Object
+{
+public:
+	uint32_t m_A;
+	uint32_t m_B;
+	uint32_t m_C;
+
+	ChangingObject()
+		: m_A( 0 )
+		, m_B( 0 )
+		, m_C( 0 )
+	{
+	}
+
+	HELIUM_DECLARE_CLASS( ChangingObject, Helium::Reflect::Object );
+	static void PopulateMetaType( Helium::Reflect::MetaClass& comp );
+};
+
+inline void ChangingObject::PopulateMetaType( Helium::Reflect::MetaClass& comp )
+{
+	comp.AddField( &ChangingObject::m_A, "A" );
+	comp.AddField( &ChangingObject::m_B, "B" );
+	comp.AddField( &ChangingObject::m_C, "C" );
+}
+
+namespace Helium
+{
+	namespace ReflectTests
+	{
+		struct ChangeCounter
+		{
+			const Reflect::Field* m_Interest;
+			uint32_t              m_Changes;
+			uint32_t              m_WholeChanges;
+
+			ChangeCounter( const Reflect::Field* interest = NULL )
+				: m_Interest( interest )
+				, m_Changes( 0 )
+				, m_WholeChanges( 0 )
+			{
+			}
+
+			void Changed( const Reflect::ObjectChangeArgs& args )
+			{
+				++m_Changes;
+				if ( args.m_Field == NULL )
+				{
+					++m_WholeChanges;
+				}
+			}
+
+			// what a listener on e_Changed has to do to care about one field
+			void Filter( const Reflect::ObjectChangeArgs& args )
+			{
+				if ( args.m_Field == m_Interest || args.m_Field == NULL )
+				{
+					++m_Changes;
+				}
+			}
+		};
+
+		inline const Reflect::Field* FieldA()
+		{
+			return Reflect::GetMetaClass< ChangingObject >()->FindField( &ChangingObject::m_A );
+		}
+
+		inline const Reflect::Field* FieldB()
+		{
+			return Reflect::GetMetaClass< ChangingObject >()->FindField( &ChangingObject::m_B );
+		}
+
+		inline const Reflect::Field* FieldC()
+		{
+			return Reflect::GetMetaClass< ChangingObject >()->FindField( &ChangingObject::m_C );
+		}
+	}
+}
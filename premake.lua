@@ -88,7 +88,8 @@ Helium.DoBasicProjectSettings = function()
 
 end
 
-Helium.DoTestsProjectSettings = function()
+-- Common settings for googletest executables.
+Helium.DoGoogleTestProjectSettings = function()
 
 	filter {}
 
@@ -107,11 +108,6 @@ Helium.DoTestsProjectSettings = function()
 		"googletest"
 	}
 
-	postbuildcommands
-	{
-		"\"%{cfg.linktarget.abspath}\""
-	}
-
 	filter "system:linux"
 		links
 		{
@@ -126,6 +122,25 @@ Helium.DoTestsProjectSettings = function()
 
 end
 
+-- Tests run after every build.
+Helium.DoTestsProjectSettings = function()
+
+	Helium.DoGoogleTestProjectSettings()
+
+	postbuildcommands
+	{
+		"\"%{cfg.linktarget.abspath}\""
+	}
+
+end
+
+-- Benchmarks only run when asked, their timings depend on the machine and are no use as a pass or fail.
+Helium.DoBenchmarksProjectSettings = function()
+
+	Helium.DoGoogleTestProjectSettings()
+
+end
+
 Helium.DoModuleProjectSettings = function( baseDirectory, tokenPrefix, moduleName, moduleNameUpper )
 
 	filter {}
@@ -94,6 +94,7 @@ project( "Foundation" )
 	excludes
 	{
 		"Source/Foundation/*Tests.*",
+		"Source/Foundation/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -102,6 +103,12 @@ project( "Foundation" )
 			"Platform",
 		}
 
+	filter { "kind:SharedLib", "system:linux" }
+		links
+		{
+			"rt",
+		}
+
 	filter {}
 
 project( "FoundationTests" )
@@ -119,6 +126,21 @@ project( "FoundationTests" )
 		"Platform",
 	}
 
+project( "FoundationBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Foundation/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Foundation",
+		"Platform",
+	}
+
 project( "Application" )
 
 	Helium.DoModuleProjectSettings( "Source", "HELIUM", "Application", "APPLICATION" )
@@ -131,6 +153,7 @@ project( "Application" )
 	excludes
 	{
 		"Source/Application/*Tests.*",
+		"Source/Application/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -158,6 +181,22 @@ project( "ApplicationTests" )
 		"Platform",
 	}
 
+project( "ApplicationBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Application/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Application",
+		"Foundation",
+		"Platform",
+	}
+
 project( "Reflect" )
 
 	Helium.DoModuleProjectSettings( "Source", "HELIUM", "Reflect", "REFLECT" )
@@ -170,6 +209,7 @@ project( "Reflect" )
 	excludes
 	{
 		"Source/Reflect/*Tests.*",
+		"Source/Reflect/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -197,6 +237,22 @@ project( "ReflectTests" )
 		"Platform",
 	}
 
+project( "ReflectBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Reflect/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Reflect",
+		"Foundation",
+		"Platform",
+	}
+
 project( "Persist" )
 
 	Helium.DoModuleProjectSettings( "Source", "HELIUM", "Persist", "PERSIST" )
@@ -251,6 +307,7 @@ project( "Mongo" )
 	excludes
 	{
 		"Source/Mongo/*Tests.*",
+		"Source/Mongo/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -284,6 +341,25 @@ project( "MongoTests" )
 		"mongo-c",
 	}
 
+project( "MongoBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Mongo/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Mongo",
+		"Persist",
+		"Reflect",
+		"Foundation",
+		"Platform",
+		"mongo-c",
+	}
+
 project( "Inspect" )
 
 	Helium.DoModuleProjectSettings( "Source", "HELIUM", "Inspect", "INSPECT" )
@@ -296,6 +372,7 @@ project( "Inspect" )
 	excludes
 	{
 		"Source/Inspect/*Tests.*",
+		"Source/Inspect/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -331,6 +408,26 @@ project( "InspectTests" )
 		"Platform",
 	}
 
+project( "InspectBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Inspect/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Inspect",
+		"Math",
+		"Persist",
+		"Reflect",
+		"Application",
+		"Foundation",
+		"Platform",
+	}
+
 project( "Math" )
 
 	Helium.DoModuleProjectSettings( "Source", "HELIUM", "Math", "MATH" )
@@ -343,6 +440,7 @@ project( "Math" )
 	excludes
 	{
 		"Source/Math/*Tests.*",
+		"Source/Math/*Benchmarks.*",
 	}
 
 	filter "kind:SharedLib"
@@ -371,3 +469,20 @@ project( "MathTests" )
 		"Foundation",
 		"Platform",
 	}
+
+project( "MathBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Math/*Benchmarks.*",
+	}
+
+	links
+	{
+		"Math",
+		"Reflect",
+		"Foundation",
+		"Platform",
+	}